@@ -21,6 +21,17 @@
 #include "moon_ephemeris.h"
 #include "moon_sphere.h"
 #include "moon_interaction.h"
+#include "jpeg_stream.h"  // Streaming JPEG decode from the HTTP socket
+#include "image_decoder.h"  // Decoder chain (hardware codec -> JPEGDEC)
+#include "jpeg_hw_decoder.h"
+#include "conditional_fetch.h"  // ETag / Last-Modified revalidation
+#include "content_hash.h"      // FNV-1a body hash for unchanged-frame dedup
+#include "frame_slots.h"       // PSRAM cache of decoded frames (prefetch + revisits)
+#include "pooled_http_client.h" // Keep-alive connections to image hosts
+#include "render_geometry.h"   // Transform geometry shared by decode and render
+#include "strip_pipeline.h"    // Strip-by-strip decode -> scale
+#include "pixel_stage.h"       // Per-pixel colour work done while decoding
+#include "row_pool.h"          // Whole-frame pixel passes split across both cores
 
 // Additional required libraries
 #include <atomic>
@@ -63,7 +74,6 @@ unsigned long lastEditActivity = 0;     // Track last transform edit time
 uint32_t imageGeneration = 0;   // bumped on every buffer swap (new image); advisory cache key
 bool scaledBufferValid = false;
 float lastRenderScaleX = 0.0f, lastRenderScaleY = 0.0f, lastRenderRotation = -1.0f;
-int lastRenderColorTemp = -1;
 uint32_t lastRenderGeneration = 0xFFFFFFFF;
 
 // Download retry: re-attempt a failed download a few times before falling back
@@ -76,17 +86,55 @@ uint16_t* fullImageBuffer = nullptr;
 size_t fullImageBufferSize = 0;
 int16_t fullImageWidth = 0;
 int16_t fullImageHeight = 0;
+// Which part of the frame fullImageBuffer holds and at what decode-time
+// reduction: a zoomed or panned source only keeps the pixels it puts on the
+// panel (see render_geometry.h).
+FrameLayout fullImageLayout = { 0, 0, 0, 0, 1, 1.0f, 1.0f, 0 };
 
 // Pending image buffer (downloaded/decoded but not yet displayed)
 uint16_t* pendingFullImageBuffer = nullptr;
 int16_t pendingImageWidth = 0;
 int16_t pendingImageHeight = 0;
+FrameLayout pendingImageLayout = { 0, 0, 0, 0, 1, 1.0f, 1.0f, 0 };
 std::atomic<bool> imageReadyToDisplay{false};  // Flag: new image fully prepared and ready to show
+std::atomic<bool> pendingFrameDecoding{false}; // Flag: streaming decode writing the pending buffer unlocked
 
 // Scaling buffer for transformed images
 uint16_t* scaledBuffer = nullptr;
 size_t scaledBufferSize = 0;
 
+#if STRIP_PIPELINE
+// Strip-pipelined JPEGDEC decode (strip_pipeline.h): MCU rows are gathered
+// into the ring and each strip is scaled into the pending buffer as soon as
+// it is complete, so frames are stored at the size they are drawn
+static uint16_t* stripRing[STRIP_RING_SLOTS] = {};
+static uint16_t* stripCarryRow = nullptr;        // StripScaler's last source row
+static StripAssembler stripAssembler;
+static StripCopySink stripCopySink;
+static StripScaler stripScaler;
+static StripBoxScaler stripBoxScaler;
+static PPAStripSink stripPpaSink;
+static StripSink* stripSink = nullptr;
+static bool stripDecodeActive = false;           // JPEGDraw feeds stripAssembler
+
+// Ring strips are as wide as the widest frame JPEGDEC is asked to decode.
+// Internal RAM when there is room (the CPU fills them, the PPA reads them).
+static bool allocateStripRing() {
+    size_t stripBytes = ((size_t)MAX_IMAGE_DIMENSION * STRIP_MAX_ROWS * 2 + 63) & ~(size_t)63;
+    for (int i = 0; i < STRIP_RING_SLOTS; i++) {
+        stripRing[i] = (uint16_t*)heap_caps_aligned_alloc(64, stripBytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if (!stripRing[i]) {
+            stripRing[i] = (uint16_t*)heap_caps_aligned_alloc(64, stripBytes, MALLOC_CAP_DMA | MALLOC_CAP_SPIRAM);
+        }
+        if (!stripRing[i]) return false;
+    }
+    stripCarryRow = (uint16_t*)heap_caps_malloc((size_t)MAX_IMAGE_DIMENSION * 2, MALLOC_CAP_INTERNAL);
+    if (!stripCarryRow) return false;
+    LOG_DEBUG_F("[Memory] ✓ Strip ring: %d x %d bytes\n", STRIP_RING_SLOTS, (int)stripBytes);
+    return true;
+}
+#endif
+
 // Previous image tracking for seamless transitions
 static int16_t prevImageX = -1, prevImageY = -1;
 static int16_t prevImageWidth = 0, prevImageHeight = 0;
@@ -95,6 +143,54 @@ static bool hasSeenFirstImage = false;
 // JPEG decoder
 JPEGDEC jpeg;
 
+// Per-pixel stage (colour temperature, night red shift, gamma) applied to
+// decoded pixels while they are still in cache: in JPEGDraw, or right after a
+// hardware decode / moon render. Its 128 KB table is allocated at startup
+// (allocatePixelStage) and rebuilt only when a setting changes. Only the
+// download task touches it.
+static PixelStage decodeStage = { 0, nullptr };
+static bool decodeStageInDraw = false;   // JPEGDraw staged direct-decode blocks
+
+// Settings the pixel stage composes
+static PixelStageSettings pixelStageSettings() {
+    PixelStageSettings s = { configStorage.getColorTemp(), configStorage.getDisplayGamma(),
+                             configStorage.getNightRedShift() };
+    return s;
+}
+
+// Key the frames should carry: 0 when there is no table to apply them with
+static uint32_t wantedPixelStageKey() {
+    return decodeStage.lut ? pixelStageKey(pixelStageSettings()) : 0;
+}
+
+// Bring decodeStage up to the current settings before a decode; returns its
+// key for pendingImageLayout.stage
+static uint32_t beginPixelStage() {
+    uint32_t key = wantedPixelStageKey();
+    if (key != decodeStage.key) {
+        unsigned long t0 = micros();
+        pixelStageBuild(&decodeStage, pixelStageSettings());
+        Serial.printf("[Image] Pixel stage table rebuilt in %lu us\n", micros() - t0);
+    }
+    decodeStageInDraw = false;
+    return decodeStage.key;
+}
+
+// Random lookups want internal RAM; PSRAM when that is short
+static void allocatePixelStage() {
+    decodeStage.lut = (uint16_t*)heap_caps_malloc(PIXEL_STAGE_LUT_BYTES, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    const char* where = "internal RAM";
+    if (!decodeStage.lut) {
+        decodeStage.lut = (uint16_t*)heap_caps_malloc(PIXEL_STAGE_LUT_BYTES, MALLOC_CAP_SPIRAM);
+        where = "PSRAM";
+    }
+    if (!decodeStage.lut) {
+        LOG_WARNING("[Memory] ✗ WARNING: Pixel stage table allocation failed - colour temperature, gamma and red shift disabled\n");
+        return;
+    }
+    LOG_DEBUG_F("[Memory] ✓ Pixel stage table: %d bytes in %s\n", (int)PIXEL_STAGE_LUT_BYTES, where);
+}
+
 // WiFi QR Code display
 uint16_t* qrCodeBuffer = nullptr;
 int16_t qrCodeWidth = 0;
@@ -161,6 +257,36 @@ QueueHandle_t imageReadyQueue = nullptr;
 volatile bool imageDownloadPending = false;  // Flag to trigger download
 SemaphoreHandle_t imageBufferMutex = nullptr;  // Protect buffer access
 
+// Which image source the frames in the buffers were decoded from (-1 = none /
+// not a downloaded source). A conditional GET is only sent when the frame on
+// screen came from the source being requested.
+int pendingSourceIndex = -1;
+int displayedSourceIndex = -1;
+
+// The source the running download belongs to. Normally currentImageIndex, but
+// a prefetch fetches the next cycling source while the current one is shown.
+int downloadSourceIndex = 0;
+String downloadSourceURL = "";
+bool downloadIsPrefetch = false;
+
+// Prefetch of the next cycling source into the frame cache (frame_slots.h)
+volatile bool imagePrefetchPending = false;  // Flag to trigger a prefetch
+int prefetchSourceIndex = -1;                // source the pending prefetch is for
+int plannedNextImageIndex = -1;              // next cycling source, chosen ahead of time
+unsigned long prefetchCycleTime = 0;         // lastCycleTime the last prefetch was scheduled in
+
+// URL, fetch time and freshness lifetime of the pending and displayed frames,
+// so the frame a swap displaces can go back into the frame cache
+String pendingSourceURL = "";
+String displayedSourceURL = "";
+uint32_t pendingFetchedAt = 0, displayedFetchedAt = 0;
+uint32_t pendingTtlMs = 0, displayedTtlMs = 0;
+volatile bool cachedFrameCheckPending = false;  // source changed: try the frame cache first
+
+// The frame on screen was decoded smaller than the current transform needs
+// (the user zoomed in): decode it again at a higher resolution
+volatile bool frameRedecodePending = false;
+
 // Forward declarations
 void debugPrint(const char* message, uint16_t color);
 void debugPrintf(uint16_t color, const char* format, ...);
@@ -169,10 +295,12 @@ int JPEGDrawQR(JPEGDRAW *pDraw);
 int16_t displayWiFiQRCode();
 void downloadAndDisplayImage();
 void renderFullImage();
+static void composeFullImage();
 void renderMoonToPendingBuffer();
 void loadCyclingConfiguration();
 void advanceToNextImage();
 String getCurrentImageURL();
+String getImageSourceURL(int index);
 void updateCyclingVariables();
 void updateCurrentImageTransformSettings();
 void downloadTask(void* params);
@@ -258,12 +386,33 @@ void debugPrintf(uint16_t color, const char* format, ...) {
 
 // JPEG callback function to collect pixels into PENDING image buffer (not displayed yet)
 int JPEGDraw(JPEGDRAW *pDraw) {
+#if STRIP_PIPELINE
+    if (stripDecodeActive) {
+        pixelStageApply(decodeStage, pDraw->pPixels, (size_t)pDraw->iWidth * pDraw->iHeight);
+        return stripAssembler.draw(pDraw->x, pDraw->y, pDraw->iWidth, pDraw->iHeight, pDraw->pPixels) ? 1 : 0;
+    }
+#endif
+    if (!pendingFullImageBuffer) return 1;
+    int clipW, clipH;
+    bool inside = jpegClipBlock(pDraw->x, pDraw->y, pDraw->iWidth, pDraw->iHeight,
+                                pendingImageWidth, pendingImageHeight, &clipW, &clipH);
+    // Direct decode (jpegdecPrepareTarget): the pixels are already in place
+    // and only go through the pixel stage there
+    if (pDraw->pPixels >= pendingFullImageBuffer &&
+        pDraw->pPixels < pendingFullImageBuffer + fullImageBufferSize / sizeof(uint16_t)) {
+        if (inside) pixelStageApplyRect(decodeStage, pDraw->pPixels, pendingImageWidth, clipW, clipH);
+        decodeStageInDraw = true;
+        return 1;
+    }
     // Store pixels in the PENDING image buffer (will be swapped to active buffer when complete)
-    if (pendingFullImageBuffer && pDraw->y + pDraw->iHeight <= pendingImageHeight) {
-        for (int16_t y = 0; y < pDraw->iHeight; y++) {
+    // Coordinates are relative to the crop area when only part of the frame
+    // is decoded; the pending buffer is packed at that part's width. MCUs
+    // overhanging the right / bottom edge are clipped, so every row is written.
+    if (inside) {
+        for (int16_t y = 0; y < clipH; y++) {
             uint16_t* destRow = pendingFullImageBuffer + ((pDraw->y + y) * pendingImageWidth + pDraw->x);
             uint16_t* srcRow = pDraw->pPixels + (y * pDraw->iWidth);
-            memcpy(destRow, srcRow, pDraw->iWidth * sizeof(uint16_t));
+            pixelStageCopy(decodeStage, destRow, srcRow, clipW);
         }
     }
     return 1;
@@ -549,15 +698,16 @@ void setup() {
     // Now watchdog is properly configured - reset it after initialization
     systemMonitor.forceResetWatchdog();
 
-    // Decode the lunar surface texture FIRST, while all PSRAM is free and
-    // contiguous. The 2048x1024 JPEG needs a transient ~6 MB contiguous decode
-    // buffer (stb_image). If this runs after the 16.9 MB of image buffers below
-    // are allocated, the largest free block is too small and the decode fails
-    // with "outofmem", falling back to the low-detail procedural placeholder.
-    // Decoding here keeps the full-resolution texture (~4 MB resident). Safe to
-    // call early: it only touches PSRAM (no display/network), and is idempotent
-    // so the later lazy call in renderMoonToPendingBuffer() is a no-op.
-    LOG_DEBUG("[Moon] Pre-decoding lunar texture while PSRAM is contiguous...");
+    // Load the lunar surface texture FIRST. With the baked texture flashed to
+    // the moontex partition (tools/bake_moon_texture.py) this is only a flash
+    // mmap: no decode and no PSRAM. Without it the 2048x1024 JPEG is decoded,
+    // which needs a transient ~6 MB contiguous buffer (stb_image). If that runs
+    // after the 16.9 MB of image buffers below are allocated, the largest free
+    // block is too small and the decode fails with "outofmem", falling back to
+    // the low-detail procedural placeholder, so it stays ahead of them. Safe to
+    // call early: it only touches flash/PSRAM (no display/network), and is
+    // idempotent so the later lazy call in renderMoonToPendingBuffer() is a no-op.
+    LOG_DEBUG("[Moon] Loading lunar texture while PSRAM is contiguous...");
     if (moon_sphere_init()) {
         LOG_INFO("[Moon] Lunar texture ready (full resolution)");
     } else {
@@ -580,7 +730,7 @@ void setup() {
                  ESP.getFreeHeap(), ESP.getFreePsram());
     
     // Clean up any existing allocations (safety check for repeated setup calls)
-    if (imageBuffer) { free(imageBuffer); imageBuffer = nullptr; }
+    if (imageBuffer) { heap_caps_free(imageBuffer); imageBuffer = nullptr; }
     if (fullImageBuffer) { heap_caps_free(fullImageBuffer); fullImageBuffer = nullptr; }
     if (pendingFullImageBuffer) { heap_caps_free(pendingFullImageBuffer); pendingFullImageBuffer = nullptr; }
     if (scaledBuffer) { heap_caps_free(scaledBuffer); scaledBuffer = nullptr; }
@@ -593,7 +743,8 @@ void setup() {
     }
     LOG_DEBUG_F("[Memory] Allocating image buffer: %d bytes (%.1f KB)\n",
                  imageBufferSize, imageBufferSize / 1024.0);
-    imageBuffer = (uint8_t*)ps_malloc(imageBufferSize);
+    // 64-byte aligned so the hardware JPEG decoder can DMA the bitstream directly
+    imageBuffer = (uint8_t*)heap_caps_aligned_alloc(64, imageBufferSize, MALLOC_CAP_SPIRAM);
     if (!imageBuffer) {
         LOG_CRITICAL("[Memory] ✗ CRITICAL: Image buffer allocation failed!\n");
         LOG_CRITICAL_F("CRITICAL: Image buffer pre-allocation failed! Size: %d bytes\n", imageBufferSize);
@@ -607,7 +758,17 @@ void setup() {
     LOG_DEBUG_F("[Memory] ✓ Image buffer: %d bytes (%.1f KB)\n", imageBufferSize, imageBufferSize / 1024.0);
     LOG_DEBUG_F("✓ Image buffer allocated: %d bytes\n", imageBufferSize);
     
+#if STRIP_PIPELINE
+    // Frames are stored at the size they are drawn (or only their visible
+    // part, ROI_DECODE): a panel-sized square plus the crop's margin and MCU
+    // rounding on each side is the most that is ever kept
+    {
+        size_t side = (size_t)max(w, h) + 2 * (ROI_DECODE_MARGIN + JPEG_MCU_ALIGN);
+        fullImageBufferSize = (side * side * 2 + 63) & ~(size_t)63;
+    }
+#else
     fullImageBufferSize = FULL_IMAGE_BUFFER_SIZE;
+#endif
     LOG_DEBUG_F("[Memory] Allocating full image buffer: %d bytes (%.1f KB, max 512x512)\n", 
                  fullImageBufferSize, fullImageBufferSize / 1024.0);
     fullImageBuffer = (uint16_t*)heap_caps_aligned_alloc(64, fullImageBufferSize, MALLOC_CAP_DMA | MALLOC_CAP_SPIRAM);
@@ -637,6 +798,22 @@ void setup() {
     }
     LOG_DEBUG_F("[Memory] ✓ Pending buffer: %d bytes (%.1f KB)\n", fullImageBufferSize, fullImageBufferSize / 1024.0);
     LOG_DEBUG_F("✓ Pending image buffer allocated: %d bytes\n", fullImageBufferSize);
+
+#if STRIP_PIPELINE
+    if (!allocateStripRing()) {
+        LOG_CRITICAL("[Memory] ✗ CRITICAL: Strip ring allocation failed!\n");
+        crashLogger.saveBeforeReboot();
+        delay(100);
+        ESP.restart();
+    }
+#endif
+
+    allocatePixelStage();
+
+    // Workers for whole-frame pixel passes, one per core, kept for the run
+    if (!rowPoolBegin(ROW_POOL_WORKERS, ROW_POOL_TASK_STACK_SIZE, ROW_POOL_TASK_PRIORITY)) {
+        LOG_WARNING("[Memory] Row pool workers not started; pixel passes run on one core");
+    }
     
     scaledBufferSize = w * h * SCALED_BUFFER_MULTIPLIER * 2;
     LOG_DEBUG_F("[Memory] Allocating scaled buffer: %d bytes (%.1f KB, 4x display for PPA)\n", 
@@ -719,6 +896,21 @@ void setup() {
     
     // Buffers already allocated before display init - just initialize PPA hardware acceleration
     ppaAccelerator.begin(w, h);
+
+    // Decoder chain for buffered frames: hardware codec (engine kept for the
+    // lifetime of the device), with JPEGDEC as the fallback. The codec only
+    // decodes whole frames, which the strip pipeline's buffers can't hold.
+#if JPEG_HW_DECODE && !STRIP_PIPELINE
+    jpegHwDecoder.begin();
+    imageDecoders.add(&jpegHwDecoder);
+#endif
+    imageDecoders.add(&jpegdecDecoder);
+
+    // Decoded-frame cache (prefetch + revisits within a source's TTL).
+    // Allocated last, after the framebuffer and PPA/codec buffers, and only
+    // while PSRAM stays above FRAME_SLOT_PSRAM_RESERVE - zero slots just
+    // disables caching and prefetch.
+    frameSlots.begin(fullImageBufferSize, FRAME_CACHE_PSRAM_BUDGET, FRAME_SLOT_PSRAM_RESERVE);
     
     if (!needsWiFiSetup) {
         // Show hardware initialization result
@@ -884,32 +1076,69 @@ void setup() {
 // image appears not to move. Only the now-uncovered pixels are cleared to the
 // background, leaving the overlap untouched, so the flicker-free same-position
 // cycling path is unaffected (identical rect -> early return, no fill).
+// With fb set (the PPA draws straight into it) the bands are cleared on the
+// PPA fill engine, falling back to the CPU per band.
 static void eraseUncoveredPrevRegion(Arduino_DSI_Display* gfx,
-                                     int16_t nx, int16_t ny, int16_t nw, int16_t nh) {
+                                     int16_t nx, int16_t ny, int16_t nw, int16_t nh,
+                                     uint16_t* fb = nullptr) {
     if (!gfx) return;
     if (prevImageX == -1 || prevImageWidth == 0 || prevImageHeight == 0) return;  // nothing drawn yet
 
-    const int16_t px = prevImageX, py = prevImageY, pw = prevImageWidth, ph = prevImageHeight;
-    if (px == nx && py == ny && pw == nw && ph == nh) return;  // unchanged rect -> no flicker
-
-    const int16_t pl = px, pr = px + pw, pt = py, pb = py + ph;   // previous rect edges
-    const int16_t nl = nx, nr = nx + nw, nt = ny, nb = ny + nh;   // new rect edges
-
-    const int16_t ox1 = max(pl, nl), ox2 = min(pr, nr);          // horizontal overlap span
-    const int16_t oy1 = max(pt, nt), oy2 = min(pb, nb);          // vertical overlap span
+    const RenderRect prev = { prevImageX, prevImageY, prevImageWidth, prevImageHeight };
+    if (prev.x == nx && prev.y == ny && prev.w == nw && prev.h == nh) return;  // unchanged rect -> no flicker
 
-    if (ox1 >= ox2 || oy1 >= oy2) {                              // no overlap: erase whole old rect
-        gfx->fillRect(pl, pt, pw, ph, COLOR_BLACK);
-        return;
+    RenderRect bands[4];
+    int count = renderUncoveredBands(prev, RenderRect{ nx, ny, nw, nh }, bands);
+    for (int i = 0; i < count; i++) {
+        const RenderRect& b = bands[i];
+        if (fb && ppaAccelerator.fillFramebuffer(fb, displayManager.getWidth(), displayManager.getHeight(),
+                                                 b, COLOR_BLACK)) {
+            continue;
+        }
+        displayManager.fillRect(b.x, b.y, b.w, b.h, COLOR_BLACK);
     }
+}
+
+// The frame's pixels went through other colour / tone settings than the ones
+// now set (the pixel stage runs while decoding, see decodeStage)
+static bool displayedFrameStageStale() {
+    return fullImageLayout.stage != wantedPixelStageKey();
+}
 
-    if (nl > pl) gfx->fillRect(pl, pt, nl - pl, ph, COLOR_BLACK);            // left band (full height)
-    if (nr < pr) gfx->fillRect(nr, pt, pr - nr, ph, COLOR_BLACK);            // right band (full height)
-    if (nt > pt) gfx->fillRect(ox1, pt, ox2 - ox1, nt - pt, COLOR_BLACK);   // top band (overlap span)
-    if (nb < pb) gfx->fillRect(ox1, nb, ox2 - ox1, pb - nb, COLOR_BLACK);   // bottom band (overlap span)
+// The frame on screen no longer serves the current settings: its pixel stage
+// is stale, it was decoded or stored smaller than the transform now draws it
+// (see frameTooCoarse), or only part of it was kept and a pan / zoom-out now
+// shows more than that part.
+static bool displayedFrameNeedsRedecode() {
+    const FrameLayout& l = fullImageLayout;
+    if (displayedFrameStageStale()) return true;
+    if (frameTooCoarse(l, scaleX, scaleY)) return true;
+    if (fullImageWidth >= l.frameW && fullImageHeight >= l.frameH) return false;
+
+    float drawX, drawY;
+    frameDrawScale(l, scaleX, scaleY, &drawX, &drawY);
+    RenderRect shown;
+    if (!renderVisibleRect(l.frameW, l.frameH, drawX, drawY, rotationAngle,
+                           offsetX, offsetY, displayManager.getWidth(), displayManager.getHeight(), &shown)) {
+        return false;
+    }
+    RenderRect held = { l.cropX, l.cropY, fullImageWidth, fullImageHeight };
+    return !renderRectContains(held, shown);
 }
 
+// Compose the frame off-screen where there is a back buffer
+// (DISPLAY_DOUBLE_BUFFER) and put it on the panel in one go, so the panel
+// never scans a half-drawn frame. A new image fades or slides in
+// (TRANSITION_MODE); redraws of the same one (offset, scale) swap at once.
 void renderFullImage() {
+    static uint32_t presentedGeneration = 0xFFFFFFFF;
+    bool composing = displayManager.beginCompose();
+    composeFullImage();
+    if (composing) displayManager.present(imageGeneration != presentedGeneration);
+    presentedGeneration = imageGeneration;
+}
+
+static void composeFullImage() {
     // Reset watchdog at function start
     systemMonitor.forceResetWatchdog();
     
@@ -930,33 +1159,69 @@ void renderFullImage() {
     // Reset watchdog before calculations
     systemMonitor.forceResetWatchdog();
     
-    // Calculate final scaled dimensions (accounting for rotation)
-    int16_t scaledWidth, scaledHeight;
-    if (rotationAngle == 90.0 || rotationAngle == 270.0) {
-        // For 90°/270° rotation, dimensions are swapped
-        scaledWidth = (int16_t)(fullImageHeight * scaleX);
-        scaledHeight = (int16_t)(fullImageWidth * scaleY);
-    } else {
-        // For 0°/180° rotation, dimensions remain the same
-        scaledWidth = (int16_t)(fullImageWidth * scaleX);
-        scaledHeight = (int16_t)(fullImageHeight * scaleY);
+    // The transform scale is relative to the frame at its buffer-fit size; a
+    // frame decoded smaller than that for this scale is drawn up by the
+    // reduction, and one stored already scaled by its prescale, so it keeps
+    // the same on-screen size
+    const FrameLayout& layout = fullImageLayout;
+    float drawScaleX, drawScaleY;
+    frameDrawScale(layout, scaleX, scaleY, &drawScaleX, &drawScaleY);
+    if (displayedFrameStageStale()) {
+        // Colour temperature, gamma or red shift changed: the stage is
+        // re-run by decoding the frame again (the moon is rendered again)
+        if (!frameRedecodePending) {
+            Serial.printf("[Render] Frame stage %08x, settings now %08x - re-decoding\n",
+                          (unsigned)layout.stage, (unsigned)wantedPixelStageKey());
+            frameRedecodePending = true;
+        }
+    } else if (!currentSourceIsMoon && displayedFrameNeedsRedecode()) {
+        // Zoomed in past what the reduced decode holds, or panned beyond the
+        // decoded crop: show what there is for now and have the download task
+        // decode the frame again for this transform
+        if (!frameRedecodePending) {
+            Serial.printf("[Render] Frame (1/%d, %dx%d at %d,%d) doesn't cover scale %.2fx%.2f offset %d,%d - re-decoding\n",
+                          layout.reduction, fullImageWidth, fullImageHeight, layout.cropX, layout.cropY,
+                          scaleX, scaleY, offsetX, offsetY);
+            frameRedecodePending = true;
+        }
     }
+
+    // The whole frame is centred plus offset; the buffer may hold just the
+    // part of it that was on screen when it was decoded, drawn at its place
+    // within the frame (accounting for rotation)
+    int frameW = layout.frameW ? layout.frameW : fullImageWidth;
+    int frameH = layout.frameH ? layout.frameH : fullImageHeight;
+    int frameScaledW, frameScaledH;
+    renderScaledSize(frameW, frameH, drawScaleX, drawScaleY, rotationAngle, &frameScaledW, &frameScaledH);
+    RenderRect stored = { layout.cropX, layout.cropY, fullImageWidth, fullImageHeight };
+    RenderRect drawn;
+    renderCropPlacement(frameW, frameH, stored, drawScaleX, drawScaleY, rotationAngle, &drawn);
+    int16_t scaledWidth = (int16_t)drawn.w;
+    int16_t scaledHeight = (int16_t)drawn.h;
     
     // Calculate center position
     int16_t centerX = w / 2;
     int16_t centerY = h / 2;
     
     // Calculate final position with centering and offset
-    int16_t finalX = centerX - (scaledWidth / 2) + offsetX;
-    int16_t finalY = centerY - (scaledHeight / 2) + offsetY;
+    int16_t finalX = centerX - (frameScaledW / 2) + offsetX + drawn.x;
+    int16_t finalY = centerY - (frameScaledH / 2) + offsetY + drawn.y;
 
     // Clear only the region the previous frame occupied that this frame won't
     // cover. This makes per-image X/Y offset (and scale) changes visibly move
     // the image instead of leaving a stale copy behind, without reintroducing
     // the flicker the full-clear skip avoids. Dimensions match whichever draw
-    // path runs below: unscaled full image vs scaled/rotated buffer.
-    {
-        bool unscaled = (scaleX == 1.0 && scaleY == 1.0 && rotationAngle == 0.0);
+    // path runs below: unscaled full image vs scaled/rotated buffer. A frame
+    // the PPA draws straight into the framebuffer clears after drawing, once
+    // it is known which panel pixels it filled.
+    bool unscaled = (drawScaleX == 1.0 && drawScaleY == 1.0 && rotationAngle == 0.0);
+    uint16_t* directFb = nullptr;
+#if PPA_DIRECT_FRAMEBUFFER
+    if (!unscaled && ppaAccelerator.isAvailable()) {
+        directFb = displayManager.drawTarget();   // back buffer while composing
+    }
+#endif
+    if (!directFb) {
         int16_t drawnW = unscaled ? fullImageWidth : scaledWidth;
         int16_t drawnH = unscaled ? fullImageHeight : scaledHeight;
         eraseUncoveredPrevRegion(gfx, finalX, finalY, drawnW, drawnH);
@@ -979,26 +1244,11 @@ void renderFullImage() {
     // Reset watchdog before rendering operations
     systemMonitor.forceResetWatchdog();
     
-    if (scaleX == 1.0 && scaleY == 1.0 && rotationAngle == 0.0) {
+    if (unscaled) {
         // No scaling or rotation needed
         scaledBufferValid = false;  // this path doesn't populate the scaled-render cache
-        int currentTemp = configStorage.getColorTemp();
-        if (currentTemp != 6500) {
-            // Copy to scaledBuffer first, then apply color temp to the copy.
-            // This prevents compounding color shifts when the same image is re-rendered.
-            size_t imageSize = fullImageWidth * fullImageHeight * sizeof(uint16_t);
-            if (imageSize <= scaledBufferSize) {
-                memcpy(scaledBuffer, fullImageBuffer, imageSize);
-                ImageUtils::adjustColorTemperature(scaledBuffer, fullImageWidth, fullImageHeight, currentTemp);
-                displayManager.drawBitmap(finalX, finalY, scaledBuffer, fullImageWidth, fullImageHeight);
-            } else {
-                // Fallback: buffer too small, apply in-place (legacy behavior)
-                ImageUtils::adjustColorTemperature(fullImageBuffer, fullImageWidth, fullImageHeight, currentTemp);
-                displayManager.drawBitmap(finalX, finalY, fullImageBuffer, fullImageWidth, fullImageHeight);
-            }
-        } else {
-            displayManager.drawBitmap(finalX, finalY, fullImageBuffer, fullImageWidth, fullImageHeight);
-        }
+        // Colour temperature was applied while decoding (decodeStage)
+        displayManager.drawBitmap(finalX, finalY, fullImageBuffer, fullImageWidth, fullImageHeight);
 
         // auto_flush (DSI ctor) already cache-syncs the drawn region
 
@@ -1010,17 +1260,49 @@ void renderFullImage() {
         prevImageWidth = fullImageWidth;
         prevImageHeight = fullImageHeight;
     } else {
+        // PPA straight into the framebuffer at the frame's place: no scaled
+        // copy and no CPU copy of it into the panel
+        if (directFb) {
+            unsigned long hwStart = millis();
+            RenderRect written;
+            displayManager.pauseDisplay();
+            bool drawn = ppaAccelerator.scaleRotateToFramebuffer(fullImageBuffer, fullImageWidth, fullImageHeight,
+                                                                 directFb, w, h, finalX, finalY,
+                                                                 scaledWidth, scaledHeight, rotationAngle, &written);
+            displayManager.resumeDisplay();
+            systemMonitor.forceResetWatchdog();
+            if (drawn) {
+                // Whatever of the previous frame this one didn't draw over,
+                // including a sliver the PPA left at a panel edge it was cut at
+                eraseUncoveredPrevRegion(gfx, written.x, written.y, written.w, written.h, directFb);
+                unsigned long hwTime = millis() - hwStart;
+                Serial.printf("[PPA] ✓ Drew %dx%d at %d,%d straight into the framebuffer in %lu ms\n",
+                              written.w, written.h, written.x, written.y, hwTime);
+                debugPrintf(COLOR_GREEN, "PPA hardware render: %lu ms", hwTime);
+                systemMonitor.forceResetWatchdog();
+
+                prevImageX = written.x;
+                prevImageY = written.y;
+                prevImageWidth = written.w;
+                prevImageHeight = written.h;
+                // Nothing kept to redraw from: an offset-only change runs the PPA again
+                scaledBufferValid = false;
+                return;
+            }
+            Serial.println("[PPA] Direct framebuffer draw refused, using the scaled buffer");
+            eraseUncoveredPrevRegion(gfx, finalX, finalY, scaledWidth, scaledHeight);
+        }
+
         // Try hardware acceleration first if available
         size_t scaledImageSize = scaledWidth * scaledHeight * 2;
 
         // Reuse fast-path: if only the per-image offset changed since the last
-        // render (same image, scale, rotation, and color temp), the scaled+rotated
+        // render (same image, scale and rotation), the scaled+rotated
         // buffer is still valid. Re-draw it at the new position and skip the PPA
         // pass entirely. Common during interactive offset tuning.
         if (scaledBufferValid && imageGeneration == lastRenderGeneration
             && scaleX == lastRenderScaleX && scaleY == lastRenderScaleY
             && rotationAngle == lastRenderRotation
-            && configStorage.getColorTemp() == lastRenderColorTemp
             && scaledImageSize <= scaledBufferSize) {
             displayManager.drawBitmap(finalX, finalY, scaledBuffer, scaledWidth, scaledHeight);
             systemMonitor.forceResetWatchdog();
@@ -1060,12 +1342,6 @@ void renderFullImage() {
                 Serial.printf("[PPA] ✓ Hardware acceleration successful in %lu ms\n", hwTime);
                 debugPrintf(COLOR_GREEN, "PPA hardware render: %lu ms", hwTime);
                 
-                // Apply color temperature adjustment to scaled buffer
-                int currentTemp = configStorage.getColorTemp();
-                if (currentTemp != 6500) {
-                    ImageUtils::adjustColorTemperature(scaledBuffer, scaledWidth, scaledHeight, currentTemp);
-                }
-                
                 // Draw the hardware-processed image
                 displayManager.drawBitmap(finalX, finalY, scaledBuffer, scaledWidth, scaledHeight);
 
@@ -1082,7 +1358,6 @@ void renderFullImage() {
                 scaledBufferValid = true;
                 lastRenderScaleX = scaleX; lastRenderScaleY = scaleY;
                 lastRenderRotation = rotationAngle;
-                lastRenderColorTemp = configStorage.getColorTemp();
                 lastRenderGeneration = imageGeneration;
                 return;
             } else {
@@ -1117,12 +1392,6 @@ void renderFullImage() {
                 Serial.printf("[Render] ✓ Software scaling complete in %lu ms\n", swTime);
                 debugPrintf(COLOR_GREEN, "SW render: %lu ms", swTime);
                 
-                // Apply color temperature adjustment to scaled buffer
-                int currentTemp = configStorage.getColorTemp();
-                if (currentTemp != 6500) {
-                    ImageUtils::adjustColorTemperature(scaledBuffer, scaledWidth, scaledHeight, currentTemp);
-                }
-                
                 // Draw the software-processed image
                 displayManager.drawBitmap(finalX, finalY, scaledBuffer, scaledWidth, scaledHeight);
 
@@ -1139,7 +1408,6 @@ void renderFullImage() {
                 scaledBufferValid = true;
                 lastRenderScaleX = scaleX; lastRenderScaleY = scaleY;
                 lastRenderRotation = rotationAngle;
-                lastRenderColorTemp = configStorage.getColorTemp();
                 lastRenderGeneration = imageGeneration;
                 return;
             } else {
@@ -1152,12 +1420,6 @@ void renderFullImage() {
         Serial.println("[Render] Drawing original unscaled image");
         debugPrint("WARNING: Showing unscaled image", COLOR_YELLOW);
         
-        // Apply color temperature adjustment
-        int currentTemp = configStorage.getColorTemp();
-        if (currentTemp != 6500) {
-            ImageUtils::adjustColorTemperature(fullImageBuffer, fullImageWidth, fullImageHeight, currentTemp);
-        }
-        
         displayManager.drawBitmap(finalX, finalY, fullImageBuffer, fullImageWidth, fullImageHeight);
         
         // auto_flush (DSI ctor) already cache-syncs the drawn region
@@ -1188,8 +1450,9 @@ void renderMoonToPendingBuffer() {
         return;
     }
 
-    // Decode the equirectangular lunar texture into PSRAM once (lazy: only the
-    // first time a moon source is shown). ~4 MB RGB565 held for app lifetime.
+    // Map (or, unbaked, decode into PSRAM) the equirectangular lunar texture
+    // once (lazy: only the first time a moon source is shown); held for the app
+    // lifetime.
     static bool moonTexReady = false;
     if (!moonTexReady) {
         moonTexReady = moon_sphere_init();
@@ -1218,16 +1481,20 @@ void renderMoonToPendingBuffer() {
     moon_sphere_set_disk_scale(diskScale);
 
     uint8_t bg = (uint8_t)configStorage.getMoonBgStyle();
+    unsigned long renderStart = micros();
     uint16_t* moon = moon_sphere_render(w, h, &st,
                                         MOON_REST_SECTORS, MOON_REST_STACKS, bg);
     if (!moon) { Serial.println("[Moon] render failed"); return; }
+    Serial.printf("[Moon] rendered %dx%d in %lu us\n", w, h, micros() - renderStart);
 
     size_t bytes = (size_t)w * (size_t)h * 2;
     if (xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(5000)) == pdTRUE) {
         if (pendingFullImageBuffer && bytes <= fullImageBufferSize) {
-            memcpy(pendingFullImageBuffer, moon, bytes);
+            uint32_t stage = beginPixelStage();
+            ImageUtils::applyPixelStage(decodeStage, pendingFullImageBuffer, moon, w, h);
             pendingImageWidth  = w;
             pendingImageHeight = h;
+            pendingImageLayout = { 0, 0, 0, 0, 1, 1.0f, 1.0f, stage };
             imageReadyToDisplay = true;
             Serial.printf("[Moon] pending buffer filled %dx%d (disk %.2f), ready\n",
                           w, h, diskScale);
@@ -1258,10 +1525,8 @@ void serviceMoonDrag() {
 
     const int DS = 240;  // interactive render size, upscaled to the panel by PPA
     static uint16_t* dragColor = nullptr;
-    static uint16_t* dragZ = nullptr;
     if (!dragColor) dragColor = (uint16_t*)heap_caps_aligned_alloc(128, (size_t)DS * DS * 2, MALLOC_CAP_DMA | MALLOC_CAP_SPIRAM);
-    if (!dragZ)     dragZ     = (uint16_t*)heap_caps_aligned_alloc(128, (size_t)DS * DS * 2, MALLOC_CAP_SPIRAM);
-    if (!dragColor || !dragZ) { Serial.println("[Moon] drag buffer alloc failed"); interactiveMoonMode = false; return; }
+    if (!dragColor) { Serial.println("[Moon] drag buffer alloc failed"); interactiveMoonMode = false; return; }
 
     const int16_t w = displayManager.getWidth();
     const int16_t h = displayManager.getHeight();
@@ -1277,6 +1542,11 @@ void serviceMoonDrag() {
     uint8_t bg = (uint8_t)configStorage.getMoonBgStyle();
     moon_light_mode_t lm = (configStorage.getMoonDragLightMode() == 1) ? MOON_LIGHT_EXPLORE : MOON_LIGHT_TRUE_PHASE;
 
+    // Frame timing for the loop summary: the render alone, and the whole frame
+    // (render, PPA upscale, panel copy, touch)
+    unsigned long frames = 0, renderUsTotal = 0, renderUsMax = 0;
+    unsigned long loopStart = micros();
+
     Serial.println("[Moon] interactive drag loop start");
     while (interactiveMoonMode) {
         updateTouchState();   // keep feeding the finger -> moon_drag_move / moon_drag_end
@@ -1291,8 +1561,13 @@ void serviceMoonDrag() {
         float yaw = 0.0f, pitch = 0.0f;
         moon_drag_get(&yaw, &pitch);
 
+        unsigned long renderStart = micros();
         uint16_t* frame = moon_sphere_render_into(DS, DS, &st, MOON_REST_SECTORS, MOON_REST_STACKS,
-                                                  bg, yaw, pitch, lm, dragColor, dragZ);
+                                                  bg, yaw, pitch, lm, dragColor);
+        unsigned long renderUs = micros() - renderStart;
+        renderUsTotal += renderUs;
+        if (renderUs > renderUsMax) renderUsMax = renderUs;
+        frames++;
         if (frame &&
             ppaAccelerator.scaleRotateImageZeroCopy(dragColor, DS, DS, scaledBuffer,
                                                     scaledBufferSize, w, h, 0.0f)) {
@@ -1308,10 +1583,703 @@ void serviceMoonDrag() {
     }
     moon_drag_reset();
     lastUpdate = 0;   // force a prompt crisp full-resolution resting re-render
-    Serial.println("[Moon] interactive drag loop end");
+    unsigned long loopUs = micros() - loopStart;
+    if (frames) {
+        Serial.printf("[Moon] interactive drag loop end: %lu frames, render avg %lu us max %lu us, "
+                      "frame avg %lu us (%.1f fps)\n",
+                      frames, renderUsTotal / frames, renderUsMax, loopUs / frames,
+                      loopUs ? frames * 1e6f / loopUs : 0.0f);
+    } else {
+        Serial.println("[Moon] interactive drag loop end");
+    }
 }
 
-void downloadAndDisplayImage() {
+// Smallest decode-time downscale (1/1, 1/2, 1/4, 1/8) at which the frame fits
+// the RGB565 image buffer: oversized full-disc sources (e.g. GOES-19 1808px,
+// which would need ~6.5MB at full size) are halved, ~1024px sources are not.
+// Always measured against FULL_IMAGE_BUFFER_SIZE, which is what the transform
+// scale refers to, also when the strip pipeline stores frames smaller.
+static int jpegFitDivisor(int srcW, int srcH) {
+    int decodeDiv = 1;
+    while (decodeDiv < 8) {
+        int dw = srcW / decodeDiv, dh = srcH / decodeDiv;
+        if ((size_t)dw * dh * 2 <= FULL_IMAGE_BUFFER_SIZE && dw <= MAX_IMAGE_DIMENSION && dh <= MAX_IMAGE_DIMENSION) break;
+        decodeDiv *= 2;
+    }
+    return decodeDiv;
+}
+
+// Transform the download source will be drawn with. The source on screen
+// uses the live values (it may be mid-tune).
+static void downloadTransform(float* sx, float* sy, float* rotation, int* ox, int* oy) {
+    if (downloadSourceIndex == currentImageIndex || imageSourceCount == 0) {
+        *sx = scaleX;
+        *sy = scaleY;
+        *rotation = rotationAngle;
+        *ox = offsetX;
+        *oy = offsetY;
+    } else {
+        *sx = configStorage.getImageScaleX(downloadSourceIndex);
+        *sy = configStorage.getImageScaleY(downloadSourceIndex);
+        *rotation = configStorage.getImageRotation(downloadSourceIndex);
+        *ox = configStorage.getImageOffsetX(downloadSourceIndex);
+        *oy = configStorage.getImageOffsetY(downloadSourceIndex);
+    }
+}
+
+// Further reduction the download source's transform can absorb on top of
+// fitDiv: a source drawn at scale 0.3 only needs half the decoded pixels.
+static int downloadDecodeReduction(int fitDiv) {
+    float sx, sy, rotation;
+    int ox, oy;
+    downloadTransform(&sx, &sy, &rotation, &ox, &oy);
+    return renderDecodeReduction(sx, sy, 8 / fitDiv);
+}
+
+// Part of the download source's frame (frameW x frameH as decoded, at
+// `reduction`) that its transform puts on the panel, padded by a margin and
+// aligned to MCUs. False when that is the whole frame, or none of it.
+static bool downloadVisibleCrop(int frameW, int frameH, int reduction, RenderRect* crop) {
+    if (!ROI_DECODE) return false;
+    float sx, sy, rotation;
+    int ox, oy;
+    downloadTransform(&sx, &sy, &rotation, &ox, &oy);
+    if (!renderVisibleRect(frameW, frameH, sx * reduction, sy * reduction, rotation, ox, oy,
+                           displayManager.getWidth(), displayManager.getHeight(), crop)) {
+        return false;
+    }
+    renderAlignRect(crop, ROI_DECODE_MARGIN, JPEG_MCU_ALIGN, frameW, frameH);
+    return crop->w < frameW || crop->h < frameH;
+}
+
+// Pick the JPEGDEC decode-time downscale: the buffer-fit divisor times the
+// reduction the renderer can absorb (capped at 1/8). Returns the divisor and
+// stores the matching JPEG_SCALE_* flag in *options.
+static int chooseJpegDecodeDivisor(int srcW, int srcH, int reduceDiv, int* options) {
+    int decodeDiv = jpegFitDivisor(srcW, srcH);
+    if (reduceDiv > 1) decodeDiv *= reduceDiv;
+    if (decodeDiv > 8) decodeDiv = 8;
+    *options = 0;
+    if (decodeDiv == 2)      *options = JPEG_SCALE_HALF;
+    else if (decodeDiv == 4) *options = JPEG_SCALE_QUARTER;
+    else if (decodeDiv == 8) *options = JPEG_SCALE_EIGHTH;
+    return decodeDiv;
+}
+
+// Drop the parts of a whole frame just decoded into the PENDING buffer that
+// its source's transform leaves off the panel, so the frame is stored, cached
+// and scaled at the size it is shown. Does nothing when the decode already
+// kept only that part (or stored the frame scaled). Caller holds
+// imageBufferMutex.
+static void cropPendingToView() {
+    const FrameLayout& l = pendingImageLayout;
+    if (pendingImageWidth < l.frameW || pendingImageHeight < l.frameH ||
+        l.prescaleX != 1.0f || l.prescaleY != 1.0f) {
+        return;
+    }
+    RenderRect crop;
+    if (!downloadVisibleCrop(pendingImageWidth, pendingImageHeight, pendingImageLayout.reduction, &crop)) return;
+    renderCropInPlace(pendingFullImageBuffer, pendingImageWidth, crop);
+    pendingImageLayout.cropX = crop.x;
+    pendingImageLayout.cropY = crop.y;
+    pendingImageWidth = crop.w;
+    pendingImageHeight = crop.h;
+}
+
+#if STRIP_PIPELINE
+// Route the JPEGDEC decode about to run through the strip pipeline: `crop` of
+// the frameW x frameH frame (as decoded) arrives in JPEGDraw at `window` and
+// is stored at the scale it is drawn (never above its own resolution), via
+// the PPA when that fits. Fills in the pending size and pendingImageLayout.
+static bool stripDecodeBegin(int frameW, int frameH, const RenderRect& crop, const RenderRect& window) {
+    if (window.w > MAX_IMAGE_DIMENSION) return false;
+    FrameLayout& l = pendingImageLayout;
+    float sx, sy, rotation;
+    int ox, oy;
+    downloadTransform(&sx, &sy, &rotation, &ox, &oy);
+    float px = fminf(sx * l.reduction, 1.0f);
+    float py = fminf(sy * l.reduction, 1.0f);
+    int outW = max(1, (int)(crop.w * px));
+    int outH = max(1, (int)(crop.h * py));
+    const char* via = "copy";
+
+    if (px == 1.0f && py == 1.0f) {
+        outW = crop.w;
+        outH = crop.h;
+        if ((size_t)outW * outH * 2 > fullImageBufferSize) return false;
+        stripCopySink.begin(outW, pendingFullImageBuffer, outH);
+        stripSink = &stripCopySink;
+    } else {
+        // The PPA scales in 1/16 steps: round up, and use it if that still fits
+        float qx = stripQuantizeScale(px), qy = stripQuantizeScale(py);
+        int qw = (int)(crop.w * qx), qh = (int)(crop.h * qy);
+        if (qw > 0 && qh > 0 && (size_t)qw * qh * 2 <= fullImageBufferSize &&
+            stripPpaSink.begin(pendingFullImageBuffer, fullImageBufferSize, crop.w, qw, qh, qx, qy)) {
+            px = qx;
+            py = qy;
+            outW = qw;
+            outH = qh;
+            stripSink = &stripPpaSink;
+            via = "PPA";
+        } else {
+            if ((size_t)outW * outH * 2 > fullImageBufferSize) return false;
+            // Below half size average the area (every source row counts)
+            // rather than sample two rows per output row
+            if (px < 0.5f && py < 0.5f &&
+                stripBoxScaler.begin(crop.w, crop.h, outW, outH, pendingFullImageBuffer)) {
+                stripSink = &stripBoxScaler;
+                via = "software box";
+            } else {
+                stripScaler.begin(crop.w, crop.h, outW, outH, pendingFullImageBuffer, stripCarryRow);
+                stripSink = &stripScaler;
+                via = "software";
+            }
+        }
+    }
+    if (!stripAssembler.begin(window, stripRing, STRIP_RING_SLOTS, stripSink)) return false;
+
+    l.prescaleX = px;
+    l.prescaleY = py;
+    l.frameW = (int16_t)(frameW * px);
+    l.frameH = (int16_t)(frameH * py);
+    l.cropX = (int16_t)(crop.x * px);
+    l.cropY = (int16_t)(crop.y * py);
+    pendingImageWidth = outW;
+    pendingImageHeight = outH;
+    stripDecodeActive = true;
+    Serial.printf("[Image] Strip pipeline: %dx%d -> %dx%d (%s)\n", crop.w, crop.h, outW, outH, via);
+    return true;
+}
+#endif
+
+// Last JPEGDEC decode wrote straight into the pending buffer
+static bool jpegdecDirect = false;
+
+// Point the JPEGDEC decode about to run (between open and decode) at the
+// PENDING buffer: the whole frame, or only the part the download source's
+// transform shows - and with STRIP_PIPELINE already scaled to the size it is
+// drawn. Sets the pending size and pendingImageLayout; false when the result
+// can't fit the buffer. Caller holds imageBufferMutex and closes the decoder
+// after jpegdecFinishTarget().
+static bool jpegdecPrepareTarget(int srcW, int srcH, int decodeDiv, int fitDiv) {
+    int frameW = srcW / decodeDiv;
+    int frameH = srcH / decodeDiv;
+    pendingImageLayout = { (int16_t)frameW, (int16_t)frameH, 0, 0, (uint8_t)(decodeDiv / fitDiv), 1.0f, 1.0f,
+                           beginPixelStage() };
+    jpegdecDirect = false;
+
+    RenderRect whole = { 0, 0, frameW, frameH };
+    RenderRect crop = whole;
+    if (!downloadVisibleCrop(frameW, frameH, pendingImageLayout.reduction, &crop)) crop = whole;
+    RenderRect window = crop;   // where crop arrives in JPEGDraw
+    if (crop.w < frameW || crop.h < frameH) {
+        if (decodeDiv == 1) {
+            // JPEGDEC crops on the unscaled MCU grid only: MCUs outside the
+            // crop area are entropy-decoded (the bitstream has to be walked)
+            // but skip the IDCT, colour conversion and the copy, and the
+            // rest arrives relative to the crop
+            jpeg.setCropArea(crop.x, crop.y, crop.w, crop.h);
+            jpeg.getCropArea(&crop.x, &crop.y, &crop.w, &crop.h);   // as JPEGDEC adjusted it
+            window = { 0, 0, crop.w, crop.h };
+            Serial.printf("[Image] Decoding only the visible %dx%d at %d,%d of %dx%d\n", crop.w, crop.h,
+                          crop.x, crop.y, frameW, frameH);
+        } else if (!STRIP_PIPELINE) {
+            // Reduced frames are decoded whole and cropped afterwards
+            // (cropPendingToView); the strip assembler drops the rest itself
+            crop = window = whole;
+        }
+    }
+
+#if STRIP_PIPELINE
+    return stripDecodeBegin(frameW, frameH, crop, window);
+#else
+    pendingImageLayout.cropX = crop.x;
+    pendingImageLayout.cropY = crop.y;
+    pendingImageWidth = crop.w;
+    pendingImageHeight = crop.h;
+    if ((size_t)crop.w * crop.h * 2 > fullImageBufferSize) return false;
+
+    // Whole frame at an MCU-aligned width: let JPEGDEC write into the buffer
+    // itself, no per-row copy in JPEGDraw
+    int subsample = jpeg.getSubSample();
+    int mcuW = (subsample >> 4) == 2 ? 16 : 8;
+    int mcuH = (subsample & 0x0F) == 2 ? 16 : 8;
+    jpegdecDirect = JPEG_DIRECT_DECODE && crop.w == frameW && crop.h == frameH &&
+                    jpegDirectDecodeFits(frameW, frameH, mcuW, mcuH, decodeDiv, fullImageBufferSize);
+    if (jpegdecDirect) jpeg.setFramebuffer(pendingFullImageBuffer);
+    return true;
+#endif
+}
+
+// Decode throughput (decoded RGB565 bytes per second of decoding, network
+// waits excluded) and whether it went straight into the buffer
+static void logJpegdecThroughput(unsigned long decodeUs, int width, int height) {
+    if (decodeUs == 0) return;
+    float mbps = (float)width * height * 2 / decodeUs;   // bytes per us = MB/s
+    Serial.printf("[Image] JPEGDEC output %.1f MB/s (%dx%d in %lu ms, %s)\n", mbps, width, height,
+                  decodeUs / 1000, STRIP_PIPELINE ? "strips" : jpegdecDirect ? "direct" : "copied");
+}
+
+// After the JPEGDEC decode: let the strip pipeline drain (always, even after a
+// failed decode - the PPA may still be reading strips). Returns whether the
+// frame in the pending buffer is complete.
+static bool jpegdecFinishTarget(bool decoded) {
+#if STRIP_PIPELINE
+    if (!stripDecodeActive) return decoded;
+    stripDecodeActive = false;
+    bool ok = stripAssembler.finish() && decoded;
+    pendingImageHeight = stripSink->rowsWritten();   // PPA strips round their rows down
+    return ok && pendingImageHeight > 0;
+#else
+    if (jpegdecDirect) {
+        jpeg.setFramebuffer(nullptr);   // the QR decode shares the decoder
+        // Blocks JPEGDEC wrote without calling JPEGDraw still need the stage
+        if (decoded && !decodeStageInDraw) {
+            ImageUtils::applyPixelStage(decodeStage, pendingFullImageBuffer, pendingFullImageBuffer,
+                                        pendingImageWidth, pendingImageHeight);
+        }
+    }
+    return decoded;
+#endif
+}
+
+// Validators from the current response; only committed once the body decodes,
+// so a 304 can never vouch for a frame that failed to reach the screen.
+static String responseEtag;
+static String responseLastModified;
+// Content hash of the body being decoded (FNV-1a, accumulated as it arrives)
+static uint64_t responseBodyHash = CONTENT_HASH_INIT;
+static size_t responseBodyLength = 0;
+// How long the decoded frame may be served from the frame cache, counted
+// from when the response arrived
+static uint32_t responseTtlMs = 0;
+static uint32_t responseFetchedAt = 0;
+
+// What imageBuffer holds: the complete body of this source / URL, or nothing
+// (length 0). Lets a zoom-in re-decode the frame on screen without a download.
+static int retainedBodySource = -1;
+static String retainedBodyURL;
+static size_t retainedBodyLength = 0;
+
+// Freshness lifetime for a frame: the update interval, shortened by a smaller
+// Cache-Control max-age, but never below FRAME_CACHE_MIN_TTL. no-cache /
+// max-age=0 are ignored - refresh timing is governed by the update interval.
+static uint32_t frameTtlFromResponse(const String& cacheControl) {
+    uint32_t ttl = currentUpdateInterval;
+    long maxAge = cacheControlMaxAge(cacheControl.c_str());
+    if (maxAge > 0 && (uint32_t)maxAge * 1000UL < ttl) ttl = (uint32_t)maxAge * 1000UL;
+    if (ttl < FRAME_CACHE_MIN_TTL) ttl = FRAME_CACHE_MIN_TTL;
+    return ttl;
+}
+
+// For a prefetch: whether the frame cache already held a frame of the source
+// when the request went out (sampled once; the decode paths hold the mutex)
+static bool prefetchFrameCached = false;
+
+// Whether the frame this download would replace came from the same source:
+// the frame on screen for a normal download, a cached frame for a prefetch.
+static bool downloadSourceFrameHeld() {
+    // A frame that doesn't cover the current zoom / pan doesn't count: it must be replaced
+    if (!downloadIsPrefetch) return displayedSourceIndex == downloadSourceIndex && !displayedFrameNeedsRedecode();
+    return prefetchFrameCached;
+}
+
+// A freshly received body that is byte-identical to the frame already held
+// for the same source needs no decode, swap or render.
+static bool bodyUnchangedOnScreen(uint64_t bodyHash, size_t bodyLength) {
+    return conditionalFetch.isUnchangedBody(downloadSourceIndex, downloadSourceURL, bodyHash, bodyLength) &&
+           downloadSourceFrameHeld();
+}
+
+// A 304 or identical body confirmed the held frame is current: restart its
+// freshness lifetime (displayed frame, or the cached one for a prefetch).
+static void markSourceFrameCurrent() {
+    uint32_t now = millis();
+    if (!downloadIsPrefetch) {
+        displayedFetchedAt = now;
+        return;
+    }
+    if (xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
+        frameSlots.refreshSource(downloadSourceIndex, now);
+        xSemaphoreGive(imageBufferMutex);
+    }
+}
+
+// Hand a freshly decoded pending frame on. A normal download flags it for the
+// swap in loop(); a prefetch trades the pending buffer into the frame cache so
+// the frame waits there until its source comes up in the cycle. Caller holds
+// imageBufferMutex.
+static void publishPendingFrame() {
+    if (!downloadIsPrefetch) {
+        // Set before the flag, under the mutex, so the swap never sees a
+        // ready frame without its source
+        pendingSourceIndex = downloadSourceIndex;
+        pendingSourceURL = downloadSourceURL;
+        pendingFetchedAt = responseFetchedAt;
+        pendingTtlMs = responseTtlMs;
+        imageReadyToDisplay = true;
+        return;
+    }
+    // Prefetch is only scheduled when slots exist
+    frameSlots.store(downloadSourceIndex, downloadSourceURL, responseFetchedAt, responseTtlMs,
+                     pendingFullImageBuffer, pendingImageWidth, pendingImageHeight, pendingImageLayout);
+}
+
+// Shared success bookkeeping once a decoded frame sits in the pending buffer
+// (or, for a prefetch, in a frame slot). Called after imageBufferMutex has
+// been released.
+static void announcePendingImageReady() {
+    conditionalFetch.onFullResponse(downloadSourceIndex, downloadSourceURL, responseEtag, responseLastModified,
+                                    responseBodyHash, responseBodyLength);
+    if (downloadIsPrefetch) {
+        Serial.printf("[Prefetch] Image %d/%d decoded into the frame cache - %s\n",
+                      downloadSourceIndex + 1, imageSourceCount, downloadSourceURL.c_str());
+        return;
+    }
+
+    if (cyclingEnabled && imageSourceCount > 1) {
+        Serial.printf("[Image] Image %d/%d ready to display - %s\n", downloadSourceIndex + 1, imageSourceCount, downloadSourceURL.c_str());
+        debugPrintf(COLOR_GREEN, "Image %d/%d ready", downloadSourceIndex + 1, imageSourceCount);
+    } else {
+        Serial.printf("[Image] Image ready to display - %s\n", downloadSourceURL.c_str());
+        debugPrintf(COLOR_GREEN, "Image ready");
+    }
+    Serial.println("Image fully decoded and ready for display");
+
+    // Mark first image as loaded (only once) - happens before actual display
+    if (!firstImageLoaded) {
+        firstImageLoaded = true;
+        displayManager.setFirstImageLoaded(true);
+        Serial.println("First image loaded successfully - switching to image mode");
+        debugPrint("DEBUG: First image loaded flag set", COLOR_GREEN);
+    } else {
+        Serial.println("Image prepared successfully - ready for seamless display");
+    }
+}
+
+// JPEGDEC as an ImageDecoder backend: the software catch-all at the end of the
+// chain. Handles progressive/grayscale streams and the 1/4, 1/8 decode-time
+// downscales the hardware codec can't do. Writes through JPEGDraw(), so the
+// destination is always pendingFullImageBuffer.
+class JpegdecDecoder : public ImageDecoder {
+public:
+    const char* name() const override { return "jpegdec"; }
+
+    DecodeStatus decode(const DecodeRequest& req, DecodeResult* result) override {
+        unsigned long t0 = micros();
+        if (req.dst != pendingFullImageBuffer) return DECODE_UNSUPPORTED;
+        if (!jpeg.openRAM((uint8_t*)req.data, (int)req.length, JPEGDraw)) {
+            Serial.printf("[Image] JPEGDEC open failed (error %d)\n", jpeg.getLastError());
+            return DECODE_FAILED;
+        }
+        result->srcWidth = jpeg.getWidth();
+        result->srcHeight = jpeg.getHeight();
+        int decodeOptions = 0;
+        int decodeDiv = chooseJpegDecodeDivisor(result->srcWidth, result->srcHeight, req.reduceDiv, &decodeOptions);
+        if (decodeDiv > 1) {
+            Serial.printf("[Image] Downscaling %dx%d by 1/%d (%s)\n", result->srcWidth, result->srcHeight,
+                          decodeDiv, req.reduceDiv > 1 ? "drawn smaller" : "to fit buffer");
+        }
+        if (!jpegdecPrepareTarget(result->srcWidth, result->srcHeight, decodeDiv,
+                                  jpegFitDivisor(result->srcWidth, result->srcHeight))) {
+            jpeg.close();
+            return DECODE_UNSUPPORTED;
+        }
+        result->parseUs = micros() - t0;
+
+        t0 = micros();
+        int decoded = jpeg.decode(0, 0, decodeOptions);
+        bool ok = jpegdecFinishTarget(decoded != 0);
+        result->decodeUs = micros() - t0;
+        jpeg.close();
+        if (!ok) return DECODE_FAILED;
+        logJpegdecThroughput(result->decodeUs, pendingImageWidth, pendingImageHeight);
+
+        // The layout is set here, not from these fields (see decodeRetainedBody)
+        result->width = pendingImageWidth;
+        result->height = pendingImageHeight;
+        result->frameWidth = pendingImageLayout.frameW;
+        result->frameHeight = pendingImageLayout.frameH;
+        result->cropX = pendingImageLayout.cropX;
+        result->cropY = pendingImageLayout.cropY;
+        result->scaleDiv = decodeDiv;
+        return DECODE_OK;
+    }
+};
+
+static JpegdecDecoder jpegdecDecoder;
+DecoderChain imageDecoders;   // populated in setup(): hardware codec, then JPEGDEC
+
+#if JPEG_STREAM_DECODE
+// =============================================================================
+// STREAMING JPEG DECODE
+// =============================================================================
+// JPEGDEC pulls the body through these callbacks while it decodes, so MCU rows
+// reach the pending buffer as the bytes arrive instead of after the whole
+// download. JpegStreamReader (jpeg_stream.cpp) handles timeouts and keeps a
+// copy of every byte in imageBuffer for the in-RAM fallback.
+
+class WiFiByteSource : public ByteSource {
+public:
+    explicit WiFiByteSource(WiFiClient* c) : client(c) {}
+    int available() override { return client->available(); }
+    int read(uint8_t* buf, size_t len) override { return client->read(buf, len); }
+    bool connected() override { return client->connected(); }
+private:
+    WiFiClient* client;
+};
+
+static uint32_t streamNowMs() { return millis(); }
+
+static void streamIdle() {
+    systemMonitor.forceResetWatchdog();
+    delay(5);
+}
+
+static int32_t jpegStreamRead(JPEGFILE* pFile, uint8_t* pBuf, int32_t iLen) {
+    JpegStreamReader* reader = (JpegStreamReader*)pFile->fHandle;
+    int32_t n = reader->read(pBuf, iLen);
+    pFile->iPos = reader->position();
+    systemMonitor.forceResetWatchdog();
+    return n;
+}
+
+static int32_t jpegStreamSeek(JPEGFILE* pFile, int32_t iPosition) {
+    JpegStreamReader* reader = (JpegStreamReader*)pFile->fHandle;
+    int32_t p = reader->seek(iPosition);
+    if (p >= 0) pFile->iPos = p;
+    return p;
+}
+
+static void jpegStreamClose(void* pHandle) {
+    (void)pHandle;  // reader lives on the caller's stack; HTTPClient owns the socket
+}
+
+enum StreamDecodeResult {
+    STREAM_DECODE_OK,        // frame decoded into the pending buffer
+    STREAM_DECODE_UNCHANGED, // decoded, but identical to the frame on screen - no swap
+    STREAM_DECODE_USE_RAM,   // body fully buffered in imageBuffer - decode it in RAM
+    STREAM_DECODE_FAILED     // gave up part-way; retry with the buffered path
+};
+
+// Sources whose streaming decode failed part-way. Their next download goes
+// through the buffered (download-then-decode) path once, then streaming is
+// tried again.
+static uint32_t streamDecodeFallbackMask = 0;
+
+static StreamDecodeResult streamDecodeJpeg(WiFiClient* stream, int contentLength,
+                                           size_t* bytesReceived, uint64_t* bodyHash) {
+    WiFiByteSource source(stream);
+    JpegStreamReader reader(&source, contentLength, imageBuffer, imageBufferSize,
+                            streamNowMs, streamIdle);
+    reader.setTimeouts(DOWNLOAD_NO_DATA_TIMEOUT, TOTAL_DOWNLOAD_TIMEOUT);
+
+    Serial.printf("[Image] Streaming decode: %d bytes from socket\n", contentLength);
+    if (!firstImageLoaded) {
+        debugPrint("Downloading Image...", COLOR_YELLOW);
+    }
+
+    StreamDecodeResult result = STREAM_DECODE_FAILED;
+
+    if (!jpeg.open(&reader, contentLength, jpegStreamClose, jpegStreamRead, jpegStreamSeek, JPEGDraw)) {
+        // Not a decodable baseline JPEG header. Let the buffered path run its
+        // PNG / header diagnostics on the full body.
+        Serial.printf("[Image] ⚠ Streaming open failed (JPEGDEC error %d, stream: %s)\n",
+                      jpeg.getLastError(), JpegStreamReader::errorName(reader.error()));
+        if (reader.drainToTee()) result = STREAM_DECODE_USE_RAM;
+        *bytesReceived = reader.received();
+        *bodyHash = reader.contentHash();
+        return result;
+    }
+
+    int srcW = jpeg.getWidth();
+    int srcH = jpeg.getHeight();
+    int decodeOptions = 0;
+    int fitDiv = jpegFitDivisor(srcW, srcH);
+    int reduceDiv = downloadDecodeReduction(fitDiv);
+    int decodeDiv = chooseJpegDecodeDivisor(srcW, srcH, reduceDiv, &decodeOptions);
+    Serial.printf("[Image] ✓ JPEG header: %dx%d after %d bytes (%lu ms)\n",
+                  srcW, srcH, (int)reader.received(), (unsigned long)reader.elapsedMs());
+    if (decodeDiv > 1) {
+        Serial.printf("[Image] Downscaling %dx%d by 1/%d (%s)\n", srcW, srcH, decodeDiv,
+                      reduceDiv > 1 ? "drawn smaller" : "to fit buffer");
+    }
+
+    if (xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(5000)) != pdTRUE) {
+        Serial.println("ERROR: Failed to acquire image buffer mutex for decode");
+        jpeg.close();
+        *bytesReceived = reader.received();
+        *bodyHash = reader.contentHash();
+        return STREAM_DECODE_FAILED;
+    }
+
+    if (!jpegdecPrepareTarget(srcW, srcH, decodeDiv, fitDiv)) {
+        Serial.printf("[Image] ✗ Image exceeds buffer capacity! Required: %d, Available: %d\n",
+                      (int)((size_t)pendingImageWidth * pendingImageHeight * 2), (int)fullImageBufferSize);
+        xSemaphoreGive(imageBufferMutex);
+        jpeg.close();
+        *bytesReceived = reader.received();
+        *bodyHash = reader.contentHash();
+        return STREAM_DECODE_FAILED;
+    }
+
+    // The decode is paced by the socket, so it can last as long as the
+    // transfer. Release the mutex for it: only this task writes the pending
+    // buffer, and the swap in loop() holds off while the flag is set, so the
+    // frame cache and UI are not blocked on the network.
+    pendingFrameDecoding = true;
+    xSemaphoreGive(imageBufferMutex);
+
+    Serial.println("[Image] Decoding JPEG to RGB565 while downloading...");
+    unsigned long decodeStart = micros();
+    uint32_t stallBefore = reader.stallMs();
+    int decoded = jpegdecFinishTarget(jpeg.decode(0, 0, decodeOptions) != 0) ? 1 : 0;
+    unsigned long decodeUs = micros() - decodeStart;
+    uint32_t waitUs = (reader.stallMs() - stallBefore) * 1000;
+    jpeg.close();
+    if (decoded) logJpegdecThroughput(decodeUs > waitUs ? decodeUs - waitUs : 0, pendingImageWidth, pendingImageHeight);
+
+    bool locked = xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(5000)) == pdTRUE;
+    pendingFrameDecoding = false;
+    if (!locked) {
+        Serial.println("ERROR: Failed to acquire image buffer mutex to publish the streamed frame");
+        *bytesReceived = reader.received();
+        *bodyHash = reader.contentHash();
+        return STREAM_DECODE_FAILED;
+    }
+
+    // JPEGDEC keeps going on short reads, so a stalled or truncated socket can
+    // still report success. Only trust the frame if the stream stayed healthy.
+    bool streamOk = (reader.error() == STREAM_OK);
+    if (decoded && streamOk) {
+        if (decodeDiv > 1) cropPendingToView();
+        // Decode overlaps the transfer, so it can't be skipped here - but the
+        // swap and render can when the bytes match what's already on screen.
+        if (bodyUnchangedOnScreen(reader.contentHash(), reader.received())) {
+            result = STREAM_DECODE_UNCHANGED;
+        } else {
+            publishPendingFrame();
+            result = STREAM_DECODE_OK;
+        }
+        imageDownloadFailed = false;
+    }
+    xSemaphoreGive(imageBufferMutex);
+
+    uint32_t totalMs = reader.elapsedMs();
+    float kbps = totalMs > 0 ? (reader.received() * 1000.0f) / totalMs / 1024.0f : 0;
+    if (result == STREAM_DECODE_OK || result == STREAM_DECODE_UNCHANGED) {
+        Serial.printf("[Image] ✓ Streamed decode complete: %d bytes, %dx%d in %lu ms (%.1f KB/s, %lu ms waiting on network)\n",
+                      (int)reader.received(), pendingImageWidth, pendingImageHeight,
+                      (unsigned long)totalMs, kbps, (unsigned long)reader.stallMs());
+    } else {
+        Serial.printf("[Image] ✗ Streamed decode failed after %lu ms (decode=%d, stream: %s, %d bytes)\n",
+                      (unsigned long)totalMs, decoded, JpegStreamReader::errorName(reader.error()),
+                      (int)reader.received());
+        // A decoder-side failure with a healthy socket can still be retried
+        // from RAM if the whole body fits the download buffer.
+        if (streamOk && reader.drainToTee()) result = STREAM_DECODE_USE_RAM;
+    }
+    *bytesReceived = reader.received();
+    *bodyHash = reader.contentHash();
+    return result;
+}
+#endif // JPEG_STREAM_DECODE
+
+// imageBuffer now holds the complete body of the download source
+static void retainBody(size_t length) {
+    retainedBodySource = downloadSourceIndex;
+    retainedBodyURL = downloadSourceURL;
+    retainedBodyLength = length;
+}
+
+// Decode the JPEG body in imageBuffer into the pending buffer - reduced as far
+// as the download source's transform allows - and hand the frame on with
+// publishPendingFrame(). Serves downloads and zoom-in re-decodes alike.
+static DecodeStatus decodeRetainedBody(size_t length, DecodeResult* res, ImageDecoder** used) {
+    // Decoders that can shrink while decoding (JPEGDEC) skip the pixels the
+    // renderer would throw away
+    int reduceDiv = 1;
+    JpegHeaderInfo hdr;
+    if (jpegParseHeader(imageBuffer, length, &hdr)) {
+        reduceDiv = downloadDecodeReduction(jpegFitDivisor(hdr.width, hdr.height));
+    }
+
+    // Take mutex to protect pendingFullImageBuffer during decode
+    if (xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(5000)) != pdTRUE) {
+        Serial.println("ERROR: Failed to acquire image buffer mutex for decode");
+        *used = nullptr;
+        return DECODE_FAILED;
+    }
+    systemMonitor.forceResetWatchdog();
+
+    // Hardware codec first, JPEGDEC for anything it declines or fails on
+    DecodeRequest decodeReq = { imageBuffer, length, pendingFullImageBuffer,
+                                fullImageBufferSize, MAX_IMAGE_DIMENSION, reduceDiv };
+    DecodeStatus status = imageDecoders.decode(decodeReq, res, used);
+    if (status == DECODE_OK) {
+        bool unstaged = res->frameWidth == 0;
+        if (unstaged) {
+            // The backend left the layout to us (hardware codec): whole frame
+            int fitDiv = jpegFitDivisor(res->srcWidth, res->srcHeight);
+            pendingImageWidth = res->width;
+            pendingImageHeight = res->height;
+            pendingImageLayout = { (int16_t)res->width, (int16_t)res->height, 0, 0,
+                                   (uint8_t)(res->scaleDiv > fitDiv ? res->scaleDiv / fitDiv : 1), 1.0f, 1.0f,
+                                   beginPixelStage() };
+        }
+        // Keep only the part on screen when the decoder couldn't skip the rest
+        cropPendingToView();
+        // Its output never went through JPEGDraw: run the pixel stage over
+        // what was kept
+        if (unstaged) {
+            ImageUtils::applyPixelStage(decodeStage, pendingFullImageBuffer, pendingFullImageBuffer,
+                                        pendingImageWidth, pendingImageHeight);
+        }
+        res->frameWidth = pendingImageLayout.frameW;
+        res->frameHeight = pendingImageLayout.frameH;
+        res->cropX = pendingImageLayout.cropX;
+        res->cropY = pendingImageLayout.cropY;
+        res->width = pendingImageWidth;
+        res->height = pendingImageHeight;
+        // Mark image as ready to display (but don't display yet - let loop handle it)
+        publishPendingFrame();
+    }
+    xSemaphoreGive(imageBufferMutex);
+    return status;
+}
+
+static void logDecodedFrame(unsigned long decodeTime, const DecodeResult& res, ImageDecoder* used) {
+    Serial.printf("[Image] ✓ Decode complete in %lu ms via %s: %dx%d", decodeTime,
+                  used->name(), res.width, res.height);
+    if (res.frameWidth > 0 && (res.width < res.frameWidth || res.height < res.frameHeight)) {
+        Serial.printf(" visible at %d,%d of %dx%d", res.cropX, res.cropY, res.frameWidth, res.frameHeight);
+    }
+    if (res.scaleDiv > 1) {
+        Serial.printf(" (1/%d of %dx%d)", res.scaleDiv, res.srcWidth, res.srcHeight);
+    }
+    Serial.println();
+}
+
+// Open a new pooled connection, timing TCP connect + TLS handshake separately
+// from the request that follows.
+static bool connectPooledClient(PooledHttpClient* pooled, HttpLeaseGuard& fetchLease) {
+    systemMonitor.forceResetWatchdog();
+    unsigned long connectStart = millis();
+    bool ok = pooled->connect(HTTP_CONNECT_TIMEOUT);
+    fetchLease.timing.connectMs = millis() - connectStart;
+    systemMonitor.forceResetWatchdog();
+    if (!ok) {
+        debugPrintf(COLOR_RED, "ERROR: Connection to %s failed after %lu ms",
+                    pooled->host(), (unsigned long)fetchLease.timing.connectMs);
+    }
+    return ok;
+}
+
+// Download and decode one image source into the pending buffer. A normal
+// download hands the frame to loop() for the swap; a prefetch (the next
+// cycling source, fetched while the current one is on screen) parks it in a
+// spare frame slot instead - see publishPendingFrame().
+static void downloadImageSource(int sourceIndex, bool prefetch) {
     // Check if already processing an image (mutex protection)
     if (imageProcessing) {
         Serial.println("WARNING: Image processing already in progress - skipping concurrent call");
@@ -1341,17 +2309,29 @@ void downloadAndDisplayImage() {
     // and the TCP probe to 8.8.8.8:53 was useless on isolated LANs.
     Serial.println("DEBUG: WiFi connection check passed");
 
-    // Get current image URL based on cycling configuration
-    String imageURL = getCurrentImageURL();
-    currentImageURL = imageURL;  // keep the shared copy in sync (used by render + logs)
+    // Resolve the source's URL; only a normal download updates the shared
+    // currentImageURL (used by render + logs) - a prefetch must not disturb it.
+    String imageURL = getImageSourceURL(sourceIndex);
+    downloadSourceIndex = sourceIndex;
+    downloadSourceURL = imageURL;
+    downloadIsPrefetch = prefetch;
+    if (!prefetch) {
+        currentImageURL = imageURL;
+    }
 
     // Assume failure until an image is successfully prepared; the scheduler uses
     // this to decide whether to retry sooner than the normal update interval.
     imageDownloadFailed = true;
 
     if (imageURL.startsWith("moon://")) {
+        if (prefetch) {
+            // Computed frames are rendered on demand; nothing to fetch ahead
+            imageProcessing = false;
+            return;
+        }
         Serial.println("[Moon] Rendering computed moon image");
         renderMoonToPendingBuffer();
+        pendingSourceIndex = -1;  // computed frame: nothing to revalidate over HTTP
         imageDownloadFailed = !imageReadyToDisplay;  // success iff a frame is ready
         // This path returns before the shared "first image loaded" bookkeeping
         // below. When the moon is the only enabled source, that flag would never
@@ -1379,7 +2359,21 @@ void downloadAndDisplayImage() {
     Serial.printf("[Image] Buffer size: %d bytes\n", imageBufferSize);
     Serial.printf("[Image] Free heap: %d bytes, Free PSRAM: %d bytes\n", ESP.getFreeHeap(), ESP.getFreePsram());
     
-    HTTPClient http;
+    // Use this host's kept-alive connection when the pool has one (or room
+    // for one); otherwise a one-shot client that closes after the fetch. The
+    // guard hands the connection back to the pool on every return below.
+    HttpLeaseGuard fetchLease;
+    HTTPClient oneShotHttp;
+    PooledHttpClient* pooled = fetchLease.acquire(imageURL);
+    HTTPClient& http = pooled ? pooled->http : oneShotHttp;
+    if (pooled) {
+        Serial.printf("[Image] %s connection to %s\n",
+                      fetchLease.lease.reused ? "Reusing kept-alive" : "Opening pooled", pooled->host());
+        if (!fetchLease.lease.reused && !connectPooledClient(pooled, fetchLease)) {
+            imageProcessing = false;  // Clear mutex before return
+            return;
+        }
+    }
     
     // Reset watchdog before potentially blocking http.begin() call
     systemMonitor.forceResetWatchdog();
@@ -1399,7 +2393,7 @@ void downloadAndDisplayImage() {
     
     // Use a lambda function to wrap the http.begin call
     auto beginOperation = [&]() {
-        beginResult = http.begin(imageURL);
+        beginResult = pooled ? http.begin(pooled->client(), imageURL) : http.begin(imageURL);
         beginCompleted = true;
     };
     
@@ -1435,10 +2429,32 @@ void downloadAndDisplayImage() {
     http.setTimeout(HTTP_REQUEST_TIMEOUT);      // Use config value
     http.setConnectTimeout(HTTP_CONNECT_TIMEOUT); // Use config value
     
+    // HTTPClient writes the Connection header itself: keep-alive when reusing
+    http.setReuse(pooled != nullptr);
+
     // Add User-Agent and other headers for better compatibility
     http.addHeader("User-Agent", "ESP32-AllSky/1.0");
-    http.addHeader("Connection", "close");
     http.addHeader("Cache-Control", "no-cache");
+
+    // Revalidate instead of re-downloading when the frame on screen (or, for a
+    // prefetch, in the frame cache) is from this source and the server gave us
+    // validators last time.
+    prefetchFrameCached = false;
+    if (prefetch && xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
+        prefetchFrameCached = frameSlots.holds(sourceIndex, imageURL);
+        xSemaphoreGive(imageBufferMutex);
+    }
+    String ifNoneMatch, ifModifiedSince;
+    if (conditionalFetch.prepare(downloadSourceIndex, imageURL, downloadSourceFrameHeld(),
+                                 ifNoneMatch, ifModifiedSince)) {
+        if (ifNoneMatch.length() > 0) http.addHeader("If-None-Match", ifNoneMatch);
+        if (ifModifiedSince.length() > 0) http.addHeader("If-Modified-Since", ifModifiedSince);
+        Serial.printf("[Image] Conditional GET (ETag: %s, Last-Modified: %s)\n",
+                      ifNoneMatch.length() ? ifNoneMatch.c_str() : "-",
+                      ifModifiedSince.length() ? ifModifiedSince.c_str() : "-");
+    }
+    const char* validatorHeaders[] = { "ETag", "Last-Modified", "Cache-Control", "Connection" };
+    http.collectHeaders(validatorHeaders, 4);
     
     // Reset watchdog before GET request
     systemMonitor.forceResetWatchdog();
@@ -1454,13 +2470,28 @@ void downloadAndDisplayImage() {
     
     // Start GET request with enhanced error handling
     Serial.println("[Image] Sending HTTP GET request...");
+    bool redirected = false;
     try {
         httpCode = http.GET();
+        if (httpCode < 0 && pooled && fetchLease.lease.reused) {
+            // The server closed the kept-alive connection just as it was
+            // reused; one retry on a fresh connection
+            Serial.printf("[Image] Kept-alive connection lost (%d) - reconnecting\n", httpCode);
+            pooled->stop();
+            fetchLease.lease.reused = false;
+            fetchLease.timing.reused = false;
+            if (connectPooledClient(pooled, fetchLease)) {
+                getRequestStart = millis();
+                httpCode = http.GET();
+            }
+        }
         Serial.printf("[Image] HTTP response code: %d\n", httpCode);
         String finalURL = http.getLocation();
         if (finalURL.length() > 0 && finalURL != imageURL) {
             Serial.printf("[Image] Redirected to: %s\n", finalURL.c_str());
         }
+        // HTTPClient follows a redirect to another host on the same socket
+        redirected = finalURL.length() > 0;
     } catch (...) {
         Serial.println("[Image] ✗ EXCEPTION during HTTP GET!");
         debugPrint("ERROR: Exception during HTTP GET", COLOR_RED);
@@ -1471,6 +2502,11 @@ void downloadAndDisplayImage() {
     }
     
     unsigned long getRequestTime = millis() - getRequestStart;
+    fetchLease.timing.responseMs = getRequestTime;
+    responseFetchedAt = millis();
+    // The connection can carry the next request only if the server keeps it
+    // open, it still points at this host and the body is read to its end
+    bool connectionReusable = pooled && !redirected && !http.header("Connection").equalsIgnoreCase("close");
     
     // Immediate timeout check with config value
     if (getRequestTime >= HTTP_REQUEST_TIMEOUT) {
@@ -1484,6 +2520,26 @@ void downloadAndDisplayImage() {
     // Reset watchdog immediately after GET
     systemMonitor.forceResetWatchdog();
     
+    // 304: the frame on screen is still current - skip download, decode, swap
+    // and render entirely.
+    if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+        fetchLease.keepAlive = connectionReusable;
+        http.end();
+        conditionalFetch.onNotModified(downloadSourceIndex);
+        markSourceFrameCurrent();
+        imageDownloadFailed = false;
+        const ConditionalFetchStats& cs = conditionalFetch.getStats();
+        Serial.printf("[Image] ✓ 304 Not Modified in %lu ms - keeping current frame (hits %u / conditional %u)\n",
+                      getRequestTime, (unsigned)cs.notModified, (unsigned)cs.conditionalRequests);
+        systemMonitor.forceResetWatchdog();
+        imageProcessing = false;  // Clear mutex before return
+        return;
+    }
+
+    responseEtag = http.header("ETag");
+    responseLastModified = http.header("Last-Modified");
+    responseTtlMs = frameTtlFromResponse(http.header("Cache-Control"));
+
     // Enhanced error handling for different HTTP codes
     if (httpCode != HTTP_CODE_OK) {
         Serial.printf("[Image] ✗ HTTP request failed with code: %d\n", httpCode);
@@ -1534,10 +2590,10 @@ void downloadAndDisplayImage() {
 
     Serial.printf("[Image] Content-Length: %d bytes%s\n", contentLength, knownLength ? "" : " (unknown/chunked)");
     if (cyclingEnabled && imageSourceCount > 1) {
-        Serial.printf("[Image] Source: Image %d/%d - %s\n", currentImageIndex + 1, imageSourceCount, currentImageURL.c_str());
-        debugPrintf(COLOR_WHITE, "Image %d/%d: %d bytes", currentImageIndex + 1, imageSourceCount, contentLength);
+        Serial.printf("[Image] Source: Image %d/%d - %s\n", downloadSourceIndex + 1, imageSourceCount, downloadSourceURL.c_str());
+        debugPrintf(COLOR_WHITE, "Image %d/%d: %d bytes", downloadSourceIndex + 1, imageSourceCount, contentLength);
     } else {
-        Serial.printf("[Image] Source: %s\n", currentImageURL.c_str());
+        Serial.printf("[Image] Source: %s\n", downloadSourceURL.c_str());
         debugPrintf(COLOR_WHITE, "Image: %d bytes", contentLength);
     }
 
@@ -1552,9 +2608,67 @@ void downloadAndDisplayImage() {
         return;
     }
 
+    size_t bytesRead = 0;
+    retainedBodyLength = 0;  // imageBuffer is about to be overwritten
+    bool bodyAlreadyRead = false;  // set when the streaming path buffered the whole body
+    responseBodyHash = CONTENT_HASH_INIT;
+    responseBodyLength = 0;
+
+#if JPEG_STREAM_DECODE
+    // Stream straight into the decoder when the size is known up front (JPEGDEC
+    // needs it) and this source's last streaming attempt didn't fail part-way.
+    uint32_t sourceBit = 1u << (downloadSourceIndex & 31);
+    bool useStreaming = knownLength && !(streamDecodeFallbackMask & sourceBit);
+    // The hardware codec needs the whole bitstream but decodes a frame in tens
+    // of ms, well under what JPEGDEC costs even when overlapped with the
+    // transfer. Buffer whenever it is up and the body fits the download buffer.
+    if (useStreaming && jpegHwDecoder.isAvailable() && (size_t)contentLength < imageBufferSize) {
+        useStreaming = false;
+    }
+    if (knownLength && (streamDecodeFallbackMask & sourceBit)) {
+        Serial.println("[Image] Previous streaming decode failed - using buffered download for this retry");
+        streamDecodeFallbackMask &= ~sourceBit;  // stream again next time
+    }
+    if (useStreaming) {
+        unsigned long streamStart = millis();
+        StreamDecodeResult sr = streamDecodeJpeg(stream, contentLength, &bytesRead, &responseBodyHash);
+        responseBodyLength = bytesRead;
+        fetchLease.timing.bodyMs = millis() - streamStart;
+        fetchLease.timing.bytes = bytesRead;
+        fetchLease.keepAlive = connectionReusable && bytesRead == (size_t)contentLength;
+        if (sr != STREAM_DECODE_USE_RAM) {
+            http.end();
+            systemMonitor.forceResetWatchdog();
+            if ((sr == STREAM_DECODE_OK || sr == STREAM_DECODE_UNCHANGED) &&
+                (size_t)contentLength <= imageBufferSize) {
+                retainBody(bytesRead);  // the whole body was teed into imageBuffer
+            }
+            if (sr == STREAM_DECODE_OK) {
+                announcePendingImageReady();
+            } else if (sr == STREAM_DECODE_UNCHANGED) {
+                conditionalFetch.onUnchangedBody(downloadSourceIndex, downloadSourceURL, responseEtag, responseLastModified);
+                markSourceFrameCurrent();
+                Serial.println("[Image] ✓ Body identical to the frame on screen - skipping swap and render");
+            } else {
+                streamDecodeFallbackMask |= sourceBit;
+                debugPrint("ERROR: Streaming decode failed - will retry buffered", COLOR_RED);
+            }
+            Serial.printf("[Image] Download cycle completed for image %d/%d\n", downloadSourceIndex + 1, imageSourceCount);
+            imageProcessing = false;  // Clear mutex before return
+            return;
+        }
+        Serial.printf("[Image] Retrying decode from RAM (%d bytes buffered)\n", bytesRead);
+        bodyAlreadyRead = true;
+    }
+#else
+    const bool useStreaming = false;
+#endif
+
     // Reject only when the server declares a size that will not fit. Unknown-length
-    // streams are capped by the read loop's buffer-overflow guard instead.
-    if (knownLength && (size_t)contentLength >= imageBufferSize) {
+    // streams are capped by the read loop's buffer-overflow guard instead. The
+    // streaming path is not bounded by the download buffer (it only keeps a copy
+    // of what fits), so this applies to the buffered path alone.
+    if (!useStreaming && knownLength && (size_t)contentLength >= imageBufferSize) {
         LOG_ERROR_F("[ImageDownload] Image too large: %d bytes exceeds buffer capacity of %d bytes\n", contentLength, imageBufferSize);
         Serial.printf("[Image] ✗ Image too large! %d bytes exceeds buffer %d bytes\n", contentLength, imageBufferSize);
         debugPrintf(COLOR_RED, "Invalid size: %d bytes", contentLength);
@@ -1574,7 +2688,6 @@ void downloadAndDisplayImage() {
     }
     LOG_DEBUG("Downloading image data...");
     
-    size_t bytesRead = 0;
     uint8_t* buffer = imageBuffer;
     unsigned long readStart = millis();
     
@@ -1590,7 +2703,7 @@ void downloadAndDisplayImage() {
     
     Serial.printf("[Image] Download started at %lu ms uptime\n", downloadStartTime);
     
-    while (http.connected() && bytesRead < size) {
+    while (!bodyAlreadyRead && http.connected() && bytesRead < size) {
         // Ultra-frequent watchdog reset - every 50ms
         if (millis() - lastWatchdogReset > DOWNLOAD_WATCHDOG_INTERVAL) {
             systemMonitor.forceResetWatchdog();
@@ -1657,6 +2770,7 @@ void downloadAndDisplayImage() {
             }
             
             if (read > 0) {
+                responseBodyHash = contentHashUpdate(responseBodyHash, buffer + bytesRead, read);
                 bytesRead += read;
                 lastDataTime = millis();  // Update last data time on successful read
                 
@@ -1695,8 +2809,14 @@ void downloadAndDisplayImage() {
     }
     
     unsigned long readTime = millis() - readStart;
+    if (!bodyAlreadyRead) {
+        fetchLease.timing.bodyMs = readTime;
+        fetchLease.timing.bytes = bytesRead;
+        fetchLease.keepAlive = connectionReusable && knownLength && bytesRead == size;
+    }
     
-    // Close HTTP connection immediately (also cleans up WiFiClient)
+    // Done with the response: a kept-alive connection stays open for the next
+    // fetch from this host, anything else is closed
     http.end();
     
     systemMonitor.forceResetWatchdog();
@@ -1775,173 +2895,117 @@ void downloadAndDisplayImage() {
     }
     
     Serial.println("[Image] ✓ Valid JPEG header (0xFFD8)");
-    
-    Serial.println("[Image] Opening JPEG decoder...");
-    Serial.printf("[Image] JPEG data: %d bytes in RAM\n", bytesRead);
-    Serial.printf("DEBUG: Opening JPEG in RAM (%d bytes)...\n", bytesRead);
-    if (jpeg.openRAM(imageBuffer, bytesRead, JPEGDraw)) {
-        Serial.println("[Image] ✓ JPEG decoder opened");
-        Serial.printf("[Image] Dimensions: %dx%d pixels\n", jpeg.getWidth(), jpeg.getHeight());
-        Serial.printf("DEBUG: JPEG opened successfully - %dx%d\n", jpeg.getWidth(), jpeg.getHeight());
-        // Choose a decode-time downscale (1/1, 1/2, 1/4, 1/8) so oversized
-        // full-disc sources (e.g. GOES-19 1808px, which would need ~6.5MB at
-        // full size) fit the RGB565 image buffer. Normal ~1024px sources keep
-        // full resolution (divisor 1).
-        int srcW = jpeg.getWidth();
-        int srcH = jpeg.getHeight();
-        int decodeDiv = 1;
-        int decodeOptions = 0;
-        while (decodeDiv < 8) {
-            int dw = srcW / decodeDiv, dh = srcH / decodeDiv;
-            if ((size_t)dw * dh * 2 <= fullImageBufferSize && dw <= MAX_IMAGE_DIMENSION && dh <= MAX_IMAGE_DIMENSION) break;
-            decodeDiv *= 2;
-        }
-        if (decodeDiv == 2)      decodeOptions = JPEG_SCALE_HALF;
-        else if (decodeDiv == 4) decodeOptions = JPEG_SCALE_QUARTER;
-        else if (decodeDiv == 8) decodeOptions = JPEG_SCALE_EIGHTH;
-        if (decodeDiv > 1) {
-            Serial.printf("[Image] Downscaling %dx%d by 1/%d to fit buffer\n", srcW, srcH, decodeDiv);
-        }
-        pendingImageWidth = srcW / decodeDiv;
-        pendingImageHeight = srcH / decodeDiv;
-
-        // Check if image fits in our pending buffer
-        size_t requiredSize = pendingImageWidth * pendingImageHeight * 2;
-        Serial.printf("[Image] Buffer check: %d bytes required, %d bytes available\n", requiredSize, fullImageBufferSize);
-        Serial.printf("DEBUG: Image size check - Required: %d bytes, Available: %d bytes\n", requiredSize, fullImageBufferSize);
-        
-        if (requiredSize <= fullImageBufferSize) {
-            Serial.println("DEBUG: Image fits in buffer, proceeding with decode...");
-
-            // Take mutex to protect pendingFullImageBuffer during decode
-            if (xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(5000)) != pdTRUE) {
-                Serial.println("ERROR: Failed to acquire image buffer mutex for decode");
-                jpeg.close();
-                imageProcessing = false;
-                return;
-            }
-
-            // Clear only the bottom MCU band of the PENDING buffer. The JPEG
-            // decoder overwrites every full-MCU row, so a full-buffer clear is
-            // redundant; only the final partial-MCU rows (skipped by the bounds
-            // guard in JPEGDraw when the height isn't MCU-aligned) need zeroing
-            // to avoid leftover pixels from a previous, taller image.
-            {
-                int bandRows = 16;
-                if (bandRows > pendingImageHeight) bandRows = pendingImageHeight;
-                int bandStart = pendingImageHeight - bandRows;
-                memset(pendingFullImageBuffer + (size_t)bandStart * pendingImageWidth, 0,
-                       (size_t)bandRows * pendingImageWidth * sizeof(uint16_t));
-            }
-
-            // Decode the full image into PENDING buffer with watchdog protection
-            systemMonitor.forceResetWatchdog();
-
-            unsigned long decodeStart = millis();
-
-            // JPEG decode with timeout monitoring
-
-            unsigned long decodeStartTime = millis();
-
-            Serial.println("[Image] Decoding JPEG to RGB565...");
-            if (jpeg.decode(0, 0, decodeOptions)) {
-                unsigned long decodeTime = millis() - decodeStart;
-                Serial.printf("[Image] ✓ Decode complete in %lu ms\n", decodeTime);
-                Serial.printf("[Image] Decoded %dx%d pixels (%d bytes RGB565)\n",
-                             pendingImageWidth, pendingImageHeight,
-                             pendingImageWidth * pendingImageHeight * 2);
-
-                // Reset watchdog after decode
-                systemMonitor.forceResetWatchdog();
+    retainBody(bytesRead);
+    
+    // Same bytes as the frame already on screen from this source (sources that
+    // ignore conditional GET, e.g. SOHO/SDO latest.jpg): skip decode, swap and
+    // the PPA/render pass entirely.
+    responseBodyLength = bytesRead;
+    if (bodyUnchangedOnScreen(responseBodyHash, responseBodyLength)) {
+        conditionalFetch.onUnchangedBody(downloadSourceIndex, downloadSourceURL, responseEtag, responseLastModified);
+        markSourceFrameCurrent();
+        imageDownloadFailed = false;
+        Serial.printf("[Image] ✓ Body unchanged (hash %08lx%08lx, %d bytes) - skipping decode and render\n",
+                      (unsigned long)(responseBodyHash >> 32), (unsigned long)responseBodyHash, bytesRead);
+        systemMonitor.forceResetWatchdog();
+        imageProcessing = false;  // Clear mutex before return
+        return;
+    }
 
-                // Mark image as ready to display (but don't display yet - let loop handle it)
-                imageReadyToDisplay = true;
-                imageDownloadFailed = false;  // success: a frame is ready for the swap
+    Serial.println("[Image] Decoding JPEG...");
+    Serial.printf("[Image] JPEG data: %d bytes in RAM\n", bytesRead);
 
-                // Release mutex after marking image ready
-                xSemaphoreGive(imageBufferMutex);
+    DecodeResult decodeRes;
+    ImageDecoder* usedDecoder = nullptr;
+    unsigned long decodeStart = millis();
+    DecodeStatus decodeStatus = decodeRetainedBody(bytesRead, &decodeRes, &usedDecoder);
+    unsigned long decodeTime = millis() - decodeStart;
+    systemMonitor.forceResetWatchdog();
 
-                if (cyclingEnabled && imageSourceCount > 1) {
-                    Serial.printf("[Image] Image %d/%d ready to display - %s\n", currentImageIndex + 1, imageSourceCount, currentImageURL.c_str());
-                    debugPrintf(COLOR_GREEN, "Image %d/%d ready", currentImageIndex + 1, imageSourceCount);
-                } else {
-                    Serial.printf("[Image] Image ready to display - %s\n", currentImageURL.c_str());
-                    debugPrintf(COLOR_GREEN, "Image ready");
-                }
-                Serial.println("Image fully decoded and ready for display");
-
-                // Mark first image as loaded (only once) - happens before actual display
-                if (!firstImageLoaded) {
-                    firstImageLoaded = true;
-                    displayManager.setFirstImageLoaded(true);
-                    Serial.println("First image loaded successfully - switching to image mode");
-                    debugPrint("DEBUG: First image loaded flag set", COLOR_GREEN);
-                } else {
-                    Serial.println("Image prepared successfully - ready for seamless display");
-                }
-            } else {
-                // Release mutex on decode failure
-                xSemaphoreGive(imageBufferMutex);
-
-                unsigned long decodeAttemptTime = millis() - decodeStart;
-                Serial.printf("[Image] ✗ JPEG decode failed after %lu ms\n", decodeAttemptTime);
-                Serial.printf("[Image] Image was: %dx%d pixels, %d bytes\n",
-                             pendingImageWidth, pendingImageHeight, bytesRead);
-                Serial.println("[Image] Possible causes:");
-                Serial.println("  - Corrupted JPEG data");
-                Serial.println("  - Unsupported JPEG format/encoding");
-                Serial.println("  - Progressive JPEG (not supported)");
-                Serial.println("  - Memory allocation failure during decode");
-
-                debugPrint("ERROR: JPEG decode() function failed!", COLOR_RED);
-                Serial.println("ERROR: JPEG decode() function failed!");
-            }
-            
-            jpeg.close();
-            systemMonitor.forceResetWatchdog();
-        } else {
-            // Image too large for buffer
-            Serial.printf("[Image] ✗ Image exceeds buffer capacity!\n");
-            Serial.printf("[Image] Required: %d bytes (%dx%d @ 2 bytes/pixel)\n", 
-                         requiredSize, pendingImageWidth, pendingImageHeight);
-            Serial.printf("[Image] Available: %d bytes (max 512x512 pixels)\n", fullImageBufferSize);
-            Serial.printf("[Image] Overflow: %d bytes\n", requiredSize - fullImageBufferSize);
-            debugPrintf(COLOR_RED, "ERROR: Image too large for buffer! Required: %d, Available: %d", 
-                       requiredSize, fullImageBufferSize);
-            Serial.printf("ERROR: Image too large for buffer! Required: %d bytes, Available: %d bytes\n", 
-                         requiredSize, fullImageBufferSize);
-            jpeg.close();
-        }
+    if (decodeStatus == DECODE_OK) {
+        imageDownloadFailed = false;  // success: a frame is ready for the swap
+        logDecodedFrame(decodeTime, decodeRes, usedDecoder);
+        Serial.printf("[Image] Stages: download %lu ms | parse %.1f ms | decode %.1f ms | post %.1f ms\n",
+                      readTime, decodeRes.parseUs / 1000.0f, decodeRes.decodeUs / 1000.0f,
+                      decodeRes.postUs / 1000.0f);
+        announcePendingImageReady();
     } else {
-        Serial.printf("[Image] ✗ JPEG decoder failed to open image\n");
-        Serial.printf("[Image] Data size: %d bytes\n", bytesRead);
-        Serial.printf("[Image] Header: %02X %02X %02X %02X\n", 
+        Serial.printf("[Image] ✗ JPEG decode failed after %lu ms (last backend: %s, status %d)\n",
+                      decodeTime, usedDecoder ? usedDecoder->name() : "none", (int)decodeStatus);
+        Serial.printf("[Image] Data size: %d bytes, header: %02X %02X %02X %02X\n", bytesRead,
                      imageBuffer[0], imageBuffer[1], imageBuffer[2], imageBuffer[3]);
         Serial.println("[Image] Possible causes:");
-        Serial.println("  - Corrupted download");
-        Serial.println("  - Incomplete file");
-        Serial.println("  - Not a valid JPEG despite header");
-        Serial.println("  - Memory allocation failure");
-        debugPrint("ERROR: JPEG openRAM() failed!", COLOR_RED);
+        Serial.println("  - Corrupted or incomplete download");
+        Serial.println("  - Unsupported JPEG format/encoding");
+        Serial.println("  - Image too large even at 1/8 scale");
+        Serial.println("  - Memory allocation failure during decode");
+        debugPrint("ERROR: JPEG decode failed!", COLOR_RED);
         debugPrintf(COLOR_RED, "Downloaded %d bytes, buffer size: %d", bytesRead, imageBufferSize);
-        Serial.printf("ERROR: JPEG openRAM() failed! Downloaded %d bytes, buffer size: %d\n", bytesRead, imageBufferSize);
-        Serial.printf("First 16 bytes: %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X\n",
-                     imageBuffer[0], imageBuffer[1], imageBuffer[2], imageBuffer[3],
-                     imageBuffer[4], imageBuffer[5], imageBuffer[6], imageBuffer[7],
-                     imageBuffer[8], imageBuffer[9], imageBuffer[10], imageBuffer[11],
-                     imageBuffer[12], imageBuffer[13], imageBuffer[14], imageBuffer[15]);
     }
-    
+
     // Final watchdog reset and cleanup
     systemMonitor.forceResetWatchdog();
     debugPrintf(COLOR_WHITE, "Free heap: %d bytes", systemMonitor.getCurrentFreeHeap());
-    Serial.printf("[Image] Download cycle completed for image %d/%d\n", currentImageIndex + 1, imageSourceCount);
+    Serial.printf("[Image] Download cycle completed for image %d/%d\n", downloadSourceIndex + 1, imageSourceCount);
     debugPrint("Download cycle completed", COLOR_GREEN);
     
     // Clear processing flag (release mutex)
     imageProcessing = false;
 }
 
+void downloadAndDisplayImage() {
+    downloadImageSource(currentImageIndex, false);
+}
+
+// Fetch and decode a cycling source ahead of time into a spare frame slot.
+// Leaves the download-failure state of the displayed source untouched, so a
+// failed prefetch never triggers the fast-retry path.
+static void prefetchImageSource(int sourceIndex) {
+    bool failedBefore = imageDownloadFailed;
+    Serial.printf("[Prefetch] Fetching image %d/%d ahead of the cycle\n", sourceIndex + 1, imageSourceCount);
+    downloadImageSource(sourceIndex, true);
+    imageDownloadFailed = failedBefore;
+}
+
+// The user zoomed in past the resolution the frame on screen was decoded at,
+// panned / zoomed out beyond the part of it that was decoded, or changed the
+// colour / tone settings its pixel stage baked in. Decode it
+// again from the body still in imageBuffer when that belongs to the displayed
+// source; otherwise download it again (a frame that doesn't cover the view
+// doesn't count as held, so no conditional GET or unchanged-body skip stops it).
+static void redecodeDisplayedFrame() {
+    if (imageProcessing || !displayedFrameNeedsRedecode()) return;
+
+    bool retained = retainedBodyLength > 0 && retainedBodySource == currentImageIndex &&
+                    retainedBodyURL == currentImageURL && displayedSourceIndex == currentImageIndex;
+    if (!retained) {
+        Serial.println("[Image] Re-decode: body no longer in RAM - downloading again");
+        downloadImageSource(currentImageIndex, false);
+        return;
+    }
+
+    imageProcessing = true;
+    downloadSourceIndex = currentImageIndex;
+    downloadSourceURL = currentImageURL;
+    downloadIsPrefetch = false;
+    // Same response as the frame on screen: keep its freshness
+    responseFetchedAt = displayedFetchedAt;
+    responseTtlMs = displayedTtlMs;
+
+    DecodeResult res;
+    ImageDecoder* used = nullptr;
+    unsigned long t0 = millis();
+    DecodeStatus status = decodeRetainedBody(retainedBodyLength, &res, &used);
+    if (status == DECODE_OK) {
+        Serial.print("[Image] Re-decoded from RAM: ");
+        logDecodedFrame(millis() - t0, res, used);
+    } else {
+        Serial.printf("[Image] ✗ Re-decode failed (status %d) - keeping the current frame\n", (int)status);
+    }
+    systemMonitor.forceResetWatchdog();
+    imageProcessing = false;
+}
+
 // Load cycling configuration from storage
 void loadCyclingConfiguration() {
     cyclingEnabled = configStorage.getCyclingEnabled();
@@ -2006,17 +3070,12 @@ void updateCurrentImageTransformSettings() {
     }
 }
 
-// Advance to next image in cycling sequence
-void advanceToNextImage() {
-    // Allow manual advancing even if cycling is disabled
-    if (imageSourceCount <= 1) {
-        Serial.println("Cannot advance: only 1 image source configured");
-        return;
-    }
-    
+// Pick the source that follows currentImageIndex in the cycle (random or
+// sequential, skipping disabled sources). Does not change any state.
+static int pickNextImageIndex() {
     int attempts = 0;
     int maxAttempts = imageSourceCount * 2;  // Prevent infinite loop
-    
+
     if (randomOrderEnabled) {
         // Random order: pick a different random enabled image
         int newIndex;
@@ -2028,22 +3087,45 @@ void advanceToNextImage() {
                 break;
             }
         } while ((newIndex == currentImageIndex || !configStorage.isImageEnabled(newIndex)) && imageSourceCount > 1);
-        
-        currentImageIndex = newIndex;
-    } else {
-        // Sequential order: advance to next enabled image
-        int startIndex = currentImageIndex;
-        do {
-            currentImageIndex = (currentImageIndex + 1) % imageSourceCount;
-            attempts++;
-            if (attempts >= maxAttempts) {
-                Serial.println("WARNING: Could not find enabled image after maximum attempts");
-                currentImageIndex = startIndex;  // Revert to original
-                break;
-            }
-        } while (!configStorage.isImageEnabled(currentImageIndex));
+
+        return newIndex;
     }
-    
+
+    // Sequential order: advance to next enabled image
+    int index = currentImageIndex;
+    do {
+        index = (index + 1) % imageSourceCount;
+        attempts++;
+        if (attempts >= maxAttempts) {
+            Serial.println("WARNING: Could not find enabled image after maximum attempts");
+            return currentImageIndex;  // Stay on the original
+        }
+    } while (!configStorage.isImageEnabled(index));
+    return index;
+}
+
+// The source advanceToNextImage() will move to. In random order the choice is
+// made once and remembered, so the prefetched source is the one shown next.
+static int peekNextImageIndex() {
+    if (plannedNextImageIndex < 0 || plannedNextImageIndex >= imageSourceCount ||
+        plannedNextImageIndex == currentImageIndex || !configStorage.isImageEnabled(plannedNextImageIndex)) {
+        plannedNextImageIndex = pickNextImageIndex();
+    }
+    return plannedNextImageIndex;
+}
+
+// Advance to next image in cycling sequence
+void advanceToNextImage() {
+    // Allow manual advancing even if cycling is disabled
+    if (imageSourceCount <= 1) {
+        Serial.println("Cannot advance: only 1 image source configured");
+        return;
+    }
+
+    currentImageIndex = peekNextImageIndex();
+    plannedNextImageIndex = -1;
+    cachedFrameCheckPending = true;
+
     // Save the new index to persistent storage
     configStorage.setCurrentImageIndex(currentImageIndex);
     configStorage.saveConfig();
@@ -2059,8 +3141,13 @@ void advanceToNextImage() {
 
 // Get current image URL based on cycling configuration
 String getCurrentImageURL() {
+    return getImageSourceURL(currentImageIndex);
+}
+
+// URL for a given source index (legacy single image URL when not cycling)
+String getImageSourceURL(int index) {
     if (cyclingEnabled && imageSourceCount > 0) {
-        String url = configStorage.getImageSource(currentImageIndex);
+        String url = configStorage.getImageSource(index);
         if (url.length() > 0) {
             return url;
         }
@@ -2070,6 +3157,64 @@ String getCurrentImageURL() {
     return configStorage.getImageURL();
 }
 
+// =============================================================================
+// DECODED-FRAME CACHE: PREFETCH AND REVISITS
+// =============================================================================
+// While source N is on screen, source N+1 is downloaded and decoded into the
+// frame cache. Frames displaced from the screen go back into the cache while
+// still fresh. When the cycle reaches a source with a fresh cached frame, the
+// slot's buffer is exchanged with fullImageBuffer and rendered at once - no
+// network I/O and no decode.
+
+// Whether the frame on screen is worth caching when something replaces it
+static bool displayedFrameCacheable() {
+    return displayedSourceIndex >= 0 &&
+           (uint32_t)(millis() - displayedFetchedAt) < displayedTtlMs;
+}
+
+// Show the cached frame for currentImageIndex, if there is a fresh one.
+// Returns false (nothing changed) when the normal download path must run.
+static bool showCachedFrame() {
+    if (frameSlots.count() == 0) return false;
+    String url = getCurrentImageURL();
+
+    // Slots are filled by the download task under the same mutex
+    if (xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+        Serial.println("WARNING: Could not acquire mutex for the frame cache, downloading instead");
+        return false;
+    }
+    int slot = frameSlots.lookup(currentImageIndex, url);
+    if (slot < 0) {
+        xSemaphoreGive(imageBufferMutex);
+        return false;
+    }
+    uint32_t fetchedAt = frameSlots.fetchedAt(slot);
+    uint32_t ttlMs = frameSlots.ttl(slot);
+
+    // The cached frame goes on screen; the displaced one takes its slot
+    frameSlots.exchange(slot, fullImageBuffer, fullImageWidth, fullImageHeight, fullImageLayout);
+    if (displayedFrameCacheable() && displayedSourceIndex != currentImageIndex) {
+        frameSlots.commit(slot, displayedSourceIndex, displayedSourceURL, displayedFetchedAt, displayedTtlMs);
+    } else {
+        frameSlots.release(slot);
+    }
+    imageGeneration++;
+    displayedSourceIndex = currentImageIndex;
+    displayedSourceURL = url;
+    displayedFetchedAt = fetchedAt;
+    displayedTtlMs = ttlMs;
+    currentImageURL = url;
+    xSemaphoreGive(imageBufferMutex);
+
+    Serial.printf("[FrameCache] ✓ Showing cached image %d/%d (%dx%d, fetched %lu s ago)\n",
+                  currentImageIndex + 1, imageSourceCount, fullImageWidth, fullImageHeight,
+                  (unsigned long)((millis() - fetchedAt) / 1000));
+    updateCurrentImageTransformSettings();
+    renderFullImage();
+    systemMonitor.forceResetWatchdog();
+    return true;
+}
+
 // =============================================================================
 // ASYNC DOWNLOAD TASK (FreeRTOS Task on Core 0)
 // =============================================================================
@@ -2099,6 +3244,17 @@ void downloadTask(void* params) {
             imageDownloadPending = false;
             
             Serial.println("[DownloadTask] Download complete, flag cleared");
+        } else if (imagePrefetchPending) {
+            esp_task_wdt_reset();
+            prefetchImageSource(prefetchSourceIndex);
+            imagePrefetchPending = false;
+        } else if (frameRedecodePending && !imageReadyToDisplay) {
+            esp_task_wdt_reset();
+            frameRedecodePending = false;
+            redecodeDisplayedFrame();
+        } else {
+            // Don't hold sockets (and TLS buffers) for hosts no longer fetched
+            httpPool.closeIdle(millis());
         }
         
         // Reset watchdog before yielding
@@ -2371,6 +3527,19 @@ void loop() {
             advanceToNextImage();
         }
     }
+
+    // A source switch (cycle, touch, web or serial "next") tries the frame
+    // cache first: a fresh cached frame is swapped in with no network I/O and
+    // refreshed once the update interval has passed since it was fetched.
+    if (cachedFrameCheckPending && !imageReadyToDisplay && !webConfig.isOTAInProgress()) {
+        cachedFrameCheckPending = false;
+        if (showCachedFrame()) {
+            shouldCycle = false;
+            lastUpdate = displayedFetchedAt;
+            imageDownloadFailed = false;
+            downloadRetryCount = 0;
+        }
+    }
     
     // Check if it's time to update the image (either scheduled update or cycling)
     // In API mode, only update on force refresh (lastUpdate = 0) or scheduled refresh interval
@@ -2422,9 +3591,31 @@ void loop() {
         }
     }
     
+    // Prefetch the next cycling source once per cycle, a few seconds into the
+    // current source's display time and only while the download task is idle
+    if (imageUpdateMode == 0 && cyclingEnabled && imageSourceCount > 1 && frameSlots.count() > 0 &&
+        firstImageLoaded && !singleImageRefreshMode && !cyclingPausedForEditing &&
+        !imageProcessing && !imageDownloadPending && !imagePrefetchPending && !imageReadyToDisplay &&
+        !webConfig.isOTAInProgress() && wifiManager.isConnected() &&
+        prefetchCycleTime != lastCycleTime && currentTime - lastCycleTime >= PREFETCH_START_DELAY) {
+        prefetchCycleTime = lastCycleTime;
+        int next = peekNextImageIndex();
+        String nextURL = getImageSourceURL(next);
+        bool cached = false;
+        if (xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+            cached = frameSlots.hasFresh(next, nextURL);
+            xSemaphoreGive(imageBufferMutex);
+        }
+        if (next != currentImageIndex && !nextURL.startsWith("moon://") && !cached) {
+            prefetchSourceIndex = next;
+            imagePrefetchPending = true;
+            lastImageProcessTime = currentTime;
+        }
+    }
+
     // Check if new image is ready to display - swap buffers for seamless transition (NO FLICKER!)
     // Skip image rendering during OTA to prevent display interference
-    if (imageReadyToDisplay && !webConfig.isOTAInProgress()) {
+    if (imageReadyToDisplay && !pendingFrameDecoding && !webConfig.isOTAInProgress()) {
         // Take mutex to protect buffer swap from concurrent decode writes
         if (xSemaphoreTake(imageBufferMutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
             imageReadyToDisplay = false;  // Clear the flag under mutex protection
@@ -2445,10 +3636,31 @@ void loop() {
             fullImageHeight = pendingImageHeight;
             pendingImageHeight = tempHeight;
 
+            FrameLayout tempLayout = fullImageLayout;
+            fullImageLayout = pendingImageLayout;
+            pendingImageLayout = tempLayout;
+
             // New image is now active; invalidate the scaled-render reuse cache
             // so the next render recomputes instead of redrawing the old scale.
             imageGeneration++;
 
+            // A fresh frame of another source that just left the screen goes
+            // into the frame cache (traded for a spare buffer, no copy). A new
+            // frame of the same source supersedes whatever was cached for it.
+            if (pendingSourceIndex >= 0) {
+                frameSlots.removeSource(pendingSourceIndex);
+            }
+            if (displayedFrameCacheable() && displayedSourceIndex != pendingSourceIndex) {
+                frameSlots.store(displayedSourceIndex, displayedSourceURL, displayedFetchedAt, displayedTtlMs,
+                                 pendingFullImageBuffer, pendingImageWidth, pendingImageHeight,
+                                 pendingImageLayout);
+            }
+            displayedSourceIndex = pendingSourceIndex;
+            displayedSourceURL = pendingSourceURL;
+            displayedFetchedAt = pendingFetchedAt;
+            displayedTtlMs = pendingTtlMs;
+            pendingSourceIndex = -1;
+
             xSemaphoreGive(imageBufferMutex);
 
             Serial.printf("Buffer swap complete: %dx%d image now active\n", fullImageWidth, fullImageHeight);
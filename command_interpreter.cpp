@@ -6,6 +6,11 @@
 
 #include "command_interpreter.h"
 #include "device_health.h"
+#include "moon_sphere.h"
+#include "pixel_kernels.h"
+#include "pixel_stage.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
 
 // Global instance definition
 CommandInterpreter& commandInterpreter = CommandInterpreter::getInstance();
@@ -118,6 +123,14 @@ void CommandInterpreter::processCommands() {
             case 'g':
                 handleHealthDiagnostics();
                 break;
+            case 'U':
+            case 'u':
+                handleKernelBenchmark();
+                break;
+            case 'O':
+            case 'o':
+                handleMoonRendererBenchmark();
+                break;
             
             default:
                 // Ignore unknown commands silently
@@ -299,6 +312,8 @@ void CommandInterpreter::handleHelp() {
     Serial.println("  T   : MQTT info");
     Serial.println("  X   : Web server status/restart");
     Serial.println("  G   : Health diagnostics (comprehensive device health report)");
+    Serial.println("  U   : Pixel kernel benchmark (reference vs wide, ns/pixel)");
+    Serial.println("  O   : Moon renderer benchmark (ray cast vs tgx mesh, full map vs mip chain, 1 vs 2 cores)");
     Serial.println("Touch:");
     Serial.println("  Single tap : Next image");
     Serial.println("  Double tap : Toggle cycling/single refresh mode");
@@ -319,6 +334,165 @@ void CommandInterpreter::handlePPAInfo() {
     ppaAccelerator.printStatus();
 }
 
+// Times each pixel kernel's reference and wide form on a panel-sized frame in
+// PSRAM, as the decoder and renderer use them
+void CommandInterpreter::handleKernelBenchmark() {
+    const int w = 720, h = 720, outW = 800;
+    const size_t n = (size_t)w * h;
+    uint16_t* src = (uint16_t*)heap_caps_malloc(n * 2, MALLOC_CAP_SPIRAM);
+    uint16_t* dst = (uint16_t*)heap_caps_malloc(n * 2, MALLOC_CAP_SPIRAM);
+    uint16_t* row = (uint16_t*)heap_caps_malloc(outW * 2, MALLOC_CAP_INTERNAL);
+    PixelStage stage = { 0, (uint16_t*)heap_caps_malloc(PIXEL_STAGE_LUT_BYTES, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) };
+    if (!src || !dst || !row || !stage.lut) {
+        Serial.println("[Bench] Not enough memory for the kernel benchmark");
+        heap_caps_free(src);
+        heap_caps_free(dst);
+        heap_caps_free(row);
+        heap_caps_free(stage.lut);
+        return;
+    }
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        src[i] = (uint16_t)(seed >> 16);
+    }
+    PixelStageSettings settings = { 3200, 180, 30 };
+    pixelStageBuild(&stage, settings);
+
+    Serial.printf("\n=== Pixel Kernels (%dx%d, %s build) ===\n", w, h,
+                  PIXEL_KERNELS_WIDE ? "wide" : "reference");
+    Serial.println("kernel      ref ns/px  wide ns/px  speedup");
+    static const char* names[] = { "fill", "copy", "lut", "bilinear" };
+    for (int k = 0; k < 4; k++) {
+        float ns[2];
+        for (int wide = 0; wide < 2; wide++) {
+            systemMonitor.forceResetWatchdog();
+            int64_t t0 = esp_timer_get_time();
+            size_t pixels = 0;
+            switch (k) {
+                case 0: (wide ? pxFillWide : pxFillRef)(dst, n, 0x1234); pixels = n; break;
+                case 1: (wide ? pxCopyWide : pxCopyRef)(dst, src, n); pixels = n; break;
+                case 2: (wide ? pxLutWide : pxLutRef)(stage.lut, dst, src, n); pixels = n; break;
+                case 3:
+                    // 720 -> 800 rows, as a zoomed frame is drawn
+                    for (int y = 0; y + 1 < h; y++) {
+                        (wide ? pxBilinearRowWide : pxBilinearRowRef)(src + (size_t)y * w, src + (size_t)(y + 1) * w,
+                                                                      0x6000, w, row, outW);
+                    }
+                    pixels = (size_t)(h - 1) * outW;
+                    break;
+            }
+            ns[wide] = (float)(esp_timer_get_time() - t0) * 1000.0f / pixels;
+        }
+        Serial.printf("%-10s %10.2f %11.2f %7.2fx\n", names[k], ns[0], ns[1], ns[0] / ns[1]);
+    }
+
+    heap_caps_free(src);
+    heap_caps_free(dst);
+    heap_caps_free(row);
+    heap_caps_free(stage.lut);
+}
+
+void CommandInterpreter::handleMoonRendererBenchmark() {
+    if (!moon_sphere_init()) {
+        Serial.println("[Bench] Moon texture unavailable");
+        return;
+    }
+    const int sizes[] = { 240, displayManager.getWidth() };
+    const int maxSize = sizes[1] > sizes[0] ? sizes[1] : sizes[0];
+    const size_t n = (size_t)maxSize * maxSize;
+    uint16_t* ray = (uint16_t*)heap_caps_aligned_alloc(128, n * 2, MALLOC_CAP_SPIRAM);
+    uint16_t* mesh = (uint16_t*)heap_caps_aligned_alloc(128, n * 2, MALLOC_CAP_SPIRAM);
+    if (!ray || !mesh) {
+        Serial.println("[Bench] Not enough memory for the moon renderer benchmark");
+        heap_caps_free(ray);
+        heap_caps_free(mesh);
+        return;
+    }
+
+    // Tonight's sky as the resting render draws it, so the terminator shows
+    moon_state_t st;
+    moon_compute(time(nullptr), (double)configStorage.getMoonLat(), (double)configStorage.getMoonLon(), &st);
+    moon_sphere_set_disk_scale(DEFAULT_MOON_DISK_SCALE);
+    moon_renderer_t selected = moon_sphere_get_renderer();
+
+    Serial.println("\n=== Moon Renderer (ray cast vs 96x48 tgx mesh) ===");
+    Serial.println("size      ray ms   mesh ms  speedup  diff px  mean/255  max/255");
+    for (int w : sizes) {
+        float ms[2];
+        for (int k = 0; k < 2; k++) {
+            systemMonitor.forceResetWatchdog();
+            moon_sphere_set_renderer(k ? MOON_RENDER_MESH : MOON_RENDER_RAYCAST);
+            int64_t t0 = esp_timer_get_time();
+            moon_sphere_render_into(w, w, &st, 96, 48, 0, 0.0f, 0.0f, MOON_LIGHT_TRUE_PHASE,
+                                    k ? mesh : ray);
+            ms[k] = (float)(esp_timer_get_time() - t0) / 1000.0f;
+        }
+        // Per-channel difference on the 8-bit scale
+        size_t differing = 0;
+        uint64_t sum = 0;
+        int worst = 0;
+        for (size_t i = 0; i < (size_t)w * w; i++) {
+            if (ray[i] == mesh[i]) continue;
+            differing++;
+            int d[3] = { abs((ray[i] >> 11) - (mesh[i] >> 11)) * 255 / 31,
+                         abs(((ray[i] >> 5) & 0x3F) - ((mesh[i] >> 5) & 0x3F)) * 255 / 63,
+                         abs((ray[i] & 0x1F) - (mesh[i] & 0x1F)) * 255 / 31 };
+            for (int c = 0; c < 3; c++) {
+                sum += d[c];
+                if (d[c] > worst) worst = d[c];
+            }
+        }
+        Serial.printf("%4dx%-4d %7.1f %9.1f %7.2fx %8u %9.2f %8d\n", w, w, ms[0], ms[1], ms[1] / ms[0],
+                      (unsigned)differing, (float)sum / ((size_t)w * w * 3), worst);
+    }
+    moon_sphere_set_renderer(selected);
+
+    // The same ray cast sampling the full map at every size, then the mip
+    // level the render picks (only the drag-size frame should change)
+    bool mipmap = moon_sphere_get_mipmap();
+    Serial.println("size      full map ms  mip chain ms  speedup");
+    for (int w : sizes) {
+        float ms[2];
+        for (int k = 0; k < 2; k++) {
+            systemMonitor.forceResetWatchdog();
+            moon_sphere_set_mipmap(k == 1);
+            int64_t t0 = esp_timer_get_time();
+            moon_sphere_render_into(w, w, &st, 96, 48, 0, 0.0f, 0.0f, MOON_LIGHT_TRUE_PHASE, ray);
+            ms[k] = (float)(esp_timer_get_time() - t0) / 1000.0f;
+        }
+        Serial.printf("%4dx%-4d %11.1f %13.1f %7.2fx\n", w, w, ms[0], ms[1], ms[0] / ms[1]);
+    }
+    moon_sphere_set_mipmap(mipmap);
+
+    // Each renderer on the calling core alone, then in row bands on both
+    // cores; the two frames must match pixel for pixel
+    bool banded = moon_sphere_get_banded();
+    Serial.println("size      renderer  1 core ms  2 cores ms  speedup  identical");
+    for (int w : sizes) {
+        for (int r = 0; r < 2; r++) {
+            moon_sphere_set_renderer(r ? MOON_RENDER_MESH : MOON_RENDER_RAYCAST);
+            float ms[2];
+            for (int k = 0; k < 2; k++) {
+                systemMonitor.forceResetWatchdog();
+                moon_sphere_set_banded(k == 1);
+                int64_t t0 = esp_timer_get_time();
+                moon_sphere_render_into(w, w, &st, 96, 48, 0, 0.0f, 0.0f, MOON_LIGHT_TRUE_PHASE,
+                                        k ? mesh : ray);
+                ms[k] = (float)(esp_timer_get_time() - t0) / 1000.0f;
+            }
+            bool same = memcmp(ray, mesh, (size_t)w * w * 2) == 0;
+            Serial.printf("%4dx%-4d %-8s %10.1f %11.1f %7.2fx  %s\n", w, w, r ? "mesh" : "ray cast", ms[0], ms[1],
+                          ms[0] / ms[1], same ? "yes" : "NO");
+        }
+    }
+    moon_sphere_set_banded(banded);
+    moon_sphere_set_renderer(selected);
+
+    heap_caps_free(ray);
+    heap_caps_free(mesh);
+}
+
 void CommandInterpreter::handleMQTTInfo() {
     mqttManager.printConnectionInfo();
 }
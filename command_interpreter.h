@@ -13,6 +13,7 @@
  * - Brightness: L, K (±10%)
  * - System: B (reboot), H/? (help)
  * - Info: M (memory), I (network), P (PPA), T (MQTT), X (web server), G (health diagnostics)
+ * - Benchmark: U (pixel kernels, ns/pixel), O (moon ray cast vs tgx mesh)
  */
 
 #ifndef COMMAND_INTERPRETER_H
@@ -86,6 +87,8 @@ private:
     void handleMQTTInfo();
     void handleWebServerStatus();
     void handleHealthDiagnostics();
+    void handleKernelBenchmark();
+    void handleMoonRendererBenchmark();
 };
 
 // Global instance
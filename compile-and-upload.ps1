@@ -283,6 +283,21 @@ if ($args -contains "-UploadOnly") {
         exit 1
     }
     
+    # write-flash -e erases the whole chip, the moontex partition included, so
+    # put the baked lunar texture back when one has been generated
+    # (tools/bake_moon_texture.py); without it the firmware decodes the JPEG
+    $FLASH_IMAGES = @(
+        "0x2000", $BOOTLOADER_BIN,
+        "0x8000", $PARTITIONS_BIN,
+        "0xe000", $BOOT_APP0_BIN,
+        "0x10000", $APP_BIN
+    )
+    $MOON_TEXTURE_BIN = Join-Path $SCRIPT_DIR "moon_texture.bin"
+    if (Test-Path $MOON_TEXTURE_BIN) {
+        $FLASH_IMAGES += @("0x1410000", $MOON_TEXTURE_BIN)
+        Write-Host "Including baked lunar texture: $MOON_TEXTURE_BIN" -ForegroundColor Gray
+    }
+    
     Write-Host "Uploading pre-compiled binaries to $ComPort..." -ForegroundColor Yellow
     
     & $ESPTOOL `
@@ -295,10 +310,7 @@ if ($args -contains "-UploadOnly") {
         --flash-mode keep `
         --flash-freq keep `
         --flash-size keep `
-        0x2000 $BOOTLOADER_BIN `
-        0x8000 $PARTITIONS_BIN `
-        0xe000 $BOOT_APP0_BIN `
-        0x10000 $APP_BIN
+        @FLASH_IMAGES
     
     if ($LASTEXITCODE -eq 0) {
         Write-Host "`nSUCCESS: Upload completed!" -ForegroundColor Green
@@ -0,0 +1,99 @@
+#include "conditional_fetch.h"
+
+// Global instance
+ConditionalFetch conditionalFetch;
+
+ConditionalFetch::ConditionalFetch() : lastRequestConditional(false) {
+    for (int i = 0; i < MAX_IMAGE_SOURCES; i++) {
+        entries[i].urlHash = 0;
+        entries[i].lastFullFetch = 0;
+        entries[i].valid = false;
+        entries[i].bodyHash = 0;
+        entries[i].bodyLength = 0;
+    }
+    memset(&stats, 0, sizeof(stats));
+}
+
+uint32_t ConditionalFetch::hashUrl(const String& url) {
+    // FNV-1a; only used to notice that a slot's URL was edited
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < url.length(); i++) {
+        h ^= (uint8_t)url[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+bool ConditionalFetch::prepare(int sourceIndex, const String& url, bool frameFromSource,
+                               String& ifNoneMatch, String& ifModifiedSince) {
+    ifNoneMatch = "";
+    ifModifiedSince = "";
+    lastRequestConditional = false;
+
+    if (sourceIndex < 0 || sourceIndex >= MAX_IMAGE_SOURCES) {
+        stats.unconditional++;
+        return false;
+    }
+
+    Entry& e = entries[sourceIndex];
+    if (!e.valid || e.urlHash != hashUrl(url) || !frameFromSource) {
+        stats.unconditional++;
+        return false;
+    }
+    if (millis() - e.lastFullFetch >= FORCE_CHECK_INTERVAL) {
+        stats.forcedRefreshes++;
+        return false;
+    }
+
+    ifNoneMatch = e.etag;
+    ifModifiedSince = e.lastModified;
+    lastRequestConditional = true;
+    stats.conditionalRequests++;
+    return true;
+}
+
+void ConditionalFetch::onNotModified(int sourceIndex) {
+    (void)sourceIndex;
+    stats.notModified++;
+}
+
+void ConditionalFetch::onFullResponse(int sourceIndex, const String& url,
+                                      const String& etag, const String& lastModified,
+                                      uint64_t bodyHash, size_t bodyLength) {
+    if (lastRequestConditional) stats.modified++;
+    lastRequestConditional = false;
+    if (sourceIndex < 0 || sourceIndex >= MAX_IMAGE_SOURCES) return;
+
+    Entry& e = entries[sourceIndex];
+    e.urlHash = hashUrl(url);
+    e.etag = etag;
+    e.lastModified = lastModified;
+    e.lastFullFetch = millis();
+    e.valid = etag.length() > 0 || lastModified.length() > 0;
+    e.bodyHash = bodyHash;
+    e.bodyLength = bodyLength;
+}
+
+bool ConditionalFetch::isUnchangedBody(int sourceIndex, const String& url,
+                                       uint64_t bodyHash, size_t bodyLength) const {
+    if (sourceIndex < 0 || sourceIndex >= MAX_IMAGE_SOURCES || bodyLength == 0) return false;
+    const Entry& e = entries[sourceIndex];
+    return e.bodyLength == bodyLength && e.bodyHash == bodyHash && e.urlHash == hashUrl(url);
+}
+
+void ConditionalFetch::onUnchangedBody(int sourceIndex, const String& url,
+                                       const String& etag, const String& lastModified) {
+    stats.unchangedBodies++;
+    if (sourceIndex < 0 || sourceIndex >= MAX_IMAGE_SOURCES) return;
+    // Same bytes, but keep any validators the server has started sending
+    const Entry& e = entries[sourceIndex];
+    onFullResponse(sourceIndex, url, etag, lastModified, e.bodyHash, e.bodyLength);
+}
+
+void ConditionalFetch::forget(int sourceIndex) {
+    if (sourceIndex < 0 || sourceIndex >= MAX_IMAGE_SOURCES) return;
+    entries[sourceIndex].valid = false;
+    entries[sourceIndex].etag = "";
+    entries[sourceIndex].lastModified = "";
+    entries[sourceIndex].bodyLength = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef CONDITIONAL_FETCH_H
+#define CONDITIONAL_FETCH_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Per-source HTTP validators (ETag / Last-Modified) for conditional GETs.
+// Validators are only offered while the frame on screen came from that same
+// source, so a 304 always means "what you are showing is still current".
+// After FORCE_CHECK_INTERVAL without a full 200 response the next request is
+// sent unconditionally.
+//
+// For servers without useful validators (SOHO/SDO latest.jpg) the 64-bit
+// FNV-1a hash of the last decoded body is kept as well: a 200 whose bytes
+// match it is treated like a 304 after the transfer.
+
+struct ConditionalFetchStats {
+    uint32_t conditionalRequests;   // requests sent with If-None-Match / If-Modified-Since
+    uint32_t notModified;           // 304 responses (download, decode and render skipped)
+    uint32_t modified;              // conditional request answered with a new 200 body
+    uint32_t forcedRefreshes;       // validators withheld because FORCE_CHECK_INTERVAL elapsed
+    uint32_t unconditional;         // no usable validators (first fetch, other source on screen)
+    uint32_t unchangedBodies;       // 200 with the same content hash (decode/render skipped)
+};
+
+class ConditionalFetch {
+public:
+    ConditionalFetch();
+
+    // Validators to send for this request, or false for a plain GET.
+    // frameFromSource: the displayed frame was decoded from this source index.
+    bool prepare(int sourceIndex, const String& url, bool frameFromSource,
+                 String& ifNoneMatch, String& ifModifiedSince);
+
+    // Record the outcome of the request prepared above
+    void onNotModified(int sourceIndex);
+    void onFullResponse(int sourceIndex, const String& url, const String& etag, const String& lastModified,
+                        uint64_t bodyHash, size_t bodyLength);
+
+    // True when a freshly received body is byte-identical (by hash and length)
+    // to the last one decoded for this source and URL
+    bool isUnchangedBody(int sourceIndex, const String& url, uint64_t bodyHash, size_t bodyLength) const;
+    void onUnchangedBody(int sourceIndex, const String& url, const String& etag, const String& lastModified);
+    void forget(int sourceIndex);
+
+    const ConditionalFetchStats& getStats() const { return stats; }
+
+private:
+    struct Entry {
+        uint32_t urlHash;
+        String etag;
+        String lastModified;
+        unsigned long lastFullFetch;   // millis() of the last 200 response
+        bool valid;                    // etag / lastModified usable
+        uint64_t bodyHash;             // content hash of the last decoded body
+        size_t bodyLength;             // 0 = no body recorded
+    };
+
+    static uint32_t hashUrl(const String& url);
+
+    Entry entries[MAX_IMAGE_SOURCES];
+    bool lastRequestConditional;
+    ConditionalFetchStats stats;
+};
+
+// Global instance
+extern ConditionalFetch conditionalFetch;
+
+#endif // CONDITIONAL_FETCH_H
@@ -113,6 +113,14 @@ extern const bool DEFAULT_RANDOM_ORDER;
 #define MIN_COLOR_TEMP 2000              // Warm (candle light)
 #define MAX_COLOR_TEMP 15000             // Cool (deep blue)
 
+// Tone defaults, composed with the colour temperature into the decoder's
+// pixel stage table (pixel_stage.h)
+#define DEFAULT_DISPLAY_GAMMA 100        // gamma x 100; 100 = unchanged, >100 lifts shadows
+#define MIN_DISPLAY_GAMMA 50
+#define MAX_DISPLAY_GAMMA 250
+#define DEFAULT_NIGHT_RED_SHIFT 0        // % of the image turned red for night viewing
+#define MAX_NIGHT_RED_SHIFT 100
+
 // Moon render defaults
 #define DEFAULT_MOON_LAT 0.0f            // 0 => north-up convention
 #define DEFAULT_MOON_LON 0.0f
@@ -181,6 +189,28 @@ extern const bool DEFAULT_RANDOM_ORDER;
 #define DOWNLOAD_TASK_STACK_SIZE 16384   // Stack size for async download task (16KB for TLS)
 #define DOWNLOAD_TASK_PRIORITY 2         // Priority for download task (Core 0)
 
+// =============================================================================
+// ROW POOL CONFIGURATION (row_pool.h)
+// =============================================================================
+
+#define ROW_POOL_WORKERS 2               // One per core: software scale / rotate, pixel stage, moon background and disc
+#define ROW_POOL_TASK_STACK_SIZE 8192    // Pixel loops, and a tgx Renderer3D per moon mesh band
+#define ROW_POOL_TASK_PRIORITY 2         // Same as the download task; the caller waits meanwhile
+
+// =============================================================================
+// IMAGE TRANSITION CONFIGURATION (transition_schedule.h)
+// =============================================================================
+// How a new image replaces the last one, run by the PPA from a task of its
+// own while the main loop carries on. Needs DISPLAY_DOUBLE_BUFFER; any frame
+// that takes longer than 1/TRANSITION_FPS s ends it with an instant swap.
+
+#define TRANSITION_MODE 1                // 0 = instant, 1 = cross-fade, 2 = slide in from the right
+#define TRANSITION_DURATION_MS 500
+#define TRANSITION_FPS 30
+#define TRANSITION_TASK_STACK_SIZE 4096
+#define TRANSITION_TASK_PRIORITY 2       // Mostly waiting on the PPA
+#define TRANSITION_TASK_CORE 1           // Off the download / network core
+
 // =============================================================================
 // TOUCH GESTURE TIMING CONFIGURATION
 // =============================================================================
@@ -200,6 +230,80 @@ extern const bool DEFAULT_RANDOM_ORDER;
 #define DECODE_TIMEOUT 5000              // 5 second timeout for JPEG decode
 #define ABSOLUTE_DOWNLOAD_TIMEOUT 50000  // 50 second absolute timeout for entire download
 
+// Streaming decode: feed JPEGDEC straight from the HTTP socket so MCU rows land
+// in the pending buffer while the body is still arriving. This does not free
+// the download buffer (imageBuffer, at least MIN_DOWNLOAD_BUFFER_SIZE): the
+// hardware codec needs the whole bitstream in a DMA-aligned buffer, a retained
+// body is re-decoded from it on zoom-in, and a streamed decode that fails keeps
+// a copy of the received bytes there for the in-RAM retry. With JPEG_HW_DECODE
+// bodies that fit the buffer are still buffered, so streaming runs only for
+// those that don't - which the buffered path could not fetch at all.
+// Set to 0 to always download the whole body first.
+#define JPEG_STREAM_DECODE 1
+
+// Decode buffered frames with the ESP32-P4 hardware JPEG codec, falling back to
+// JPEGDEC for progressive / grayscale / CMYK streams or codec errors. While the
+// codec is up, bodies that fit the download buffer are buffered rather than
+// streamed. Set to 0 to use JPEGDEC only.
+#define JPEG_HW_DECODE 1
+
+// Have JPEGDEC write MCUs straight into the pending frame buffer instead of a
+// scratch block that JPEGDraw then copies row by row. Used for whole frames
+// whose width is a multiple of the MCU width (most sources); others, cropped
+// decodes and the strip pipeline keep the copy. Set to 0 to always copy.
+#define JPEG_DIRECT_DECODE 1
+
+// Region-of-interest decode: when a source's scale / offset push part of the
+// frame off the panel, only the visible part (plus a margin for the scaler's
+// filter, aligned to JPEG MCUs) is decoded and kept. Panning or zooming out
+// past it re-decodes the frame. Set to 0 to always keep the whole frame.
+#define ROI_DECODE 1
+#define ROI_DECODE_MARGIN 16             // Frame pixels kept beyond the visible edge
+#define JPEG_MCU_ALIGN 16                // Largest JPEG MCU (4:2:0), in pixels
+
+// Strip-pipelined decode: JPEGDEC's MCU rows are collected into a small ring of
+// strips and each is scaled (PPA, or the software bilinear scaler) to the size
+// it is drawn as soon as it is complete, so a frame is stored at about panel
+// size instead of at full resolution. The image buffers and frame cache slots
+// then shrink from FULL_IMAGE_BUFFER_SIZE to a panel-sized square (plus the ROI
+// margin). The hardware codec decodes whole frames only and is not used. The
+// PPA scales in 1/16 steps, rounded up. Set to 1 to enable.
+#define STRIP_PIPELINE 0
+#define STRIP_RING_SLOTS 2               // Strips in flight (at most STRIP_MAX_SLOTS)
+#define STRIP_PPA_TIMEOUT_MS 1000        // Longest wait for one PPA strip
+#if STRIP_PIPELINE && !ROI_DECODE
+#error "STRIP_PIPELINE needs ROI_DECODE: the panel-sized buffers only hold the visible part of a zoomed frame"
+#endif
+
+// Decoded-frame cache: frames of other sources are kept in PSRAM (one
+// image-buffer-sized slot each) while fresh, so cycling back to a source
+// within its TTL is an instant buffer swap. While a source is on screen the
+// next one is prefetched into the cache. The budget sets the number of slots;
+// slots are only allocated at boot while at least FRAME_SLOT_PSRAM_RESERVE
+// bytes of PSRAM would remain free. A budget of 0 disables cache and prefetch.
+#define FRAME_CACHE_PSRAM_BUDGET (8 * 1024 * 1024)   // 2 slots
+#define FRAME_SLOT_PSRAM_RESERVE (4 * 1024 * 1024)
+// A frame stays fresh for the update interval (or a shorter Cache-Control
+// max-age from its server), but at least this long
+#define FRAME_CACHE_MIN_TTL 60000
+#define PREFETCH_START_DELAY 5000        // Wait 5s into a source's display time before prefetching
+
+// Scaled / rotated frames are drawn by the PPA straight into the panel
+// framebuffer at their place, clipped to the panel, instead of into the scaled
+// buffer and then copied across by the CPU. What the previous frame leaves
+// uncovered is cleared on the PPA fill engine. Drawn into the back buffer with
+// DISPLAY_DOUBLE_BUFFER; without it only with the panel at rotation 0 (the
+// framebuffer is in panel order). Otherwise, and if the PPA refuses, the
+// scaled buffer is used. Set to 0 to always use the scaled buffer.
+#define PPA_DIRECT_FRAMEBUFFER 1
+
+// Each frame is composed in a panel-sized back buffer (PSRAM) and put on the
+// panel with one PPA copy, turned to the panel's orientation on the way, so
+// the panel never scans a frame while it is being drawn. Costs a panel-sized
+// buffer and two PPA copies per frame. Only for display rotation 0 or 2; set
+// to 0 to draw straight onto the panel.
+#define DISPLAY_DOUBLE_BUFFER 1
+
 // =============================================================================
 // SYSTEM STARTUP DELAYS
 // =============================================================================
@@ -235,6 +339,14 @@ extern const bool DEFAULT_RANDOM_ORDER;
 #define DOWNLOAD_CHUNK_TIMEOUT 8000      // 8 second timeout per download chunk (for larger 4MB images)
 #define TOTAL_DOWNLOAD_TIMEOUT 90000     // 90 second total download timeout (for larger 4MB images)
 
+// Keep-alive: image downloads reuse one open connection per host (up to
+// HTTP_POOL_MAX_ENTRIES hosts), so refreshing an https source skips the TCP
+// connect and TLS handshake. Each kept TLS connection holds ~40KB of internal
+// RAM for mbedTLS buffers. Set to 0 to open a new connection per download.
+#define HTTP_KEEP_ALIVE 1
+#define HTTP_KEEP_ALIVE_IDLE_TIMEOUT 150000  // Close after 2.5 min unused (one update interval + margin)
+#define HTTP_KEEP_ALIVE_MAX_REQUESTS 100     // Reconnect after this many fetches on one connection
+
 // =============================================================================
 // CONFIGURATION FUNCTIONS
 // =============================================================================
@@ -96,6 +96,8 @@ String exportJson(bool includeSecrets) {
   // Display hardware
   config["displayType"] = configStorage.getDisplayType();
   config["colorTemp"] = configStorage.getColorTemp();
+  config["displayGamma"] = configStorage.getDisplayGamma();
+  config["nightRedShift"] = configStorage.getNightRedShift();
 
   // Moon render
   config["moonLat"] = configStorage.getMoonLat();
@@ -253,6 +255,8 @@ RestoreResult importJson(const String& body) {
   // Display hardware
   APPLY_INT("displayType", setDisplayType);
   APPLY_INT("colorTemp", setColorTemp);
+  APPLY_INT("displayGamma", setDisplayGamma);
+  APPLY_INT("nightRedShift", setNightRedShift);
 
   // Moon render
   APPLY_FLOAT("moonLat", setMoonLat);
@@ -352,7 +356,7 @@ RestoreResult importJson(const String& body) {
     "imageSources",
     "defaultBrightness","brightnessAutoMode","defaultScaleX","defaultScaleY","defaultOffsetX",
     "defaultOffsetY","defaultRotation","defaultImageDuration","backlightFreq","backlightResolution",
-    "displayType","colorTemp",
+    "displayType","colorTemp","displayGamma","nightRedShift",
     "moonLat","moonLon","moonBgStyle","moonFlipU","moonFlipV","moonRollOffset","moonYawOffset",
     "moonPitchOffset","moonNorthUp","moonDragLightMode","moonSpinMode","moonSpinReturnS",
     "updateInterval","mqttReconnectInterval","watchdogTimeout","criticalHeapThreshold","criticalPSRAMThreshold",
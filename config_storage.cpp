@@ -98,6 +98,10 @@ void ConfigStorage::setDefaults() {
   // Color temperature default
   config.colorTemp = DEFAULT_COLOR_TEMP;  // 6500K neutral white
 
+  // Tone defaults (no change)
+  config.displayGamma = DEFAULT_DISPLAY_GAMMA;
+  config.nightRedShift = DEFAULT_NIGHT_RED_SHIFT;
+
   // Moon render defaults
   config.moonLat = DEFAULT_MOON_LAT;
   config.moonLon = DEFAULT_MOON_LON;
@@ -242,6 +246,8 @@ void ConfigStorage::loadConfig() {
     config.displayType = preferences.getInt("disp_type", config.displayType);
 
     config.colorTemp = preferences.getInt("color_temp", config.colorTemp);
+    config.displayGamma = preferences.getInt("disp_gamma", config.displayGamma);
+    config.nightRedShift = preferences.getInt("night_red", config.nightRedShift);
 
     config.moonLat = preferences.getFloat("moonLat", config.moonLat);
     config.moonLon = preferences.getFloat("moonLon", config.moonLon);
@@ -412,6 +418,8 @@ void ConfigStorage::saveConfig() {
     preferences.putInt("bl_res", config.backlightResolution);
     preferences.putInt("disp_type", config.displayType);
     preferences.putInt("color_temp", config.colorTemp);
+    preferences.putInt("disp_gamma", config.displayGamma);
+    preferences.putInt("night_red", config.nightRedShift);
   }
 
   if (fieldsToSave & DIRTY_MOON) {
@@ -541,6 +549,8 @@ void ConfigStorage::resetToDefaults() {
   preferences.putInt("bl_res", config.backlightResolution);
   preferences.putInt("disp_type", config.displayType);
   preferences.putInt("color_temp", config.colorTemp);
+  preferences.putInt("disp_gamma", config.displayGamma);
+  preferences.putInt("night_red", config.nightRedShift);
   preferences.putFloat("moonLat", config.moonLat);
   preferences.putFloat("moonLon", config.moonLon);
   preferences.putInt("moonBg", config.moonBgStyle);
@@ -1419,6 +1429,28 @@ int ConfigStorage::getColorTemp() {
   return config.colorTemp;
 }
 
+void ConfigStorage::setDisplayGamma(int gammaX100) {
+  ConfigLock lock(_mutex);
+  config.displayGamma = constrain(gammaX100, MIN_DISPLAY_GAMMA, MAX_DISPLAY_GAMMA);
+  markDirty(DIRTY_DISPLAY);
+}
+
+int ConfigStorage::getDisplayGamma() {
+  ConfigLock lock(_mutex);
+  return config.displayGamma;
+}
+
+void ConfigStorage::setNightRedShift(int percent) {
+  ConfigLock lock(_mutex);
+  config.nightRedShift = constrain(percent, 0, MAX_NIGHT_RED_SHIFT);
+  markDirty(DIRTY_DISPLAY);
+}
+
+int ConfigStorage::getNightRedShift() {
+  ConfigLock lock(_mutex);
+  return config.nightRedShift;
+}
+
 void ConfigStorage::setMoonLat(float lat) {
   ConfigLock lock(_mutex);
   config.moonLat = lat;
@@ -232,6 +232,12 @@ public:
     void setColorTemp(int temp);
     int getColorTemp();
 
+    // Tone setters/getters (gamma x 100, night red shift %)
+    void setDisplayGamma(int gammaX100);
+    int getDisplayGamma();
+    void setNightRedShift(int percent);
+    int getNightRedShift();
+
     // Moon render setters/getters
     void setMoonLat(float lat);
     void setMoonLon(float lon);
@@ -333,6 +339,10 @@ private:
         // Color temperature
         int colorTemp;  // Display color temperature in Kelvin (2000-10000)
 
+        // Tone
+        int displayGamma;     // gamma x 100 (50-250, 100 = unchanged)
+        int nightRedShift;    // 0-100 %, 0 = off
+
         // Moon render settings
         float moonLat;        // observer latitude, degrees (0 => unset/north-up)
         float moonLon;        // observer longitude, degrees
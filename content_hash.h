@@ -0,0 +1,31 @@
+#pragma once
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Incremental 64-bit FNV-1a hash of a downloaded body.
+ *
+ * Fed chunk by chunk as bytes come off the socket, so it costs nothing extra
+ * once the download finishes. Not cryptographic: it only has to tell
+ * "same bytes as last time" apart from "new frame" for one source.
+ *
+ * Usage:
+ * ```cpp
+ * uint64_t h = CONTENT_HASH_INIT;
+ * h = contentHashUpdate(h, chunk, len);   // repeat per chunk
+ * ```
+ */
+#define CONTENT_HASH_INIT 0xcbf29ce484222325ULL
+
+static inline uint64_t contentHashUpdate(uint64_t hash, const uint8_t* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+#endif // CONTENT_HASH_H
@@ -1,6 +1,10 @@
 #include "display_manager.h"
 #include "system_monitor.h"
 #include "config_storage.h"
+#include "ppa_accelerator.h"
+#include "logging.h"
+#include "esp_timer.h"
+#include "transition_schedule.h"
 
 // Global instance
 DisplayManager displayManager;
@@ -17,7 +21,19 @@ DisplayManager::DisplayManager() :
     firstImageLoaded(false),
     otaScreenInitialized(false),
     lastOTAPercent(255),
-    _paused(false)
+    _paused(false),
+    backBuffer(nullptr),
+    composing(false),
+    presentRotation(0.0f),
+    framePeriodUs(0),
+    lastPresentCopyUs(0),
+    maxPresentUs(0),
+    transitionTask(nullptr),
+    transitionStart(nullptr),
+    transitionIdle(nullptr),
+    transitionAbort(false),
+    transitionBuffer(nullptr),
+    transitionFrame(nullptr)
 {}
 
 DisplayManager::~DisplayManager() {
@@ -78,6 +94,56 @@ bool DisplayManager::begin() {
     
     displayWidth = gfx->width();
     displayHeight = gfx->height();
+
+    // A refresh scans the active area plus porches and sync at the pixel clock
+    uint64_t lineClocks = (uint64_t)activeConfig.width + activeConfig.hsync_pulse_width +
+                          activeConfig.hsync_back_porch + activeConfig.hsync_front_porch;
+    uint64_t frameLines = (uint64_t)activeConfig.height + activeConfig.vsync_pulse_width +
+                          activeConfig.vsync_back_porch + activeConfig.vsync_front_porch;
+    framePeriodUs = activeConfig.prefer_speed ? (uint32_t)(lineClocks * frameLines * 1000000ULL /
+                                                           activeConfig.prefer_speed) : 0;
+
+#if DISPLAY_DOUBLE_BUFFER
+    // Only for orientations the PPA turns exactly (rotation 2 is 180°; 1 and
+    // 3 swap the axes and keep drawing live)
+    if (activeConfig.rotation == 0 || activeConfig.rotation == 2) {
+        presentRotation = activeConfig.rotation == 2 ? 180.0f : 0.0f;
+        backBuffer = (uint16_t*)heap_caps_aligned_alloc(64, (size_t)displayWidth * displayHeight * 2,
+                                                        MALLOC_CAP_DMA | MALLOC_CAP_SPIRAM);
+        if (!backBuffer) Serial.println("WARNING: No PSRAM for the back buffer, drawing live");
+    }
+#if TRANSITION_MODE != TRANSITION_NONE
+    if (backBuffer) {
+        // The blend engine doesn't rotate: a rotated panel fades in a copy of
+        // the frame turned to panel order
+        if (TRANSITION_MODE == TRANSITION_FADE && presentRotation != 0.0f) {
+            transitionBuffer = (uint16_t*)heap_caps_aligned_alloc(64, (size_t)displayWidth * displayHeight * 2,
+                                                                  MALLOC_CAP_DMA | MALLOC_CAP_SPIRAM);
+        }
+        bool buffered = TRANSITION_MODE != TRANSITION_FADE || presentRotation == 0.0f || transitionBuffer;
+        if (buffered) {
+            transitionStart = xSemaphoreCreateBinary();
+            transitionIdle = xSemaphoreCreateBinary();
+        }
+        if (transitionStart && transitionIdle) {
+            xSemaphoreGive(transitionIdle);
+            if (xTaskCreatePinnedToCore(transitionTaskEntry, "Transition", TRANSITION_TASK_STACK_SIZE, this,
+                                        TRANSITION_TASK_PRIORITY, &transitionTask, TRANSITION_TASK_CORE) != pdPASS) {
+                transitionTask = nullptr;
+            }
+        }
+        if (!transitionTask) {
+            // Nothing may wait on an idle signal no task will ever give back
+            if (transitionStart) vSemaphoreDelete(transitionStart);
+            if (transitionIdle) vSemaphoreDelete(transitionIdle);
+            transitionStart = transitionIdle = nullptr;
+            if (transitionBuffer) heap_caps_free(transitionBuffer);
+            transitionBuffer = nullptr;
+            Serial.println("WARNING: Image transitions unavailable, swapping instantly");
+        }
+    }
+#endif
+#endif
     
     // Clear screen and start debug output
     clearScreen();
@@ -89,6 +155,28 @@ bool DisplayManager::begin() {
 }
 
 void DisplayManager::cleanup() {
+    endTransition();
+    if (transitionTask) {
+        vTaskDelete(transitionTask);
+        transitionTask = nullptr;
+    }
+    if (transitionStart) {
+        vSemaphoreDelete(transitionStart);
+        transitionStart = nullptr;
+    }
+    if (transitionIdle) {
+        vSemaphoreDelete(transitionIdle);
+        transitionIdle = nullptr;
+    }
+    if (transitionBuffer) {
+        heap_caps_free(transitionBuffer);
+        transitionBuffer = nullptr;
+    }
+    if (backBuffer) {
+        heap_caps_free(backBuffer);
+        backBuffer = nullptr;
+    }
+    composing = false;
     if (gfx) {
         delete gfx;
         gfx = nullptr;
@@ -220,18 +308,193 @@ void DisplayManager::setDisableAutoScroll(bool disable) {
 }
 
 void DisplayManager::clearScreen(uint16_t color) {
-    if (gfx) {
+    if (composing) {
+        fillRect(0, 0, displayWidth, displayHeight, color);
+    } else if (gfx) {
+        endTransition();
         gfx->fillScreen(color);
     }
 }
 
+void DisplayManager::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (!composing) {
+        endTransition();
+        if (gfx) gfx->fillRect(x, y, w, h, color);
+        return;
+    }
+    RenderRect r = { x, y, w, h };
+    if (ppaAccelerator.fillFramebuffer(backBuffer, displayWidth, displayHeight, r, color)) return;
+    if (!renderClipRect(&r, displayWidth, displayHeight)) return;
+    for (int row = r.y; row < r.y + r.h; row++) {
+        uint16_t* p = backBuffer + (size_t)row * displayWidth + r.x;
+        for (int i = 0; i < r.w; i++) p[i] = color;
+    }
+}
+
 void DisplayManager::drawBitmap(int16_t x, int16_t y, uint16_t* bitmap, int16_t w, int16_t h) {
     if (_paused) return;
+    if (composing && bitmap) {
+        RenderRect r = { x, y, w, h };
+        if (!renderClipRect(&r, displayWidth, displayHeight)) return;
+        for (int row = r.y; row < r.y + r.h; row++) {
+            memcpy(backBuffer + (size_t)row * displayWidth + r.x,
+                   bitmap + (size_t)(row - y) * w + (r.x - x), (size_t)r.w * sizeof(uint16_t));
+        }
+        return;
+    }
     if (gfx && bitmap) {
+        endTransition();   // drawn live: whatever is fading in is superseded
         gfx->draw16bitRGBBitmap(x, y, bitmap, w, h);
     }
 }
 
+bool DisplayManager::beginCompose() {
+    if (composing) return true;
+    endTransition();
+    uint16_t* fb = gfx ? gfx->getFramebuffer() : nullptr;
+    if (!backBuffer || !fb || !ppaAccelerator.isAvailable()) return false;
+
+    // Start from what is on screen: text or overlays drawn live since the
+    // last frame stay, and the renderer only redraws what changed. The panel
+    // is only read, so this copy can't show.
+    RenderRect written;
+    if (!ppaAccelerator.scaleRotateToFramebuffer(fb, displayWidth, displayHeight, backBuffer,
+                                                 displayWidth, displayHeight, 0, 0,
+                                                 displayWidth, displayHeight, presentRotation, &written)) {
+        return false;
+    }
+    composing = true;
+    return true;
+}
+
+void DisplayManager::present(bool transition) {
+    if (!composing) return;
+    composing = false;
+    if (transition && startTransition()) return;
+    copyToPanel();
+}
+
+void DisplayManager::copyToPanel() {
+    uint16_t* fb = gfx ? gfx->getFramebuffer() : nullptr;
+    if (!fb) return;
+
+    // One PPA pass puts the frame up while the panel scans: at most one
+    // refresh shows a tear, instead of every refresh for as long as the
+    // frame took to compose
+    int64_t start = esp_timer_get_time();
+    RenderRect written;
+    if (!ppaAccelerator.scaleRotateToFramebuffer(backBuffer, displayWidth, displayHeight, fb,
+                                                 displayWidth, displayHeight, 0, 0,
+                                                 displayWidth, displayHeight, presentRotation, &written)) {
+        gfx->draw16bitRGBBitmap(0, 0, backBuffer, displayWidth, displayHeight);
+    }
+    lastPresentCopyUs = (uint32_t)(esp_timer_get_time() - start);
+
+    // Visible once the panel has scanned it: within a refresh of the copy
+    // finishing
+    uint32_t visibleUs = lastPresentCopyUs + framePeriodUs;
+    if (visibleUs > maxPresentUs) maxPresentUs = visibleUs;
+    LOG_DEBUG_F("[Display] Present: copy %lu us, visible within %lu us (max %lu us)\n",
+                (unsigned long)lastPresentCopyUs, (unsigned long)visibleUs, (unsigned long)maxPresentUs);
+}
+
+bool DisplayManager::startTransition() {
+    if (!transitionTask || !gfx || !gfx->getFramebuffer()) return false;
+    transitionFrame = backBuffer;
+    if (TRANSITION_MODE == TRANSITION_FADE && presentRotation != 0.0f) {
+        RenderRect written;
+        if (!ppaAccelerator.scaleRotateToFramebuffer(backBuffer, displayWidth, displayHeight, transitionBuffer,
+                                                     displayWidth, displayHeight, 0, 0,
+                                                     displayWidth, displayHeight, presentRotation, &written)) {
+            return false;
+        }
+        transitionFrame = transitionBuffer;
+    }
+    // Idle is free here: beginCompose() waited for the last transition
+    if (xSemaphoreTake(transitionIdle, 0) != pdTRUE) return false;
+    transitionAbort = false;
+    xSemaphoreGive(transitionStart);
+    return true;
+}
+
+void DisplayManager::endTransition() {
+    if (!transitionTask || !transitionIdle) return;
+    transitionAbort = true;
+    xSemaphoreTake(transitionIdle, portMAX_DELAY);
+    xSemaphoreGive(transitionIdle);
+}
+
+void DisplayManager::transitionTaskEntry(void* param) {
+    DisplayManager* self = (DisplayManager*)param;
+    for (;;) {
+        xSemaphoreTake(self->transitionStart, portMAX_DELAY);
+        self->runTransition();
+        xSemaphoreGive(self->transitionIdle);
+    }
+}
+
+void DisplayManager::runTransition() {
+    uint16_t* fb = gfx->getFramebuffer();
+    const int steps = transitionSteps(TRANSITION_DURATION_MS, TRANSITION_FPS);
+    const uint32_t budgetUs = 1000000 / TRANSITION_FPS;
+    TickType_t period = pdMS_TO_TICKS(1000 / TRANSITION_FPS);
+    if (period < 1) period = 1;
+
+    int64_t start = esp_timer_get_time();
+    TickType_t wake = xTaskGetTickCount();
+    uint64_t totalStepUs = 0;
+    uint32_t maxStepUs = 0;
+    int done = 0;
+    const char* cut = nullptr;
+    for (int step = 1; step <= steps; step++) {
+        if (transitionAbort) {
+            cut = "next frame";
+            break;
+        }
+        int64_t stepStart = esp_timer_get_time();
+        bool ok;
+        if (TRANSITION_MODE == TRANSITION_SLIDE) {
+            // The new frame moves in over the old one from the right (in
+            // GFX coordinates; mirrored on a panel turned 180°)
+            int offset = transitionSlideOffset(step, steps, displayWidth);
+            RenderRect written;
+            ok = ppaAccelerator.scaleRotateToFramebuffer(backBuffer, displayWidth, displayHeight, fb,
+                                                         displayWidth, displayHeight,
+                                                         presentRotation != 0.0f ? -offset : offset, 0,
+                                                         displayWidth, displayHeight, presentRotation, &written);
+        } else {
+            ok = ppaAccelerator.blendFramebuffer(transitionFrame, fb, displayWidth, displayHeight,
+                                                 transitionFadeAlpha(step, steps));
+        }
+        uint32_t stepUs = (uint32_t)(esp_timer_get_time() - stepStart);
+        totalStepUs += stepUs;
+        if (stepUs > maxStepUs) maxStepUs = stepUs;
+        done++;
+        if (!ok) {
+            cut = "PPA refused";
+            break;
+        }
+        if (stepUs > budgetUs && step < steps) {
+            cut = "over frame budget";
+            break;
+        }
+        if (step < steps) vTaskDelayUntil(&wake, period);
+    }
+    // Cut short: the rest in one go
+    if (cut) copyToPanel();
+
+    LOG_INFO_F("[Display] Transition: %d/%d frames, step avg %lu us max %lu us (budget %lu us), %lu ms%s%s\n",
+               done, steps, (unsigned long)(done ? totalStepUs / done : 0), (unsigned long)maxStepUs,
+               (unsigned long)budgetUs, (unsigned long)((esp_timer_get_time() - start) / 1000),
+               cut ? ", instant swap: " : "", cut ? cut : "");
+}
+
+uint16_t* DisplayManager::drawTarget() const {
+    if (composing) return backBuffer;
+    if (gfx && gfx->getRotation() == 0) return gfx->getFramebuffer();
+    return nullptr;
+}
+
 void DisplayManager::pauseDisplay() {
     // Pause display rendering to prevent memory bandwidth conflicts during heavy PSRAM operations
     _paused = true;
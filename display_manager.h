@@ -34,6 +34,31 @@ private:
     // Pause flag to prevent rendering during heavy PSRAM operations
     bool _paused;
 
+    // Double-buffered presentation (DISPLAY_DOUBLE_BUFFER): frames are
+    // composed in backBuffer, in the GFX's (rotated) coordinates, and copied
+    // to the panel framebuffer in one PPA pass
+    uint16_t* backBuffer;
+    bool composing;
+    float presentRotation;        // PPA turn from backBuffer to the panel's order
+    uint32_t framePeriodUs;       // one DPI refresh
+    uint32_t lastPresentCopyUs;
+    uint32_t maxPresentUs;        // longest request-to-visible so far
+
+    // Image-change transition (TRANSITION_MODE): present(true) hands the
+    // frame to transitionTask, beginCompose() ends a running one first
+    TaskHandle_t transitionTask;
+    SemaphoreHandle_t transitionStart;    // frame handed over
+    SemaphoreHandle_t transitionIdle;     // held while a transition runs
+    volatile bool transitionAbort;
+    uint16_t* transitionBuffer;           // incoming frame turned to panel order (rotated panels)
+    const uint16_t* transitionFrame;      // what the cross-fade blends in
+
+    void copyToPanel();
+    bool startTransition();
+    void endTransition();
+    void runTransition();
+    static void transitionTaskEntry(void* param);
+
 public:
     DisplayManager();
     ~DisplayManager();
@@ -64,6 +89,25 @@ public:
     void clearScreen(uint16_t color = COLOR_BLACK);
     void drawBitmap(int16_t x, int16_t y, uint16_t* bitmap, int16_t w, int16_t h);
     
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+
+    // Off-screen composition. beginCompose() starts a frame in the back
+    // buffer, holding what is on screen now; clearScreen(), fillRect() and
+    // drawBitmap() then draw there, and present() puts the whole frame on the
+    // panel at once. False (and everything drawn live, as without it) when
+    // there is no back buffer or no PPA.
+    // present(true) fades or slides the frame in (TRANSITION_MODE) instead;
+    // the next beginCompose() cuts a transition still running short.
+    bool beginCompose();
+    void present(bool transition = false);
+    bool isComposing() const { return composing; }
+    // Buffer in GFX coordinates the PPA may draw a frame into: the back
+    // buffer while composing, else the panel framebuffer if unrotated, else
+    // nullptr
+    uint16_t* drawTarget() const;
+    uint32_t getLastPresentUs() const { return lastPresentCopyUs + framePeriodUs; }
+    uint32_t getMaxPresentUs() const { return maxPresentUs; }
+
     // Display pause/resume to prevent memory bandwidth conflicts
     void pauseDisplay();
     void resumeDisplay();
@@ -0,0 +1,149 @@
+#include "frame_cache_policy.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+FrameCachePolicy::FrameCachePolicy() : numSlots(0) {
+    reset(0);
+}
+
+void FrameCachePolicy::reset(int n) {
+    if (n < 0) n = 0;
+    if (n > FRAME_CACHE_MAX_SLOTS) n = FRAME_CACHE_MAX_SLOTS;
+    numSlots = n;
+    memset(slots, 0, sizeof(slots));
+    for (int i = 0; i < FRAME_CACHE_MAX_SLOTS; i++) slots[i].sourceIndex = -1;
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool FrameCachePolicy::isFresh(int slot, uint32_t now) const {
+    if (!valid(slot) || !slots[slot].used) return false;
+    return (uint32_t)(now - slots[slot].fetchedAt) < slots[slot].ttlMs;
+}
+
+int FrameCachePolicy::find(int sourceIndex, uint32_t urlHash) const {
+    for (int i = 0; i < numSlots; i++) {
+        if (slots[i].used && slots[i].sourceIndex == sourceIndex && slots[i].urlHash == urlHash) return i;
+    }
+    return -1;
+}
+
+int FrameCachePolicy::findFresh(int sourceIndex, uint32_t urlHash, uint32_t now) const {
+    int i = find(sourceIndex, urlHash);
+    return isFresh(i, now) ? i : -1;
+}
+
+int FrameCachePolicy::lookup(int sourceIndex, uint32_t urlHash, uint32_t now) {
+    int i = find(sourceIndex, urlHash);
+    if (i >= 0 && !isFresh(i, now)) {
+        stats.expirations++;
+        release(i);
+        i = -1;
+    }
+    if (i < 0) {
+        stats.misses++;
+        return -1;
+    }
+    stats.hits++;
+    slots[i].lastUsed = now;
+    return i;
+}
+
+int FrameCachePolicy::victim(uint32_t now, int protect) {
+    int expired = -1, lru = -1;
+    for (int i = 0; i < numSlots; i++) {
+        if (i == protect) continue;
+        if (!slots[i].used) return i;
+        if (!isFresh(i, now)) {
+            if (expired < 0) expired = i;
+        } else if (lru < 0 || (int32_t)(slots[i].lastUsed - slots[lru].lastUsed) < 0) {
+            lru = i;
+        }
+    }
+    if (expired >= 0) {
+        stats.expirations++;
+        release(expired);
+        return expired;
+    }
+    if (lru >= 0) {
+        stats.evictions++;
+        release(lru);
+    }
+    return lru;
+}
+
+void FrameCachePolicy::commit(int slot, int sourceIndex, uint32_t urlHash, size_t bytes,
+                              uint32_t fetchedAt, uint32_t ttlMs, uint32_t now) {
+    if (!valid(slot)) return;
+    for (int i = 0; i < numSlots; i++) {
+        if (i != slot && slots[i].used && slots[i].sourceIndex == sourceIndex) release(i);
+    }
+    release(slot);
+    Entry& e = slots[slot];
+    e.used = true;
+    e.sourceIndex = sourceIndex;
+    e.urlHash = urlHash;
+    e.bytes = bytes;
+    e.fetchedAt = fetchedAt;
+    e.ttlMs = ttlMs;
+    e.lastUsed = now;
+    stats.entries++;
+    stats.bytesHeld += bytes;
+}
+
+void FrameCachePolicy::refresh(int slot, uint32_t fetchedAt) {
+    if (valid(slot) && slots[slot].used) slots[slot].fetchedAt = fetchedAt;
+}
+
+void FrameCachePolicy::release(int slot) {
+    if (!valid(slot) || !slots[slot].used) return;
+    stats.entries--;
+    stats.bytesHeld -= slots[slot].bytes;
+    memset(&slots[slot], 0, sizeof(Entry));
+    slots[slot].sourceIndex = -1;
+}
+
+void FrameCachePolicy::removeSource(int sourceIndex) {
+    for (int i = 0; i < numSlots; i++) {
+        if (slots[i].used && slots[i].sourceIndex == sourceIndex) release(i);
+    }
+}
+
+const FrameCachePolicy::Entry* FrameCachePolicy::entry(int slot) const {
+    return (valid(slot) && slots[slot].used) ? &slots[slot] : nullptr;
+}
+
+FrameCacheStats FrameCachePolicy::getStats() const {
+    return stats;
+}
+
+uint32_t FrameCachePolicy::hashUrl(const char* url) {
+    uint32_t h = 2166136261u;
+    for (; url && *url; url++) {
+        h ^= (uint8_t)*url;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+long cacheControlMaxAge(const char* header) {
+    if (!header) return -1;
+    long maxAge = -1;
+    const char* p = header;
+    while (*p) {
+        while (*p == ' ' || *p == ',' || *p == '\t') p++;
+        const char* tok = p;
+        while (*p && *p != ',') p++;
+        size_t n = (size_t)(p - tok);
+
+        if (n >= 8 && strncasecmp(tok, "no-cache", 8) == 0) return 0;
+        if (n >= 8 && strncasecmp(tok, "no-store", 8) == 0) return 0;
+        if (n > 8 && strncasecmp(tok, "max-age=", 8) == 0) {
+            const char* v = tok + 8;
+            if (*v == '"') v++;
+            if (isdigit((unsigned char)*v)) maxAge = strtol(v, nullptr, 10);
+        }
+    }
+    return maxAge;
+}
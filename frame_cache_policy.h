@@ -0,0 +1,91 @@
+#pragma once
+#ifndef FRAME_CACHE_POLICY_H
+#define FRAME_CACHE_POLICY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// DECODED-FRAME CACHE POLICY
+// =============================================================================
+// Bookkeeping for the PSRAM frame cache (frame_slots.h): which slot holds the
+// frame for which (source index, URL), when it was fetched, how long it stays
+// fresh and which slot to give up next. Holds no pixels and no Arduino / IDF
+// types so it can be unit-tested on the host (test/test_frame_cache_policy.cpp).
+//
+// Victim order: a free slot, else an expired entry, else the least recently
+// used one. Times are millis()-style uint32_t and may wrap.
+
+#define FRAME_CACHE_MAX_SLOTS 16
+
+struct FrameCacheStats {
+    uint32_t hits;          // lookup() found a fresh frame
+    uint32_t misses;        // lookup() found nothing, or only a stale frame
+    uint32_t evictions;     // fresh frames dropped to make room
+    uint32_t expirations;   // stale frames dropped (lookup or reuse)
+    uint32_t entries;       // slots currently holding a frame
+    size_t bytesHeld;       // RGB565 bytes of the frames held
+};
+
+class FrameCachePolicy {
+public:
+    struct Entry {
+        bool used;
+        int sourceIndex;
+        uint32_t urlHash;
+        size_t bytes;
+        uint32_t fetchedAt;
+        uint32_t ttlMs;
+        uint32_t lastUsed;
+    };
+
+    FrameCachePolicy();
+
+    // Forget everything and manage `slots` slots (capped at FRAME_CACHE_MAX_SLOTS)
+    void reset(int slots);
+    int capacity() const { return numSlots; }
+
+    // Slot holding a fresh frame for the key, or -1. Counts a hit or a miss;
+    // a stale entry found here is dropped. A hit marks the slot as used.
+    int lookup(int sourceIndex, uint32_t urlHash, uint32_t now);
+
+    // Same, without touching statistics or recency
+    int findFresh(int sourceIndex, uint32_t urlHash, uint32_t now) const;
+    // Slot holding a frame for the key whether fresh or not, or -1
+    int find(int sourceIndex, uint32_t urlHash) const;
+
+    // Slot to store a new frame in (free > expired > least recently used).
+    // Whatever it held is dropped. `protect` is never chosen. -1 if none.
+    int victim(uint32_t now, int protect = -1);
+
+    // Record that `slot` now holds this frame. Any other slot holding a frame
+    // of the same source is released, so a source never has two cached.
+    void commit(int slot, int sourceIndex, uint32_t urlHash, size_t bytes,
+                uint32_t fetchedAt, uint32_t ttlMs, uint32_t now);
+
+    // Extend an entry's freshness (a 304 or identical body for its source)
+    void refresh(int slot, uint32_t fetchedAt);
+
+    void release(int slot);
+    void removeSource(int sourceIndex);
+
+    bool isFresh(int slot, uint32_t now) const;
+    const Entry* entry(int slot) const;
+    FrameCacheStats getStats() const;
+
+    // FNV-1a over a string, used as the URL part of the key
+    static uint32_t hashUrl(const char* url);
+
+private:
+    bool valid(int slot) const { return slot >= 0 && slot < numSlots; }
+
+    Entry slots[FRAME_CACHE_MAX_SLOTS];
+    int numSlots;
+    FrameCacheStats stats;
+};
+
+// Freshness lifetime from a response's Cache-Control header: max-age in
+// seconds, or -1 when absent (also for no-cache / no-store, which give 0).
+long cacheControlMaxAge(const char* header);
+
+#endif // FRAME_CACHE_POLICY_H
@@ -0,0 +1,125 @@
+#include "frame_slots.h"
+#include "logging.h"
+#include "esp_heap_caps.h"
+
+// Global instance
+FrameSlotPool frameSlots;
+
+FrameSlotPool::FrameSlotPool() : slotBytes(0), budgetBytes(0) {
+    for (int i = 0; i < FRAME_CACHE_MAX_SLOTS; i++) {
+        slots[i].pixels = nullptr;
+        slots[i].width = 0;
+        slots[i].height = 0;
+        slots[i].layout = { 0, 0, 0, 0, 1, 1.0f, 1.0f, 0 };
+    }
+}
+
+int FrameSlotPool::begin(size_t bytes, size_t budget, size_t psramReserve) {
+    slotBytes = bytes;
+    budgetBytes = budget;
+    int maxSlots = bytes > 0 ? (int)(budget / bytes) : 0;
+    if (maxSlots > FRAME_CACHE_MAX_SLOTS) maxSlots = FRAME_CACHE_MAX_SLOTS;
+
+    int n = 0;
+    while (n < maxSlots) {
+        size_t freePsram = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+        if (freePsram < bytes + psramReserve) {
+            LOG_DEBUG_F("[FrameCache] Stopping at %d slot(s): %u bytes PSRAM free, reserve %u\n",
+                        n, (unsigned)freePsram, (unsigned)psramReserve);
+            break;
+        }
+        uint16_t* buf = (uint16_t*)heap_caps_aligned_alloc(64, bytes, MALLOC_CAP_DMA | MALLOC_CAP_SPIRAM);
+        if (!buf) break;
+        slots[n].pixels = buf;
+        n++;
+    }
+    policy.reset(n);
+
+    LOG_INFO_F("[FrameCache] %d frame slot(s) of %u KB (budget %u KB, PSRAM free after: %u KB)\n",
+               n, (unsigned)(bytes / 1024), (unsigned)(budget / 1024),
+               (unsigned)(heap_caps_get_free_size(MALLOC_CAP_SPIRAM) / 1024));
+    return n;
+}
+
+int FrameSlotPool::lookup(int sourceIndex, const String& url) {
+    if (count() == 0) return -1;
+    return policy.lookup(sourceIndex, FrameCachePolicy::hashUrl(url.c_str()), millis());
+}
+
+bool FrameSlotPool::hasFresh(int sourceIndex, const String& url) const {
+    return policy.findFresh(sourceIndex, FrameCachePolicy::hashUrl(url.c_str()), millis()) >= 0;
+}
+
+bool FrameSlotPool::holds(int sourceIndex, const String& url) const {
+    return policy.find(sourceIndex, FrameCachePolicy::hashUrl(url.c_str())) >= 0;
+}
+
+bool FrameSlotPool::store(int sourceIndex, const String& url, uint32_t fetched, uint32_t ttlMs,
+                          uint16_t*& pixels, int16_t& width, int16_t& height, FrameLayout& layout) {
+    int slot = policy.victim(millis());
+    if (slot < 0) return false;
+    exchange(slot, pixels, width, height, layout);
+    commit(slot, sourceIndex, url, fetched, ttlMs);
+    return true;
+}
+
+void FrameSlotPool::exchange(int slot, uint16_t*& pixels, int16_t& width, int16_t& height,
+                             FrameLayout& layout) {
+    FrameSlot* s = at(slot);
+    if (!s) return;
+
+    uint16_t* p = s->pixels;
+    s->pixels = pixels;
+    pixels = p;
+
+    int16_t w = s->width;
+    s->width = width;
+    width = w;
+
+    int16_t h = s->height;
+    s->height = height;
+    height = h;
+
+    FrameLayout l = s->layout;
+    s->layout = layout;
+    layout = l;
+}
+
+void FrameSlotPool::commit(int slot, int sourceIndex, const String& url, uint32_t fetched, uint32_t ttlMs) {
+    FrameSlot* s = at(slot);
+    if (!s) return;
+    s->url = url;
+    policy.commit(slot, sourceIndex, FrameCachePolicy::hashUrl(url.c_str()),
+                  (size_t)s->width * s->height * sizeof(uint16_t), fetched, ttlMs, millis());
+}
+
+void FrameSlotPool::release(int slot) {
+    FrameSlot* s = at(slot);
+    if (!s) return;
+    s->url = "";
+    policy.release(slot);
+}
+
+void FrameSlotPool::refreshSource(int sourceIndex, uint32_t fetched) {
+    for (int i = 0; i < count(); i++) {
+        const FrameCachePolicy::Entry* e = policy.entry(i);
+        if (e && e->sourceIndex == sourceIndex) policy.refresh(i, fetched);
+    }
+}
+
+void FrameSlotPool::removeSource(int sourceIndex) {
+    for (int i = 0; i < count(); i++) {
+        const FrameCachePolicy::Entry* e = policy.entry(i);
+        if (e && e->sourceIndex == sourceIndex) release(i);
+    }
+}
+
+uint32_t FrameSlotPool::fetchedAt(int slot) const {
+    const FrameCachePolicy::Entry* e = policy.entry(slot);
+    return e ? e->fetchedAt : 0;
+}
+
+uint32_t FrameSlotPool::ttl(int slot) const {
+    const FrameCachePolicy::Entry* e = policy.entry(slot);
+    return e ? e->ttlMs : 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef FRAME_SLOTS_H
+#define FRAME_SLOTS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "frame_cache_policy.h"
+#include "render_geometry.h"
+
+// =============================================================================
+// PSRAM CACHE OF DECODED FRAMES
+// =============================================================================
+// Extra RGB565 frame buffers alongside fullImageBuffer (on screen) and
+// pendingFullImageBuffer (decode target), keyed by image source index + URL.
+// A slot holds either a frame prefetched for the next cycling source or one
+// that was on screen earlier and is still fresh, so coming back to a source
+// within its TTL is a pointer exchange instead of a download and decode.
+//
+// All buffers are the same size (the image buffer size, 64-byte aligned,
+// DMA-capable), so a slot can trade its buffer with the active or pending
+// buffer without copying. The number of slots follows FRAME_CACHE_PSRAM_BUDGET
+// and is further limited so PSRAM never drops below FRAME_SLOT_PSRAM_RESERVE.
+// Which slot to give up is decided by FrameCachePolicy.
+//
+// Every method except begin() and getStats() must be called with
+// imageBufferMutex held: the download task and loop() both use the slots.
+
+struct FrameSlot {
+    uint16_t* pixels;
+    int16_t width;       // stored pixels (the visible crop for a cropped frame)
+    int16_t height;
+    FrameLayout layout;  // as fullImageLayout
+    String url;
+};
+
+class FrameSlotPool {
+public:
+    FrameSlotPool();
+
+    // Allocate slots of slotBytes until budgetBytes is used up or one more
+    // would leave less than psramReserve bytes of PSRAM free.
+    int begin(size_t slotBytes, size_t budgetBytes, size_t psramReserve);
+
+    int count() const { return policy.capacity(); }
+    size_t slotSize() const { return slotBytes; }
+    size_t budget() const { return budgetBytes; }
+    FrameSlot* at(int i) { return (i >= 0 && i < count()) ? &slots[i] : nullptr; }
+
+    // Slot with a fresh frame for this source and URL, or -1. Counts toward
+    // the hit rate, so call it once per source switch.
+    int lookup(int sourceIndex, const String& url);
+
+    // Whether a fresh frame is cached (no statistics)
+    bool hasFresh(int sourceIndex, const String& url) const;
+    // Whether any frame is cached, fresh or not: its validators can still be
+    // used for a conditional GET that renews it
+    bool holds(int sourceIndex, const String& url) const;
+
+    // Park a decoded frame: its buffer is traded with a victim slot's, so the
+    // caller gets a spare buffer back. Returns false if there are no slots.
+    bool store(int sourceIndex, const String& url, uint32_t fetchedAt, uint32_t ttlMs,
+               uint16_t*& pixels, int16_t& width, int16_t& height, FrameLayout& layout);
+
+    // Trade a slot's frame with the caller's. Follow with commit() to key the
+    // frame the slot now holds, or release() to drop it.
+    void exchange(int slot, uint16_t*& pixels, int16_t& width, int16_t& height, FrameLayout& layout);
+    void commit(int slot, int sourceIndex, const String& url, uint32_t fetchedAt, uint32_t ttlMs);
+    void release(int slot);
+
+    // A 304 / identical body confirmed the source's cached frame is current
+    void refreshSource(int sourceIndex, uint32_t fetchedAt);
+    void removeSource(int sourceIndex);
+
+    uint32_t fetchedAt(int slot) const;
+    uint32_t ttl(int slot) const;
+
+    FrameCacheStats getStats() const { return policy.getStats(); }
+
+private:
+    FrameSlot slots[FRAME_CACHE_MAX_SLOTS];
+    FrameCachePolicy policy;
+    size_t slotBytes;
+    size_t budgetBytes;
+};
+
+// Global instance
+extern FrameSlotPool frameSlots;
+
+#endif // FRAME_SLOTS_H
@@ -0,0 +1,198 @@
+#include "http_pool.h"
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+bool httpParseEndpoint(const char* url, HttpEndpoint* ep) {
+    if (!url || !ep) return false;
+    const char* p;
+    if (strncasecmp(url, "http://", 7) == 0) {
+        ep->secure = false;
+        ep->port = 80;
+        p = url + 7;
+    } else if (strncasecmp(url, "https://", 8) == 0) {
+        ep->secure = true;
+        ep->port = 443;
+        p = url + 8;
+    } else {
+        return false;
+    }
+
+    // Skip any user:password@ part of the authority
+    const char* end = p + strcspn(p, "/?#");
+    const char* at = (const char*)memchr(p, '@', end - p);
+    if (at) p = at + 1;
+
+    const char* colon = (const char*)memchr(p, ':', end - p);
+    const char* hostEnd = colon ? colon : end;
+    size_t n = (size_t)(hostEnd - p);
+    if (n == 0 || n >= HTTP_POOL_HOST_MAX) return false;
+    for (size_t i = 0; i < n; i++) ep->host[i] = (char)tolower((unsigned char)p[i]);
+    ep->host[n] = '\0';
+
+    if (colon) {
+        long port = 0;
+        const char* d = colon + 1;
+        if (d == end) return false;
+        for (; d < end; d++) {
+            if (!isdigit((unsigned char)*d)) return false;
+            port = port * 10 + (*d - '0');
+            if (port > 65535) return false;
+        }
+        if (port == 0) return false;
+        ep->port = (uint16_t)port;
+    }
+    return true;
+}
+
+bool httpEndpointEqual(const HttpEndpoint& a, const HttpEndpoint& b) {
+    return a.secure == b.secure && a.port == b.port && strcmp(a.host, b.host) == 0;
+}
+
+HttpConnectionPool::HttpConnectionPool(PooledTransportFactory factory, void* ctx,
+                                       uint32_t idleTimeoutMs, uint16_t maxRequests)
+    : makeTransport(factory), factoryCtx(ctx), idleTimeout(idleTimeoutMs),
+      maxRequestsPerConnection(maxRequests) {
+    memset(entries, 0, sizeof(entries));
+    memset(&stats, 0, sizeof(stats));
+    memset(&last, 0, sizeof(last));
+    lastHostName[0] = '\0';
+}
+
+HttpConnectionPool::~HttpConnectionPool() {
+    for (int i = 0; i < HTTP_POOL_MAX_ENTRIES; i++) {
+        if (entries[i].transport) {
+            entries[i].transport->stop();
+            delete entries[i].transport;
+        }
+    }
+}
+
+void HttpConnectionPool::closeEntry(Entry& e) {
+    if (e.open) stats.openConnections--;
+    e.open = false;
+    e.requests = 0;
+    if (e.transport) e.transport->stop();
+}
+
+bool HttpConnectionPool::acquire(const HttpEndpoint& ep, uint32_t now, HttpLease* lease) {
+    int match = -1, freeSlot = -1, lru = -1;
+    for (int i = 0; i < HTTP_POOL_MAX_ENTRIES; i++) {
+        Entry& e = entries[i];
+        if (!e.used) {
+            if (freeSlot < 0) freeSlot = i;
+        } else if (httpEndpointEqual(e.ep, ep)) {
+            match = i;
+        } else if (!e.leased && (lru < 0 || (int32_t)(e.lastUsed - entries[lru].lastUsed) < 0)) {
+            lru = i;
+        }
+    }
+
+    if (match >= 0) {
+        Entry& e = entries[match];
+        if (e.leased) return false;
+        bool reusable = false;
+        if (e.open) {
+            if ((uint32_t)(now - e.lastUsed) >= idleTimeout) {
+                stats.closedIdle++;
+            } else if (maxRequestsPerConnection && e.requests >= maxRequestsPerConnection) {
+                stats.notReusable++;
+            } else if (!e.transport->connected()) {
+                stats.closedByPeer++;
+            } else {
+                reusable = true;
+            }
+            if (!reusable) closeEntry(e);
+        }
+        e.leased = true;
+        lease->slot = match;
+        lease->transport = e.transport;
+        lease->reused = reusable;
+        return true;
+    }
+
+    int slot = freeSlot;
+    if (slot < 0 && lru >= 0) {
+        // Another host takes the least recently used entry
+        Entry& e = entries[lru];
+        if (e.open) stats.evicted++;
+        closeEntry(e);
+        delete e.transport;
+        e.transport = nullptr;
+        e.used = false;
+        slot = lru;
+    }
+    if (slot < 0 || !makeTransport) return false;
+
+    PooledTransport* t = makeTransport(ep, factoryCtx);
+    if (!t) return false;
+    Entry& e = entries[slot];
+    e.used = true;
+    e.leased = true;
+    e.open = false;
+    e.ep = ep;
+    e.transport = t;
+    e.requests = 0;
+    e.lastUsed = now;
+    lease->slot = slot;
+    lease->transport = t;
+    lease->reused = false;
+    return true;
+}
+
+void HttpConnectionPool::release(const HttpLease& lease, bool keepAlive, uint32_t now,
+                                 const HttpFetchTiming& timing) {
+    if (lease.slot < 0 || lease.slot >= HTTP_POOL_MAX_ENTRIES) return;
+    Entry& e = entries[lease.slot];
+    if (!e.used || !e.leased) return;
+    e.leased = false;
+    e.lastUsed = now;
+
+    stats.fetches++;
+    if (lease.reused) {
+        stats.reused++;
+    } else {
+        stats.opened++;
+        stats.connectMsTotal += timing.connectMs;
+    }
+    stats.responseMsTotal += timing.responseMs;
+    stats.bodyMsTotal += timing.bodyMs;
+    last = timing;
+    last.reused = lease.reused;
+    strncpy(lastHostName, e.ep.host, sizeof(lastHostName) - 1);
+    lastHostName[sizeof(lastHostName) - 1] = '\0';
+
+    bool wasOpen = e.open;
+    if (keepAlive && e.transport->connected()) {
+        e.requests = lease.reused ? e.requests + 1 : 1;
+        e.open = true;
+        if (!wasOpen) stats.openConnections++;
+    } else {
+        if (!keepAlive) stats.notReusable++;
+        else stats.closedByPeer++;
+        closeEntry(e);
+    }
+}
+
+int HttpConnectionPool::closeIdle(uint32_t now) {
+    int closed = 0;
+    for (int i = 0; i < HTTP_POOL_MAX_ENTRIES; i++) {
+        Entry& e = entries[i];
+        if (e.used && e.open && !e.leased && (uint32_t)(now - e.lastUsed) >= idleTimeout) {
+            closeEntry(e);
+            stats.closedIdle++;
+            closed++;
+        }
+    }
+    return closed;
+}
+
+void HttpConnectionPool::closeAll() {
+    for (int i = 0; i < HTTP_POOL_MAX_ENTRIES; i++) {
+        if (entries[i].used && !entries[i].leased) closeEntry(entries[i]);
+    }
+}
+
+HttpPoolStats HttpConnectionPool::getStats() const {
+    return stats;
+}
@@ -0,0 +1,122 @@
+#pragma once
+#ifndef HTTP_POOL_H
+#define HTTP_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// PER-HOST KEEP-ALIVE CONNECTION POOL
+// =============================================================================
+// Keeps one open connection per (scheme, host, port) between image fetches so
+// repeated downloads from the same server skip the TCP connect and, for https,
+// the TLS handshake. The pool only decides which connection a fetch uses and
+// when to close one; connecting and the HTTP exchange belong to the caller's
+// transport (HTTPClient + WiFiClient / WiFiClientSecure on the device, POSIX
+// sockets and OpenSSL in test/test_http_pool.cpp). No Arduino / IDF types.
+//
+// A kept connection is reused only while the transport still reports it
+// connected, it has been idle for less than the idle timeout and it has served
+// fewer than maxRequests fetches. Otherwise it is closed and reopened.
+
+#define HTTP_POOL_MAX_ENTRIES 4
+#define HTTP_POOL_HOST_MAX 64
+
+struct HttpEndpoint {
+    bool secure;                    // https
+    uint16_t port;
+    char host[HTTP_POOL_HOST_MAX];  // lower-cased
+};
+
+// Split "http[s]://host[:port]/..." into an endpoint. False for other schemes,
+// missing / oversized hosts and bad ports.
+bool httpParseEndpoint(const char* url, HttpEndpoint* ep);
+bool httpEndpointEqual(const HttpEndpoint& a, const HttpEndpoint& b);
+
+// A connection the pool can hold on to between fetches
+class PooledTransport {
+public:
+    virtual ~PooledTransport() {}
+    virtual bool connected() = 0;   // still open (no FIN / error seen)
+    virtual void stop() = 0;        // close; the object stays reusable
+};
+
+// Creates the transport for a new pool entry (plain or TLS by ep.secure)
+typedef PooledTransport* (*PooledTransportFactory)(const HttpEndpoint& ep, void* ctx);
+
+// Where one fetch spent its time
+struct HttpFetchTiming {
+    bool reused;           // went out on a kept-alive connection
+    uint32_t connectMs;    // TCP connect + TLS handshake (0 when reused)
+    uint32_t responseMs;   // request sent until response headers parsed
+    uint32_t bodyMs;       // body transfer (and any overlapped decode)
+    size_t bytes;          // body bytes received
+};
+
+struct HttpPoolStats {
+    uint32_t fetches;         // leases released
+    uint32_t reused;          // fetches on a kept-alive connection
+    uint32_t opened;          // fetches that needed a new connection
+    uint32_t closedIdle;      // closed after the idle timeout
+    uint32_t closedByPeer;    // found closed by the server when reused
+    uint32_t evicted;         // closed to make room for another host
+    uint32_t notReusable;     // response or transfer ruled out keep-alive
+    uint32_t connectMsTotal;  // summed over fetches that opened a connection
+    uint32_t responseMsTotal;
+    uint32_t bodyMsTotal;
+    uint32_t openConnections; // currently kept open
+};
+
+struct HttpLease {
+    int slot;
+    PooledTransport* transport;
+    bool reused;              // transport is already connected to the endpoint
+};
+
+class HttpConnectionPool {
+public:
+    HttpConnectionPool(PooledTransportFactory factory, void* ctx,
+                       uint32_t idleTimeoutMs, uint16_t maxRequests);
+    ~HttpConnectionPool();
+
+    // Connection for the endpoint. lease->reused tells whether it is already
+    // connected; otherwise the caller connects it. False when every entry is
+    // leased or the factory fails - fetch without the pool then.
+    bool acquire(const HttpEndpoint& ep, uint32_t now, HttpLease* lease);
+
+    // The fetch is over. keepAlive: the server allowed reuse and the body was
+    // read to its exact end, so the connection can carry the next request.
+    void release(const HttpLease& lease, bool keepAlive, uint32_t now, const HttpFetchTiming& timing);
+
+    // Close connections idle for longer than the idle timeout; returns how many
+    int closeIdle(uint32_t now);
+    void closeAll();
+
+    HttpPoolStats getStats() const;
+    const HttpFetchTiming& lastFetch() const { return last; }
+    const char* lastHost() const { return lastHostName; }
+
+private:
+    struct Entry {
+        bool used;            // has a transport for `ep`
+        bool leased;
+        bool open;            // kept connected after the last fetch
+        HttpEndpoint ep;
+        PooledTransport* transport;
+        uint32_t lastUsed;
+        uint16_t requests;    // fetches on the current connection
+    };
+
+    void closeEntry(Entry& e);
+
+    Entry entries[HTTP_POOL_MAX_ENTRIES];
+    PooledTransportFactory makeTransport;
+    void* factoryCtx;
+    uint32_t idleTimeout;
+    uint16_t maxRequestsPerConnection;
+    HttpPoolStats stats;
+    HttpFetchTiming last;
+    char lastHostName[HTTP_POOL_HOST_MAX];
+};
+
+#endif // HTTP_POOL_H
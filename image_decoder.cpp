@@ -0,0 +1,104 @@
+#include "image_decoder.h"
+#include <string.h>
+
+bool jpegParseHeader(const uint8_t* data, size_t len, JpegHeaderInfo* info) {
+    if (!data || len < 4 || data[0] != 0xFF || data[1] != 0xD8) return false;
+
+    size_t pos = 2;
+    while (pos + 4 <= len) {
+        if (data[pos] != 0xFF) return false;
+        uint8_t marker = data[pos + 1];
+        if (marker == 0xFF) { pos++; continue; }                 // fill byte
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            pos += 2;                                            // standalone markers
+            continue;
+        }
+        if (marker == 0xD9 || marker == 0xDA) return false;      // EOI / SOS before any SOF
+
+        size_t segLen = ((size_t)data[pos + 2] << 8) | data[pos + 3];
+        if (segLen < 2) return false;
+
+        // SOF0..SOF15 except DHT (C4), JPG (C8) and DAC (CC)
+        bool isSof = marker >= 0xC0 && marker <= 0xCF &&
+                     marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+        if (isSof) {
+            if (pos + 2 + segLen > len || segLen < 8) return false;
+            const uint8_t* p = data + pos + 4;
+            memset(info, 0, sizeof(*info));
+            info->height = (p[1] << 8) | p[2];
+            info->width = (p[3] << 8) | p[4];
+            info->components = p[5];
+            info->progressive = (marker != 0xC0 && marker != 0xC1);
+            if (segLen < 8 + (size_t)info->components * 3) return false;
+            int hMax = 1, vMax = 1;
+            for (int c = 0; c < info->components; c++) {
+                uint8_t sf = p[6 + c * 3 + 1];
+                if ((sf >> 4) > hMax) hMax = sf >> 4;
+                if ((sf & 0x0F) > vMax) vMax = sf & 0x0F;
+            }
+            // A single-component scan is not interleaved: its MCU is one 8x8 block
+            if (info->components == 1) hMax = vMax = 1;
+            info->mcuWidth = 8 * hMax;
+            info->mcuHeight = 8 * vMax;
+            return info->width > 0 && info->height > 0;
+        }
+        pos += 2 + segLen;
+    }
+    return false;
+}
+
+bool jpegClipBlock(int x, int y, int w, int h, int frameW, int frameH, int* clipW, int* clipH) {
+    if (x < 0 || y < 0 || x >= frameW || y >= frameH || w <= 0 || h <= 0) return false;
+    *clipW = (x + w <= frameW) ? w : frameW - x;
+    *clipH = (y + h <= frameH) ? h : frameH - y;
+    return true;
+}
+
+bool jpegDirectDecodeFits(int frameW, int frameH, int mcuW, int mcuH, int decodeDiv, size_t bufferBytes) {
+    if (frameW <= 0 || frameH <= 0 || decodeDiv <= 0) return false;
+    int cx = mcuW / decodeDiv, cy = mcuH / decodeDiv;
+    if (cx < 1) cx = 1;
+    if (cy < 1) cy = 1;
+    if (frameW % cx != 0) return false;
+    size_t rows = (size_t)(frameH + cy - 1) / cy * cy;
+    return (size_t)frameW * rows * 2 <= bufferBytes;
+}
+
+DecoderChain::DecoderChain() : numDecoders(0) {
+    memset(decoders, 0, sizeof(decoders));
+    memset(okCounts, 0, sizeof(okCounts));
+    memset(fallbackCounts, 0, sizeof(fallbackCounts));
+}
+
+bool DecoderChain::add(ImageDecoder* decoder) {
+    if (!decoder || numDecoders >= DECODER_CHAIN_MAX) return false;
+    decoders[numDecoders++] = decoder;
+    return true;
+}
+
+ImageDecoder* DecoderChain::preferred() const {
+    for (int i = 0; i < numDecoders; i++) {
+        if (decoders[i]->isAvailable()) return decoders[i];
+    }
+    return nullptr;
+}
+
+DecodeStatus DecoderChain::decode(const DecodeRequest& req, DecodeResult* result, ImageDecoder** used) {
+    DecodeStatus status = DECODE_UNSUPPORTED;
+    if (used) *used = nullptr;
+
+    for (int i = 0; i < numDecoders; i++) {
+        ImageDecoder* d = decoders[i];
+        if (!d->isAvailable()) continue;
+
+        memset(result, 0, sizeof(*result));
+        status = d->decode(req, result);
+        if (used) *used = d;
+        if (status == DECODE_OK) {
+            okCounts[i]++;
+            return status;
+        }
+        fallbackCounts[i]++;
+    }
+    return status;
+}
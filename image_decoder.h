@@ -0,0 +1,117 @@
+#pragma once
+#ifndef IMAGE_DECODER_H
+#define IMAGE_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// PLUGGABLE JPEG DECODERS
+// =============================================================================
+// Buffered (whole-bitstream-in-RAM) decode into an RGB565 frame. Backends are
+// tried in order by DecoderChain: the hardware codec first, JPEGDEC as the
+// catch-all. Kept free of Arduino / IDF types so the selection and fallback
+// logic can be unit-tested on the host (test/test_image_decoder.cpp).
+
+enum DecodeStatus {
+    DECODE_OK = 0,
+    DECODE_UNSUPPORTED,   // backend can't handle this stream (progressive, CMYK, too big)
+    DECODE_FAILED         // backend tried and failed (corrupt data, engine error)
+};
+
+// Facts read from the JPEG markers without decoding any entropy data
+struct JpegHeaderInfo {
+    int width;
+    int height;
+    int components;       // 1 = grayscale, 3 = YCbCr, 4 = CMYK/YCCK
+    int mcuWidth;         // 8 * max horizontal sampling factor
+    int mcuHeight;        // 8 * max vertical sampling factor
+    bool progressive;     // SOF2 (or any non-baseline SOF)
+};
+
+// Walk the marker segments up to the first SOFn. Returns false if the buffer
+// is not a JPEG or ends before the frame header.
+bool jpegParseHeader(const uint8_t* data, size_t len, JpegHeaderInfo* info);
+
+// Part of a w x h decoder output block at (x, y) that lies inside a
+// frameW x frameH frame: MCUs overhanging the right or bottom edge are
+// clipped, not dropped. False when none of the block is inside.
+bool jpegClipBlock(int x, int y, int w, int h, int frameW, int frameH, int* clipW, int* clipH);
+
+// Whether JPEGDEC can decode a frameW x frameH frame (at 1/decodeDiv, from
+// mcuW x mcuH MCUs) straight into a buffer of bufferBytes packed at frameW.
+// It writes whole scaled MCUs at that pitch, so frameW has to be a multiple
+// of the scaled MCU width and the last MCU row's overhang needs room below
+// the frame.
+bool jpegDirectDecodeFits(int frameW, int frameH, int mcuW, int mcuH, int decodeDiv, size_t bufferBytes);
+
+struct DecodeRequest {
+    const uint8_t* data;  // complete JPEG bitstream
+    size_t length;
+    uint16_t* dst;        // RGB565 output, rows packed at the decoded width
+    size_t dstBytes;
+    int maxDimension;     // largest allowed decoded width/height
+    int reduceDiv;        // extra 1/2, 1/4, 1/8 downscale the renderer can absorb
+                          // on top of any fit-the-buffer one (0 or 1 = none);
+                          // a hint - backends may decode larger
+};
+
+struct DecodeResult {
+    int width;            // decoded size written to dst
+    int height;
+    int srcWidth;         // size declared by the JPEG
+    int srcHeight;
+    int scaleDiv;         // 1, 2, 4 or 8
+    int frameWidth;       // whole frame at the decoded scale when only part of
+    int frameHeight;      // it was decoded (0: width x height is the whole frame)
+    int cropX;            // where that part starts within the frame
+    int cropY;
+    uint32_t parseUs;     // per-stage timings filled in by the backend
+    uint32_t decodeUs;
+    uint32_t postUs;      // MCU-padding compaction / downscale
+};
+
+class ImageDecoder {
+public:
+    virtual ~ImageDecoder() {}
+    virtual const char* name() const = 0;
+    // False when the backend could not be initialised (e.g. no codec engine)
+    virtual bool isAvailable() const { return true; }
+    virtual DecodeStatus decode(const DecodeRequest& req, DecodeResult* result) = 0;
+};
+
+#define DECODER_CHAIN_MAX 4
+
+/**
+ * @brief Ordered list of decoders with fallback.
+ *
+ * Each backend is asked in turn; UNSUPPORTED and FAILED both move on to the
+ * next one, so JPEGDEC still gets a go after a hardware error. Per-backend
+ * counters feed the serial stats.
+ */
+class DecoderChain {
+public:
+    DecoderChain();
+
+    bool add(ImageDecoder* decoder);
+    int count() const { return numDecoders; }
+    ImageDecoder* at(int i) const { return (i >= 0 && i < numDecoders) ? decoders[i] : nullptr; }
+
+    // The backend that would be tried first right now (nullptr if none)
+    ImageDecoder* preferred() const;
+
+    // Returns the status of the last backend tried; *used is the backend that
+    // produced the frame (or the last one that failed).
+    DecodeStatus decode(const DecodeRequest& req, DecodeResult* result, ImageDecoder** used);
+
+    uint32_t okCount(int i) const { return (i >= 0 && i < numDecoders) ? okCounts[i] : 0; }
+    uint32_t fallbackCount(int i) const { return (i >= 0 && i < numDecoders) ? fallbackCounts[i] : 0; }
+
+private:
+    ImageDecoder* decoders[DECODER_CHAIN_MAX];
+    uint32_t okCounts[DECODER_CHAIN_MAX];
+    uint32_t fallbackCounts[DECODER_CHAIN_MAX];   // handed the frame on to the next backend
+    int numDecoders;
+};
+
+#endif // IMAGE_DECODER_H
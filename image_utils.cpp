@@ -1,65 +1,95 @@
 #include "image_utils.h"
 #include "system_monitor.h"
+#include "strip_pipeline.h"  // Shared bilinear row kernel
+#include "pixel_stage.h"     // Colour temperature table
+#include "pixel_kernels.h"   // Tiled scale + rotate
+#include "row_pool.h"        // Row bands across both cores
+#include <atomic>
 
 extern SystemMonitor systemMonitor;  // Defined in main .ino file
 
 void ImageUtils::getKelvinScales(int temp, float& rScale, float& gScale, float& bScale) {
-    // 6500K is neutral (1.0, 1.0, 1.0)
-    // Simplified approximation for performance (Tanner Helland's method)
-    temp = constrain(temp, 1000, 40000) / 100;
-    
-    // Calculate Red
-    if (temp <= 66) {
-        rScale = 1.0f;
-    } else {
-        rScale = constrain(pow(temp - 60, -0.1332047592) * 329.698727446 / 255.0, 0.0, 1.0);
+    pixelKelvinScales(temp, &rScale, &gScale, &bScale);
+}
+
+void ImageUtils::adjustColorTemperature(uint16_t* buffer, int width, int height, int tempKelvin) {
+    // Same table the decoder applies per block (pixel_stage.h), kept between
+    // calls and rebuilt only for another temperature
+    static PixelStage stage = { 0, nullptr };
+    PixelStageSettings settings = { tempKelvin, PIXEL_STAGE_NEUTRAL_GAMMA, 0 };
+    if (pixelStageKey(settings) == 0) return;
+    if (!stage.lut) {
+        stage.lut = (uint16_t*)heap_caps_malloc(PIXEL_STAGE_LUT_BYTES, MALLOC_CAP_SPIRAM);
+        if (!stage.lut) {
+            Serial.println("[ImageUtils] ERROR: No memory for the colour temperature table");
+            return;
+        }
     }
-    
-    // Calculate Green
-    if (temp <= 66) {
-        gScale = constrain(log(temp) * 99.4708025861 - 161.1195681661, 0.0, 255.0) / 255.0;
-    } else {
-        gScale = constrain(pow(temp - 60, -0.0755148492) * 288.1221695283 / 255.0, 0.0, 1.0);
+    if (stage.key != pixelStageKey(settings)) pixelStageBuild(&stage, settings);
+    applyPixelStage(stage, buffer, buffer, width, height);
+}
+
+namespace {
+struct StageJob {
+    const PixelStage* stage;
+    uint16_t* dst;
+    const uint16_t* src;
+    int width;
+};
+
+void stageRows(void* ctx, int rowBegin, int rowEnd) {
+    const StageJob& j = *(const StageJob*)ctx;
+    size_t offset = (size_t)rowBegin * j.width;
+    size_t count = (size_t)(rowEnd - rowBegin) * j.width;
+    if (j.dst == j.src) pixelStageApply(*j.stage, j.dst + offset, count);
+    else pixelStageCopy(*j.stage, j.dst + offset, j.src + offset, count);
+}
+
+struct ScaleJob {
+    const uint16_t* src;
+    int srcWidth, srcHeight;
+    uint16_t* dst;
+    int dstWidth, dstHeight;
+    int rotation;
+    uint32_t yRatio;                 // 16.16, bilinearScale only
+    std::atomic<bool> failed;        // a band had no memory for its tables
+};
+
+void scaleRows(void* ctx, int rowBegin, int rowEnd) {
+    const ScaleJob& j = *(const ScaleJob*)ctx;
+    for (int dstY = rowBegin; dstY < rowEnd; dstY++) {
+        uint32_t srcY_fp = (uint32_t)dstY * j.yRatio;
+        int y0 = srcY_fp >> 16;
+        int y1 = (y0 + 1 < j.srcHeight) ? y0 + 1 : y0;
+        stripBilinearRow(j.src + y0 * j.srcWidth, j.src + y1 * j.srcWidth, srcY_fp & 0xFFFF,
+                         j.srcWidth, j.dst + dstY * j.dstWidth, j.dstWidth);
     }
-    
-    // Calculate Blue
-    if (temp >= 66) {
-        bScale = 1.0f;
-    } else if (temp <= 19) {
-        bScale = 0.0f;
-    } else {
-        bScale = constrain(log(temp - 10) * 138.5177312231 - 305.0447927307, 0.0, 255.0) / 255.0;
+}
+
+void boxRows(void* ctx, int rowBegin, int rowEnd) {
+    ScaleJob& j = *(ScaleJob*)ctx;
+    if (!stripBoxScale(j.src, j.srcWidth, j.srcHeight, j.dst, j.dstWidth, j.dstHeight, rowBegin, rowEnd)) {
+        j.failed = true;
     }
 }
 
-void ImageUtils::adjustColorTemperature(uint16_t* buffer, int width, int height, int tempKelvin) {
-    if (tempKelvin == 6500) return; // Neutral, no-op
-
-    float rS, gS, bS;
-    getKelvinScales(tempKelvin, rS, gS, bS);
-
-    // Use fixed-point math for speed (scale by 256)
-    int rFix = rS * 256;
-    int gFix = gS * 256;
-    int bFix = bS * 256;
-
-    int len = width * height;
-    for (int i = 0; i < len; i++) {
-        uint16_t p = buffer[i];
-        
-        // Unpack RGB565
-        int r = (p >> 11) & 0x1F;
-        int g = (p >> 5) & 0x3F;
-        int b = p & 0x1F;
-
-        // Apply scaling
-        r = constrain((r * rFix) >> 8, 0, 31);
-        g = constrain((g * gFix) >> 8, 0, 63);
-        b = constrain((b * bFix) >> 8, 0, 31);
-
-        // Repack
-        buffer[i] = (r << 11) | (g << 5) | b;
+void scaleRotateRows(void* ctx, int rowBegin, int rowEnd) {
+    ScaleJob& j = *(ScaleJob*)ctx;
+    if (!pxScaleRotate(j.src, j.srcWidth, j.srcHeight, j.dst, j.dstWidth, j.dstHeight, j.rotation,
+                       rowBegin, rowEnd)) {
+        j.failed = true;
+    }
+}
+}
+
+void ImageUtils::applyPixelStage(const PixelStage& stage, uint16_t* dst, const uint16_t* src,
+                                 int width, int height) {
+    if (pixelStageIsIdentity(stage)) {
+        if (dst != src) memcpy(dst, src, (size_t)width * height * sizeof(uint16_t));
+        return;
     }
+    StageJob job = { &stage, dst, src, width };
+    rowPoolRun(height, stageRows, &job);
 }
 
 bool ImageUtils::softwareTransform(
@@ -77,26 +107,49 @@ bool ImageUtils::softwareTransform(
         return false;
     }
     
-    // For now, only support 0° rotation (scale only)
-    // Future enhancement: implement 90°, 180°, 270° rotation
-    if (rotation != 0) {
-        Serial.printf("[ImageUtils] WARNING: Rotation %d° not yet implemented, using 0°\n", rotation);
+    if (rotation != 0 && rotation != 90 && rotation != 180 && rotation != 270) {
+        Serial.printf("[ImageUtils] WARNING: Rotation %d° not supported, using 0°\n", rotation);
+        rotation = 0;
     }
-    
-    Serial.printf("[ImageUtils] Software scaling: %dx%d -> %dx%d\n", 
-                 srcWidth, srcHeight, dstWidth, dstHeight);
-    
-    return bilinearScale(srcBuffer, srcWidth, srcHeight, dstBuffer, dstWidth, dstHeight);
+
+    if (rotation == 0) {
+        // Below half size bilinear skips most source pixels (aliased detail,
+        // lost stars): average the area instead
+        if (dstWidth * 2 < srcWidth && dstHeight * 2 < srcHeight) {
+            Serial.printf("[ImageUtils] Software box downscale: %dx%d -> %dx%d\n",
+                         srcWidth, srcHeight, dstWidth, dstHeight);
+            if (boxScale(srcBuffer, srcWidth, srcHeight, dstBuffer, dstWidth, dstHeight)) return true;
+            Serial.println("[ImageUtils] WARNING: Box downscale failed, using bilinear");
+        }
+        Serial.printf("[ImageUtils] Software scaling: %dx%d -> %dx%d\n",
+                     srcWidth, srcHeight, dstWidth, dstHeight);
+        return bilinearScale(srcBuffer, srcWidth, srcHeight, dstBuffer, dstWidth, dstHeight);
+    }
+
+    // Scale and turn in one tiled pass (pixel_kernels.h): no full-size
+    // intermediate, and the source rows a 90 / 270 tile reads stay in cache.
+    // Bands of whole tile rows go to the row pool.
+    Serial.printf("[ImageUtils] Software scale+rotate: %dx%d -> %dx%d (%d°) on %d worker(s)\n",
+                 srcWidth, srcHeight, dstWidth, dstHeight, rotation, rowPoolWorkers());
+    ScaleJob job = { srcBuffer, srcWidth, srcHeight, dstBuffer, dstWidth, dstHeight, rotation, 0, {false} };
+    rowPoolRun(dstHeight, scaleRotateRows, &job, PX_TILE);
+    systemMonitor.forceResetWatchdog();
+    if (job.failed) {
+        Serial.println("[ImageUtils] ERROR: No memory for the scale+rotate tables");
+        return false;
+    }
+    return true;
 }
 
 bool ImageUtils::bilinearScale(
     const uint16_t* srcBuffer, int srcWidth, int srcHeight,
     uint16_t* dstBuffer, int dstWidth, int dstHeight
 ) {
-    // 16.16 fixed-point arithmetic for ~2-4x speedup over float on RISC-V
+    // 16.16 fixed-point arithmetic for ~2-4x speedup over float on RISC-V.
+    // The per-row blend is shared with the strip pipeline (strip_pipeline.cpp)
+    // so both produce identical pixels. Rows are split across the row pool's
+    // workers (one per core); the caller waits for all of them.
     static constexpr int FP_SHIFT = 16;
-    static constexpr uint32_t FP_ONE = 1u << FP_SHIFT;
-    static constexpr uint32_t FP_MASK = FP_ONE - 1;
 
     // Calculate scaling ratios in 16.16 fixed-point
     uint32_t xRatio_fp = ((uint32_t)(srcWidth - 1) << FP_SHIFT) / dstWidth;
@@ -105,82 +158,35 @@ bool ImageUtils::bilinearScale(
     Serial.printf("[ImageUtils] Scale ratios (fixed-point): X=0x%08X, Y=0x%08X\n", xRatio_fp, yRatio_fp);
 
     unsigned long startTime = millis();
-    int pixelsProcessed = 0;
-    unsigned long lastWatchdogReset = millis();
-
-    // Process each destination pixel
-    for (int dstY = 0; dstY < dstHeight; dstY++) {
-        // Reset watchdog periodically during long operations
-        if (millis() - lastWatchdogReset > 100) {
-            systemMonitor.forceResetWatchdog();
-            lastWatchdogReset = millis();
-        }
+    systemMonitor.forceResetWatchdog();
 
-        uint32_t srcY_fp = (uint32_t)dstY * yRatio_fp;
-        int y0 = srcY_fp >> FP_SHIFT;
-        uint32_t yFrac = srcY_fp & FP_MASK;
-        uint32_t yFracInv = FP_ONE - yFrac;
-        int y1 = (y0 + 1 < srcHeight) ? y0 + 1 : y0;
-
-        const uint16_t* srcRow0 = srcBuffer + y0 * srcWidth;
-        const uint16_t* srcRow1 = srcBuffer + y1 * srcWidth;
-
-        for (int dstX = 0; dstX < dstWidth; dstX++) {
-            uint32_t srcX_fp = (uint32_t)dstX * xRatio_fp;
-            int x0 = srcX_fp >> FP_SHIFT;
-            uint32_t xFrac = srcX_fp & FP_MASK;
-            uint32_t xFracInv = FP_ONE - xFrac;
-            int x1 = (x0 + 1 < srcWidth) ? x0 + 1 : x0;
-
-            // Get the four surrounding pixels
-            uint16_t p00 = srcRow0[x0];
-            uint16_t p10 = srcRow0[x1];
-            uint16_t p01 = srcRow1[x0];
-            uint16_t p11 = srcRow1[x1];
-
-            // Extract RGB565 components inline
-            uint32_t r00 = (p00 >> 11) & 0x1F;
-            uint32_t g00 = (p00 >> 5) & 0x3F;
-            uint32_t b00 = p00 & 0x1F;
-
-            uint32_t r10 = (p10 >> 11) & 0x1F;
-            uint32_t g10 = (p10 >> 5) & 0x3F;
-            uint32_t b10 = p10 & 0x1F;
-
-            uint32_t r01 = (p01 >> 11) & 0x1F;
-            uint32_t g01 = (p01 >> 5) & 0x3F;
-            uint32_t b01 = p01 & 0x1F;
-
-            uint32_t r11 = (p11 >> 11) & 0x1F;
-            uint32_t g11 = (p11 >> 5) & 0x3F;
-            uint32_t b11 = p11 & 0x1F;
-
-            // Bilinear interpolation using fixed-point (all in 16.16)
-            // Top row: lerp(p00, p10, xFrac)
-            uint32_t r0 = r00 * xFracInv + r10 * xFrac;
-            uint32_t g0 = g00 * xFracInv + g10 * xFrac;
-            uint32_t b0 = b00 * xFracInv + b10 * xFrac;
-
-            // Bottom row: lerp(p01, p11, xFrac)
-            uint32_t r1 = r01 * xFracInv + r11 * xFrac;
-            uint32_t g1 = g01 * xFracInv + g11 * xFrac;
-            uint32_t b1 = b01 * xFracInv + b11 * xFrac;
-
-            // Vertical: lerp(row0, row1, yFrac) - result is in 32.16 after two multiplies
-            // r0/g0/b0 are already in 5.16 (or 6.16 for green), shift down by 2*FP_SHIFT
-            uint32_t r = (r0 * yFracInv + r1 * yFrac) >> (2 * FP_SHIFT);
-            uint32_t g = (g0 * yFracInv + g1 * yFrac) >> (2 * FP_SHIFT);
-            uint32_t b = (b0 * yFracInv + b1 * yFrac) >> (2 * FP_SHIFT);
-
-            // Pack RGB565 and store
-            dstBuffer[dstY * dstWidth + dstX] = ((r & 0x1F) << 11) | ((g & 0x3F) << 5) | (b & 0x1F);
-            pixelsProcessed++;
-        }
-    }
+    ScaleJob job = { srcBuffer, srcWidth, srcHeight, dstBuffer, dstWidth, dstHeight, 0, yRatio_fp, {false} };
+    rowPoolRun(dstHeight, scaleRows, &job);
+    systemMonitor.forceResetWatchdog();
 
+    int pixelsProcessed = dstWidth * dstHeight;
     unsigned long duration = millis() - startTime;
-    Serial.printf("[ImageUtils] Software scaling complete: %d pixels in %lu ms (%.1f ms/Kpixel)\n",
-                 pixelsProcessed, duration, (duration * 1000.0) / pixelsProcessed);
+    Serial.printf("[ImageUtils] Software scaling complete: %d pixels in %lu ms (%.1f ms/Kpixel, %d worker(s))\n",
+                 pixelsProcessed, duration, (duration * 1000.0) / pixelsProcessed, rowPoolWorkers());
+
+    return true;
+}
+
+bool ImageUtils::boxScale(
+    const uint16_t* srcBuffer, int srcWidth, int srcHeight,
+    uint16_t* dstBuffer, int dstWidth, int dstHeight
+) {
+    // Area average (strip_pipeline.h): each band reads the source rows under
+    // its output rows once, with its own running sums
+    unsigned long startTime = millis();
+    systemMonitor.forceResetWatchdog();
+
+    ScaleJob job = { srcBuffer, srcWidth, srcHeight, dstBuffer, dstWidth, dstHeight, 0, 0, {false} };
+    rowPoolRun(dstHeight, boxRows, &job);
+    systemMonitor.forceResetWatchdog();
+    if (job.failed) return false;
 
+    Serial.printf("[ImageUtils] Box downscale complete: %d source pixels in %lu ms (%d worker(s))\n",
+                 srcWidth * srcHeight, millis() - startTime, rowPoolWorkers());
     return true;
 }
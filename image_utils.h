@@ -2,6 +2,7 @@
 #define IMAGE_UTILS_H
 
 #include <Arduino.h>
+#include "pixel_stage.h"
 
 /**
  * @brief Image processing utilities for software-based transformations
@@ -14,6 +15,11 @@ public:
     /**
      * @brief Software-based image scaling with optional rotation
      * 
+     * Rotation is counter-clockwise, as the PPA turns; dstWidth x dstHeight is
+     * the size after turning. 90 / 180 / 270 scale and turn in one tiled pass
+     * (pxScaleRotate), any other angle falls back to 0. Unrotated reductions
+     * below half size on both axes use boxScale().
+     * 
      * @param srcBuffer Source image buffer (RGB565)
      * @param srcWidth Source image width
      * @param srcHeight Source image height
@@ -45,8 +51,31 @@ public:
         uint16_t* dstBuffer, int dstWidth, int dstHeight
     );
     
+    /**
+     * @brief Area-average (box) downscale (no rotation)
+     *
+     * Every source pixel counts towards the output pixel it falls in, so
+     * large reductions keep fine detail that bilinear sampling skips.
+     * softwareTransform() picks it below half size on both axes.
+     * 
+     * @param srcBuffer Source image buffer (RGB565)
+     * @param srcWidth Source image width
+     * @param srcHeight Source image height
+     * @param dstBuffer Destination buffer (must be pre-allocated)
+     * @param dstWidth Desired output width (<= srcWidth)
+     * @param dstHeight Desired output height (<= srcHeight)
+     * @return true if scaling succeeded (false: upscale or out of memory)
+     */
+    static bool boxScale(
+        const uint16_t* srcBuffer, int srcWidth, int srcHeight,
+        uint16_t* dstBuffer, int dstWidth, int dstHeight
+    );
+    
     /**
      * @brief Adjust color temperature of an image buffer
+     *
+     * Decoded frames get this in the decoder's pixel stage (pixel_stage.h);
+     * this whole-buffer pass is for pixels that didn't come from a decode.
      * 
      * @param buffer Image buffer (RGB565)
      * @param width Image width
@@ -55,6 +84,18 @@ public:
      */
     static void adjustColorTemperature(uint16_t* buffer, int width, int height, int tempKelvin);
 
+    /**
+     * @brief Run a pixel stage over a whole frame, rows split across the row pool
+     *
+     * @param stage Pixel stage (identity: plain copy, or nothing in place)
+     * @param dst Destination buffer (may equal src)
+     * @param src Source buffer
+     * @param width Image width
+     * @param height Image height
+     */
+    static void applyPixelStage(const PixelStage& stage, uint16_t* dst, const uint16_t* src,
+                                int width, int height);
+
 private:
     /**
      * @brief Helper to get RGB scaling factors from Kelvin temperature
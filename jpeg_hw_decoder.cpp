@@ -0,0 +1,145 @@
+#include "jpeg_hw_decoder.h"
+#include "logging.h"
+#include "esp_heap_caps.h"
+
+// Global instance
+JpegHwDecoder jpegHwDecoder;
+
+// Keep this much PSRAM free when borrowing a staging buffer for a 2:1 decode
+static const size_t HW_STAGING_PSRAM_RESERVE = 1024 * 1024;
+
+JpegHwDecoder::JpegHwDecoder() : engine(nullptr) {
+}
+
+JpegHwDecoder::~JpegHwDecoder() {
+    end();
+}
+
+bool JpegHwDecoder::begin() {
+    if (engine) return true;
+
+    jpeg_decode_engine_cfg_t engineCfg = {};
+    engineCfg.intr_priority = 0;
+    engineCfg.timeout_ms = DECODE_TIMEOUT;
+    esp_err_t err = jpeg_new_decoder_engine(&engineCfg, &engine);
+    if (err != ESP_OK) {
+        engine = nullptr;
+        LOG_WARNING_F("[JPEG-HW] Decoder engine init failed: %s - using JPEGDEC only\n", esp_err_to_name(err));
+        return false;
+    }
+    LOG_INFO("[JPEG-HW] Hardware JPEG decoder ready");
+    return true;
+}
+
+void JpegHwDecoder::end() {
+    if (engine) {
+        jpeg_del_decoder_engine(engine);
+        engine = nullptr;
+    }
+}
+
+bool JpegHwDecoder::runEngine(const DecodeRequest& req, uint16_t* out, size_t outBytes, uint32_t* outSize) {
+    jpeg_decode_cfg_t cfg = {};
+    cfg.output_format = JPEG_DECODE_OUT_FORMAT_RGB565;
+    cfg.rgb_order = JPEG_DEC_RGB_ELEMENT_ORDER_BGR;   // little-endian RGB565, same as JPEGDEC
+    cfg.conv_std = JPEG_YUV_RGB_CONV_STD_BT601;
+
+    esp_err_t err = jpeg_decoder_process(engine, &cfg, req.data, req.length,
+                                         (uint8_t*)out, outBytes, outSize);
+    if (err != ESP_OK) {
+        LOG_WARNING_F("[JPEG-HW] Decode failed: %s\n", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+// 2:1 box filter from an MCU-padded RGB565 frame into a packed one
+static void boxHalveRgb565(const uint16_t* src, int srcStride, uint16_t* dst, int dstW, int dstH) {
+    for (int y = 0; y < dstH; y++) {
+        const uint16_t* r0 = src + (size_t)(y * 2) * srcStride;
+        const uint16_t* r1 = r0 + srcStride;
+        uint16_t* d = dst + (size_t)y * dstW;
+        for (int x = 0; x < dstW; x++) {
+            uint16_t a = r0[x * 2], b = r0[x * 2 + 1], c = r1[x * 2], e = r1[x * 2 + 1];
+            uint32_t r = ((a >> 11) + (b >> 11) + (c >> 11) + (e >> 11) + 2) >> 2;
+            uint32_t g = (((a >> 5) & 0x3F) + ((b >> 5) & 0x3F) + ((c >> 5) & 0x3F) + ((e >> 5) & 0x3F) + 2) >> 2;
+            uint32_t bl = ((a & 0x1F) + (b & 0x1F) + (c & 0x1F) + (e & 0x1F) + 2) >> 2;
+            d[x] = (uint16_t)((r << 11) | (g << 5) | bl);
+        }
+    }
+}
+
+DecodeStatus JpegHwDecoder::decode(const DecodeRequest& req, DecodeResult* result) {
+    if (!engine) return DECODE_UNSUPPORTED;
+
+    unsigned long t0 = micros();
+    JpegHeaderInfo hdr;
+    if (!jpegParseHeader(req.data, req.length, &hdr)) return DECODE_FAILED;
+    // The codec only handles baseline YCbCr; leave everything else to JPEGDEC
+    if (hdr.progressive || hdr.components != 3) return DECODE_UNSUPPORTED;
+
+    result->srcWidth = hdr.width;
+    result->srcHeight = hdr.height;
+
+    int padW = (hdr.width + hdr.mcuWidth - 1) / hdr.mcuWidth * hdr.mcuWidth;
+    int padH = (hdr.height + hdr.mcuHeight - 1) / hdr.mcuHeight * hdr.mcuHeight;
+    size_t paddedBytes = (size_t)padW * padH * 2;
+
+    // req.reduceDiv is not applied: the codec decodes a full frame faster than
+    // JPEGDEC does a reduced one, and halving afterwards only adds a pass
+    int div = 1;
+    if (paddedBytes > req.dstBytes || hdr.width > req.maxDimension || hdr.height > req.maxDimension) {
+        div = 2;
+        int hw = hdr.width / 2, hh = hdr.height / 2;
+        if ((size_t)hw * hh * 2 > req.dstBytes || hw > req.maxDimension || hh > req.maxDimension) {
+            return DECODE_UNSUPPORTED;   // needs 1/4 or 1/8 - JPEGDEC scales those during decode
+        }
+    }
+    result->parseUs = micros() - t0;
+
+    uint32_t outSize = 0;
+    if (div == 1) {
+        // Decode straight into the destination, then pack the padded rows
+        t0 = micros();
+        if (!runEngine(req, req.dst, req.dstBytes, &outSize)) return DECODE_FAILED;
+        result->decodeUs = micros() - t0;
+
+        t0 = micros();
+        if (padW != hdr.width) {
+            for (int y = 1; y < hdr.height; y++) {
+                memmove(req.dst + (size_t)y * hdr.width, req.dst + (size_t)y * padW,
+                        (size_t)hdr.width * sizeof(uint16_t));
+            }
+        }
+        result->postUs = micros() - t0;
+        result->width = hdr.width;
+        result->height = hdr.height;
+        result->scaleDiv = 1;
+        return DECODE_OK;
+    }
+
+    // Too big at full size: borrow a staging buffer and halve into dst
+    if (heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM) < paddedBytes + HW_STAGING_PSRAM_RESERVE) {
+        LOG_DEBUG_F("[JPEG-HW] Not enough PSRAM for %dx%d staging - deferring to JPEGDEC\n", padW, padH);
+        return DECODE_UNSUPPORTED;
+    }
+    jpeg_decode_memory_alloc_cfg_t memCfg = {};
+    memCfg.buffer_direction = JPEG_DEC_ALLOC_OUTPUT_BUFFER;
+    size_t allocated = 0;
+    uint16_t* staging = (uint16_t*)jpeg_alloc_decoder_mem(paddedBytes, &memCfg, &allocated);
+    if (!staging) return DECODE_UNSUPPORTED;
+
+    t0 = micros();
+    bool ok = runEngine(req, staging, allocated, &outSize);
+    result->decodeUs = micros() - t0;
+    if (ok) {
+        t0 = micros();
+        result->width = hdr.width / 2;
+        result->height = hdr.height / 2;
+        result->scaleDiv = 2;
+        boxHalveRgb565(staging, padW, req.dst, result->width, result->height);
+        result->postUs = micros() - t0;
+    }
+    free(staging);
+    return ok ? DECODE_OK : DECODE_FAILED;
+}
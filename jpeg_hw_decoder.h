@@ -0,0 +1,47 @@
+#pragma once
+#ifndef JPEG_HW_DECODER_H
+#define JPEG_HW_DECODER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "image_decoder.h"
+
+extern "C" {
+#include "driver/jpeg_decode.h"
+}
+
+/**
+ * @brief ESP32-P4 hardware JPEG codec as an ImageDecoder backend.
+ *
+ * The decoder engine is created once in begin() and reused for every frame.
+ * Output goes straight into the caller's 64-byte-aligned RGB565 buffer; the
+ * codec writes MCU-padded rows, which are compacted in place afterwards.
+ *
+ * Frames whose full-size output doesn't fit the destination (e.g. GOES-19
+ * 1808px = 6.5MB) are decoded into a temporary PSRAM buffer and box-filtered
+ * 2:1, matching JPEGDEC's JPEG_SCALE_HALF geometry. Progressive, CMYK and
+ * grayscale streams are reported UNSUPPORTED so the chain falls back to
+ * JPEGDEC.
+ */
+class JpegHwDecoder : public ImageDecoder {
+public:
+    JpegHwDecoder();
+    ~JpegHwDecoder();
+
+    bool begin();
+    void end();
+
+    const char* name() const override { return "hw"; }
+    bool isAvailable() const override { return engine != nullptr; }
+    DecodeStatus decode(const DecodeRequest& req, DecodeResult* result) override;
+
+private:
+    bool runEngine(const DecodeRequest& req, uint16_t* out, size_t outBytes, uint32_t* outSize);
+
+    jpeg_decoder_handle_t engine;
+};
+
+// Global instance
+extern JpegHwDecoder jpegHwDecoder;
+
+#endif // JPEG_HW_DECODER_H
@@ -0,0 +1,161 @@
+#include "jpeg_stream.h"
+#include <string.h>
+
+JpegStreamReader::JpegStreamReader(ByteSource* source, int32_t contentLength,
+                                   uint8_t* tee, size_t teeCapacity,
+                                   NowFn nowMs, IdleFn idle)
+    : src(source), length(contentLength), teeBuf(tee), teeCap(tee ? teeCapacity : 0),
+      teeOverflow(false), now(nowMs), idleHook(idle),
+      pos(0), receivedBytes(0), bodyHash(CONTENT_HASH_INIT), atEnd(false), lastError(STREAM_OK),
+      noDataTimeout(5000), totalTimeout(60000), startMs(0), waitedMs(0) {
+    startMs = now ? now() : 0;
+}
+
+void JpegStreamReader::setTimeouts(uint32_t noDataTimeoutMs, uint32_t totalTimeoutMs) {
+    noDataTimeout = noDataTimeoutMs;
+    totalTimeout = totalTimeoutMs;
+}
+
+uint32_t JpegStreamReader::elapsedMs() const {
+    return now ? now() - startMs : 0;
+}
+
+size_t JpegStreamReader::pull(uint8_t* dst, size_t len) {
+    if (atEnd || lastError != STREAM_OK || len == 0) return 0;
+
+    if (length >= 0) {
+        if (receivedBytes >= (size_t)length) {
+            atEnd = true;
+            return 0;
+        }
+        size_t remaining = (size_t)length - receivedBytes;
+        if (len > remaining) len = remaining;
+    }
+
+    uint32_t waitStart = now ? now() : 0;
+    while (true) {
+        int avail = src->available();
+        if (avail > 0) {
+            size_t want = len < (size_t)avail ? len : (size_t)avail;
+            int got = src->read(dst, want);
+            if (got > 0) {
+                if (now) waitedMs += now() - waitStart;
+                // Tee into the download buffer while it fits; once a single byte
+                // is dropped the buffer can no longer stand in for the body.
+                // The part of a read that still fits is kept, so the tee always
+                // holds [0, min(receivedBytes, teeCap)) for backward seeks.
+                if (!teeOverflow) {
+                    if (receivedBytes + (size_t)got <= teeCap) {
+                        memcpy(teeBuf + receivedBytes, dst, got);
+                    } else {
+                        if (receivedBytes < teeCap) memcpy(teeBuf + receivedBytes, dst, teeCap - receivedBytes);
+                        teeOverflow = true;
+                    }
+                }
+                bodyHash = contentHashUpdate(bodyHash, dst, got);
+                receivedBytes += got;
+                if (length >= 0 && receivedBytes >= (size_t)length) atEnd = true;
+                return (size_t)got;
+            }
+        }
+
+        if (!src->connected() && src->available() <= 0) {
+            atEnd = true;
+            if (length >= 0 && receivedBytes < (size_t)length) {
+                lastError = STREAM_CLOSED_EARLY;
+            }
+            return 0;
+        }
+
+        uint32_t t = now ? now() : 0;
+        if (t - waitStart > noDataTimeout) {
+            lastError = STREAM_STALLED;
+            waitedMs += t - waitStart;
+            return 0;
+        }
+        if (t - startMs > totalTimeout) {
+            lastError = STREAM_TOTAL_TIMEOUT;
+            waitedMs += t - waitStart;
+            return 0;
+        }
+        if (idleHook) idleHook();
+    }
+}
+
+int32_t JpegStreamReader::read(uint8_t* buf, int32_t len) {
+    if (len <= 0) return 0;
+    int32_t copied = 0;
+
+    // Serve from the teed window first (after a backward seek)
+    if ((size_t)pos < receivedBytes) {
+        size_t windowEnd = receivedBytes < teeCap ? receivedBytes : teeCap;
+        if ((size_t)pos >= windowEnd) {
+            lastError = STREAM_BAD_SEEK;
+            return 0;
+        }
+        size_t inWindow = windowEnd - (size_t)pos;
+        size_t n = (size_t)len < inWindow ? (size_t)len : inWindow;
+        memcpy(buf, teeBuf + pos, n);
+        pos += (int32_t)n;
+        copied += (int32_t)n;
+        // The tee ended short of what has been received: the socket is further
+        // on, so stop here rather than splice later bytes in
+        if ((size_t)pos < receivedBytes) return copied;
+    }
+
+    // Then straight from the socket into the caller's buffer
+    while (copied < len) {
+        size_t got = pull(buf + copied, (size_t)(len - copied));
+        if (got == 0) break;
+        pos += (int32_t)got;
+        copied += (int32_t)got;
+    }
+    return copied;
+}
+
+int32_t JpegStreamReader::seek(int32_t position) {
+    if (position < 0) return -1;
+    if (length >= 0 && position > length) position = length;
+
+    if ((size_t)position <= receivedBytes) {
+        // Backward (or in-window) seek: only valid while the bytes are still teed
+        if ((size_t)position < receivedBytes && (size_t)position >= teeCap) {
+            lastError = STREAM_BAD_SEEK;
+            return -1;
+        }
+        pos = position;
+        return pos;
+    }
+
+    // Forward seek past what has been received: read and discard (into the
+    // tee when it fits, so a later RAM retry still sees the skipped bytes)
+    uint8_t scratch[512];
+    pos = (int32_t)receivedBytes;
+    while ((size_t)pos < (size_t)position) {
+        size_t want = (size_t)position - (size_t)pos;
+        if (want > sizeof(scratch)) want = sizeof(scratch);
+        size_t got = pull(scratch, want);
+        if (got == 0) return -1;
+        pos += (int32_t)got;
+    }
+    return pos;
+}
+
+bool JpegStreamReader::drainToTee() {
+    uint8_t scratch[1024];
+    while (!atEnd && lastError == STREAM_OK) {
+        if (pull(scratch, sizeof(scratch)) == 0) break;
+    }
+    return teeComplete() && lastError == STREAM_OK;
+}
+
+const char* JpegStreamReader::errorName(StreamReadError e) {
+    switch (e) {
+        case STREAM_OK:            return "ok";
+        case STREAM_STALLED:       return "stalled";
+        case STREAM_TOTAL_TIMEOUT: return "total timeout";
+        case STREAM_CLOSED_EARLY:  return "closed early";
+        case STREAM_BAD_SEEK:      return "seek outside buffered window";
+    }
+    return "unknown";
+}
@@ -0,0 +1,107 @@
+#pragma once
+#ifndef JPEG_STREAM_H
+#define JPEG_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "content_hash.h"
+
+/**
+ * @brief Minimal pull-style byte source the streaming JPEG decoder reads from.
+ *
+ * On the device this wraps the WiFiClient returned by HTTPClient::getStreamPtr();
+ * host tests substitute a throttled fake. Kept free of Arduino types so the
+ * reader logic below compiles on Linux.
+ */
+class ByteSource {
+public:
+    virtual ~ByteSource() {}
+    virtual int available() = 0;                      // bytes readable without blocking
+    virtual int read(uint8_t* buf, size_t len) = 0;   // returns bytes read (0 = none yet)
+    virtual bool connected() = 0;                     // false once the peer closed
+};
+
+// Why a streaming read ended early (STREAM_OK while healthy or after a clean EOF)
+enum StreamReadError {
+    STREAM_OK = 0,
+    STREAM_STALLED,          // no data for noDataTimeoutMs
+    STREAM_TOTAL_TIMEOUT,    // whole body exceeded totalTimeoutMs
+    STREAM_CLOSED_EARLY,     // connection closed before contentLength bytes
+    STREAM_BAD_SEEK          // backward seek outside the retained window
+};
+
+/**
+ * @brief Blocking reader that feeds JPEGDEC's read/seek callbacks from a socket.
+ *
+ * Every byte pulled from the socket is also copied ("teed") into the caller's
+ * download buffer while it fits. That keeps the complete bitstream available
+ * afterwards, so a failed streaming decode can be retried in RAM without a
+ * second request, and backward seeks inside the received window are served
+ * from memory. Bytes past the tee capacity are streamed straight through.
+ *
+ * Time and idle hooks are injected so the same code runs under a simulated
+ * clock on the host: on the device nowMs = millis() and idle() feeds the
+ * watchdog and yields.
+ */
+class JpegStreamReader {
+public:
+    typedef uint32_t (*NowFn)();
+    typedef void (*IdleFn)();
+
+    JpegStreamReader(ByteSource* source, int32_t contentLength,
+                     uint8_t* tee, size_t teeCapacity,
+                     NowFn nowMs, IdleFn idle);
+
+    void setTimeouts(uint32_t noDataTimeoutMs, uint32_t totalTimeoutMs);
+
+    // Copy up to len bytes at the current position; blocks until data arrives.
+    // Returns bytes copied, 0 at end of stream or on error (see error()).
+    int32_t read(uint8_t* buf, int32_t len);
+
+    // Move to an absolute position. Forward seeks read and discard; backward
+    // seeks are only possible inside the teed window. Returns the new position
+    // or -1 on failure.
+    int32_t seek(int32_t position);
+
+    // Pull whatever is left of the body into the tee (used before an in-RAM
+    // retry after the streaming decode gave up part-way).
+    bool drainToTee();
+
+    int32_t position() const { return pos; }
+    int32_t size() const { return length; }          // -1 when unknown (chunked)
+    size_t received() const { return receivedBytes; }
+    bool teeComplete() const { return !teeOverflow && atEnd; }
+    bool ended() const { return atEnd; }
+    StreamReadError error() const { return lastError; }
+    uint32_t elapsedMs() const;
+    uint32_t stallMs() const { return waitedMs; }    // time spent waiting on the socket
+    uint64_t contentHash() const { return bodyHash; } // FNV-1a of every byte received
+
+    static const char* errorName(StreamReadError e);
+
+private:
+    // Read more bytes from the socket (at most len) into dst and the tee.
+    // Returns bytes obtained, 0 at end/error.
+    size_t pull(uint8_t* dst, size_t len);
+
+    ByteSource* src;
+    int32_t length;
+    uint8_t* teeBuf;
+    size_t teeCap;
+    bool teeOverflow;
+    NowFn now;
+    IdleFn idleHook;
+
+    int32_t pos;                 // logical read position
+    size_t receivedBytes;        // bytes pulled from the socket so far
+    uint64_t bodyHash;
+    bool atEnd;
+    StreamReadError lastError;
+
+    uint32_t noDataTimeout;
+    uint32_t totalTimeout;
+    uint32_t startMs;
+    uint32_t waitedMs;
+};
+
+#endif // JPEG_STREAM_H
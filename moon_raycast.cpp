@@ -0,0 +1,126 @@
+#include "moon_raycast.h"
+#include <math.h>
+
+static const float PI_F = 3.14159265f;
+
+// atan2 to within 1e-5 rad (a hundredth of a texel on a 2048-wide map), well
+// cheaper than the libm call on a single-precision FPU
+static inline float fastAtan2(float y, float x) {
+    float ax = fabsf(x), ay = fabsf(y);
+    float hi = ax > ay ? ax : ay;
+    if (hi == 0.0f) return 0.0f;
+    float t = (ax > ay ? ay : ax) / hi;
+    float t2 = t * t;
+    float a = t * (0.99997726f + t2 * (-0.33262347f + t2 * (0.19354346f + t2 * (-0.11643287f +
+                   t2 * (0.05265332f + t2 * -0.01172120f)))));
+    if (ay > ax) a = 0.5f * PI_F - a;
+    if (x < 0.0f) a = PI_F - a;
+    return y < 0.0f ? -a : a;
+}
+
+// Bilinear RGB565 sample at texel coordinates (fx, fy), centres on the half
+// pixel; x wraps, y clamps. Channels come back scaled by 65536.
+static inline void sampleBilinear(const MoonTexture* tex, float fx, float fy, uint32_t* r, uint32_t* g, uint32_t* b) {
+    int x0 = (int)floorf(fx), y0 = (int)floorf(fy);
+    uint32_t ax = (uint32_t)((fx - x0) * 256.0f), ay = (uint32_t)((fy - y0) * 256.0f);
+    x0 %= tex->w;
+    if (x0 < 0) x0 += tex->w;
+    int x1 = x0 + 1 == tex->w ? 0 : x0 + 1;
+    int y1 = y0 + 1;
+    if (y0 < 0) y0 = 0;
+    if (y1 < 0) y1 = 0;
+    if (y0 >= tex->h) y0 = tex->h - 1;
+    if (y1 >= tex->h) y1 = tex->h - 1;
+    const uint16_t* row0 = tex->texels + (size_t)y0 * tex->w;
+    const uint16_t* row1 = tex->texels + (size_t)y1 * tex->w;
+    uint16_t p[4] = { row0[x0], row0[x1], row1[x0], row1[x1] };
+    uint32_t wt[4] = { (256 - ax) * (256 - ay), ax * (256 - ay), (256 - ax) * ay, ax * ay };
+    uint32_t sr = 0, sg = 0, sb = 0;
+    for (int i = 0; i < 4; i++) {
+        sr += (p[i] >> 11) * wt[i];
+        sg += ((p[i] >> 5) & 0x3F) * wt[i];
+        sb += (p[i] & 0x1F) * wt[i];
+    }
+    *r = sr;
+    *g = sg;
+    *b = sb;
+}
+
+void moonRaycastRows(const MoonRaycastView* view, const MoonTexture* tex, uint16_t* frame, int w, int h,
+                     int rowBegin, int rowEnd) {
+    const float (*m)[3] = view->rot;
+    const float* L = view->light;
+    const float R = view->orthoR;
+    const float pxToView = 2.0f * R / w, pyToView = 2.0f * R / h;
+    const float uScale = tex->w / (2.0f * PI_F), vScale = tex->h / PI_F;
+
+    for (int py = rowBegin; py < rowEnd; py++) {
+        float y = R - (py + 0.5f) * pyToView;
+        float span2 = 1.0f - y * y;
+        if (span2 <= 0.0f) continue;
+        // Columns whose centre falls inside the disc on this row
+        float half = sqrtf(span2) / pxToView;
+        int x0 = (int)ceilf(0.5f * w - half - 0.5f), x1 = (int)floorf(0.5f * w + half - 0.5f);
+        if (x0 < 0) x0 = 0;
+        if (x1 > w - 1) x1 = w - 1;
+        uint16_t* row = frame + (size_t)py * w;
+
+        for (int px = x0; px <= x1; px++) {
+            float x = (px + 0.5f) * pxToView - R;
+            float z2 = span2 - x * x;
+            if (z2 <= 0.0f) continue;
+            float z = sqrtf(z2);
+
+            // View normal back into the body frame (the transpose undoes rot)
+            float bx = m[0][0] * x + m[1][0] * y + m[2][0] * z;
+            float by = m[0][1] * x + m[1][1] * y + m[2][1] * z;
+            float bz = m[0][2] * x + m[1][2] * y + m[2][2] * z;
+
+            // Longitude from +X towards +Z over the whole width; polar angle
+            // from +Y, with +Y at the bottom row
+            float lon = fastAtan2(bz, bx);
+            if (lon < 0.0f) lon += 2.0f * PI_F;
+            float polar = fastAtan2(sqrtf(bx * bx + bz * bz), by);
+            uint32_t r, g, b;
+            sampleBilinear(tex, lon * uScale - 0.5f, (PI_F - polar) * vScale - 0.5f, &r, &g, &b);
+
+            float lambert = -(x * L[0] + y * L[1] + z * L[2]);
+            float s = view->ambient + (lambert > 0.0f ? view->diffuse * lambert : 0.0f);
+            float sr = view->tint[0] * s, sg = view->tint[1] * s, sb = view->tint[2] * s;
+            uint32_t kr = sr >= 1.0f ? 256 : (uint32_t)(sr * 256.0f);
+            uint32_t kg = sg >= 1.0f ? 256 : (uint32_t)(sg * 256.0f);
+            uint32_t kb = sb >= 1.0f ? 256 : (uint32_t)(sb * 256.0f);
+            row[px] = (uint16_t)((((r * kr + (1u << 23)) >> 24) << 11) | (((g * kg + (1u << 23)) >> 24) << 5) |
+                                 ((b * kb + (1u << 23)) >> 24));
+        }
+    }
+}
+
+int moonTextureLevel(int texW, int levels, int frameW, float orthoR) {
+    // A view-space unit at the disc centre spans one radian of longitude,
+    // texW / 2pi texels, and 2 * orthoR / frameW of it is one pixel
+    float texelsPerPixel = texW * orthoR / (PI_F * frameW);
+    int level = 0;
+    // Round in log2: step down once the density passes sqrt(2) per octave
+    while (level + 1 < levels && texelsPerPixel >= 1.41421356f * (float)(1 << level)) level++;
+    return level;
+}
+
+void moonTextureHalve(const MoonTexture* src, uint16_t* dst) {
+    const int dw = src->w / 2, dh = src->h / 2;
+    for (int y = 0; y < dh; y++) {
+        const uint16_t* a = src->texels + (size_t)(2 * y) * src->w;
+        const uint16_t* b = a + src->w;
+        uint16_t* out = dst + (size_t)y * dw;
+        for (int x = 0; x < dw; x++) {
+            uint16_t p[4] = { a[2 * x], a[2 * x + 1], b[2 * x], b[2 * x + 1] };
+            uint32_t r = 2, g = 2, bl = 2;
+            for (int i = 0; i < 4; i++) {
+                r += p[i] >> 11;
+                g += (p[i] >> 5) & 0x3F;
+                bl += p[i] & 0x1F;
+            }
+            out[x] = (uint16_t)(((r >> 2) << 11) | ((g >> 2) << 5) | (bl >> 2));
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#ifndef MOON_RAYCAST_H
+#define MOON_RAYCAST_H
+
+#include <stdint.h>
+
+// =============================================================================
+// RAY-CAST MOON DISC
+// =============================================================================
+// Orthographic view of the textured unit sphere, shaded per output pixel
+// instead of through a tessellated mesh: each pixel inside the disc gets its
+// view-space normal from (x, y, sqrt(1 - x² - y²)), is turned back into the
+// body frame to find its longitude / latitude on the equirectangular map, and
+// takes the Lambert term of the light. No triangles, no depth buffer and no
+// facets; moon_sphere.cpp uses it in place of the tgx mesh unless
+// MOON_RENDERER says otherwise. No Arduino / IDF types: compared against a
+// mesh rasterizer and timed on the host (test/bench_moon_raycast.cpp).
+//
+// The body frame is the one tgx's drawSphere() builds: pole along +Y,
+// longitude winding +X -> +Z, texture row 0 (lunar north) at -Y. The light
+// follows tgx too: `light` is the direction the light travels, so a surface
+// is lit by max(0, -N·light).
+
+// Equirectangular RGB565 map, row 0 = north; the width wraps
+struct MoonTexture {
+    const uint16_t* texels;
+    int w, h;
+};
+
+struct MoonRaycastView {
+    float rot[3][3];    // body -> view rotation (view = rot * body)
+    float light[3];     // unit light direction in view space
+    float tint[3];      // material colour, 0..1
+    float ambient;      // material ambient strength
+    float diffuse;      // material diffuse strength
+    float orthoR;       // half-extent of the orthographic box; the sphere has radius 1
+};
+
+// Shade the disc pixels in rows [rowBegin, rowEnd) of a w x h frame; pixels
+// off the disc keep what the frame holds. Rows are independent.
+void moonRaycastRows(const MoonRaycastView* view, const MoonTexture* tex, uint16_t* frame, int w, int h,
+                     int rowBegin, int rowEnd);
+
+// --- Mip chain ---------------------------------------------------------------
+// Level i of the map is (w >> i) x (h >> i). A small disc sampling the full map
+// skips texels between neighbouring pixels, so it shimmers as it turns and
+// each fetch lands somewhere new in a multi-megabyte texture; a level near one
+// texel per pixel fixes both.
+
+// Level for a frameW-wide frame of a disc drawn with half-extent orthoR: the
+// one whose texel density at the disc centre is nearest one per pixel, in
+// octaves. 0 when the full map is already at or under that, capped at levels - 1.
+int moonTextureLevel(int texW, int levels, int frameW, float orthoR);
+
+// Next level down: each texel the 2x2 box average of src, per channel and
+// rounded. src->w and src->h must be even; dst holds src->w / 2 * src->h / 2.
+void moonTextureHalve(const MoonTexture* src, uint16_t* dst);
+
+#endif // MOON_RAYCAST_H
@@ -5,8 +5,10 @@
  *
  * Ported from the ESP-IDF NINA project to this ESP32-P4 Arduino project.
  * Adaptations vs. the NINA source:
- *  - Texture comes from the vendored byte array MOON_EQUIRECT_JPG (moon_equirect_data.h)
- *    decoded with stb_image, instead of a linker-embedded binary asset.
+ *  - Texture is the RGB565 image baked into the `moontex` flash partition
+ *    (tools/bake_moon_texture.py) and memory-mapped, or failing that the vendored
+ *    byte array MOON_EQUIRECT_JPG (moon_equirect_data.h) decoded with stb_image,
+ *    instead of a linker-embedded binary asset.
  *  - Orientation config comes from the global `configStorage` (config_storage.h)
  *    instead of app_config_get().
  *  - Logging uses the project LOG_*_F macros (logging.h) instead of ESP_LOG*.
@@ -16,7 +18,8 @@
  * ESP32-P4 notes:
  *  - The P4 FPU is single precision only. tgx defaults TGX_SINGLE_PRECISION_COMPUTATIONS
  *    to 1, and all math in this file uses float / sqrtf. No double in hot paths.
- *  - Big buffers (color + z-buffer) live in PSRAM, 128-byte aligned for PPA.
+ *  - The color buffer lives in PSRAM, 128-byte aligned for PPA. No z-buffer:
+ *    a single convex sphere with back faces culled cannot hide itself.
  */
 
 /* Force single precision before pulling in tgx (matches tgx default; explicit
@@ -28,6 +31,7 @@
 #include "moon_sphere.h"
 
 #include "esp_heap_caps.h"
+#include "esp_partition.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include <math.h>
@@ -55,6 +59,12 @@ extern "C" {
 /* Project logging macros (LOG_INFO_F / LOG_WARNING_F / LOG_ERROR_F). */
 #include "logging.h"
 
+/* Background rows split across both cores (row_pool.h). */
+#include "row_pool.h"
+
+/* Per-pixel analytic sphere (moon_raycast.h), the default disc renderer. */
+#include "moon_raycast.h"
+
 using namespace tgx;
 
 /* ----------------------------------------------------------------------------
@@ -72,6 +82,49 @@ void moon_sphere_set_disk_scale(float scale)
     s_disk_scale = scale;
 }
 
+/* ----------------------------------------------------------------------------
+ * Disc renderer. MOON_RENDER_RAYCAST shades every disc pixel analytically
+ * (moon_raycast.h): no mesh, no facets, and nb_sectors/nb_stacks
+ * are ignored. MOON_RENDER_MESH is the tgx tessellated sphere, kept for
+ * comparison (serial 'O' renders both and diffs them). Runtime-switchable;
+ * applied to the next render. */
+#ifndef MOON_RENDERER
+#define MOON_RENDERER MOON_RENDER_RAYCAST
+#endif
+
+static moon_renderer_t s_renderer = MOON_RENDERER;
+
+void moon_sphere_set_renderer(moon_renderer_t renderer)
+{
+    s_renderer = renderer;
+}
+
+moon_renderer_t moon_sphere_get_renderer(void)
+{
+    return s_renderer;
+}
+
+/* ----------------------------------------------------------------------------
+ * Texture level selection. On, each render samples the mip level picked for its
+ * output size and disk scale (see the lunar texture notes below); off, always
+ * the full map. Runtime-switchable for comparison (serial 'O'); applied to the
+ * next render. */
+#ifndef MOON_TEX_MIPMAP
+#define MOON_TEX_MIPMAP 1
+#endif
+
+static bool s_mipmap = MOON_TEX_MIPMAP;
+
+void moon_sphere_set_mipmap(bool on)
+{
+    s_mipmap = on;
+}
+
+bool moon_sphere_get_mipmap(void)
+{
+    return s_mipmap;
+}
+
 /* ----------------------------------------------------------------------------
  * Orientation tunables (compile-time fallbacks; the live path reads config).
  * Defaults yield the STANDARD near-side naked-eye view: north up, selenographic
@@ -117,20 +170,47 @@ static const uint8_t s_bayer4[4][4] = {
 /* ----------------------------------------------------------------------------
  * Lunar texture.
  *
- * Primary path: decode the vendored Clementine equirectangular map
- * (MOON_EQUIRECT_JPG) into an RGB565 PSRAM buffer.
+ * Primary path: map the RGB565 image baked into the `moontex` partition
+ * (tools/bake_moon_texture.py). No decode, no PSRAM, nothing to order at boot.
+ * Second: decode the vendored Clementine equirectangular map (MOON_EQUIRECT_JPG)
+ * into an RGB565 PSRAM buffer, for boards whose partition was never flashed.
  * Fallback path: if decode fails, generate the procedural placeholder below so
  * the page never blanks.
  * --------------------------------------------------------------------------*/
 static const int   PLACEHOLDER_TEX_W = 512;
 static const int   PLACEHOLDER_TEX_H = 256;
 
-static uint16_t        *s_tex_buf = nullptr;   /* RGB565, s_tex_w*s_tex_h, PSRAM */
-static int              s_tex_w   = 0;         /* actual texture width           */
-static int              s_tex_h   = 0;         /* actual texture height          */
-static Image<RGB565>    s_tex;                  /* wraps s_tex_buf               */
+/* Mip chain (moon_raycast.h): level i is (s_tex_w >> i) x (s_tex_h >> i). The
+ * decoded and placeholder textures build MOON_TEX_LEVELS at init, the baked one
+ * brings its own. Each render samples the level moonTextureLevel() picks for
+ * its output size and disk scale: the full map for the resting panel frame, a
+ * quarter-width one for the 240 px drag frame, which then stays in cache and
+ * does not shimmer. MOON_TEX_MIPMAP 0 (or moon_sphere_set_mipmap(false))
+ * always samples level 0. */
+#ifndef MOON_TEX_LEVELS
+#define MOON_TEX_LEVELS 4   /* full map + 3 halvings: 2048 -> 256 wide */
+#endif
+#define MOON_TEX_MAX_LEVELS 12
+
+static uint16_t        *s_tex_buf = nullptr;   /* RGB565 chain, levels back to back, PSRAM */
+static const uint16_t  *s_tex_lvl[MOON_TEX_MAX_LEVELS]; /* what the renderers sample:
+                                                  into s_tex_buf or s_tex_flash  */
+static int              s_tex_levels = 0;
+static int              s_tex_w   = 0;         /* level 0 texture width          */
+static int              s_tex_h   = 0;         /* level 0 texture height         */
+static Image<RGB565>    s_tex;                  /* wraps level 0                  */
+
+/* Baked texture in flash, mapped read-only for the app lifetime (null when the
+ * partition is missing, erased or stale). Flips cannot be applied in place, so
+ * a flipped view renders from a PSRAM copy in s_tex_buf instead. */
+static const uint16_t  *s_tex_flash[MOON_TEX_MAX_LEVELS];
+static int              s_tex_flash_levels = 0;
+static int              s_tex_flash_w = 0;
+static int              s_tex_flash_h = 0;
+static esp_partition_mmap_handle_t s_tex_mmap;
 static bool             s_inited = false;
 static SemaphoreHandle_t s_init_mtx = nullptr;
+static SemaphoreHandle_t s_bg_mtx = nullptr;    /* background cache (below) */
 
 /* Runtime flip state actually baked into s_tex_buf. Used to detect a config
  * change in render_core and trigger a re-flip so flip toggles from the web UI
@@ -190,9 +270,68 @@ static void generate_placeholder_texture()
     }
 }
 
-/* Allocate the PSRAM RGB565 texture buffer for w*h pixels and wrap it with s_tex.
- * Returns true on success and sets s_tex_w/s_tex_h. */
-static bool alloc_texture(int w, int h)
+/* Levels a w x h map can halve to, up to `want`: each halving needs even sides. */
+static int chain_levels(int w, int h, int want)
+{
+    int levels = 1;
+    while (levels < want && levels < MOON_TEX_MAX_LEVELS &&
+           !((w >> (levels - 1)) & 1) && !((h >> (levels - 1)) & 1) &&
+           (w >> levels) >= 2 && (h >> levels) >= 2) {
+        levels++;
+    }
+    return levels;
+}
+
+/* Point the renderers at a chain of RGB565 levels, level 0 w*h. tgx only reads
+ * the texture, so the const flash mapping can back s_tex too. */
+static void use_texture(const uint16_t *const *lvl, int levels, int w, int h)
+{
+    for (int i = 0; i < levels; i++) s_tex_lvl[i] = lvl[i];
+    s_tex_levels = levels;
+    s_tex_w = w;
+    s_tex_h = h;
+    /* Stride == width for a tight buffer. */
+    s_tex.set(const_cast<uint16_t *>(lvl[0]), w, h, w);
+}
+
+/* Texels in the first n levels of a chain whose level 0 is w*h. */
+static size_t chain_texels(int w, int h, int n)
+{
+    size_t at = 0;
+    for (int k = 0; k < n; k++) at += (size_t)(w >> k) * (size_t)(h >> k);
+    return at;
+}
+
+/* Level i of a PSRAM chain whose level 0 is w*h: the levels sit back to back. */
+static uint16_t *chain_level(uint16_t *buf, int w, int h, int i)
+{
+    return buf + chain_texels(w, h, i);
+}
+
+/* Allocate a PSRAM RGB565 chain for a w*h level 0 and `levels` levels, without
+ * pointing the renderers at it. NULL (logged) when PSRAM is short. */
+static uint16_t *alloc_chain(int w, int h, int levels)
+{
+    size_t bytes = chain_texels(w, h, levels) * sizeof(uint16_t);
+    uint16_t *buf = (uint16_t *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+    if (!buf) {
+        LOG_ERROR_F("[MoonSphere] PSRAM lunar texture alloc failed (%dx%d, %d levels, %u bytes)\n",
+                    w, h, levels, (unsigned)bytes);
+    }
+    return buf;
+}
+
+/* Point the renderers at the chain in s_tex_buf. */
+static void use_texture_buf(int w, int h, int levels)
+{
+    const uint16_t *lvl[MOON_TEX_MAX_LEVELS];
+    for (int i = 0; i < levels; i++) lvl[i] = chain_level(s_tex_buf, w, h, i);
+    use_texture(lvl, levels, w, h);
+}
+
+/* Allocate the PSRAM RGB565 chain for a w*h level 0 and `levels` levels and wrap
+ * it with s_tex. Returns true on success and sets s_tex_w/s_tex_h. */
+static bool alloc_texture(int w, int h, int levels)
 {
     /* Free any previously decoded buffer so re-decode does not leak PSRAM. On
      * the first call s_tex_buf is NULL and this is a no-op. */
@@ -200,71 +339,197 @@ static bool alloc_texture(int w, int h)
         heap_caps_free(s_tex_buf);
         s_tex_buf = nullptr;
     }
-    size_t bytes = (size_t)w * (size_t)h * sizeof(uint16_t);
-    s_tex_buf = (uint16_t *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
-    if (!s_tex_buf) {
-        LOG_ERROR_F("[MoonSphere] PSRAM lunar texture alloc failed (%dx%d, %u bytes)\n",
-                    w, h, (unsigned)bytes);
-        return false;
-    }
-    s_tex_w = w;
-    s_tex_h = h;
-    /* Wrap the PSRAM buffer; stride == width for a tight buffer. */
-    s_tex.set(s_tex_buf, w, h, w);
+    s_tex_buf = alloc_chain(w, h, levels);
+    if (!s_tex_buf) return false;
+    use_texture_buf(w, h, levels);
     return true;
 }
 
-/* RUNTIME texture mirrors applied in place to the already-filled texture buffer.
+/* Fill levels 1.. of the PSRAM chain from level 0, each a 2x2 box of the one above. */
+static void build_mips(void)
+{
+    for (int i = 1; i < s_tex_levels; i++) {
+        MoonTexture up = { s_tex_lvl[i - 1], s_tex_w >> (i - 1), s_tex_h >> (i - 1) };
+        moonTextureHalve(&up, chain_level(s_tex_buf, s_tex_w, s_tex_h, i));
+    }
+}
+
+/* RUNTIME texture mirrors applied in place to every level of the already-filled
+ * texture buffer (a mirrored 2x2 box average is the box average of the mirror).
  * Flip state comes from the live config (configStorage.getMoonFlipU/V):
  *  - flip_u mirrors columns (x -> w-1-x): east<->west longitude swap.
  *  - flip_v mirrors rows    (y -> h-1-y): north<->south latitude swap.
  * Both default OFF, so the base orientation is unchanged on defaults. The mirror
  * helpers are self-inverse, so toggling an axis from the web UI is just one more
  * mirror of that axis. */
-static void mirror_texture_u(void)
-{
-    for (int y = 0; y < s_tex_h; y++) {
-        uint16_t *row = s_tex_buf + (size_t)y * (size_t)s_tex_w;
-        for (int x = 0; x < s_tex_w / 2; x++) {
-            uint16_t t = row[x];
-            row[x] = row[s_tex_w - 1 - x];
-            row[s_tex_w - 1 - x] = t;
+static void mirror_texture_u(uint16_t *buf, int w0, int h0, int levels)
+{
+    for (int i = 0; i < levels; i++) {
+        int w = w0 >> i, h = h0 >> i;
+        uint16_t *lvl = chain_level(buf, w0, h0, i);
+        for (int y = 0; y < h; y++) {
+            uint16_t *row = lvl + (size_t)y * (size_t)w;
+            for (int x = 0; x < w / 2; x++) {
+                uint16_t t = row[x];
+                row[x] = row[w - 1 - x];
+                row[w - 1 - x] = t;
+            }
         }
     }
 }
 
-static void mirror_texture_v(void)
+static void mirror_texture_v(uint16_t *buf, int w0, int h0, int levels)
 {
-    for (int y = 0; y < s_tex_h / 2; y++) {
-        uint16_t *a = s_tex_buf + (size_t)y * (size_t)s_tex_w;
-        uint16_t *b = s_tex_buf + (size_t)(s_tex_h - 1 - y) * (size_t)s_tex_w;
-        for (int x = 0; x < s_tex_w; x++) {
-            uint16_t t = a[x];
-            a[x] = b[x];
-            b[x] = t;
+    for (int i = 0; i < levels; i++) {
+        int w = w0 >> i, h = h0 >> i;
+        uint16_t *lvl = chain_level(buf, w0, h0, i);
+        for (int y = 0; y < h / 2; y++) {
+            uint16_t *a = lvl + (size_t)y * (size_t)w;
+            uint16_t *b = lvl + (size_t)(h - 1 - y) * (size_t)w;
+            for (int x = 0; x < w; x++) {
+                uint16_t t = a[x];
+                a[x] = b[x];
+                b[x] = t;
+            }
         }
     }
 }
 
-static void apply_texture_flips(void)
+/* Bring the texture to the wanted flip state from whatever s_applied_flip_u/v
+ * says it holds. Column/row mirrors commute and are self-inverse, so mirroring
+ * each changed axis once gets there from any prior state. With the baked flash
+ * texture the unflipped view samples flash directly; the first flip copies it to
+ * PSRAM, mirrors the copy and only then points the renderers at it, so a render
+ * on another task sees either the flash map or the finished copy. From then on
+ * the copy is mirrored in place like a decoded texture. The copy is kept once
+ * made: a render on another task may still be sampling it, and the mirrors
+ * never free what they flip. */
+static void set_texture_flips(int want_u, int want_v)
 {
-    int flip_u = configStorage.getMoonFlipU() ? 1 : 0;
-    int flip_v = configStorage.getMoonFlipV() ? 1 : 0;
+    if (s_tex_flash[0] && !s_tex_buf) {
+        if (!want_u && !want_v) {
+            use_texture(s_tex_flash, s_tex_flash_levels, s_tex_flash_w, s_tex_flash_h);
+            s_applied_flip_u = 0;
+            s_applied_flip_v = 0;
+            return;
+        }
+        const int w = s_tex_flash_w, h = s_tex_flash_h, levels = s_tex_flash_levels;
+        uint16_t *copy = alloc_chain(w, h, levels);
+        if (!copy) {
+            /* Stay on the unflipped flash texture; record the wanted state
+             * so this is not retried on every frame. */
+            use_texture(s_tex_flash, levels, w, h);
+            LOG_WARNING_F("[MoonSphere] texture flip needs a PSRAM copy; rendering unflipped\n");
+            s_applied_flip_u = want_u;
+            s_applied_flip_v = want_v;
+            return;
+        }
+        for (int i = 0; i < levels; i++) {
+            memcpy(chain_level(copy, w, h, i), s_tex_flash[i],
+                   (size_t)(w >> i) * (size_t)(h >> i) * sizeof(uint16_t));
+        }
+        if (want_u) mirror_texture_u(copy, w, h, levels);
+        if (want_v) mirror_texture_v(copy, w, h, levels);
+        s_tex_buf = copy;
+        use_texture_buf(w, h, levels);
+        s_applied_flip_u = want_u;
+        s_applied_flip_v = want_v;
+        return;
+    }
 
-    if (flip_u) mirror_texture_u();
-    if (flip_v) mirror_texture_v();
+    if (want_u != s_applied_flip_u) mirror_texture_u(s_tex_buf, s_tex_w, s_tex_h, s_tex_levels);
+    if (want_v != s_applied_flip_v) mirror_texture_v(s_tex_buf, s_tex_w, s_tex_h, s_tex_levels);
 
     /* Remember what is now baked into the buffer for live re-flip detection. */
-    s_applied_flip_u = flip_u;
-    s_applied_flip_v = flip_v;
+    s_applied_flip_u = want_u;
+    s_applied_flip_v = want_v;
+}
+
+/* Apply the configured flips to a freshly filled, unflipped texture. */
+static void apply_texture_flips(void)
+{
+    s_applied_flip_u = 0;
+    s_applied_flip_v = 0;
+    set_texture_flips(configStorage.getMoonFlipU() ? 1 : 0, configStorage.getMoonFlipV() ? 1 : 0);
+}
+
+/* Header of the image tools/bake_moon_texture.py writes into the `moontex`
+ * partition; level i is w >> i by h >> i texels at offset[i] from the start. */
+#define MOON_TEX_PARTITION_SUBTYPE ((esp_partition_subtype_t)0x40)
+#define MOON_TEX_FORMAT_RGB565     1
+
+typedef struct {
+    char     magic[8];          /* "MOONTX01" */
+    uint16_t w, h;              /* level 0, powers of two */
+    uint8_t  levels;
+    uint8_t  format;            /* MOON_TEX_FORMAT_RGB565 */
+    uint16_t reserved;
+    uint32_t offset[MOON_TEX_MAX_LEVELS];
+} moon_tex_header_t;
+
+/* Map the baked texture out of flash. Returns true with s_tex_flash set and the
+ * renderers pointed at it; false (nothing mapped) when the partition is absent,
+ * erased or does not hold a texture this build understands. */
+static bool init_flash_texture(void)
+{
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                                           MOON_TEX_PARTITION_SUBTYPE, "moontex");
+    if (!part) {
+        LOG_INFO_F("[MoonSphere] no moontex partition; decoding the embedded JPEG\n");
+        return false;
+    }
+
+    moon_tex_header_t hdr;
+    if (esp_partition_read(part, 0, &hdr, sizeof(hdr)) != ESP_OK ||
+        memcmp(hdr.magic, "MOONTX01", 8) != 0) {
+        LOG_INFO_F("[MoonSphere] moontex partition holds no baked texture "
+                   "(see tools/bake_moon_texture.py); decoding the embedded JPEG\n");
+        return false;
+    }
+
+    int w = hdr.w, h = hdr.h, levels = hdr.levels;
+    bool ok = hdr.format == MOON_TEX_FORMAT_RGB565 && levels >= 1 && levels <= MOON_TEX_MAX_LEVELS &&
+              w > 0 && h > 0 && !(w & (w - 1)) && !(h & (h - 1)) && (w >> (levels - 1)) >= 1 &&
+              (h >> (levels - 1)) >= 1;
+    /* Every level inside the partition; map up to the end of the last one */
+    size_t end = 0;
+    for (int i = 0; ok && i < levels; i++) {
+        size_t lvl_end = (size_t)hdr.offset[i] + (size_t)(w >> i) * (size_t)(h >> i) * sizeof(uint16_t);
+        ok = hdr.offset[i] >= sizeof(hdr) && (hdr.offset[i] & 1) == 0 && lvl_end <= part->size;
+        if (lvl_end > end) end = lvl_end;
+    }
+    if (!ok) {
+        LOG_WARNING_F("[MoonSphere] moontex header invalid (%dx%d, format %d, %d levels)\n",
+                      w, h, hdr.format, levels);
+        return false;
+    }
+
+    const void *base = nullptr;
+    if (esp_partition_mmap(part, 0, end, ESP_PARTITION_MMAP_DATA, &base, &s_tex_mmap) != ESP_OK) {
+        LOG_WARNING_F("[MoonSphere] moontex mmap failed (%u bytes)\n", (unsigned)end);
+        return false;
+    }
+
+    for (int i = 0; i < levels; i++) s_tex_flash[i] = (const uint16_t *)((const uint8_t *)base + hdr.offset[i]);
+    s_tex_flash_levels = levels;
+    s_tex_flash_w = w;
+    s_tex_flash_h = h;
+    apply_texture_flips();
+    LOG_INFO_F("[MoonSphere] mapped baked lunar texture %dx%d (%d levels) from the moontex partition\n",
+               w, h, levels);
+    return true;
 }
 
 /* Build the procedural placeholder texture (fallback when the real JPEG fails
  * to decode). Allocates its own buffer at the placeholder dimensions. */
 static bool init_placeholder_texture(void)
 {
-    if (!alloc_texture(PLACEHOLDER_TEX_W, PLACEHOLDER_TEX_H)) return false;
+    if (!alloc_texture(PLACEHOLDER_TEX_W, PLACEHOLDER_TEX_H,
+                       chain_levels(PLACEHOLDER_TEX_W, PLACEHOLDER_TEX_H, MOON_TEX_LEVELS))) {
+        return false;
+    }
     generate_placeholder_texture();
+    build_mips();
     apply_texture_flips();
     LOG_WARNING_F("[MoonSphere] using procedural placeholder lunar texture %dx%d "
                   "(real texture decode unavailable)\n",
@@ -303,7 +568,7 @@ static bool init_real_texture(void)
         return false;
     }
 
-    if (!alloc_texture(w, h)) {
+    if (!alloc_texture(w, h, chain_levels(w, h, MOON_TEX_LEVELS))) {
         stbi_image_free(img);
         return false;
     }
@@ -322,20 +587,23 @@ static bool init_real_texture(void)
     }
 
     stbi_image_free(img);
+    build_mips();
     apply_texture_flips();
-    LOG_INFO_F("[MoonSphere] decoded real lunar texture %dx%d (src channels=%d) "
-               "from moon_equirect.jpg\n", w, h, ch);
+    LOG_INFO_F("[MoonSphere] decoded real lunar texture %dx%d (src channels=%d, %d levels) "
+               "from moon_equirect.jpg\n", w, h, ch, s_tex_levels);
     return true;
 }
 
 extern "C" bool moon_sphere_init(void)
 {
     if (!s_init_mtx) s_init_mtx = xSemaphoreCreateMutex();
+    if (!s_bg_mtx)   s_bg_mtx   = xSemaphoreCreateMutex();
     if (s_init_mtx) xSemaphoreTake(s_init_mtx, portMAX_DELAY);
 
     if (!s_inited) {
-        /* Primary path: real embedded texture. Fallback: procedural placeholder. */
-        if (init_real_texture() || init_placeholder_texture()) {
+        /* Primary path: baked texture in flash. Then the embedded JPEG, then
+         * the procedural placeholder. */
+        if (init_flash_texture() || init_real_texture() || init_placeholder_texture()) {
             s_inited = true;
         }
     }
@@ -344,9 +612,8 @@ extern "C" bool moon_sphere_init(void)
     return s_inited;
 }
 
-/* Apply a live flip-config change to the EXISTING decoded texture buffer in
- * place, with no JPEG re-decode. A flip is a row/column mirror, which is its own
- * inverse, so toggling an axis = mirroring that axis once. Guarded by the init
+/* Apply a live flip-config change to the EXISTING texture, with no JPEG
+ * re-decode or flash re-map (set_texture_flips). Guarded by the init
  * mutex. No-op when the flip state already matches (the common steady-state
  * path, zero cost). */
 static void moon_sphere_reflip_if_changed(void)
@@ -358,73 +625,62 @@ static void moon_sphere_reflip_if_changed(void)
     if (s_init_mtx) xSemaphoreTake(s_init_mtx, portMAX_DELAY);
     /* Re-check under the lock in case another task already re-flipped. */
     if (want_u != s_applied_flip_u || want_v != s_applied_flip_v) {
-        if (s_tex_buf == nullptr) {
-            /* No texture decoded yet (shouldn't happen post-init): do a full
-             * decode, which applies the current flips itself. */
-            if (!init_real_texture()) init_placeholder_texture();
+        if (s_tex_levels == 0) {
+            /* No texture loaded yet (shouldn't happen post-init): do a full
+             * load, which applies the current flips itself. */
+            if (!init_flash_texture() && !init_real_texture()) init_placeholder_texture();
         } else {
-            /* Apply only the delta in place. Column/row mirrors commute and are
-             * self-inverse, so mirroring the changed axis once reaches the target
-             * state from any prior state. */
-            if (want_u != s_applied_flip_u) {
-                mirror_texture_u();
-                s_applied_flip_u = want_u;
-            }
-            if (want_v != s_applied_flip_v) {
-                mirror_texture_v();
-                s_applied_flip_v = want_v;
-            }
+            set_texture_flips(want_u, want_v);
         }
     }
     if (s_init_mtx) xSemaphoreGive(s_init_mtx);
 }
 
-/* Shaders compiled into the renderer:
- * orthographic projection + z-buffer + Gouraud (per-vertex Lambert/diffuse)
- * shading + bilinear texture sampling with power-of-two wrapping. GOURAUD (not
- * FLAT) so the sphere is lit per-vertex with normals interpolated across each
- * triangle, avoiding the faint facet grid FLAT shading produces. */
-static const Shader LOADED_SHADERS =
-    SHADER_ORTHO | SHADER_ZBUFFER | SHADER_GOURAUD |
-    SHADER_TEXTURE_BILINEAR | SHADER_TEXTURE_WRAP_POW2;
-
-/* Core sphere renderer. Rasterizes into `color_buf` (RGB565) using `zbuf` as the
- * depth buffer; both must be w*h uint16 and 128-byte aligned (PPA / cache line).
- * The caller owns both buffers and their lifetime. */
-static uint16_t *moon_sphere_render_core(int w, int h, const moon_state_t *st,
-                                         int nb_sectors, int nb_stacks,
-                                         uint8_t bg_style,
-                                         float yaw_deg, float pitch_deg,
-                                         moon_light_mode_t light_mode,
-                                         uint16_t *color_buf, uint16_t *zbuf)
+/* Soft warm glow halo rows [row_begin, row_end): additive ring in
+ * [R_disc, R_disc*1.35] over whatever the background already holds. Rows are
+ * independent, so the pool runs bands of them on both cores. */
+typedef struct {
+    uint16_t *buf;
+    int w;
+    float R_disc, R_disc2, Rout2, inv_band;
+    float cx, cy;
+} glow_job_t;
+
+static void glow_rows(void *ctx, int row_begin, int row_end)
 {
-    const size_t npix      = (size_t)w * (size_t)h;
-    const size_t color_sz  = npix * sizeof(uint16_t);
-
-    /* Disk-scale-derived orthographic half-extent (NEW vs. NINA). With
-     * s_disk_scale == 1.0 this equals NINA's fixed 1.08 (disk fills the frame).
-     * Larger ORTHO_R -> a smaller disk within the frame, leaving the starfield/
-     * glow background to fill out to the screen edge. Used for BOTH the renderer
-     * setOrtho() AND the glow-halo R_disc geometry so the glow tracks the disk. */
-    const float ORTHO_R = 1.08f / s_disk_scale;
-
-    /* If the flip config changed since the texture was last decoded, re-apply the
-     * flips now so web-UI flip toggles take effect live. No-op when unchanged. */
-    moon_sphere_reflip_if_changed();
-
-    /* ----- Background ----------------------------------------------------
-     * Drawn DIRECTLY into color_buf BEFORE the sphere is rasterized, across the
-     * WHOLE w*h buffer, so the background fills to the screen edge regardless of
-     * disk size. The Renderer3D only writes the pixels the disc covers, so the
-     * background shows through everywhere outside the lunar disc. Do NOT call
-     * im.fillScreen() after this, it would erase the background.
-     *   bit 0 (bg_style 1 or 3): deterministic starfield
-     *   bit 1 (bg_style 2 or 3): soft warm glow halo just outside the disc
-     *   bg_style 0: plain black */
-    Image<RGB565> im(color_buf, w, h, w);
+    const glow_job_t *j = (const glow_job_t *)ctx;
+    for (int py = row_begin; py < row_end; py++) {
+        float dy = (float)py - j->cy;
+        uint16_t *row = j->buf + (size_t)py * j->w;
+        for (int px = 0; px < j->w; px++) {
+            float dx = (float)px - j->cx;
+            float r2 = dx * dx + dy * dy;
+            if (r2 <= j->R_disc2 || r2 >= j->Rout2) continue;
+            float dist = sqrtf(r2);
+            float t = 1.0f - (dist - j->R_disc) * j->inv_band;   /* 1 at disc edge -> 0 */
+            int add = (int)(40.0f * t);
+            uint16_t c = row[px];
+            int r = ((c >> 11) & 0x1F) * 255 / 31 + add;
+            int g = ((c >> 5)  & 0x3F) * 255 / 63 + add * 9 / 10;   /* warm */
+            int b = ( c        & 0x1F) * 255 / 31 + add * 7 / 10;   /* warm */
+            /* Ordered dither fills RGB565 truncation slack (kills rings). */
+            int dr = s_bayer4[py & 3][px & 3] >> 1;   /* 0..7 */
+            int dg = s_bayer4[py & 3][px & 3] >> 2;   /* 0..3 */
+            int db = dr;
+            row[px] = pack565(r + dr, g + dg, b + db);
+        }
+    }
+}
 
+/* Background drawn across the WHOLE w*h buffer, so it fills to the screen
+ * edge regardless of disk size:
+ *   bit 0 (bg_style 1 or 3): deterministic starfield
+ *   bit 1 (bg_style 2 or 3): soft warm glow halo just outside the disc
+ *   bg_style 0: plain black */
+static void draw_background(uint16_t *buf, int w, int h, float ortho_r, uint8_t bg_style)
+{
     /* 1. Black base. */
-    memset(color_buf, 0, color_sz);   /* RGB565 0x0000 */
+    memset(buf, 0, (size_t)w * (size_t)h * sizeof(uint16_t));   /* RGB565 0x0000 */
 
     /* 2. Deterministic starfield (fixed LCG seed for frame-stable stars). */
     if (bg_style & 1) {
@@ -436,71 +692,226 @@ static uint16_t *moon_sphere_render_core(int w, int h, const moon_state_t *st,
             seed = seed * 1103515245u + 12345u;
             int sy = (int)((seed >> 8) % (uint32_t)h);
             int br = 120 + (int)((seed >> 4) & 0x7F);
-            color_buf[(size_t)sy * w + sx] = pack565(br, br, br);
+            buf[(size_t)sy * w + sx] = pack565(br, br, br);
         }
     }
 
     /* 3. Soft warm glow halo: additive ring in [R_disc, R_disc*1.35].
-     * Disc geometry: the sphere is unit radius and setOrtho uses half-extent
-     * ORTHO_R, so the disc pixel radius is (1.0/ORTHO_R) * 0.5 * min(w,h). This
-     * uses the SAME disk-scale-derived ORTHO_R as setOrtho below, so the glow
-     * tracks the disk size. */
+     * Disc geometry: the sphere is unit radius and the view's half-extent is
+     * ortho_r, so the disc pixel radius is (1.0/ortho_r) * 0.5 * min(w,h). The
+     * caller passes the SAME disk-scale-derived ORTHO_R the disc is drawn
+     * with, so the glow tracks the disk size. */
     if (bg_style & 2) {
-        const float R_disc  = (1.0f / ORTHO_R) * 0.5f * (float)((w < h) ? w : h);
-        const float cx = (float)(w - 1) * 0.5f;
-        const float cy = (float)(h - 1) * 0.5f;
-        const float R_disc2 = R_disc * R_disc;
-        const float Rout    = R_disc * 1.35f;
-        const float Rout2   = Rout * Rout;
-        const float inv_band = 1.0f / (R_disc * 0.35f);
-        for (int py = 0; py < h; py++) {
-            float dy = (float)py - cy;
-            uint16_t *row = color_buf + (size_t)py * w;
-            for (int px = 0; px < w; px++) {
-                float dx = (float)px - cx;
-                float r2 = dx * dx + dy * dy;
-                if (r2 <= R_disc2 || r2 >= Rout2) continue;
-                float dist = sqrtf(r2);
-                float t = 1.0f - (dist - R_disc) * inv_band;   /* 1 at disc edge -> 0 */
-                int add = (int)(40.0f * t);
-                uint16_t c = row[px];
-                int r = ((c >> 11) & 0x1F) * 255 / 31 + add;
-                int g = ((c >> 5)  & 0x3F) * 255 / 63 + add * 9 / 10;   /* warm */
-                int b = ( c        & 0x1F) * 255 / 31 + add * 7 / 10;   /* warm */
-                /* Ordered dither fills RGB565 truncation slack (kills rings). */
-                int dr = s_bayer4[py & 3][px & 3] >> 1;   /* 0..7 */
-                int dg = s_bayer4[py & 3][px & 3] >> 2;   /* 0..3 */
-                int db = dr;
-                row[px] = pack565(r + dr, g + dg, b + db);
+        glow_job_t job;
+        job.buf      = buf;
+        job.w        = w;
+        job.R_disc   = (1.0f / ortho_r) * 0.5f * (float)((w < h) ? w : h);
+        job.cx       = (float)(w - 1) * 0.5f;
+        job.cy       = (float)(h - 1) * 0.5f;
+        job.R_disc2  = job.R_disc * job.R_disc;
+        const float Rout = job.R_disc * 1.35f;
+        job.Rout2    = Rout * Rout;
+        job.inv_band = 1.0f / (job.R_disc * 0.35f);
+        rowPoolRun(h, glow_rows, &job);
+    }
+}
+
+/* ----------------------------------------------------------------------------
+ * Background cache. The background depends only on (w, h, disk scale,
+ * bg_style), yet the drag loop redraws it ~30 times a second: a full-frame
+ * memset, the starfield and a per-pixel sqrtf glow ring. Keep the finished
+ * layer per key and copy it in instead; rebuild only when a key changes.
+ * Two slots, least recently used replaced, so the 240x240 drag frames and the
+ * panel-sized resting frame do not evict each other. Plain black (bg_style 0)
+ * is a memset and is not cached. MOON_BG_CACHE 0 draws every frame, for
+ * comparing frame times.
+ * --------------------------------------------------------------------------*/
+#ifndef MOON_BG_CACHE
+#define MOON_BG_CACHE 1
+#endif
+
+#define MOON_BG_SLOTS 2
+
+typedef struct {
+    uint16_t *buf;
+    int       w, h;
+    float     ortho_r;
+    uint8_t   bg_style;
+    uint32_t  last_used;
+} bg_slot_t;
+
+static bg_slot_t         s_bg_slots[MOON_BG_SLOTS];
+static uint32_t          s_bg_clock = 0;
+
+static void fill_background(uint16_t *color_buf, int w, int h, float ortho_r, uint8_t bg_style)
+{
+#if MOON_BG_CACHE
+    if ((bg_style & 3) && s_bg_mtx) {
+        const size_t bytes = (size_t)w * (size_t)h * sizeof(uint16_t);
+        xSemaphoreTake(s_bg_mtx, portMAX_DELAY);
+        bg_slot_t *slot = nullptr;
+        for (int i = 0; i < MOON_BG_SLOTS; i++) {
+            bg_slot_t *c = &s_bg_slots[i];
+            if (c->buf && c->w == w && c->h == h && c->ortho_r == ortho_r && c->bg_style == bg_style) {
+                slot = c;
+                break;
             }
         }
+        if (!slot) {
+            /* Miss: rebuild the least recently used slot for this key. */
+            slot = &s_bg_slots[0];
+            for (int i = 1; i < MOON_BG_SLOTS; i++) {
+                if (s_bg_slots[i].last_used < slot->last_used) slot = &s_bg_slots[i];
+            }
+            if (slot->buf && (slot->w != w || slot->h != h)) {
+                heap_caps_free(slot->buf);
+                slot->buf = nullptr;
+            }
+            if (!slot->buf) {
+                slot->buf = (uint16_t *)heap_caps_aligned_alloc(128, bytes, MALLOC_CAP_SPIRAM);
+            }
+            if (slot->buf) {
+                draw_background(slot->buf, w, h, ortho_r, bg_style);
+                slot->w = w;
+                slot->h = h;
+                slot->ortho_r = ortho_r;
+                slot->bg_style = bg_style;
+            }
+        }
+        if (slot->buf) {
+            slot->last_used = ++s_bg_clock;
+            memcpy(color_buf, slot->buf, bytes);
+            xSemaphoreGive(s_bg_mtx);
+            return;
+        }
+        xSemaphoreGive(s_bg_mtx);   /* no PSRAM for a slot: draw it in place */
     }
+#endif
+    draw_background(color_buf, w, h, ortho_r, bg_style);
+}
+
+/* Shaders compiled into the renderer:
+ * orthographic projection + Gouraud (per-vertex Lambert/diffuse) shading +
+ * bilinear texture sampling with power-of-two wrapping, WITHOUT depth testing.
+ * GOURAUD (not FLAT) so the sphere is lit per-vertex with normals interpolated
+ * across each triangle, avoiding the faint facet grid FLAT shading produces.
+ * NOZBUFFER: with back-face culling on, the front faces of one convex sphere
+ * project side by side without overlapping, so the depth test never rejects a
+ * pixel. Dropping it saves the w*h z-buffer and its clear pass and leaves the
+ * image pixel-identical (test/bench_moon_raycast.cpp). */
+static const Shader LOADED_SHADERS =
+    SHADER_ORTHO | SHADER_NOZBUFFER | SHADER_GOURAUD |
+    SHADER_TEXTURE_BILINEAR | SHADER_TEXTURE_WRAP_POW2;
+
+/* ----------------------------------------------------------------------------
+ * Disc bands. The disc is drawn as horizontal bands of rows, one per row pool
+ * worker, so both cores share it; the caller waits. Every band gives exactly
+ * the pixels a single pass gives: ray-cast rows are independent of each other,
+ * and each mesh band is the whole tgx sphere drawn through a viewport offset
+ * into an image that covers only that band's rows (tgx's tiled rendering),
+ * which clips the same triangles at the same pixel centres. The disc is
+ * centred, so equal row counts are equal work. MOON_RENDER_BANDS 0 (or
+ * moon_sphere_set_banded(false)) draws the disc on the calling core alone. */
+#ifndef MOON_RENDER_BANDS
+#define MOON_RENDER_BANDS 1
+#endif
+
+static bool s_banded = MOON_RENDER_BANDS;
+
+void moon_sphere_set_banded(bool on)
+{
+    s_banded = on;
+}
+
+bool moon_sphere_get_banded(void)
+{
+    return s_banded;
+}
+
+typedef struct {
+    const MoonRaycastView *view;
+    const MoonTexture *tex;
+    uint16_t *buf;
+    int w, h;
+} raycast_job_t;
+
+static void raycast_rows(void *ctx, int row_begin, int row_end)
+{
+    const raycast_job_t &job = *(const raycast_job_t *)ctx;
+    moonRaycastRows(job.view, job.tex, job.buf, job.w, job.h, row_begin, row_end);
+}
+
+typedef struct {
+    uint16_t *buf;
+    int w, h;
+    float ortho_r;
+    fMat4 M;                    /* model matrix, sphere pushed down -Z */
+    fVec3 light;
+    RGBf tint;
+    float ambient, diffuse;
+    int nb_sectors, nb_stacks;
+    Image<RGB565> *tex;
+} mesh_job_t;
+
+static void mesh_rows(void *ctx, int row_begin, int row_end)
+{
+    mesh_job_t &job = *(mesh_job_t *)ctx;
+    Image<RGB565> band(job.buf + (size_t)row_begin * (size_t)job.w, job.w, row_end - row_begin, job.w);
 
-    /* ----- Set up the renderer ------------------------------------------- */
     Renderer3D<RGB565, LOADED_SHADERS, uint16_t> renderer;
-    renderer.setViewportSize(w, h);
-    renderer.setOffset(0, 0);
-    renderer.setImage(&im);
-    renderer.setZbuffer(zbuf);
-    renderer.clearZbuffer();
-    renderer.setCulling(1);
+    renderer.setViewportSize(job.w, job.h);
+    renderer.setOffset(0, row_begin);
+    renderer.setImage(&band);
+    renderer.setCulling(1);   /* required: culling is what stands in for depth */
 
     /* Orthographic box sized to a unit sphere (radius 1) using the disk-scale-
      * derived ORTHO_R half-extent. near/far bracket the sphere on the z axis. */
-    renderer.setOrtho(-ORTHO_R, ORTHO_R, -ORTHO_R, ORTHO_R, 0.1f, 10.0f);
+    renderer.setOrtho(-job.ortho_r, job.ortho_r, -job.ortho_r, job.ortho_r, 0.1f, 10.0f);
 
-    /* Diffuse-only (Lambert) material: ambient low so the unlit limb goes dark
-     * (terminator), diffuse high, specular off. Warm tint so the lit moon reads
-     * warm-gray rather than neutral; the texture grayscale still shows through. */
-    renderer.setShaders(SHADER_GOURAUD | SHADER_TEXTURE_BILINEAR | SHADER_TEXTURE_WRAP_POW2);
-    renderer.setMaterialColor(RGBf(1.0f, 0.96f, 0.86f));
-    renderer.setMaterialAmbiantStrength(0.06f);
-    renderer.setMaterialDiffuseStrength(1.0f);
+    renderer.setShaders(SHADER_NOZBUFFER | SHADER_GOURAUD | SHADER_TEXTURE_BILINEAR |
+                        SHADER_TEXTURE_WRAP_POW2);
+    renderer.setMaterialColor(job.tint);
+    renderer.setMaterialAmbiantStrength(job.ambient);
+    renderer.setMaterialDiffuseStrength(job.diffuse);
     renderer.setMaterialSpecularStrength(0.0f);
 
     renderer.setLightAmbiant(RGBf(1.0f, 1.0f, 1.0f));
     renderer.setLightDiffuse(RGBf(1.0f, 1.0f, 1.0f));
     renderer.setLightSpecular(RGBf(0.0f, 0.0f, 0.0f));
+    renderer.setModelMatrix(job.M);
+    renderer.setLightDirection(job.light);
+
+    renderer.drawSphere(job.nb_sectors, job.nb_stacks, job.tex);
+}
+
+/* Core sphere renderer. Draws into `color_buf` (RGB565, w*h, 128-byte aligned
+ * for PPA / cache line) with `disc_renderer`. The caller owns the buffer and
+ * its lifetime. */
+static uint16_t *moon_sphere_render_core(int w, int h, const moon_state_t *st,
+                                         int nb_sectors, int nb_stacks,
+                                         uint8_t bg_style,
+                                         float yaw_deg, float pitch_deg,
+                                         moon_light_mode_t light_mode,
+                                         moon_renderer_t disc_renderer,
+                                         uint16_t *color_buf)
+{
+    /* Disk-scale-derived orthographic half-extent (NEW vs. NINA). With
+     * s_disk_scale == 1.0 this equals NINA's fixed 1.08 (disk fills the frame).
+     * Larger ORTHO_R -> a smaller disk within the frame, leaving the starfield/
+     * glow background to fill out to the screen edge. Used for BOTH the renderer
+     * setOrtho() AND the glow-halo R_disc geometry so the glow tracks the disk. */
+    const float ORTHO_R = 1.08f / s_disk_scale;
+
+    /* If the flip config changed since the texture was last decoded, re-apply the
+     * flips now so web-UI flip toggles take effect live. No-op when unchanged. */
+    moon_sphere_reflip_if_changed();
+
+    /* ----- Background ----------------------------------------------------
+     * Fills the WHOLE w*h buffer BEFORE the sphere is drawn; the disc renderers
+     * only write the pixels the disc covers, so the background shows through
+     * everywhere else. Do NOT fill the image after this, it would erase
+     * the background. */
+    fill_background(color_buf, w, h, ORTHO_R, bg_style);
 
     /* ----- Model matrix: orient the disc -------------------------------
      * tgx sphere + camera conventions (verified against the tgx sources):
@@ -574,12 +985,6 @@ static uint16_t *moon_sphere_render_core(int w, int h, const moon_state_t *st,
     M_rot.multRotate(pitch_deg, fVec3(1.0f, 0.0f, 0.0f)); /* drag: pitch (screen-horiz) */
     M_rot.multRotate(yaw_deg,   fVec3(0.0f, 1.0f, 0.0f)); /* drag: yaw   (screen-vert)  */
 
-    fMat4 M = M_rot;
-    /* Push the unit sphere down -Z so it lands between zNear (0.1) and zFar (10),
-     * centered at z = -2 (camera at origin looking toward -Z). */
-    M.multTranslate(fVec3(0.0f, 0.0f, -2.0f));
-    renderer.setModelMatrix(M);
-
     /* ----- Lighting: directional light from the sub-solar point ----------
      * st->sun_lon / st->sun_lat are the sub-solar selenographic coordinates.
      * Build the unit vector to the sun-lit surface point in the body frame, then
@@ -595,41 +1000,98 @@ static uint16_t *moon_sphere_render_core(int w, int h, const moon_state_t *st,
     float n = sqrtf(sun_w.x * sun_w.x + sun_w.y * sun_w.y + sun_w.z * sun_w.z);
     if (n > 1e-6f) { sun_w.x /= n; sun_w.y /= n; sun_w.z /= n; }
 
+    /* Diffuse-only (Lambert) material: ambient low so the unlit limb goes dark
+     * (terminator), diffuse high, specular off. Warm tint so the lit moon reads
+     * warm-gray rather than neutral; the texture grayscale still shows through.
+     * True sub-solar phase keeps the directional sub-solar light so the real
+     * phase terminator shows. */
+    const RGBf tint(1.0f, 0.96f, 0.86f);
+    float ambient = 0.06f;
+    float diffuse = 1.0f;
+    fVec3 light = sun_w;
     if (light_mode == MOON_LIGHT_EXPLORE) {
         /* Explore view: light the whole disc so the user can inspect the far
          * side while spinning. Raise ambient near full and drop diffuse to a
          * gentle view-aligned headlight (-Z) for mild shading with no night side. */
-        renderer.setMaterialAmbiantStrength(0.95f);
-        renderer.setMaterialDiffuseStrength(0.15f);
-        renderer.setLightDirection(fVec3(0.0f, 0.0f, -1.0f));
-    } else {
-        /* True sub-solar phase: keep the directional sub-solar light so the real
-         * phase terminator shows (material/light defaults set above). */
-        renderer.setLightDirection(fVec3(sun_w.x, sun_w.y, sun_w.z));
+        ambient = 0.95f;
+        diffuse = 0.15f;
+        light   = fVec3(0.0f, 0.0f, -1.0f);
     }
 
-    /* ----- Draw the textured sphere -------------------------------------- */
-    renderer.drawSphere(nb_sectors, nb_stacks, &s_tex);
+    /* ----- Texture level: nearest one texel per pixel at the disc centre --
+     * (moonTextureLevel): the full map at panel size, a smaller level for the
+     * drag frame and small discs. Both renderers sample the same level. */
+    int lvl = s_mipmap ? moonTextureLevel(s_tex_w, s_tex_levels, w, ORTHO_R) : 0;
+    MoonTexture tex = { s_tex_lvl[lvl], s_tex_w >> lvl, s_tex_h >> lvl };
+
+    /* ----- Ray cast: shade each disc pixel from its analytic normal ------
+     * Same orientation, light and material as the mesh below, with M_rot's
+     * columns as the body -> view rotation. Writes only disc pixels, so the
+     * background drawn above shows through as before. */
+    if (disc_renderer == MOON_RENDER_RAYCAST) {
+        MoonRaycastView view;
+        for (int c = 0; c < 3; c++) {
+            fVec4 col = M_rot.mult0(fVec3(c == 0 ? 1.0f : 0.0f, c == 1 ? 1.0f : 0.0f, c == 2 ? 1.0f : 0.0f));
+            view.rot[0][c] = col.x;
+            view.rot[1][c] = col.y;
+            view.rot[2][c] = col.z;
+        }
+        view.light[0] = light.x;
+        view.light[1] = light.y;
+        view.light[2] = light.z;
+        view.tint[0]  = tint.R;
+        view.tint[1]  = tint.G;
+        view.tint[2]  = tint.B;
+        view.ambient  = ambient;
+        view.diffuse  = diffuse;
+        view.orthoR   = ORTHO_R;
+        raycast_job_t job = { &view, &tex, color_buf, w, h };
+        if (s_banded) rowPoolRun(h, raycast_rows, &job);
+        else          raycast_rows(&job, 0, h);
+        return color_buf;
+    }
 
-    /* Both buffers are caller-owned; do NOT free here. Return the color buffer. */
+    /* ----- Mesh: tgx tessellated sphere (mesh_rows) ----------------------- */
+    Image<RGB565> tex_im(const_cast<uint16_t *>(tex.texels), tex.w, tex.h, tex.w);
+    mesh_job_t job;
+    job.buf        = color_buf;
+    job.w          = w;
+    job.h          = h;
+    job.ortho_r    = ORTHO_R;
+    job.M          = M_rot;
+    /* Push the unit sphere down -Z so it lands between zNear (0.1) and zFar (10),
+     * centered at z = -2 (camera at origin looking toward -Z). */
+    job.M.multTranslate(fVec3(0.0f, 0.0f, -2.0f));
+    job.light      = light;
+    job.tint       = tint;
+    job.ambient    = ambient;
+    job.diffuse    = diffuse;
+    job.nb_sectors = nb_sectors;
+    job.nb_stacks  = nb_stacks;
+    job.tex        = &tex_im;
+    if (s_banded) rowPoolRun(h, mesh_rows, &job);
+    else          mesh_rows(&job, 0, h);
+
+    /* The buffer is caller-owned; do NOT free here. */
     return color_buf;
 }
 
-/* Render into CALLER-PROVIDED color + z buffers (no per-frame alloc/free). Both
- * must be w*h uint16 and 128-byte aligned (PPA / cache line). Returns color_buf
- * on success, nullptr on bad args. */
+/* Render into a CALLER-PROVIDED color buffer (no per-frame alloc/free). Must
+ * be w*h uint16 and 128-byte aligned (PPA / cache line). Returns color_buf on
+ * success, nullptr on bad args. */
 extern "C" uint16_t *moon_sphere_render_into(int w, int h, const moon_state_t *st,
                                              int nb_sectors, int nb_stacks,
                                              uint8_t bg_style,
                                              float yaw_deg, float pitch_deg,
                                              moon_light_mode_t light_mode,
-                                             uint16_t *color_buf, uint16_t *zbuf)
+                                             uint16_t *color_buf)
 {
-    if (w <= 0 || h <= 0 || st == nullptr || color_buf == nullptr || zbuf == nullptr)
+    if (w <= 0 || h <= 0 || st == nullptr || color_buf == nullptr)
         return nullptr;
     if (!moon_sphere_init()) return nullptr;
     return moon_sphere_render_core(w, h, st, nb_sectors, nb_stacks, bg_style,
-                                   yaw_deg, pitch_deg, light_mode, color_buf, zbuf);
+                                   yaw_deg, pitch_deg, light_mode, s_renderer,
+                                   color_buf);
 }
 
 extern "C" uint16_t *moon_sphere_render_ex(int w, int h, const moon_state_t *st,
@@ -645,29 +1107,19 @@ extern "C" uint16_t *moon_sphere_render_ex(int w, int h, const moon_state_t *st,
 
     const size_t npix      = (size_t)w * (size_t)h;
     const size_t color_sz  = npix * sizeof(uint16_t);
-    const size_t z_sz      = npix * sizeof(uint16_t);
 
-    /* Color + z-buffer in PSRAM, 128-byte aligned (PPA / cache line). */
+    /* Color buffer in PSRAM, 128-byte aligned (PPA / cache line). */
     uint16_t *color_buf =
         (uint16_t *)heap_caps_aligned_alloc(128, color_sz, MALLOC_CAP_SPIRAM);
-    uint16_t *zbuf =
-        (uint16_t *)heap_caps_aligned_alloc(128, z_sz, MALLOC_CAP_SPIRAM);
-
-    if (!color_buf || !zbuf) {
-        LOG_ERROR_F("[MoonSphere] PSRAM alloc failed (color=%p z=%p, %dx%d)\n",
-                    (void *)color_buf, (void *)zbuf, w, h);
-        if (color_buf) heap_caps_free(color_buf);
-        if (zbuf)      heap_caps_free(zbuf);
+    if (!color_buf) {
+        LOG_ERROR_F("[MoonSphere] PSRAM alloc failed (color, %dx%d)\n", w, h);
         return nullptr;   /* caller keeps previous frame */
     }
 
-    moon_sphere_render_core(w, h, st, nb_sectors, nb_stacks,
-                            bg_style, yaw_deg, pitch_deg,
-                            light_mode, color_buf, zbuf);
-
-    /* z-buffer no longer needed; return only the color buffer (caller frees). */
-    heap_caps_free(zbuf);
-    return color_buf;
+    /* Return the color buffer (caller frees). */
+    return moon_sphere_render_core(w, h, st, nb_sectors, nb_stacks,
+                                   bg_style, yaw_deg, pitch_deg,
+                                   light_mode, s_renderer, color_buf);
 }
 
 /* Thin wrapper: the original sub-solar-lit, no-user-rotation render. */
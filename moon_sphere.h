@@ -25,21 +25,44 @@ uint16_t *moon_sphere_render_ex(int w, int h, const moon_state_t *st,
                                 float yaw_deg, float pitch_deg,
                                 moon_light_mode_t light_mode);
 
-/* Same as moon_sphere_render_ex() but renders into CALLER-PROVIDED color + z
- * buffers (no per-frame heap alloc/free). Both must be w*h uint16 and 128-byte
- * aligned (PPA / cache line). Returns color_buf on success or NULL on bad args.
- * Used by the drag-to-rotate loop with persistent scratch buffers. */
+/* Same as moon_sphere_render_ex() but renders into a CALLER-PROVIDED color
+ * buffer (no per-frame heap alloc/free). Must be w*h uint16 and 128-byte
+ * aligned (PPA / cache line). No z-buffer is needed: the sphere is convex and
+ * back faces are culled. Returns color_buf on success or NULL on bad args.
+ * Used by the drag-to-rotate loop with a persistent scratch buffer. */
 uint16_t *moon_sphere_render_into(int w, int h, const moon_state_t *st,
                                   int nb_sectors, int nb_stacks, uint8_t bg_style,
                                   float yaw_deg, float pitch_deg,
                                   moon_light_mode_t light_mode,
-                                  uint16_t *color_buf, uint16_t *zbuf);
+                                  uint16_t *color_buf);
 
 /* Set the disk scale for subsequent renders.
    1.0 = moon disk fills the frame edge-to-edge; <1.0 shrinks the disk within
    the frame so the starfield/glow background fills out to the screen edge.
    Clamped internally. Applied to the next render. */
 void moon_sphere_set_disk_scale(float scale);
+
+/* How the lunar disc is drawn. RAYCAST shades each disc pixel from its
+   analytic sphere normal (no mesh, nb_sectors/nb_stacks
+   ignored); MESH is the tgx tessellated sphere, kept for comparison.
+   Defaults to MOON_RENDERER (RAYCAST). Applied to the next render. */
+typedef enum { MOON_RENDER_RAYCAST = 0, MOON_RENDER_MESH = 1 } moon_renderer_t;
+void moon_sphere_set_renderer(moon_renderer_t renderer);
+moon_renderer_t moon_sphere_get_renderer(void);
+
+/* Whether renders sample the lunar texture's mip chain: the level nearest one
+   texel per output pixel for the frame size and disk scale, so small and
+   interactive frames read a smaller, cache-friendly map and do not shimmer.
+   Off samples the full map at every size. Defaults to MOON_TEX_MIPMAP (on).
+   Applied to the next render. */
+void moon_sphere_set_mipmap(bool on);
+bool moon_sphere_get_mipmap(void);
+
+/* Whether the disc is drawn as row bands on the row pool's workers (both
+   cores) rather than on the calling core alone. Same pixels either way.
+   Defaults to MOON_RENDER_BANDS (on). Applied to the next render. */
+void moon_sphere_set_banded(bool on);
+bool moon_sphere_get_banded(void);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,258 @@
+#include "pixel_kernels.h"
+#include <stdlib.h>
+
+// Two RGB565 pixels, first one in the low half (little-endian)
+typedef uint32_t __attribute__((may_alias)) PixelPair;
+
+static const int FP_SHIFT = 16;
+static const uint32_t FP_MASK = (1u << FP_SHIFT) - 1;
+
+void pxFillRef(uint16_t* dst, size_t count, uint16_t color) {
+    for (size_t i = 0; i < count; i++) dst[i] = color;
+}
+
+void pxFillWide(uint16_t* dst, size_t count, uint16_t color) {
+    if (count && ((uintptr_t)dst & 2)) {
+        *dst++ = color;
+        count--;
+    }
+    PixelPair pair = color | ((uint32_t)color << 16);
+    PixelPair* d = (PixelPair*)dst;
+    size_t words = count / 2, i = 0;
+    for (; i + 4 <= words; i += 4) {
+        d[i] = pair;
+        d[i + 1] = pair;
+        d[i + 2] = pair;
+        d[i + 3] = pair;
+    }
+    for (; i < words; i++) d[i] = pair;
+    if (count & 1) dst[count - 1] = color;
+}
+
+void pxCopyRef(uint16_t* dst, const uint16_t* src, size_t count) {
+    for (size_t i = 0; i < count; i++) dst[i] = src[i];
+}
+
+void pxCopyWide(uint16_t* dst, const uint16_t* src, size_t count) {
+    // Words only line up when both start on the same half of a word
+    if (((uintptr_t)dst ^ (uintptr_t)src) & 2) {
+        pxCopyRef(dst, src, count);
+        return;
+    }
+    if (count && ((uintptr_t)dst & 2)) {
+        *dst++ = *src++;
+        count--;
+    }
+    PixelPair* d = (PixelPair*)dst;
+    const PixelPair* s = (const PixelPair*)src;
+    size_t words = count / 2, i = 0;
+    for (; i + 4 <= words; i += 4) {
+        PixelPair a = s[i], b = s[i + 1], c = s[i + 2], e = s[i + 3];
+        d[i] = a;
+        d[i + 1] = b;
+        d[i + 2] = c;
+        d[i + 3] = e;
+    }
+    for (; i < words; i++) d[i] = s[i];
+    if (count & 1) dst[count - 1] = src[count - 1];
+}
+
+void pxLutRef(const uint16_t* lut, uint16_t* dst, const uint16_t* src, size_t count) {
+    for (size_t i = 0; i < count; i++) dst[i] = lut[src[i]];
+}
+
+void pxLutWide(const uint16_t* lut, uint16_t* dst, const uint16_t* src, size_t count) {
+    if (((uintptr_t)dst ^ (uintptr_t)src) & 2) {
+        pxLutRef(lut, dst, src, count);
+        return;
+    }
+    if (count && ((uintptr_t)dst & 2)) {
+        *dst++ = lut[*src++];
+        count--;
+    }
+    PixelPair* d = (PixelPair*)dst;
+    const PixelPair* s = (const PixelPair*)src;
+    size_t words = count / 2, i = 0;
+    for (; i + 2 <= words; i += 2) {
+        uint32_t a = s[i], b = s[i + 1];
+        d[i] = lut[a & 0xFFFF] | ((uint32_t)lut[a >> 16] << 16);
+        d[i + 1] = lut[b & 0xFFFF] | ((uint32_t)lut[b >> 16] << 16);
+    }
+    for (; i < words; i++) {
+        uint32_t a = s[i];
+        d[i] = lut[a & 0xFFFF] | ((uint32_t)lut[a >> 16] << 16);
+    }
+    if (count & 1) dst[count - 1] = lut[src[count - 1]];
+}
+
+void pxBilinearRowRef(const uint16_t* row0, const uint16_t* row1, uint32_t yFrac,
+                      int srcW, uint16_t* out, int dstW) {
+    uint32_t xRatio = ((uint32_t)(srcW - 1) << FP_SHIFT) / dstW;
+    // Weights at 8-bit precision keep both blends inside 32 bits
+    uint32_t fy = yFrac >> 8;
+    uint32_t fyInv = 256 - fy;
+
+    for (int dstX = 0; dstX < dstW; dstX++) {
+        uint32_t srcX = (uint32_t)dstX * xRatio;
+        int x0 = srcX >> FP_SHIFT;
+        int x1 = (x0 + 1 < srcW) ? x0 + 1 : x0;
+        uint32_t fx = (srcX & FP_MASK) >> 8;
+        uint32_t fxInv = 256 - fx;
+
+        uint16_t p00 = row0[x0], p10 = row0[x1];
+        uint16_t p01 = row1[x0], p11 = row1[x1];
+
+        uint32_t r0 = ((p00 >> 11) & 0x1F) * fxInv + ((p10 >> 11) & 0x1F) * fx;
+        uint32_t g0 = ((p00 >> 5) & 0x3F) * fxInv + ((p10 >> 5) & 0x3F) * fx;
+        uint32_t b0 = (p00 & 0x1F) * fxInv + (p10 & 0x1F) * fx;
+        uint32_t r1 = ((p01 >> 11) & 0x1F) * fxInv + ((p11 >> 11) & 0x1F) * fx;
+        uint32_t g1 = ((p01 >> 5) & 0x3F) * fxInv + ((p11 >> 5) & 0x3F) * fx;
+        uint32_t b1 = (p01 & 0x1F) * fxInv + (p11 & 0x1F) * fx;
+
+        uint32_t r = (r0 * fyInv + r1 * fy) >> 16;
+        uint32_t g = (g0 * fyInv + g1 * fy) >> 16;
+        uint32_t b = (b0 * fyInv + b1 * fy) >> 16;
+        out[dstX] = (uint16_t)((r << 11) | (g << 5) | b);
+    }
+}
+
+// Vertical blend of one source column. Red and blue share a word (each at
+// most 31 * 256, so no carry between them); the sums are the reference's
+// before its shift, just added in the other order.
+static inline void blendColumn(uint16_t a, uint16_t b, uint32_t fy, uint32_t fyInv,
+                               uint32_t* rb, uint32_t* g) {
+    uint32_t rbA = (uint32_t)(a >> 11) | ((uint32_t)(a & 0x1F) << 16);
+    uint32_t rbB = (uint32_t)(b >> 11) | ((uint32_t)(b & 0x1F) << 16);
+    *rb = rbA * fyInv + rbB * fy;
+    *g = ((a >> 5) & 0x3F) * fyInv + ((b >> 5) & 0x3F) * fy;
+}
+
+void pxBilinearRowWide(const uint16_t* row0, const uint16_t* row1, uint32_t yFrac,
+                       int srcW, uint16_t* out, int dstW) {
+    uint32_t xRatio = ((uint32_t)(srcW - 1) << FP_SHIFT) / dstW;
+    uint32_t fy = yFrac >> 8;
+    uint32_t fyInv = 256 - fy;
+
+    // Left / right source columns of the last output pixel, already blended
+    int colL = -1, colR = -1;
+    uint32_t rbL = 0, gL = 0, rbR = 0, gR = 0;
+
+    for (int dstX = 0; dstX < dstW; dstX++) {
+        uint32_t srcX = (uint32_t)dstX * xRatio;
+        int x0 = srcX >> FP_SHIFT;
+        int x1 = (x0 + 1 < srcW) ? x0 + 1 : x0;
+        uint32_t fx = (srcX & FP_MASK) >> 8;
+        uint32_t fxInv = 256 - fx;
+
+        if (x0 != colL) {
+            if (x0 == colR) {
+                rbL = rbR;
+                gL = gR;
+            } else {
+                blendColumn(row0[x0], row1[x0], fy, fyInv, &rbL, &gL);
+            }
+            colL = x0;
+        }
+        if (x1 != colR) {
+            if (x1 == colL) {
+                rbR = rbL;
+                gR = gL;
+            } else {
+                blendColumn(row0[x1], row1[x1], fy, fyInv, &rbR, &gR);
+            }
+            colR = x1;
+        }
+
+        uint32_t r = ((rbL & 0xFFFF) * fxInv + (rbR & 0xFFFF) * fx) >> 16;
+        uint32_t b = ((rbL >> 16) * fxInv + (rbR >> 16) * fx) >> 16;
+        uint32_t g = (gL * fxInv + gR * fx) >> 16;
+        out[dstX] = (uint16_t)((r << 11) | (g << 5) | b);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// Source offsets and weight for each output coordinate along one axis
+struct AxisStep {
+    int32_t off0, off1;   // source offset of the two samples blended
+    uint32_t frac;        // weight of off1, 8 bits
+};
+
+// Sample positions [first, end) of a dstN-pixel axis over srcN rotated
+// pixels, as the bilinear row computes them, turned into source offsets
+// base + pos * stride
+static void axisSteps(AxisStep* steps, int first, int end, int dstN, int srcN, int32_t base, int32_t stride) {
+    uint32_t ratio = ((uint32_t)(srcN - 1) << FP_SHIFT) / dstN;
+    for (int i = first; i < end; i++) {
+        uint32_t pos = (uint32_t)i * ratio;
+        int p0 = pos >> FP_SHIFT;
+        int p1 = (p0 + 1 < srcN) ? p0 + 1 : p0;
+        steps[i - first].off0 = base + p0 * stride;
+        steps[i - first].off1 = base + p1 * stride;
+        steps[i - first].frac = (pos & FP_MASK) >> 8;
+    }
+}
+
+bool pxScaleRotate(const uint16_t* src, int srcW, int srcH, uint16_t* dst, int dstW, int dstH, int rotation,
+                   int rowBegin, int rowEnd) {
+    if (!src || !dst || srcW <= 0 || srcH <= 0 || dstW <= 0 || dstH <= 0) return false;
+    if (rowEnd < 0 || rowEnd > dstH) rowEnd = dstH;
+    if (rowBegin < 0) rowBegin = 0;
+    if (rowBegin >= rowEnd) return true;
+
+    // Rotated pixel (u, v) is source pixel base + u * du + v * dv
+    int32_t base, du, dv;
+    switch (rotation) {
+        case 0:   base = 0;                                 du = 1;     dv = srcW;  break;
+        case 90:  base = srcW - 1;                          du = srcW;  dv = -1;    break;
+        case 180: base = (int32_t)(srcH - 1) * srcW + srcW - 1; du = -1; dv = -srcW; break;
+        case 270: base = (int32_t)(srcH - 1) * srcW;        du = -srcW; dv = 1;     break;
+        default: return false;
+    }
+    bool quarter = rotation == 90 || rotation == 270;
+    int rotW = quarter ? srcH : srcW;
+    int rotH = quarter ? srcW : srcH;
+
+    AxisStep* cols = (AxisStep*)malloc(sizeof(AxisStep) * ((size_t)dstW + (rowEnd - rowBegin)));
+    if (!cols) return false;
+    AxisStep* rows = cols + dstW;   // rows[y - rowBegin]
+    axisSteps(cols, 0, dstW, dstW, rotW, 0, du);
+    axisSteps(rows, rowBegin, rowEnd, dstH, rotH, base, dv);
+
+    for (int ty = rowBegin; ty < rowEnd; ty += PX_TILE) {
+        int tyEnd = (ty + PX_TILE < rowEnd) ? ty + PX_TILE : rowEnd;
+        for (int tx = 0; tx < dstW; tx += PX_TILE) {
+            int txEnd = (tx + PX_TILE < dstW) ? tx + PX_TILE : dstW;
+            for (int y = ty; y < tyEnd; y++) {
+                const AxisStep& ry = rows[y - rowBegin];
+                const uint16_t* row0 = src + ry.off0;
+                const uint16_t* row1 = src + ry.off1;
+                uint32_t fy = ry.frac;
+                uint32_t fyInv = 256 - fy;
+                uint16_t* out = dst + (size_t)y * dstW;
+                for (int x = tx; x < txEnd; x++) {
+                    const AxisStep& c = cols[x];
+                    uint32_t fx = c.frac;
+                    uint32_t fxInv = 256 - fx;
+                    uint16_t p00 = row0[c.off0], p10 = row0[c.off1];
+                    uint16_t p01 = row1[c.off0], p11 = row1[c.off1];
+
+                    // The reference row's arithmetic: across, then down
+                    uint32_t r0 = ((p00 >> 11) & 0x1F) * fxInv + ((p10 >> 11) & 0x1F) * fx;
+                    uint32_t g0 = ((p00 >> 5) & 0x3F) * fxInv + ((p10 >> 5) & 0x3F) * fx;
+                    uint32_t b0 = (p00 & 0x1F) * fxInv + (p10 & 0x1F) * fx;
+                    uint32_t r1 = ((p01 >> 11) & 0x1F) * fxInv + ((p11 >> 11) & 0x1F) * fx;
+                    uint32_t g1 = ((p01 >> 5) & 0x3F) * fxInv + ((p11 >> 5) & 0x3F) * fx;
+                    uint32_t b1 = (p01 & 0x1F) * fxInv + (p11 & 0x1F) * fx;
+
+                    uint32_t r = (r0 * fyInv + r1 * fy) >> 16;
+                    uint32_t g = (g0 * fyInv + g1 * fy) >> 16;
+                    uint32_t b = (b0 * fyInv + b1 * fy) >> 16;
+                    out[x] = (uint16_t)((r << 11) | (g << 5) | b);
+                }
+            }
+        }
+    }
+    free(cols);
+    return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef PIXEL_KERNELS_H
+#define PIXEL_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// RGB565 PIXEL KERNELS
+// =============================================================================
+// The inner loops of ImageUtils, the strip pipeline and the pixel stage, each
+// in two forms: a plain per-pixel reference (...Ref) and a wide form
+// (...Wide) that moves two pixels per 32-bit word, or for the bilinear row
+// blends each source column once instead of once per output pixel. The wide
+// forms must give exactly the reference's pixels; test/test_pixel_kernels.cpp
+// checks that on the host, and the serial 'U' command times both on the
+// device (ns / pixel).
+//
+// PIXEL_KERNELS_WIDE picks the form the unsuffixed entry points use; build
+// with -DPIXEL_KERNELS_WIDE=0 to run everything on the references.
+
+#ifndef PIXEL_KERNELS_WIDE
+#define PIXEL_KERNELS_WIDE 1
+#endif
+
+// dst[0..count) = color
+void pxFillRef(uint16_t* dst, size_t count, uint16_t color);
+void pxFillWide(uint16_t* dst, size_t count, uint16_t color);
+
+// dst[0..count) = src[0..count); the ranges must not overlap
+void pxCopyRef(uint16_t* dst, const uint16_t* src, size_t count);
+void pxCopyWide(uint16_t* dst, const uint16_t* src, size_t count);
+
+// dst[i] = lut[src[i]] over a 65536-entry table; dst may equal src
+void pxLutRef(const uint16_t* lut, uint16_t* dst, const uint16_t* src, size_t count);
+void pxLutWide(const uint16_t* lut, uint16_t* dst, const uint16_t* src, size_t count);
+
+// One output row of a bilinear scale from srcW to dstW pixels, blending row0
+// and row1 by yFrac (16.16), with 8-bit weights
+void pxBilinearRowRef(const uint16_t* row0, const uint16_t* row1, uint32_t yFrac,
+                      int srcW, uint16_t* out, int dstW);
+void pxBilinearRowWide(const uint16_t* row0, const uint16_t* row1, uint32_t yFrac,
+                       int srcW, uint16_t* out, int dstW);
+
+// Bilinear scale of a srcW x srcH frame turned by rotation (0, 90, 180 or
+// 270, counter-clockwise as the PPA turns it) into dstW x dstH, in one pass:
+// the same pixels as rotating exactly and then scaling with the bilinear row
+// above. The output is walked in PX_TILE x PX_TILE tiles so that for 90 / 270,
+// where an output row runs down a source column, the source rows a tile
+// touches stay in cache. rowBegin / rowEnd limit it to a band of output rows
+// (same pixels as the whole call gives there), so bands can run on separate
+// cores; rowEnd < 0 means dstH. False for another angle or without memory for
+// the coordinate tables.
+#define PX_TILE 32
+bool pxScaleRotate(const uint16_t* src, int srcW, int srcH, uint16_t* dst, int dstW, int dstH, int rotation,
+                   int rowBegin = 0, int rowEnd = -1);
+
+#if PIXEL_KERNELS_WIDE
+inline void pxFill(uint16_t* dst, size_t count, uint16_t color) { pxFillWide(dst, count, color); }
+inline void pxCopy(uint16_t* dst, const uint16_t* src, size_t count) { pxCopyWide(dst, src, count); }
+inline void pxLut(const uint16_t* lut, uint16_t* dst, const uint16_t* src, size_t count) {
+    pxLutWide(lut, dst, src, count);
+}
+inline void pxBilinearRow(const uint16_t* row0, const uint16_t* row1, uint32_t yFrac,
+                          int srcW, uint16_t* out, int dstW) {
+    pxBilinearRowWide(row0, row1, yFrac, srcW, out, dstW);
+}
+#else
+inline void pxFill(uint16_t* dst, size_t count, uint16_t color) { pxFillRef(dst, count, color); }
+inline void pxCopy(uint16_t* dst, const uint16_t* src, size_t count) { pxCopyRef(dst, src, count); }
+inline void pxLut(const uint16_t* lut, uint16_t* dst, const uint16_t* src, size_t count) {
+    pxLutRef(lut, dst, src, count);
+}
+inline void pxBilinearRow(const uint16_t* row0, const uint16_t* row1, uint32_t yFrac,
+                          int srcW, uint16_t* out, int dstW) {
+    pxBilinearRowRef(row0, row1, yFrac, srcW, out, dstW);
+}
+#endif
+
+#endif // PIXEL_KERNELS_H
@@ -0,0 +1,124 @@
+#include "pixel_stage.h"
+#include "pixel_kernels.h"
+#include <math.h>
+
+static double clampd(double v, double lo, double hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+void pixelKelvinScales(int kelvin, float* rScale, float* gScale, float* bScale) {
+    int temp = kelvin < 1000 ? 1000 : (kelvin > 40000 ? 40000 : kelvin);
+    temp /= 100;
+
+    if (temp <= 66) {
+        *rScale = 1.0f;
+        *gScale = (float)(clampd(log((double)temp) * 99.4708025861 - 161.1195681661, 0.0, 255.0) / 255.0);
+    } else {
+        *rScale = (float)clampd(pow(temp - 60, -0.1332047592) * 329.698727446 / 255.0, 0.0, 1.0);
+        *gScale = (float)clampd(pow(temp - 60, -0.0755148492) * 288.1221695283 / 255.0, 0.0, 1.0);
+    }
+
+    if (temp >= 66) {
+        *bScale = 1.0f;
+    } else if (temp <= 19) {
+        *bScale = 0.0f;
+    } else {
+        *bScale = (float)(clampd(log((double)(temp - 10)) * 138.5177312231 - 305.0447927307, 0.0, 255.0) / 255.0);
+    }
+}
+
+// Gain in 8.8 fixed point applied to every level of a channel, as the
+// render-time colour temperature pass did
+static void buildChannel(uint8_t* map, int levels, float scale) {
+    int fix = (int)(scale * 256);
+    for (int i = 0; i < levels; i++) {
+        int v = (i * fix) >> 8;
+        map[i] = (uint8_t)(v < 0 ? 0 : (v > levels - 1 ? levels - 1 : v));
+    }
+}
+
+static int clampi(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// The ranges the key can hold
+static PixelStageSettings clampSettings(const PixelStageSettings& in) {
+    PixelStageSettings s;
+    s.colorTempKelvin = clampi(in.colorTempKelvin, 1000, 40000);
+    s.gammaX100 = clampi(in.gammaX100, 10, 255);
+    s.nightRedShift = clampi(in.nightRedShift, 0, 100);
+    return s;
+}
+
+uint32_t pixelStageKey(const PixelStageSettings& settings) {
+    PixelStageSettings s = clampSettings(settings);
+    if (s.colorTempKelvin == PIXEL_STAGE_NEUTRAL_KELVIN && s.gammaX100 == PIXEL_STAGE_NEUTRAL_GAMMA &&
+        s.nightRedShift == 0) {
+        return 0;
+    }
+    return (uint32_t)s.colorTempKelvin | ((uint32_t)s.gammaX100 << 16) | ((uint32_t)s.nightRedShift << 24);
+}
+
+bool pixelStageBuild(PixelStage* stage, const PixelStageSettings& settings) {
+    PixelStageSettings s = clampSettings(settings);
+    uint32_t key = pixelStageKey(s);
+    stage->key = 0;
+    if (key == 0) return true;
+    if (!stage->lut) return false;
+
+    // Colour temperature per channel, at the channel's own depth
+    float rS = 1.0f, gS = 1.0f, bS = 1.0f;
+    if (s.colorTempKelvin != PIXEL_STAGE_NEUTRAL_KELVIN) pixelKelvinScales(s.colorTempKelvin, &rS, &gS, &bS);
+    uint8_t rMap[32], gMap[64], bMap[32];
+    buildChannel(rMap, 32, rS);
+    buildChannel(gMap, 64, gS);
+    buildChannel(bMap, 32, bS);
+
+    // Red shift and gamma mix channels / need more levels: done at 8 bits
+    bool mix = s.nightRedShift > 0 || s.gammaX100 != PIXEL_STAGE_NEUTRAL_GAMMA;
+    uint8_t gamma[256];
+    for (int i = 0; i < 256; i++) {
+        gamma[i] = (s.gammaX100 == PIXEL_STAGE_NEUTRAL_GAMMA)
+                       ? (uint8_t)i
+                       : (uint8_t)(255.0 * pow(i / 255.0, 100.0 / s.gammaX100) + 0.5);
+    }
+    int shift = s.nightRedShift * 256 / 100;
+
+    for (uint32_t p = 0; p < PIXEL_STAGE_LUT_ENTRIES; p++) {
+        int r = rMap[p >> 11], g = gMap[(p >> 5) & 0x3F], b = bMap[p & 0x1F];
+        if (mix) {
+            int r8 = (r * 255 + 15) / 31, g8 = (g * 255 + 31) / 63, b8 = (b * 255 + 15) / 31;
+            if (shift) {
+                // Towards a red image of the same brightness
+                int lum = (77 * r8 + 150 * g8 + 29 * b8) >> 8;
+                if (lum > r8) r8 += ((lum - r8) * shift) >> 8;
+                g8 = (g8 * (256 - shift)) >> 8;
+                b8 = (b8 * (256 - shift)) >> 8;
+            }
+            r = (gamma[r8] * 31 + 127) / 255;
+            g = (gamma[g8] * 63 + 127) / 255;
+            b = (gamma[b8] * 31 + 127) / 255;
+        }
+        stage->lut[p] = (uint16_t)((r << 11) | (g << 5) | b);
+    }
+    stage->key = key;
+    return true;
+}
+
+void pixelStageApply(const PixelStage& stage, uint16_t* pixels, size_t count) {
+    if (pixelStageIsIdentity(stage)) return;
+    pxLut(stage.lut, pixels, pixels, count);
+}
+
+void pixelStageCopy(const PixelStage& stage, uint16_t* dst, const uint16_t* src, size_t count) {
+    if (pixelStageIsIdentity(stage)) {
+        pxCopy(dst, src, count);
+        return;
+    }
+    pxLut(stage.lut, dst, src, count);
+}
+
+void pixelStageApplyRect(const PixelStage& stage, uint16_t* pixels, int stride, int w, int h) {
+    if (pixelStageIsIdentity(stage)) return;
+    for (int y = 0; y < h; y++) pixelStageApply(stage, pixels + (size_t)y * stride, (size_t)w);
+}
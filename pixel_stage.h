@@ -0,0 +1,60 @@
+#pragma once
+#ifndef PIXEL_STAGE_H
+#define PIXEL_STAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// PIXEL STAGE
+// =============================================================================
+// Per-pixel post-processing of decoded RGB565, applied to each block as the
+// decoder hands it out, while it is still in cache, instead of as an extra
+// pass at render time. Colour temperature, the night red shift and gamma are
+// composed into one 65536-entry RGB565 -> RGB565 table (128 KB), so each
+// pixel costs a single lookup; the table is only rebuilt when a setting
+// changes. A frame records the stage it went through (FrameLayout::stage),
+// so one processed with older settings can be decoded again. No Arduino /
+// IDF types: unit-tested on the host (test/test_pixel_stage.cpp, benchmark
+// in test/bench_pixel_stage.cpp).
+
+#define PIXEL_STAGE_NEUTRAL_KELVIN 6500
+#define PIXEL_STAGE_NEUTRAL_GAMMA 100     // gamma x 100
+#define PIXEL_STAGE_LUT_ENTRIES 65536
+#define PIXEL_STAGE_LUT_BYTES (PIXEL_STAGE_LUT_ENTRIES * sizeof(uint16_t))
+
+struct PixelStageSettings {
+    int colorTempKelvin;   // 6500 = neutral
+    int gammaX100;         // output = input ^ (1 / gamma); 100 = unchanged
+    int nightRedShift;     // 0..100 %: luminance moved into red, green / blue dropped
+};
+
+struct PixelStage {
+    uint32_t key;          // identifies the settings; 0 = leaves pixels unchanged
+    uint16_t* lut;         // PIXEL_STAGE_LUT_ENTRIES, owned by the caller
+};
+
+// Red / green / blue gains (0..1) for a colour temperature: Tanner Helland's
+// approximation, 6500K neutral
+void pixelKelvinScales(int kelvin, float* rScale, float* gScale, float* bScale);
+
+// Key of the stage for these settings, without building it (0 = neutral)
+uint32_t pixelStageKey(const PixelStageSettings& settings);
+
+// Fill stage->lut for the settings. A neutral stage leaves the table alone.
+// False (and an identity stage) when a non-neutral stage has no table.
+bool pixelStageBuild(PixelStage* stage, const PixelStageSettings& settings);
+
+inline bool pixelStageIsIdentity(const PixelStage& stage) { return stage.key == 0; }
+
+inline uint16_t pixelStageMap(const PixelStage& s, uint16_t p) {
+    return s.key ? s.lut[p] : p;
+}
+
+void pixelStageApply(const PixelStage& stage, uint16_t* pixels, size_t count);
+// dst = stage(src): the copy and the processing in one pass
+void pixelStageCopy(const PixelStage& stage, uint16_t* dst, const uint16_t* src, size_t count);
+// w x h pixels starting at `pixels`, rows `stride` pixels apart
+void pixelStageApplyRect(const PixelStage& stage, uint16_t* pixels, int stride, int w, int h);
+
+#endif // PIXEL_STAGE_H
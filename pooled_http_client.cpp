@@ -0,0 +1,64 @@
+#include "pooled_http_client.h"
+#include "logging.h"
+
+static PooledTransport* makePooledHttpClient(const HttpEndpoint& ep, void* ctx) {
+    (void)ctx;
+    return new PooledHttpClient(ep);
+}
+
+// Global instance
+HttpConnectionPool httpPool(makePooledHttpClient, nullptr,
+                            HTTP_KEEP_ALIVE_IDLE_TIMEOUT, HTTP_KEEP_ALIVE_MAX_REQUESTS);
+
+PooledHttpClient::PooledHttpClient(const HttpEndpoint& ep) : endpoint(ep), secure(ep.secure) {
+    if (secure) tls.setInsecure();
+}
+
+PooledHttpClient::~PooledHttpClient() {
+    stop();
+}
+
+bool PooledHttpClient::connect(int32_t timeoutMs) {
+    // Call the concrete client so the TLS handshake happens here, where it is
+    // timed, rather than inside HTTPClient::GET()
+    int ok = secure ? tls.connect(endpoint.host, endpoint.port, timeoutMs)
+                    : plain.connect(endpoint.host, endpoint.port, timeoutMs);
+    return ok != 0;
+}
+
+bool PooledHttpClient::connected() {
+    return secure ? tls.connected() : plain.connected();
+}
+
+void PooledHttpClient::stop() {
+    if (secure) tls.stop();
+    else plain.stop();
+}
+
+HttpLeaseGuard::HttpLeaseGuard() : active(false), keepAlive(false) {
+    memset(&lease, 0, sizeof(lease));
+    memset(&timing, 0, sizeof(timing));
+}
+
+HttpLeaseGuard::~HttpLeaseGuard() {
+    if (!active) return;
+    httpPool.release(lease, keepAlive, millis(), timing);
+    LOG_INFO_F("[HTTP] %s (%s): connect %lu ms, response %lu ms, body %lu ms for %u bytes, %s\n",
+               httpPool.lastHost(), lease.reused ? "reused" : "new",
+               (unsigned long)timing.connectMs, (unsigned long)timing.responseMs,
+               (unsigned long)timing.bodyMs, (unsigned)timing.bytes, keepAlive ? "kept open" : "closed");
+}
+
+PooledHttpClient* HttpLeaseGuard::acquire(const String& url) {
+#if HTTP_KEEP_ALIVE
+    HttpEndpoint ep;
+    if (active || !httpParseEndpoint(url.c_str(), &ep)) return nullptr;
+    if (!httpPool.acquire(ep, millis(), &lease)) return nullptr;
+    active = true;
+    timing.reused = lease.reused;
+    return (PooledHttpClient*)lease.transport;
+#else
+    (void)url;
+    return nullptr;
+#endif
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef POOLED_HTTP_CLIENT_H
+#define POOLED_HTTP_CLIENT_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+#include "config.h"
+#include "http_pool.h"
+
+/**
+ * @brief One kept-alive image-host connection: the socket (plain or TLS) and
+ * the HTTPClient driving it.
+ *
+ * The HTTPClient is bound to the socket with begin(client, url) and setReuse()
+ * so end() leaves the connection open when the server allows it. TLS uses
+ * setInsecure(), as HTTPClient::begin(url) without a CA did before.
+ *
+ * The arduino-esp32 TLS client performs its handshake inside connect() and
+ * does not expose the mbedTLS session, so sessions / tickets cannot be
+ * resumed across connections; keeping the connection open is what avoids
+ * the handshake.
+ */
+class PooledHttpClient : public PooledTransport {
+public:
+    explicit PooledHttpClient(const HttpEndpoint& ep);
+    ~PooledHttpClient() override;
+
+    // TCP connect (+ TLS handshake) to the endpoint
+    bool connect(int32_t timeoutMs);
+    bool connected() override;
+    void stop() override;
+
+    WiFiClient& client() { return secure ? (WiFiClient&)tls : plain; }
+    const char* host() const { return endpoint.host; }
+
+    HTTPClient http;
+
+private:
+    HttpEndpoint endpoint;
+    bool secure;
+    WiFiClient plain;
+    WiFiClientSecure tls;
+};
+
+// Hands a pooled connection back when the fetch ends, however it ends. Fill
+// in keepAlive / timing as the fetch goes; end the HTTPClient before this
+// goes out of scope.
+struct HttpLeaseGuard {
+    HttpLeaseGuard();
+    ~HttpLeaseGuard();
+
+    // Lease this URL's host connection; nullptr when pooling is off, the URL
+    // is not http(s) or no entry is free
+    PooledHttpClient* acquire(const String& url);
+
+    bool active;
+    bool keepAlive;
+    HttpLease lease;
+    HttpFetchTiming timing;
+};
+
+// Global instance (download task only, apart from reading stats)
+extern HttpConnectionPool httpPool;
+
+#endif // POOLED_HTTP_CLIENT_H
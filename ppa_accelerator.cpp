@@ -4,6 +4,35 @@
 // Global instance
 PPAAccelerator ppaAccelerator;
 
+// SRM scale for one input axis, nudged up by a float step where needed so
+// the driver's floor(size * scale) comes out at dstLen rather than one short
+static float srmAxisScale(int srcLen, int dstLen) {
+    float scale = (float)dstLen / srcLen;
+    if ((int)(srcLen * scale) < dstLen) scale = nextafterf(scale, 2.0f * scale);
+    return scale;
+}
+
+// scale_x / scale_y apply to the input's own axes, so at 90 and 270 degrees
+// the input width becomes the output height
+static void srmScales(int srcWidth, int srcHeight, int dstWidth, int dstHeight,
+                      ppa_srm_rotation_angle_t rotation, float* scaleX, float* scaleY) {
+    bool quarter = rotation == PPA_SRM_ROTATION_ANGLE_90 || rotation == PPA_SRM_ROTATION_ANGLE_270;
+    *scaleX = srmAxisScale(srcWidth, quarter ? dstHeight : dstWidth);
+    *scaleY = srmAxisScale(srcHeight, quarter ? dstWidth : dstHeight);
+}
+
+// Cache lines of framebuffer rows [y0, y1), widened to whole lines (the
+// framebuffer itself is line aligned)
+static void syncFramebufferRows(uint16_t* fb, int fbWidth, int y0, int y1, int flags) {
+    uintptr_t begin = (uintptr_t)(fb + (size_t)y0 * fbWidth) & ~(uintptr_t)63;
+    uintptr_t end = ((uintptr_t)(fb + (size_t)y1 * fbWidth) + 63) & ~(uintptr_t)63;
+    esp_cache_msync((void*)begin, end - begin, flags);
+}
+
+static bool framebufferUsable(const uint16_t* fb, int fbWidth, int fbHeight) {
+    return fb && ((uintptr_t)fb & 63) == 0 && (((size_t)fbWidth * fbHeight * sizeof(uint16_t)) & 63) == 0;
+}
+
 PPAAccelerator::PPAAccelerator() :
     ppa_scaling_handle(nullptr),
     ppa_available(false),
@@ -11,6 +40,18 @@ PPAAccelerator::PPAAccelerator() :
     ppa_dst_buffer(nullptr),
     ppa_src_buffer_size(0),
     ppa_dst_buffer_size(0),
+    ppa_strip_handle(nullptr),
+    strip_done(nullptr),
+    strip_dst(nullptr),
+    strip_dst_size(0),
+    strip_dst_width(0),
+    strip_dst_height(0),
+    strip_seq(0),
+    strip_trans_submitted(0),
+    strip_trans_done(0),
+    strip_trans_for(),
+    ppa_fill_handle(nullptr),
+    ppa_blend_handle(nullptr),
     debugPrintFunc(nullptr),
     debugPrintfFunc(nullptr)
 {
@@ -91,6 +132,24 @@ void PPAAccelerator::cleanup() {
         ppa_unregister_client(ppa_scaling_handle);
         ppa_scaling_handle = nullptr;
     }
+
+    if (ppa_strip_handle) {
+        ppa_unregister_client(ppa_strip_handle);
+        ppa_strip_handle = nullptr;
+    }
+    if (strip_done) {
+        vSemaphoreDelete(strip_done);
+        strip_done = nullptr;
+    }
+
+    if (ppa_fill_handle) {
+        ppa_unregister_client(ppa_fill_handle);
+        ppa_fill_handle = nullptr;
+    }
+    if (ppa_blend_handle) {
+        ppa_unregister_client(ppa_blend_handle);
+        ppa_blend_handle = nullptr;
+    }
     
     if (ppa_src_buffer) {
         heap_caps_free(ppa_src_buffer);
@@ -166,8 +225,8 @@ bool PPAAccelerator::scaleRotateImage(uint16_t* srcPixels, int16_t srcWidth, int
     srm_oper_config.out.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
     
     // Scaling configuration
-    srm_oper_config.scale_x = (float)dstWidth / srcWidth;
-    srm_oper_config.scale_y = (float)dstHeight / srcHeight;
+    srmScales(srcWidth, srcHeight, dstWidth, dstHeight, ppa_rotation,
+              &srm_oper_config.scale_x, &srm_oper_config.scale_y);
     
     // Rotation configuration
     srm_oper_config.rotation_angle = ppa_rotation;
@@ -264,8 +323,8 @@ bool PPAAccelerator::scaleRotateImageZeroCopy(uint16_t* srcPixels, int16_t srcWi
     srm_oper_config.out.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
 
     // Scaling configuration
-    srm_oper_config.scale_x = (float)dstWidth / srcWidth;
-    srm_oper_config.scale_y = (float)dstHeight / srcHeight;
+    srmScales(srcWidth, srcHeight, dstWidth, dstHeight, ppa_rotation,
+              &srm_oper_config.scale_x, &srm_oper_config.scale_y);
 
     // Rotation configuration
     srm_oper_config.rotation_angle = ppa_rotation;
@@ -299,6 +358,306 @@ bool PPAAccelerator::scaleRotateImageZeroCopy(uint16_t* srcPixels, int16_t srcWi
     return true;
 }
 
+bool PPAAccelerator::scaleRotateToFramebuffer(uint16_t* srcPixels, int srcWidth, int srcHeight,
+                                              uint16_t* fb, int fbWidth, int fbHeight,
+                                              int dstX, int dstY, int dstWidth, int dstHeight,
+                                              float rotation, RenderRect* written) {
+    if (!ppa_available || !ppa_scaling_handle || !framebufferUsable(fb, fbWidth, fbHeight)) return false;
+
+    ppa_srm_rotation_angle_t ppa_rotation = convertRotationAngle(rotation);
+    if (ppa_rotation == (ppa_srm_rotation_angle_t)-1) {
+        LOG_DEBUG_F("DEBUG: Invalid rotation angle: %.1f\n", rotation);
+        return false;
+    }
+
+    float scaleX, scaleY;
+    srmScales(srcWidth, srcHeight, dstWidth, dstHeight, ppa_rotation, &scaleX, &scaleY);
+    RenderBlit blit;
+    if (!renderPanelBlit(srcWidth, srcHeight, scaleX, scaleY, rotation, dstX, dstY, fbWidth, fbHeight, &blit)) {
+        LOG_DEBUG("DEBUG: Picture is off the panel");
+        return false;
+    }
+
+    LOG_DEBUG_F("DEBUG: PPA scale+rotate into framebuffer: block %d,%d %dx%d -> %d,%d %dx%d (%.1f°)\n",
+                blit.in.x, blit.in.y, blit.in.w, blit.in.h,
+                blit.out.x, blit.out.y, blit.out.w, blit.out.h, rotation);
+
+    size_t srcSizeAligned = ((size_t)srcWidth * srcHeight * sizeof(uint16_t) + 63) & ~63;
+    esp_cache_msync(srcPixels, srcSizeAligned, ESP_CACHE_MSYNC_FLAG_DIR_C2M);
+    // Write back and drop the CPU's lines for the rows written (text or a
+    // previous CPU draw), so nothing dirty is evicted over the PPA's output
+    syncFramebufferRows(fb, fbWidth, blit.out.y, blit.out.y + blit.out.h,
+                        ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_INVALIDATE);
+
+    ppa_srm_oper_config_t config = {};
+    config.in.buffer = srcPixels;
+    config.in.pic_w = srcWidth;
+    config.in.pic_h = srcHeight;
+    config.in.block_w = blit.in.w;
+    config.in.block_h = blit.in.h;
+    config.in.block_offset_x = blit.in.x;
+    config.in.block_offset_y = blit.in.y;
+    config.in.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+    config.out.buffer = fb;
+    config.out.buffer_size = (size_t)fbWidth * fbHeight * sizeof(uint16_t);
+    config.out.pic_w = fbWidth;
+    config.out.pic_h = fbHeight;
+    config.out.block_offset_x = blit.out.x;
+    config.out.block_offset_y = blit.out.y;
+    config.out.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+    config.rotation_angle = ppa_rotation;
+    config.scale_x = scaleX;
+    config.scale_y = scaleY;
+    config.alpha_update_mode = PPA_ALPHA_NO_CHANGE;
+    config.mode = PPA_TRANS_MODE_BLOCKING;
+
+    esp_err_t ret = ppa_do_scale_rotate_mirror(ppa_scaling_handle, &config);
+    if (ret != ESP_OK) {
+        LOG_ERROR_F("PPA scale+rotate into framebuffer failed: %s (0x%x)\n", esp_err_to_name(ret), ret);
+        return false;
+    }
+    syncFramebufferRows(fb, fbWidth, blit.out.y, blit.out.y + blit.out.h, ESP_CACHE_MSYNC_FLAG_DIR_M2C);
+    *written = blit.out;
+    return true;
+}
+
+bool PPAAccelerator::fillFramebuffer(uint16_t* fb, int fbWidth, int fbHeight, RenderRect rect, uint16_t color) {
+    if (!ppa_available || !framebufferUsable(fb, fbWidth, fbHeight)) return false;
+    if (!renderClipRect(&rect, fbWidth, fbHeight)) return true;   // nothing on the panel
+    if (!ppa_fill_handle) {
+        ppa_client_config_t clientConfig = {};
+        clientConfig.oper_type = PPA_OPERATION_FILL;
+        esp_err_t ret = ppa_register_client(&clientConfig, &ppa_fill_handle);
+        if (ret != ESP_OK) {
+            LOG_ERROR_F("PPA fill client registration failed: %s\n", esp_err_to_name(ret));
+            ppa_fill_handle = nullptr;
+            return false;
+        }
+    }
+
+    syncFramebufferRows(fb, fbWidth, rect.y, rect.y + rect.h,
+                        ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_INVALIDATE);
+
+    // RGB565 widened to ARGB8888, low bits copied from the top ones
+    uint32_t r = (color >> 11) & 0x1F, g = (color >> 5) & 0x3F, b = color & 0x1F;
+    ppa_fill_oper_config_t config = {};
+    config.out.buffer = fb;
+    config.out.buffer_size = (size_t)fbWidth * fbHeight * sizeof(uint16_t);
+    config.out.pic_w = fbWidth;
+    config.out.pic_h = fbHeight;
+    config.out.block_offset_x = rect.x;
+    config.out.block_offset_y = rect.y;
+    config.out.fill_cm = PPA_FILL_COLOR_MODE_RGB565;
+    config.fill_block_w = rect.w;
+    config.fill_block_h = rect.h;
+    config.fill_argb_color.val = 0xFF000000u | ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+    config.mode = PPA_TRANS_MODE_BLOCKING;
+
+    esp_err_t ret = ppa_do_fill(ppa_fill_handle, &config);
+    if (ret != ESP_OK) {
+        LOG_ERROR_F("PPA fill failed: %s (0x%x)\n", esp_err_to_name(ret), ret);
+        return false;
+    }
+    syncFramebufferRows(fb, fbWidth, rect.y, rect.y + rect.h, ESP_CACHE_MSYNC_FLAG_DIR_M2C);
+    return true;
+}
+
+bool PPAAccelerator::blendFramebuffer(const uint16_t* fg, uint16_t* fb, int fbWidth, int fbHeight, uint8_t alpha) {
+    if (!ppa_available || !framebufferUsable(fb, fbWidth, fbHeight) || ((uintptr_t)fg & 63)) return false;
+    if (!ppa_blend_handle) {
+        ppa_client_config_t clientConfig = {};
+        clientConfig.oper_type = PPA_OPERATION_BLEND;
+        esp_err_t ret = ppa_register_client(&clientConfig, &ppa_blend_handle);
+        if (ret != ESP_OK) {
+            LOG_ERROR_F("PPA blend client registration failed: %s\n", esp_err_to_name(ret));
+            ppa_blend_handle = nullptr;
+            return false;
+        }
+    }
+
+    size_t size = (size_t)fbWidth * fbHeight * sizeof(uint16_t);
+    esp_cache_msync((void*)fg, size, ESP_CACHE_MSYNC_FLAG_DIR_C2M);
+    syncFramebufferRows(fb, fbWidth, 0, fbHeight, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_INVALIDATE);
+
+    // Background (what is on the panel) opaque, foreground at alpha: the
+    // engine's "over" gives fg * alpha + bg * (1 - alpha)
+    ppa_blend_oper_config_t config = {};
+    config.in_bg.buffer = fb;
+    config.in_bg.pic_w = fbWidth;
+    config.in_bg.pic_h = fbHeight;
+    config.in_bg.block_w = fbWidth;
+    config.in_bg.block_h = fbHeight;
+    config.in_bg.blend_cm = PPA_BLEND_COLOR_MODE_RGB565;
+    config.in_fg.buffer = fg;
+    config.in_fg.pic_w = fbWidth;
+    config.in_fg.pic_h = fbHeight;
+    config.in_fg.block_w = fbWidth;
+    config.in_fg.block_h = fbHeight;
+    config.in_fg.blend_cm = PPA_BLEND_COLOR_MODE_RGB565;
+    config.out.buffer = fb;
+    config.out.buffer_size = size;
+    config.out.pic_w = fbWidth;
+    config.out.pic_h = fbHeight;
+    config.out.blend_cm = PPA_BLEND_COLOR_MODE_RGB565;
+    config.bg_alpha_update_mode = PPA_ALPHA_FIX_VALUE;
+    config.bg_alpha_fix_val = 255;
+    config.fg_alpha_update_mode = PPA_ALPHA_FIX_VALUE;
+    config.fg_alpha_fix_val = alpha;
+    config.mode = PPA_TRANS_MODE_BLOCKING;
+
+    esp_err_t ret = ppa_do_blend(ppa_blend_handle, &config);
+    if (ret != ESP_OK) {
+        LOG_ERROR_F("PPA blend failed: %s (0x%x)\n", esp_err_to_name(ret), ret);
+        return false;
+    }
+    syncFramebufferRows(fb, fbWidth, 0, fbHeight, ESP_CACHE_MSYNC_FLAG_DIR_M2C);
+    return true;
+}
+
+// Strip transaction finished (interrupt context): count it
+static bool IRAM_ATTR onStripTransDone(ppa_client_handle_t client, ppa_event_data_t* event, void* userData) {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR((SemaphoreHandle_t)userData, &woken);
+    return woken == pdTRUE;
+}
+
+bool PPAAccelerator::beginStrips(uint16_t* dst, size_t dstBufferSize, int dstWidth, int dstHeight) {
+    if (!ppa_available) return false;
+    if (!ppa_strip_handle) {
+        ppa_client_config_t config = {};
+        config.oper_type = PPA_OPERATION_SRM;
+        config.max_pending_trans_num = STRIP_MAX_SLOTS;
+        esp_err_t ret = ppa_register_client(&config, &ppa_strip_handle);
+        if (ret != ESP_OK) {
+            LOG_ERROR_F("PPA strip client registration failed: %s\n", esp_err_to_name(ret));
+            ppa_strip_handle = nullptr;
+            return false;
+        }
+        ppa_event_callbacks_t callbacks = {};
+        callbacks.on_trans_done = onStripTransDone;
+        strip_done = xSemaphoreCreateCounting(STRIP_MAX_SLOTS, 0);
+        if (!strip_done || ppa_client_register_event_callbacks(ppa_strip_handle, &callbacks) != ESP_OK) {
+            LOG_ERROR("PPA strip client setup failed");
+            ppa_unregister_client(ppa_strip_handle);
+            ppa_strip_handle = nullptr;
+            if (strip_done) vSemaphoreDelete(strip_done);
+            strip_done = nullptr;
+            return false;
+        }
+    }
+    if ((size_t)dstWidth * dstHeight * sizeof(uint16_t) > dstBufferSize) return false;
+
+    // A previous run that timed out may have left completions behind
+    while (xSemaphoreTake(strip_done, 0) == pdTRUE) {}
+    strip_dst = dst;
+    strip_dst_size = dstBufferSize;
+    strip_dst_width = dstWidth;
+    strip_dst_height = dstHeight;
+    strip_seq = 0;
+    strip_trans_submitted = 0;
+    strip_trans_done = 0;
+
+    // Write back and drop the CPU's lines for the output, so nothing dirty is
+    // evicted over what the PPA writes
+    size_t dstSizeAligned = ((size_t)dstWidth * dstHeight * sizeof(uint16_t) + 63) & ~63;
+    esp_cache_msync(dst, dstSizeAligned, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_INVALIDATE);
+    return true;
+}
+
+bool PPAAccelerator::submitStrip(const uint16_t* strip, int srcWidth, int rows, int dstY,
+                                 float scaleX, float scaleY, int* outRows) {
+    // The PPA writes floor(size * scale) pixels; with k/16 factors that is exact
+    int outW = (int)(srcWidth * scaleX);
+    int outH = (int)(rows * scaleY);
+    *outRows = 0;
+    if (outW > strip_dst_width || dstY + outH > strip_dst_height) return false;
+
+    if (outH > 0 && outW > 0) {
+        size_t srcSizeAligned = ((size_t)srcWidth * rows * sizeof(uint16_t) + 63) & ~63;
+        esp_cache_msync((void*)strip, srcSizeAligned, ESP_CACHE_MSYNC_FLAG_DIR_C2M);
+
+        ppa_srm_oper_config_t config = {};
+        config.in.buffer = strip;
+        config.in.pic_w = srcWidth;
+        config.in.pic_h = rows;
+        config.in.block_w = srcWidth;
+        config.in.block_h = rows;
+        config.in.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+        config.out.buffer = strip_dst;
+        config.out.buffer_size = strip_dst_size;
+        config.out.pic_w = strip_dst_width;
+        config.out.pic_h = strip_dst_height;
+        config.out.block_offset_x = 0;
+        config.out.block_offset_y = dstY;
+        config.out.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+        config.rotation_angle = PPA_SRM_ROTATION_ANGLE_0;
+        config.scale_x = scaleX;
+        config.scale_y = scaleY;
+        config.alpha_update_mode = PPA_ALPHA_NO_CHANGE;
+        config.mode = PPA_TRANS_MODE_NON_BLOCKING;
+        config.user_data = strip_done;
+
+        esp_err_t ret = ppa_do_scale_rotate_mirror(ppa_strip_handle, &config);
+        if (ret != ESP_OK) {
+            LOG_ERROR_F("PPA strip %lu failed: %s\n", (unsigned long)strip_seq, esp_err_to_name(ret));
+            return false;
+        }
+        strip_trans_submitted++;
+        *outRows = outH;
+    }
+    // A strip scaled to no rows needs no transaction and is free at once
+    strip_trans_for[strip_seq % STRIP_MAX_SLOTS] = strip_trans_submitted;
+    strip_seq++;
+    return true;
+}
+
+bool PPAAccelerator::waitStrip(uint32_t seq) {
+    if (seq >= strip_seq || strip_seq - seq > STRIP_MAX_SLOTS) return false;
+    uint32_t target = strip_trans_for[seq % STRIP_MAX_SLOTS];
+    while (strip_trans_done < target) {
+        if (xSemaphoreTake(strip_done, pdMS_TO_TICKS(STRIP_PPA_TIMEOUT_MS)) != pdTRUE) {
+            LOG_ERROR_F("PPA strip %lu timed out\n", (unsigned long)seq);
+            return false;
+        }
+        strip_trans_done++;
+    }
+    return true;
+}
+
+bool PPAAccelerator::endStrips() {
+    bool ok = true;
+    while (ok && strip_trans_done < strip_trans_submitted) {
+        if (xSemaphoreTake(strip_done, pdMS_TO_TICKS(STRIP_PPA_TIMEOUT_MS)) != pdTRUE) {
+            LOG_ERROR("PPA strips timed out");
+            ok = false;
+        } else {
+            strip_trans_done++;
+        }
+    }
+    if (!strip_dst) return false;
+    size_t dstSizeAligned = ((size_t)strip_dst_width * strip_dst_height * sizeof(uint16_t) + 63) & ~63;
+    esp_cache_msync(strip_dst, dstSizeAligned, ESP_CACHE_MSYNC_FLAG_DIR_M2C);
+    return ok;
+}
+
+bool PPAStripSink::begin(uint16_t* dst, size_t dstBufferSize, int width, int dstWidth, int dstHeight,
+                         float sx, float sy) {
+    srcWidth = width;
+    scaleX = sx;
+    scaleY = sy;
+    rows = 0;
+    return ppaAccelerator.beginStrips(dst, dstBufferSize, dstWidth, dstHeight);
+}
+
+bool PPAStripSink::consume(const uint16_t* strip, int y, int h, uint32_t seq) {
+    (void)y;
+    (void)seq;
+    int out = 0;
+    if (!ppaAccelerator.submitStrip(strip, srcWidth, h, rows, scaleX, scaleY, &out)) return false;
+    rows += out;
+    return true;
+}
+
 size_t PPAAccelerator::getSourceBufferSize() const {
     return ppa_src_buffer_size;
 }
@@ -4,6 +4,8 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "render_geometry.h"
+#include "strip_pipeline.h"
 
 extern "C" {
 #include "driver/ppa.h"
@@ -20,6 +22,24 @@ private:
     uint16_t* ppa_dst_buffer;      // DMA-aligned destination buffer
     size_t ppa_src_buffer_size;
     size_t ppa_dst_buffer_size;
+
+    // Strip scaling (beginStrips): own client so several transactions can be
+    // queued, completions counted by the done interrupt
+    ppa_client_handle_t ppa_strip_handle;
+    SemaphoreHandle_t strip_done;
+    uint16_t* strip_dst;
+    size_t strip_dst_size;
+    int strip_dst_width;
+    int strip_dst_height;
+    uint32_t strip_seq;                          // strips submitted
+    uint32_t strip_trans_submitted;              // PPA transactions queued
+    uint32_t strip_trans_done;                   // and completed
+    uint32_t strip_trans_for[STRIP_MAX_SLOTS];   // transactions queued up to strip n
+
+    // Fill and blend engine clients (fillFramebuffer, blendFramebuffer),
+    // registered on first use
+    ppa_client_handle_t ppa_fill_handle;
+    ppa_client_handle_t ppa_blend_handle;
     
     // Debug function pointer
     void (*debugPrintFunc)(const char* message, uint16_t color);
@@ -56,6 +76,49 @@ public:
                                   int16_t dstWidth, int16_t dstHeight,
                                   float rotation = 0.0);
 
+    /**
+     * @brief Scale+rotate straight into the panel framebuffer
+     *
+     * Draws the whole srcWidth x srcHeight picture at dstWidth x dstHeight
+     * (after rotation) with its top-left at (dstX, dstY) on the fbWidth x
+     * fbHeight framebuffer, using the output block offset for the position
+     * and reading only the part of the picture that lands on the panel (see
+     * renderPanelBlit). *written is set to the panel pixels filled. Saves
+     * the scaled copy and the CPU copy of it into the framebuffer. False
+     * when the PPA can't take it or none of the picture is on the panel; the
+     * framebuffer is then untouched. fb must be 64-byte aligned.
+     */
+    bool scaleRotateToFramebuffer(uint16_t* srcPixels, int srcWidth, int srcHeight,
+                                  uint16_t* fb, int fbWidth, int fbHeight,
+                                  int dstX, int dstY, int dstWidth, int dstHeight,
+                                  float rotation, RenderRect* written);
+
+    // Fill rect (clipped to the framebuffer) with an RGB565 colour on the
+    // PPA fill engine
+    bool fillFramebuffer(uint16_t* fb, int fbWidth, int fbHeight, RenderRect rect, uint16_t color);
+
+    // Blend fg, a whole fbWidth x fbHeight picture in panel order, over the
+    // framebuffer in place at a fixed alpha (255: fg replaces it), on the
+    // PPA blend engine
+    bool blendFramebuffer(const uint16_t* fg, uint16_t* fb, int fbWidth, int fbHeight, uint8_t alpha);
+
+    /**
+     * @brief Scale a picture strip by strip without waiting (strip pipeline)
+     *
+     * beginStrips() sets up the output picture; each submitStrip() queues one
+     * rows-high strip, scaled by k/16 factors (see stripQuantizeScale), below
+     * the rows already written and returns at once - the strip buffer must
+     * stay untouched until waitStrip() for its number (counted from 0) has
+     * returned. endStrips() waits for everything and makes the output
+     * visible to the CPU. Strip buffers and dst must be 64-byte aligned DMA
+     * memory.
+     */
+    bool beginStrips(uint16_t* dst, size_t dstBufferSize, int dstWidth, int dstHeight);
+    bool submitStrip(const uint16_t* strip, int srcWidth, int rows, int dstY,
+                     float scaleX, float scaleY, int* outRows);
+    bool waitStrip(uint32_t seq);
+    bool endStrips();
+
     // Buffer information
     size_t getSourceBufferSize() const;
     size_t getDestinationBufferSize() const;
@@ -76,4 +139,21 @@ private:
 // Global instance
 extern PPAAccelerator ppaAccelerator;
 
+// StripSink that has the PPA scale each strip into the output (asynchronously;
+// a ring buffer is reclaimed once its transaction is done)
+class PPAStripSink : public StripSink {
+public:
+    bool begin(uint16_t* dst, size_t dstBufferSize, int srcWidth, int dstWidth, int dstHeight,
+               float scaleX, float scaleY);
+    bool consume(const uint16_t* strip, int y, int h, uint32_t seq) override;
+    bool reclaim(uint32_t seq) override { return ppaAccelerator.waitStrip(seq); }
+    bool finish() override { return ppaAccelerator.endStrips(); }
+    int rowsWritten() const override { return rows; }
+
+private:
+    int srcWidth = 0;
+    float scaleX = 1.0f, scaleY = 1.0f;
+    int rows = 0;
+};
+
 #endif // PPA_ACCELERATOR_H
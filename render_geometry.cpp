@@ -0,0 +1,221 @@
+#include "render_geometry.h"
+#include <math.h>
+#include <string.h>
+
+static bool rotatedQuarter(float rotationDeg) {
+    return rotationDeg == 90.0f || rotationDeg == 270.0f;
+}
+
+void renderScaledSize(int frameW, int frameH, float scaleX, float scaleY, float rotationDeg,
+                      int* outW, int* outH) {
+    if (rotatedQuarter(rotationDeg)) {
+        *outW = (int)(frameH * scaleX);
+        *outH = (int)(frameW * scaleY);
+    } else {
+        *outW = (int)(frameW * scaleX);
+        *outH = (int)(frameH * scaleY);
+    }
+}
+
+int renderDecodeReduction(float scaleX, float scaleY, int maxReduction) {
+    if (scaleX <= 0.0f || scaleY <= 0.0f) return 1;
+    int reduction = 1;
+    while (reduction < 8 && reduction * 2 <= maxReduction) {
+        int next = reduction * 2;
+        if (scaleX * next > 1.0f || scaleY * next > 1.0f) break;
+        reduction = next;
+    }
+    return reduction;
+}
+
+void frameDrawScale(const FrameLayout& l, float scaleX, float scaleY, float* drawX, float* drawY) {
+    *drawX = scaleX * l.reduction / l.prescaleX;
+    *drawY = scaleY * l.reduction / l.prescaleY;
+}
+
+bool frameTooCoarse(const FrameLayout& l, float scaleX, float scaleY) {
+    // Small tolerance: a prescale of exactly the wanted scale is not coarse
+    float wantX = fminf(scaleX * l.reduction, (float)l.reduction);
+    float wantY = fminf(scaleY * l.reduction, (float)l.reduction);
+    return wantX > l.prescaleX * 1.001f || wantY > l.prescaleY * 1.001f;
+}
+
+bool renderVisibleRect(int frameW, int frameH, float scaleX, float scaleY, float rotationDeg,
+                       int offsetX, int offsetY, int panelW, int panelH, RenderRect* out) {
+    int sw, sh;
+    renderScaledSize(frameW, frameH, scaleX, scaleY, rotationDeg, &sw, &sh);
+    if (sw <= 0 || sh <= 0) return false;
+
+    // Drawn frame's top-left, as renderFullImage() places it
+    int left = panelW / 2 - sw / 2 + offsetX;
+    int top = panelH / 2 - sh / 2 + offsetY;
+
+    // Part of the drawn frame on the panel, relative to its top-left
+    int u0 = left < 0 ? -left : 0;
+    int v0 = top < 0 ? -top : 0;
+    int u1 = panelW - left < sw ? panelW - left : sw;
+    int v1 = panelH - top < sh ? panelH - top : sh;
+    if (u0 >= u1 || v0 >= v1) return false;
+
+    // Back to pixels of the rotated frame, rounding outwards
+    bool quarter = rotatedQuarter(rotationDeg);
+    int rw = quarter ? frameH : frameW;
+    int rh = quarter ? frameW : frameH;
+    int x0 = (int)floorf((float)u0 * rw / sw);
+    int y0 = (int)floorf((float)v0 * rh / sh);
+    int x1 = (int)ceilf((float)u1 * rw / sw);
+    int y1 = (int)ceilf((float)v1 * rh / sh);
+    if (x1 > rw) x1 = rw;
+    if (y1 > rh) y1 = rh;
+
+    // Undo the rotation
+    if (rotationDeg == 90.0f) {
+        *out = { frameW - y1, x0, y1 - y0, x1 - x0 };
+    } else if (rotationDeg == 180.0f) {
+        *out = { frameW - x1, frameH - y1, x1 - x0, y1 - y0 };
+    } else if (rotationDeg == 270.0f) {
+        *out = { y0, frameH - x1, y1 - y0, x1 - x0 };
+    } else {
+        *out = { x0, y0, x1 - x0, y1 - y0 };
+    }
+    return true;
+}
+
+void renderAlignRect(RenderRect* r, int margin, int align, int frameW, int frameH) {
+    if (align < 1) align = 1;
+    int x0 = r->x - margin, y0 = r->y - margin;
+    int x1 = r->x + r->w + margin, y1 = r->y + r->h + margin;
+    x0 = x0 < 0 ? 0 : x0 / align * align;
+    y0 = y0 < 0 ? 0 : y0 / align * align;
+    x1 = (x1 + align - 1) / align * align;
+    y1 = (y1 + align - 1) / align * align;
+    if (x1 > frameW) x1 = frameW;
+    if (y1 > frameH) y1 = frameH;
+    *r = { x0, y0, x1 - x0, y1 - y0 };
+}
+
+bool renderRectContains(const RenderRect& outer, const RenderRect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.w <= outer.x + outer.w && inner.y + inner.h <= outer.y + outer.h;
+}
+
+void renderCropPlacement(int frameW, int frameH, const RenderRect& crop, float scaleX, float scaleY,
+                         float rotationDeg, RenderRect* out) {
+    // The crop's position in the rotated frame
+    int rx, ry;
+    if (rotationDeg == 90.0f) {
+        rx = crop.y;
+        ry = frameW - crop.x - crop.w;
+    } else if (rotationDeg == 180.0f) {
+        rx = frameW - crop.x - crop.w;
+        ry = frameH - crop.y - crop.h;
+    } else if (rotationDeg == 270.0f) {
+        rx = frameH - crop.y - crop.h;
+        ry = crop.x;
+    } else {
+        rx = crop.x;
+        ry = crop.y;
+    }
+    out->x = (int)(rx * scaleX);
+    out->y = (int)(ry * scaleY);
+    renderScaledSize(crop.w, crop.h, scaleX, scaleY, rotationDeg, &out->w, &out->h);
+}
+
+void renderCropInPlace(uint16_t* pixels, int stride, const RenderRect& crop) {
+    // Each row moves to an address at or below where it was, so a forward
+    // pass never overwrites a row still to be moved
+    for (int y = 0; y < crop.h; y++) {
+        memmove(pixels + (size_t)y * crop.w, pixels + (size_t)(crop.y + y) * stride + crop.x,
+                (size_t)crop.w * sizeof(uint16_t));
+    }
+}
+
+int renderUncoveredBands(const RenderRect& prev, const RenderRect& next, RenderRect out[4]) {
+    if (prev.w <= 0 || prev.h <= 0) return 0;
+    int pl = prev.x, pr = prev.x + prev.w, pt = prev.y, pb = prev.y + prev.h;
+    int nl = next.x, nr = next.x + next.w, nt = next.y, nb = next.y + next.h;
+    int ox1 = pl > nl ? pl : nl, ox2 = pr < nr ? pr : nr;   // horizontal overlap
+    int oy1 = pt > nt ? pt : nt, oy2 = pb < nb ? pb : nb;   // vertical overlap
+    if (ox1 >= ox2 || oy1 >= oy2) {
+        out[0] = prev;
+        return 1;
+    }
+
+    int n = 0;
+    if (nl > pl) out[n++] = { pl, pt, nl - pl, prev.h };
+    if (nr < pr) out[n++] = { nr, pt, pr - nr, prev.h };
+    if (nt > pt) out[n++] = { ox1, pt, ox2 - ox1, nt - pt };
+    if (nb < pb) out[n++] = { ox1, nb, ox2 - ox1, pb - nb };
+    return n;
+}
+
+bool renderClipRect(RenderRect* r, int panelW, int panelH) {
+    int x0 = r->x < 0 ? 0 : r->x, y0 = r->y < 0 ? 0 : r->y;
+    int x1 = r->x + r->w > panelW ? panelW : r->x + r->w;
+    int y1 = r->y + r->h > panelH ? panelH : r->y + r->h;
+    if (x0 >= x1 || y0 >= y1) return false;
+    *r = { x0, y0, x1 - x0, y1 - y0 };
+    return true;
+}
+
+// One panel axis of renderPanelBlit: `srcLen` picture pixels scaled by
+// `scale`, read in reverse when `reversed`, drawn from panel position `pos`.
+// Sets the source span [*srcBegin, *srcBegin + *srcCount) and the panel span
+// it is written to.
+static bool blitAxis(int srcLen, float scale, bool reversed, int pos, int panelLen,
+                     int* srcBegin, int* srcCount, int* outPos, int* outLen) {
+    int drawn = (int)(srcLen * scale);
+    int a = pos < 0 ? -pos : 0;                                // visible part of the drawn
+    int b = panelLen - pos < drawn ? panelLen - pos : drawn;   // picture, relative to it
+    if (a >= b) return false;
+
+    // Whole source pixels inside [a, b) (the slack keeps edges that are exact but for float rounding)
+    double s = scale;
+    int s0, s1;
+    if (reversed) {
+        s0 = (int)ceil(srcLen - b / s - 1e-3);
+        s1 = (int)floor(srcLen - a / s + 1e-3);
+    } else {
+        s0 = (int)ceil(a / s - 1e-3);
+        s1 = (int)floor(b / s + 1e-3);
+    }
+    if (s0 < 0) s0 = 0;
+    if (s1 > srcLen) s1 = srcLen;
+
+    // Where the block starts within the drawn picture, rounded down but not
+    // before the visible part; drop a far-edge pixel should rounding still
+    // take the written span past it
+    int start, len;
+    for (;;) {
+        if (s1 <= s0) return false;
+        len = (int)((s1 - s0) * scale);
+        start = (int)floor((reversed ? srcLen - s1 : s0) * s + 1e-3);
+        if (start < a) start = a;
+        if (start + len <= b) break;
+        if (reversed) s0++;
+        else s1--;
+    }
+    if (len <= 0) return false;
+    *srcBegin = s0;
+    *srcCount = s1 - s0;
+    *outPos = pos + start;
+    *outLen = len;
+    return true;
+}
+
+bool renderPanelBlit(int srcW, int srcH, float scaleX, float scaleY, float rotationDeg,
+                     int x, int y, int panelW, int panelH, RenderBlit* out) {
+    // Which picture axis feeds each panel axis, and in which direction (the
+    // rotation is counter-clockwise)
+    bool quarter = rotatedQuarter(rotationDeg);
+    bool revX = rotationDeg == 180.0f || rotationDeg == 270.0f;   // panel x
+    bool revY = rotationDeg == 90.0f || rotationDeg == 180.0f;    // panel y
+    int lenX = quarter ? srcH : srcW, lenY = quarter ? srcW : srcH;
+    float sX = quarter ? scaleY : scaleX, sY = quarter ? scaleX : scaleY;
+
+    int bx, bw, by, bh;
+    if (!blitAxis(lenX, sX, revX, x, panelW, &bx, &bw, &out->out.x, &out->out.w)) return false;
+    if (!blitAxis(lenY, sY, revY, y, panelH, &by, &bh, &out->out.y, &out->out.h)) return false;
+    out->in = quarter ? RenderRect{ by, bx, bh, bw } : RenderRect{ bx, by, bw, bh };
+    return true;
+}
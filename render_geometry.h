@@ -0,0 +1,106 @@
+#pragma once
+#ifndef RENDER_GEOMETRY_H
+#define RENDER_GEOMETRY_H
+
+// =============================================================================
+// RENDER GEOMETRY
+// =============================================================================
+// How a decoded frame maps onto the panel under the per-source transform
+// (scaleX / scaleY relative to the frame, rotation in 90° steps, centred plus
+// offset), and what that implies for decoding. Shared by the decode-size
+// choice and renderFullImage(); no Arduino / IDF types so it is unit-tested
+// on the host (test/test_render_geometry.cpp).
+//
+// 90° and 270° turn the frame counter-clockwise, as the PPA does.
+
+#include <stdint.h>
+
+// Rectangle in frame or screen pixels
+struct RenderRect {
+    int x, y, w, h;
+};
+
+// What a buffer of decoded pixels holds: all of a frame, or only the part of
+// it the transform put on the panel when it was decoded (see
+// renderVisibleRect). The buffer's own width / height are the stored size.
+struct FrameLayout {
+    int16_t frameW, frameH;   // whole frame at the decoded resolution (0: same as stored)
+    int16_t cropX, cropY;     // top-left of the stored pixels within the frame
+    uint8_t reduction;        // decode-time downscale beyond buffer fit (1 = none);
+                              // the renderer multiplies the transform scale by it
+    float prescaleX, prescaleY;   // already scaled by this when stored (1 = not);
+                                  // frameW / cropX etc. are then in stored pixels
+    uint32_t stage;           // pixel stage the stored pixels went through
+                              // (PixelStage::key, pixel_stage.h; 0 = none)
+};
+
+// Scale to draw the stored pixels at so the frame appears at the transform
+// scale: scale * reduction / prescale per axis.
+void frameDrawScale(const FrameLayout& l, float scaleX, float scaleY, float* drawX, float* drawY);
+
+// Whether the stored pixels are too coarse for the transform, i.e. are drawn
+// enlarged where a new decode could give more detail: on either axis the
+// scale wanted relative to the decoded frame (scale * reduction, but no more
+// than the reduction, which is full resolution) exceeds what was stored.
+bool frameTooCoarse(const FrameLayout& l, float scaleX, float scaleY);
+
+// On-screen size of a frameW x frameH frame drawn with the transform. 90°
+// and 270° swap the axes before scaling, exactly as renderFullImage() does.
+void renderScaledSize(int frameW, int frameH, float scaleX, float scaleY, float rotationDeg,
+                      int* outW, int* outH);
+
+// Largest power-of-two decode-time reduction (1, 2, 4 or 8, at most
+// maxReduction) that the transform can absorb without upscaling: the frame is
+// decoded 1/r the size and drawn at r times the scale, which must stay <= 1 on
+// both axes. Rotation only swaps which frame axis each scale applies to, and
+// the panel size is already in the user's scale, so neither changes the
+// answer. renderFullImage() uses the same test to spot a frame that has
+// become too coarse after a zoom-in.
+int renderDecodeReduction(float scaleX, float scaleY, int maxReduction);
+
+// The pixels of a frameW x frameH frame that land on a panelW x panelH panel
+// when it is drawn centred plus offset with the transform, rounded outwards
+// to whole frame pixels. False when none of the frame is on the panel.
+bool renderVisibleRect(int frameW, int frameH, float scaleX, float scaleY, float rotationDeg,
+                       int offsetX, int offsetY, int panelW, int panelH, RenderRect* out);
+
+// Grow r by margin on every side and out to multiples of align (the JPEG MCU
+// size), clipped to the frame.
+void renderAlignRect(RenderRect* r, int margin, int align, int frameW, int frameH);
+
+bool renderRectContains(const RenderRect& outer, const RenderRect& inner);
+
+// Where the part `crop` of a frameW x frameH frame is drawn, relative to the
+// top-left of the whole drawn frame, and its drawn size. For the whole frame
+// that is (0, 0) and renderScaledSize().
+void renderCropPlacement(int frameW, int frameH, const RenderRect& crop, float scaleX, float scaleY,
+                         float rotationDeg, RenderRect* out);
+
+// Keep only `crop` of a packed RGB565 frame `stride` pixels wide, repacked at
+// crop.w from the start of the buffer.
+void renderCropInPlace(uint16_t* pixels, int stride, const RenderRect& crop);
+
+// Parts of `prev` that `next` does not cover, as at most four bands (left
+// and right at prev's full height, top and bottom across the overlap) in
+// out[]; returns how many. All of prev when the two don't overlap.
+int renderUncoveredBands(const RenderRect& prev, const RenderRect& next, RenderRect out[4]);
+
+// Clip r to a panelW x panelH panel; false when nothing is left.
+bool renderClipRect(RenderRect* r, int panelW, int panelH);
+
+// A srcW x srcH picture scaled by scaleX / scaleY (along its own axes, as the
+// PPA takes them), rotated, and drawn with its top-left at (x, y) straight
+// into a panelW x panelH framebuffer: the block of the picture to read and
+// the panel pixels that block fills. The PPA writes floor(block * scale)
+// pixels from the output block offset, so where the panel cuts the picture
+// the block is whole source pixels inside the cut, placed up to a pixel
+// inward rather than past the panel edge. False when none of it is on the
+// panel.
+struct RenderBlit {
+    RenderRect in;    // source block
+    RenderRect out;   // panel pixels written
+};
+bool renderPanelBlit(int srcW, int srcH, float scaleX, float scaleY, float rotationDeg,
+                     int x, int y, int panelW, int panelH, RenderBlit* out);
+
+#endif // RENDER_GEOMETRY_H
@@ -0,0 +1,177 @@
+#include "row_pool.h"
+
+// The band split and the job hand-off are shared; only waking a worker,
+// reporting back and the "one job at a time" lock differ per platform.
+
+struct RowBand {
+    int begin, end;
+};
+
+static int workerCount = 0;
+static RowPoolJob currentJob = nullptr;
+static void* currentCtx = nullptr;
+static RowBand bands[ROW_POOL_MAX_WORKERS];
+
+#if defined(ESP_PLATFORM)
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+static TaskHandle_t workerTasks[ROW_POOL_MAX_WORKERS];
+static SemaphoreHandle_t workSignals[ROW_POOL_MAX_WORKERS];
+static SemaphoreHandle_t doneSignal = nullptr;
+static SemaphoreHandle_t jobLock = nullptr;
+
+static void workerLoop(void* param) {
+    int index = (int)(intptr_t)param;
+    for (;;) {
+        xSemaphoreTake(workSignals[index], portMAX_DELAY);
+        currentJob(currentCtx, bands[index].begin, bands[index].end);
+        xSemaphoreGive(doneSignal);
+    }
+}
+
+static bool tryLockJob() { return xSemaphoreTake(jobLock, 0) == pdTRUE; }
+static void unlockJob() { xSemaphoreGive(jobLock); }
+static void wakeWorker(int index) { xSemaphoreGive(workSignals[index]); }
+static void waitForWorkers(int count) {
+    for (int i = 0; i < count; i++) xSemaphoreTake(doneSignal, portMAX_DELAY);
+}
+
+bool rowPoolBegin(int workers, uint32_t stackBytes, int priority) {
+    if (workerCount) return true;
+    if (workers < 1) workers = 1;
+    if (workers > ROW_POOL_MAX_WORKERS) workers = ROW_POOL_MAX_WORKERS;
+    doneSignal = xSemaphoreCreateCounting(ROW_POOL_MAX_WORKERS, 0);
+    jobLock = xSemaphoreCreateMutex();
+    if (!doneSignal || !jobLock) return false;
+    for (int i = 0; i < workers; i++) {
+        workSignals[i] = xSemaphoreCreateBinary();
+        if (!workSignals[i] ||
+            xTaskCreatePinnedToCore(workerLoop, "RowPool", stackBytes, (void*)(intptr_t)i, priority,
+                                    &workerTasks[i], i % portNUM_PROCESSORS) != pdPASS) {
+            workerCount = i;
+            rowPoolEnd();
+            return false;
+        }
+    }
+    workerCount = workers;
+    return true;
+}
+
+void rowPoolEnd() {
+    // Only between jobs: take the lock so no band is mid-flight
+    if (jobLock) xSemaphoreTake(jobLock, portMAX_DELAY);
+    for (int i = 0; i < workerCount; i++) {
+        vTaskDelete(workerTasks[i]);
+        vSemaphoreDelete(workSignals[i]);
+    }
+    workerCount = 0;
+    if (doneSignal) vSemaphoreDelete(doneSignal);
+    if (jobLock) vSemaphoreDelete(jobLock);
+    doneSignal = jobLock = nullptr;
+}
+
+#else
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+static std::thread workerThreads[ROW_POOL_MAX_WORKERS];
+static bool workPending[ROW_POOL_MAX_WORKERS];
+static bool stopping = false;
+static int workersDone = 0;
+static std::mutex poolMutex;
+static std::condition_variable workCv, doneCv;
+static std::mutex jobLock;
+
+static void workerLoop(int index) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            workCv.wait(lock, [index] { return workPending[index] || stopping; });
+            if (stopping) return;
+            workPending[index] = false;
+        }
+        currentJob(currentCtx, bands[index].begin, bands[index].end);
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            workersDone++;
+        }
+        doneCv.notify_one();
+    }
+}
+
+static bool tryLockJob() { return jobLock.try_lock(); }
+static void unlockJob() { jobLock.unlock(); }
+static void wakeWorker(int index) {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    workPending[index] = true;
+    workCv.notify_all();
+}
+static void waitForWorkers(int count) {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    doneCv.wait(lock, [count] { return workersDone >= count; });
+    workersDone = 0;
+}
+
+bool rowPoolBegin(int workers, uint32_t, int) {
+    if (workerCount) return true;
+    if (workers < 1) workers = 1;
+    if (workers > ROW_POOL_MAX_WORKERS) workers = ROW_POOL_MAX_WORKERS;
+    stopping = false;
+    for (int i = 0; i < workers; i++) {
+        workPending[i] = false;
+        workerThreads[i] = std::thread(workerLoop, i);
+    }
+    workerCount = workers;
+    return true;
+}
+
+void rowPoolEnd() {
+    std::lock_guard<std::mutex> job(jobLock);
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        stopping = true;
+    }
+    workCv.notify_all();
+    for (int i = 0; i < workerCount; i++) workerThreads[i].join();
+    workerCount = 0;
+}
+
+#endif
+
+int rowPoolWorkers() { return workerCount; }
+
+void rowPoolRun(int rows, RowPoolJob job, void* ctx, int align) {
+    if (rows <= 0) return;
+    if (align < 1) align = 1;
+    int workers = workerCount;
+    if (workers > 1 && rows < workers * ROW_POOL_MIN_BAND_ROWS) workers = rows / ROW_POOL_MIN_BAND_ROWS;
+    if (workers <= 1 || !tryLockJob()) {
+        job(ctx, 0, rows);
+        return;
+    }
+
+    // Even split in units of `align` rows; trailing workers may get nothing
+    int units = (rows + align - 1) / align;
+    int active = 0;
+    for (int i = 0; i < workers; i++) {
+        int begin = (int)((long)units * i / workers) * align;
+        int end = (int)((long)units * (i + 1) / workers) * align;
+        if (end > rows) end = rows;
+        if (begin >= end) continue;
+        bands[active].begin = begin;
+        bands[active].end = end;
+        active++;
+    }
+    currentJob = job;
+    currentCtx = ctx;
+    for (int i = 0; i < active; i++) wakeWorker(i);
+    waitForWorkers(active);
+    currentJob = nullptr;
+    currentCtx = nullptr;
+    unlockJob();
+}
@@ -0,0 +1,43 @@
+#pragma once
+#ifndef ROW_POOL_H
+#define ROW_POOL_H
+
+#include <stdint.h>
+
+// =============================================================================
+// ROW POOL (FORK / JOIN)
+// =============================================================================
+// Splits the rows of a whole-frame pixel pass (software scale / rotate, the
+// pixel stage, the moon background) into one band per worker, runs the bands
+// at the same time and returns once all of them are done. The workers are
+// created once and sleep between jobs: FreeRTOS tasks pinned one per core on
+// the device, std::thread on the host (test/bench_row_pool.cpp), behind the
+// same calls.
+//
+// One job at a time: a call made while another job is running (from the task
+// on the other core, or from inside a job) runs its rows on the caller
+// instead of waiting, as does any call before rowPoolBegin() or with too few
+// rows to be worth splitting.
+
+#define ROW_POOL_MAX_WORKERS 4
+#define ROW_POOL_MIN_BAND_ROWS 8    // fewer rows per worker run on the caller
+
+// Rows [rowBegin, rowEnd) of a job
+typedef void (*RowPoolJob)(void* ctx, int rowBegin, int rowEnd);
+
+// Start the workers (1..ROW_POOL_MAX_WORKERS). On the device worker i is
+// pinned to core i % cores with the given stack and priority; the host
+// ignores both. False if a worker could not be started (the pool then runs
+// every job on the caller).
+bool rowPoolBegin(int workers, uint32_t stackBytes, int priority);
+// Stop and release the workers
+void rowPoolEnd();
+// Workers running (0 before rowPoolBegin())
+int rowPoolWorkers();
+
+// Run job over rows [0, rows), each band starting on a multiple of `align`
+// rows (tile height for tiled jobs). The caller blocks until every band is
+// done, so the job's context can live on its stack.
+void rowPoolRun(int rows, RowPoolJob job, void* ctx, int align = 1);
+
+#endif // ROW_POOL_H
@@ -0,0 +1,321 @@
+#include "strip_pipeline.h"
+#include "pixel_kernels.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int FP_SHIFT = 16;
+static const uint32_t FP_MASK = (1u << FP_SHIFT) - 1;
+
+void stripBilinearRow(const uint16_t* row0, const uint16_t* row1, uint32_t yFrac,
+                      int srcW, uint16_t* out, int dstW) {
+    pxBilinearRow(row0, row1, yFrac, srcW, out, dstW);
+}
+
+void stripBilinearScale(const uint16_t* src, int srcW, int srcH, uint16_t* dst, int dstW, int dstH) {
+    uint32_t yRatio = ((uint32_t)(srcH - 1) << FP_SHIFT) / dstH;
+    for (int dstY = 0; dstY < dstH; dstY++) {
+        uint32_t srcY = (uint32_t)dstY * yRatio;
+        int y0 = srcY >> FP_SHIFT;
+        int y1 = (y0 + 1 < srcH) ? y0 + 1 : y0;
+        stripBilinearRow(src + (size_t)y0 * srcW, src + (size_t)y1 * srcW, srcY & FP_MASK,
+                         srcW, dst + (size_t)dstY * dstW, dstW);
+    }
+}
+
+float stripQuantizeScale(float scale) {
+    int k = (int)ceilf(scale * 16.0f - 1e-4f);
+    if (k < 1) k = 1;
+    return k / 16.0f;
+}
+
+// -----------------------------------------------------------------------------
+
+void StripCopySink::begin(int w, uint16_t* dst, int rowsMax) {
+    width = w;
+    out = dst;
+    maxRows = rowsMax;
+    rows = 0;
+}
+
+bool StripCopySink::consume(const uint16_t* strip, int y, int h, uint32_t seq) {
+    (void)seq;
+    if (y != rows || y + h > maxRows) return false;
+    memcpy(out + (size_t)y * width, strip, (size_t)h * width * sizeof(uint16_t));
+    rows = y + h;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void StripScaler::begin(int sw, int sh, int dw, int dh, uint16_t* dst, uint16_t* carryRow) {
+    srcW = sw;
+    srcH = sh;
+    dstW = dw;
+    dstH = dh;
+    out = dst;
+    carry = carryRow;
+    yRatio = ((uint32_t)(srcH - 1) << FP_SHIFT) / dstH;
+    nextY = 0;
+    done = 0;
+}
+
+bool StripScaler::consume(const uint16_t* strip, int y, int h, uint32_t seq) {
+    (void)seq;
+    if (y != nextY || h <= 0 || y + h > srcH) return false;
+    int end = y + h;
+
+    while (done < dstH) {
+        uint32_t srcY = (uint32_t)done * yRatio;
+        int y0 = srcY >> FP_SHIFT;
+        int y1 = (y0 + 1 < srcH) ? y0 + 1 : y0;
+        if (y1 >= end) break;   // needs the next strip
+        // y0 >= y - 1: rows before that were finished with the last strip
+        const uint16_t* row0 = (y0 < y) ? carry : strip + (size_t)(y0 - y) * srcW;
+        const uint16_t* row1 = (y1 < y) ? carry : strip + (size_t)(y1 - y) * srcW;
+        stripBilinearRow(row0, row1, srcY & FP_MASK, srcW, out + (size_t)done * dstW, dstW);
+        done++;
+    }
+
+    memcpy(carry, strip + (size_t)(h - 1) * srcW, (size_t)srcW * sizeof(uint16_t));
+    nextY = end;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool stripBoxScale(const uint16_t* src, int srcW, int srcH, uint16_t* dst, int dstW, int dstH,
+                   int rowBegin, int rowEnd) {
+    StripBoxScaler box;
+    if (!box.begin(srcW, srcH, dstW, dstH, dst, rowBegin, rowEnd)) return false;
+    int y0, y1;
+    StripBoxScaler::sourceRows(srcH, dstH, rowBegin, rowEnd < 0 ? dstH : rowEnd, &y0, &y1);
+    bool ok = box.consume(src + (size_t)y0 * srcW, y0, y1 - y0, 0);
+    return box.finish() && ok;
+}
+
+void StripBoxScaler::sourceRows(int sh, int dh, int kBegin, int kEnd, int* y0, int* y1) {
+    *y0 = (int)((int64_t)kBegin * sh / dh);
+    *y1 = (int)(((int64_t)kEnd * sh + dh - 1) / dh);
+    if (*y1 > sh) *y1 = sh;
+}
+
+bool StripBoxScaler::begin(int sw, int sh, int dw, int dh, uint16_t* dst, int kBegin, int kEnd) {
+    release();
+    if (sw <= 0 || sh <= 0 || dw <= 0 || dh <= 0 || dw > sw || dh > sh || sw > 0xFFFF) return false;
+    // A channel sum reaches 63 * srcW * srcH before the division
+    uint64_t total = (uint64_t)sw * sh;
+    if (total > 0xFFFFFFFFull / 64) return false;
+    if (kEnd < 0 || kEnd > dh) kEnd = dh;
+    if (kBegin < 0) kBegin = 0;
+
+    size_t sums = (size_t)dw * 3;
+    spans = (Span*)malloc(sizeof(Span) * dw + sizeof(uint32_t) * sums * 3);
+    if (!spans) return false;
+    whole = (uint32_t*)(spans + dw);
+    edge = whole + sums;
+    next = edge + sums;
+    memset(whole, 0, sizeof(uint32_t) * sums * 3);
+
+    srcW = sw;
+    srcH = sh;
+    dstW = dw;
+    dstH = dh;
+    out = dst;
+    rowBegin = kBegin;
+    rowEnd = kEnd;
+
+    // In units where an output pixel is srcW wide and a source pixel dstW,
+    // output column j covers [j * srcW, (j + 1) * srcW)
+    for (int j = 0; j < dw; j++) {
+        int64_t left = (int64_t)j * sw, right = left + sw;
+        int x0 = (int)(left / dw);
+        int x1 = (int)((right - 1) / dw);
+        Span& s = spans[j];
+        s.x0 = (uint16_t)x0;
+        s.x1 = (uint16_t)x1;
+        if (x0 == x1) {
+            s.wl = (uint16_t)sw;
+            s.wr = 0;
+        } else {
+            s.wl = (uint16_t)((int64_t)(x0 + 1) * dw - left);
+            s.wr = (uint16_t)(right - (int64_t)x1 * dw);
+        }
+    }
+
+    // n / total == (n * recip) >> recipShift for every n < 64 * total
+    int bits = 0;
+    while ((1ull << bits) < total) bits++;
+    recipShift = 32 + bits;
+    recip = ((1ull << recipShift) + total - 1) / total;
+
+    sourceRows(sh, dh, kBegin, kEnd, &nextY, &endY);
+    curK = -1;
+    done = 0;
+    return true;
+}
+
+void StripBoxScaler::release() {
+    free(spans);
+    spans = nullptr;
+    whole = edge = next = nullptr;
+}
+
+bool StripBoxScaler::finish() {
+    release();
+    return true;
+}
+
+bool StripBoxScaler::consume(const uint16_t* strip, int y, int h, uint32_t seq) {
+    (void)seq;
+    if (!spans || y > nextY || h <= 0 || y + h > srcH) return false;
+    int from = nextY > y ? nextY : y;
+    int to = (y + h < endY) ? y + h : endY;
+    for (int row = from; row < to; row++) addRow(strip + (size_t)(row - y) * srcW, row);
+    if (to > nextY) nextY = to;
+    return true;
+}
+
+void StripBoxScaler::addRow(const uint16_t* row, int y) {
+    // Row y covers [y * dstH, (y + 1) * dstH) of output row k's
+    // [k * srcH, (k + 1) * srcH)
+    int64_t top = (int64_t)y * dstH, bottom = top + dstH;
+    int k = (int)(top / srcH);
+    int64_t boundary = (int64_t)(k + 1) * srcH;
+    uint32_t w0 = (uint32_t)((bottom < boundary ? bottom : boundary) - top);
+    uint32_t w1 = dstH - w0;
+    if (curK < 0) curK = k;
+
+    for (int j = 0; j < dstW; j++) {
+        const Span& s = spans[j];
+        uint16_t a = row[s.x0];
+        uint32_t r = (a >> 11) * s.wl;
+        uint32_t g = ((a >> 5) & 0x3F) * s.wl;
+        uint32_t b = (a & 0x1F) * s.wl;
+        if (s.x1 != s.x0) {
+            uint16_t c = row[s.x1];
+            r += (c >> 11) * s.wr;
+            g += ((c >> 5) & 0x3F) * s.wr;
+            b += (c & 0x1F) * s.wr;
+            // Columns in between, unweighted: R, G and B spread over one word
+            // (G << 21 | R << 11 | B) add up 32 pixels without carrying over
+            uint32_t sr = 0, sg = 0, sb = 0;
+            for (int x = s.x0 + 1; x < s.x1;) {
+                int end = (x + 32 < s.x1) ? x + 32 : s.x1;
+                uint32_t sum = 0;
+                for (; x < end; x++) {
+                    uint32_t p = row[x];
+                    sum += (p | (p << 16)) & 0x07E0F81F;
+                }
+                sr += (sum >> 11) & 0x3FF;
+                sg += sum >> 21;
+                sb += sum & 0x3FF;
+            }
+            r += sr * dstW;
+            g += sg * dstW;
+            b += sb * dstW;
+        }
+
+        uint32_t* acc = &whole[j * 3];
+        if (w0 == (uint32_t)dstH) {
+            acc[0] += r;
+            acc[1] += g;
+            acc[2] += b;
+        } else {
+            acc = &edge[j * 3];
+            acc[0] += r * w0;
+            acc[1] += g * w0;
+            acc[2] += b * w0;
+            if (w1) {
+                acc = &next[j * 3];
+                acc[0] += r * w1;
+                acc[1] += g * w1;
+                acc[2] += b * w1;
+            }
+        }
+    }
+
+    if (bottom >= boundary) {
+        if (curK >= rowBegin && curK < rowEnd) emitRow(curK);
+        // The straddling row's share moves on; the rest starts from zero
+        uint32_t* t = edge;
+        edge = next;
+        next = t;
+        memset(next, 0, sizeof(uint32_t) * dstW * 3);
+        memset(whole, 0, sizeof(uint32_t) * dstW * 3);
+        curK++;
+    }
+}
+
+void StripBoxScaler::emitRow(int k) {
+    uint16_t* o = out + (size_t)k * dstW;
+    uint64_t half = ((uint64_t)srcW * srcH) / 2;
+    for (int j = 0; j < dstW; j++) {
+        const uint32_t* a = &whole[j * 3];
+        const uint32_t* e = &edge[j * 3];
+        uint32_t r = (uint32_t)(((a[0] * (uint64_t)dstH + e[0] + half) * recip) >> recipShift);
+        uint32_t g = (uint32_t)(((a[1] * (uint64_t)dstH + e[1] + half) * recip) >> recipShift);
+        uint32_t b = (uint32_t)(((a[2] * (uint64_t)dstH + e[2] + half) * recip) >> recipShift);
+        o[j] = (uint16_t)((r << 11) | (g << 5) | b);
+    }
+    done++;
+}
+
+// -----------------------------------------------------------------------------
+
+bool StripAssembler::begin(const RenderRect& window, uint16_t* const* ring, int n, StripSink* s) {
+    if (n < 1 || n > STRIP_MAX_SLOTS || !s || window.w <= 0 || window.h <= 0) return false;
+    win = window;
+    for (int i = 0; i < n; i++) buffers[i] = ring[i];
+    slots = n;
+    sink = s;
+    seq = 0;
+    bandY = -1;
+    flushedY = -1;
+    return true;
+}
+
+bool StripAssembler::flush() {
+    if (bandY < 0) return true;
+    flushedY = bandY;
+    bandY = -1;
+    if (bandRow1 <= bandRow0) return true;   // MCU row entirely above / below the window
+    uint16_t* buf = buffers[seq % slots];
+    bool ok = sink->consume(buf, bandRow0 - win.y, bandRow1 - bandRow0, seq);
+    seq++;
+    return ok;
+}
+
+bool StripAssembler::draw(int x, int y, int w, int h, const uint16_t* pixels) {
+    if (h > STRIP_MAX_ROWS) return false;
+    if (bandY >= 0 && y != bandY && !flush()) return false;
+    if (y == flushedY) return true;   // rest of an MCU row right of the window
+
+    if (bandY < 0) {
+        bandY = y;
+        bandRow0 = y > win.y ? y : win.y;
+        bandRow1 = (y + h < win.y + win.h) ? y + h : win.y + win.h;
+        // The ring buffer this strip goes into was last used `slots` strips ago
+        if (bandRow1 > bandRow0 && seq >= (uint32_t)slots && !sink->reclaim(seq - slots)) return false;
+    }
+
+    int c0 = x > win.x ? x : win.x;
+    int c1 = (x + w < win.x + win.w) ? x + w : win.x + win.w;
+    if (c0 < c1 && bandRow1 > bandRow0) {
+        uint16_t* buf = buffers[seq % slots];
+        for (int row = bandRow0; row < bandRow1; row++) {
+            memcpy(buf + (size_t)(row - bandRow0) * win.w + (c0 - win.x),
+                   pixels + (size_t)(row - y) * w + (c0 - x),
+                   (size_t)(c1 - c0) * sizeof(uint16_t));
+        }
+    }
+
+    if (x + w >= win.x + win.w) return flush();
+    return true;
+}
+
+bool StripAssembler::finish() {
+    // The sink finishes even after a failure: it may still be reading strips
+    bool ok = flush();
+    return sink->finish() && ok;
+}
@@ -0,0 +1,183 @@
+#pragma once
+#ifndef STRIP_PIPELINE_H
+#define STRIP_PIPELINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "render_geometry.h"
+
+// =============================================================================
+// STRIP-PIPELINED DECODE -> SCALE
+// =============================================================================
+// JPEGDEC hands a frame out one MCU row at a time. Instead of collecting the
+// whole frame at full resolution and scaling it afterwards, StripAssembler
+// gathers each MCU row of the part that is kept into one of a small ring of
+// strip buffers and passes the finished strip to a StripSink, which writes
+// that strip's rows of the already-scaled output. Image memory then follows
+// the output (about the panel size), not the source.
+//
+// No Arduino / IDF types: the software sinks live here and are checked on the
+// host against a whole-frame scale (test/test_strip_pipeline.cpp); the PPA
+// sink is in ppa_accelerator.
+
+#define STRIP_MAX_ROWS 16     // tallest MCU row JPEGDEC emits (4:2:0)
+#define STRIP_MAX_SLOTS 4
+
+// One output row of a bilinear scale from srcW to dstW pixels, blending
+// row0 and row1 by yFrac (16.16). The arithmetic of ImageUtils::bilinearScale,
+// which is built on it (kernel in pixel_kernels.h).
+void stripBilinearRow(const uint16_t* row0, const uint16_t* row1, uint32_t yFrac,
+                      int srcW, uint16_t* out, int dstW);
+
+// Whole-frame bilinear scale, dst packed at dstW
+void stripBilinearScale(const uint16_t* src, int srcW, int srcH, uint16_t* dst, int dstW, int dstH);
+
+// Whole-frame area-average (box) downscale, dst packed at dstW, output rows
+// [rowBegin, rowEnd) only (rowEnd < 0: all). False when StripBoxScaler
+// can't take the sizes or has no memory.
+bool stripBoxScale(const uint16_t* src, int srcW, int srcH, uint16_t* dst, int dstW, int dstH,
+                   int rowBegin = 0, int rowEnd = -1);
+
+// Scale factor the PPA can apply exactly (a multiple of 1/16), rounded up so
+// the output is never coarser than asked for
+float stripQuantizeScale(float scale);
+
+// Receives finished strips in top-to-bottom order
+class StripSink {
+public:
+    virtual ~StripSink() {}
+    // Rows [y, y + h) of the kept part, packed at its width. The sink may go
+    // on reading `strip` until reclaim(seq) returns. False aborts the decode.
+    virtual bool consume(const uint16_t* strip, int y, int h, uint32_t seq) = 0;
+    // Block until strip number `seq` is no longer read
+    virtual bool reclaim(uint32_t seq) { (void)seq; return true; }
+    // Every strip has been delivered; wait for outstanding work
+    virtual bool finish() { return true; }
+    virtual int rowsWritten() const = 0;
+};
+
+// Rows copied unchanged into the output (no scaling needed)
+class StripCopySink : public StripSink {
+public:
+    void begin(int width, uint16_t* dst, int maxRows);
+    bool consume(const uint16_t* strip, int y, int h, uint32_t seq) override;
+    int rowsWritten() const override { return rows; }
+
+private:
+    int width = 0;
+    uint16_t* out = nullptr;
+    int maxRows = 0;
+    int rows = 0;
+};
+
+/**
+ * @brief Bilinear scale fed strip by strip.
+ *
+ * Produces exactly what stripBilinearScale() produces for the whole
+ * srcW x srcH picture: every output row is written as soon as both source
+ * rows it blends have arrived. The last row of each strip is kept in
+ * `carryRow` (srcW pixels) for the first output rows of the next one.
+ */
+class StripScaler : public StripSink {
+public:
+    void begin(int srcW, int srcH, int dstW, int dstH, uint16_t* dst, uint16_t* carryRow);
+    bool consume(const uint16_t* strip, int y, int h, uint32_t seq) override;
+    int rowsWritten() const override { return done; }
+
+private:
+    int srcW = 0, srcH = 0, dstW = 0, dstH = 0;
+    uint16_t* out = nullptr;
+    uint16_t* carry = nullptr;
+    uint32_t yRatio = 0;
+    int nextY = 0;      // first source row of the next strip
+    int done = 0;       // output rows written
+};
+
+/**
+ * @brief Area-average (box) downscale fed strip by strip.
+ *
+ * Each output pixel is the mean of the source area it covers, the source
+ * pixels on its edges weighted by the part inside, with exact integer weights
+ * so fractional ratios work as well as whole ones. Source rows are read once,
+ * in order, into running sums for the output row they fall in (and the next
+ * one, for a row straddling the boundary); an output row is written when its
+ * last source row has arrived. Unlike the bilinear scale every source pixel
+ * counts, so well below 1/2 fine detail (single-pixel stars) is averaged in
+ * instead of aliased or dropped. Downscales only (dst <= src on both axes).
+ *
+ * Only output rows [rowBegin, rowEnd) are written, from source rows
+ * sourceRows() names, so a frame can be split into bands.
+ */
+class StripBoxScaler : public StripSink {
+public:
+    ~StripBoxScaler() { release(); }
+    // False for an upscale, sizes whose sums could overflow 32 bits, or no
+    // memory for the (44 * dstW bytes of) tables and sums
+    bool begin(int srcW, int srcH, int dstW, int dstH, uint16_t* dst, int rowBegin = 0, int rowEnd = -1);
+    bool consume(const uint16_t* strip, int y, int h, uint32_t seq) override;
+    // Frees the tables (also after a failed decode)
+    bool finish() override;
+    int rowsWritten() const override { return done; }
+
+    // Source rows [*y0, *y1) that output rows [rowBegin, rowEnd) cover
+    static void sourceRows(int srcH, int dstH, int rowBegin, int rowEnd, int* y0, int* y1);
+
+private:
+    struct Span {
+        uint16_t x0, x1;   // first and last source column of an output pixel
+        uint16_t wl, wr;   // their weights; the columns between weigh dstW
+    };
+
+    void addRow(const uint16_t* row, int y);
+    void emitRow(int k);
+    void release();
+
+    int srcW = 0, srcH = 0, dstW = 0, dstH = 0;
+    int rowBegin = 0, rowEnd = 0;
+    uint16_t* out = nullptr;
+    Span* spans = nullptr;
+    uint32_t* whole = nullptr;   // R, G, B per column: rows wholly inside output row curK
+    uint32_t* edge = nullptr;    // rows partly inside it, weighted
+    uint32_t* next = nullptr;    // the part of a straddling row that belongs to curK + 1
+    uint64_t recip = 0;          // division by srcW * srcH as multiply + shift
+    int recipShift = 0;
+    int nextY = 0;               // first source row still wanted
+    int endY = 0;
+    int curK = -1;               // output row being summed (-1: none yet)
+    int done = 0;                // output rows written
+};
+
+/**
+ * @brief Collects decoder blocks into full-width strips.
+ *
+ * `window` is the part of the decoder's draw coordinates to keep; blocks and
+ * rows outside it are dropped. A strip is handed to the sink when the block
+ * reaching the window's right edge arrives (or the next MCU row starts).
+ * Ring buffers hold window.w * STRIP_MAX_ROWS pixels each and are reused in
+ * turn once the sink has reclaimed them.
+ */
+class StripAssembler {
+public:
+    bool begin(const RenderRect& window, uint16_t* const* ring, int slots, StripSink* sink);
+    // One decoder output block (JPEGDRAW); false aborts the decode
+    bool draw(int x, int y, int w, int h, const uint16_t* pixels);
+    // Hand over a partial last strip and let the sink finish (always call it,
+    // also after draw() failed)
+    bool finish();
+    uint32_t strips() const { return seq; }
+
+private:
+    bool flush();
+
+    RenderRect win = { 0, 0, 0, 0 };
+    uint16_t* buffers[STRIP_MAX_SLOTS] = {};
+    int slots = 0;
+    StripSink* sink = nullptr;
+    uint32_t seq = 0;       // strips handed to the sink
+    int bandY = -1;         // decoder row of the MCU row being collected (-1: none)
+    int bandRow0 = 0;       // its first and end rows inside the window
+    int bandRow1 = 0;
+    int flushedY = -1;      // MCU row already handed over
+};
+
+#endif // STRIP_PIPELINE_H
@@ -0,0 +1,523 @@
+// test/bench_moon_raycast.cpp
+// Host test and benchmark for the ray-cast moon disc: texture addressing and
+// lighting on known views, agreement with the same maths in double precision
+// (libm atan2, float shading), untouched pixels off the disc, and an image
+// diff against a 96 x 48 Gouraud mesh rasterized the way moon_sphere.cpp
+// drives tgx (tgx itself is not built on the host, so the mesh here stands in
+// for it; the serial 'O' command diffs against the real one on the device).
+// The mesh drawn with culling alone must match it drawn with a depth buffer
+// pixel for pixel. The mip level picked for a small frame must land nearer a
+// supersampled render than the full map does, and the halving must be a
+// rounded 2x2 box. Prints the render times per frame size and per level.
+//
+//   g++ -std=c++17 -O2 test/bench_moon_raycast.cpp moon_raycast.cpp -o /tmp/t && /tmp/t
+#include "../moon_raycast.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static double nowUs() {
+    using namespace std::chrono;
+    return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+static const uint16_t SENTINEL = 0x0821;
+
+// Highland grey with dark maria, a few bright craters and a faint grid,
+// which is what faceting and wrong texture addressing show up on
+static std::vector<uint16_t> lunarTexture(int w, int h) {
+    std::vector<uint16_t> t((size_t)w * h);
+    srand(7);
+    struct Blob { double u, v, r, d; } blobs[40];
+    for (auto& b : blobs) {
+        b.u = (rand() & 1023) / 1024.0;
+        b.v = 0.15 + 0.7 * (rand() & 1023) / 1024.0;
+        b.r = 0.01 + 0.08 * (rand() & 1023) / 1024.0;
+        b.d = (rand() & 1) ? -0.35 : 0.25;
+    }
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            double u = (x + 0.5) / w, v = (y + 0.5) / h, g = 0.7 + 0.05 * sin(u * 60) * cos(v * 40);
+            for (auto& b : blobs) {
+                double du = fabs(u - b.u);
+                if (du > 0.5) du = 1 - du;
+                double d = hypot(du * 2, v - b.v) / b.r;
+                if (d < 1) g += b.d * (1 - d * d);
+            }
+            if (x % (w / 16) == 0 || y % (h / 8) == 0) g -= 0.15;
+            g = fmin(1, fmax(0, g));
+            t[(size_t)y * w + x] = (uint16_t)(((int)(g * 31 + 0.5) << 11) | ((int)(g * 63 + 0.5) << 5) |
+                                              (int)(g * 31 * 0.9 + 0.5));
+        }
+    }
+    return t;
+}
+
+// --- Views -----------------------------------------------------------------
+
+static void matMul(float a[3][3], const float b[3][3]) {
+    float r[3][3];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) r[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+    memcpy(a, r, sizeof(r));
+}
+
+// rot = rot * R(axis, deg), as tgx's multRotate() appends
+static void rotate(float rot[3][3], int axis, float deg) {
+    float c = cosf(deg * 0.0174532925f), s = sinf(deg * 0.0174532925f);
+    float r[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    int i = (axis + 1) % 3, j = (axis + 2) % 3;
+    r[i][i] = c;
+    r[i][j] = -s;
+    r[j][i] = s;
+    r[j][j] = c;
+    matMul(rot, r);
+}
+
+// The true-phase view moon_sphere.cpp builds: libration, the base turn,
+// roll, then a drag yaw / pitch, lit from the given sub-solar body direction
+static MoonRaycastView skyView(float libLon, float libLat, float roll, float yaw, float pitch, float sunLon,
+                               float sunLat, float orthoR) {
+    MoonRaycastView v = {};
+    float rot[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    rotate(rot, 1, libLon);
+    rotate(rot, 2, -libLat);
+    rotate(rot, 0, 180);
+    rotate(rot, 1, 90);
+    rotate(rot, 2, roll);
+    float sky[3][3];
+    memcpy(sky, rot, sizeof(sky));
+    rotate(rot, 0, pitch);
+    rotate(rot, 1, yaw);
+    memcpy(v.rot, rot, sizeof(rot));
+    float sl = sunLon * 0.0174532925f, sb = sunLat * 0.0174532925f;
+    float body[3] = { cosf(sb) * cosf(sl), sinf(sb), cosf(sb) * sinf(sl) };
+    for (int i = 0; i < 3; i++) v.light[i] = sky[i][0] * body[0] + sky[i][1] * body[1] + sky[i][2] * body[2];
+    v.tint[0] = 1.0f;
+    v.tint[1] = 0.96f;
+    v.tint[2] = 0.86f;
+    v.ambient = 0.06f;
+    v.diffuse = 1.0f;
+    v.orthoR = orthoR;
+    return v;
+}
+
+static MoonRaycastView plainView(const float light[3]) {
+    MoonRaycastView v = {};
+    for (int i = 0; i < 3; i++) v.rot[i][i] = 1.0f;
+    memcpy(v.light, light, sizeof(v.light));
+    v.tint[0] = v.tint[1] = v.tint[2] = 1.0f;
+    v.ambient = 0.0f;
+    v.diffuse = 1.0f;
+    v.orthoR = 1.0f;
+    return v;
+}
+
+// --- References -------------------------------------------------------------
+
+// Bilinear sample in double, channels 0..1; x wraps, y clamps
+static void sampleRef(const MoonTexture& t, double fx, double fy, double c[3]) {
+    int x0 = (int)floor(fx), y0 = (int)floor(fy);
+    double ax = fx - x0, ay = fy - y0;
+    c[0] = c[1] = c[2] = 0;
+    for (int k = 0; k < 4; k++) {
+        int x = ((x0 + (k & 1)) % t.w + t.w) % t.w;
+        int y = y0 + (k >> 1);
+        y = y < 0 ? 0 : (y >= t.h ? t.h - 1 : y);
+        double wt = ((k & 1) ? ax : 1 - ax) * ((k >> 1) ? ay : 1 - ay);
+        uint16_t p = t.texels[(size_t)y * t.w + x];
+        c[0] += wt * (p >> 11) / 31.0;
+        c[1] += wt * ((p >> 5) & 0x3F) / 63.0;
+        c[2] += wt * (p & 0x1F) / 31.0;
+    }
+}
+
+static uint16_t shadeRef(const MoonRaycastView& v, const double c[3], double lambert) {
+    double s = v.ambient + v.diffuse * fmax(0, lambert);
+    double k[3];
+    for (int i = 0; i < 3; i++) k[i] = fmin(1, v.tint[i] * s) * c[i];
+    return (uint16_t)(((int)(k[0] * 31 + 0.5) << 11) | ((int)(k[1] * 63 + 0.5) << 5) | (int)(k[2] * 31 + 0.5));
+}
+
+static void raycastRef(const MoonRaycastView& v, const MoonTexture& t, uint16_t* frame, int w, int h) {
+    for (int py = 0; py < h; py++) {
+        for (int px = 0; px < w; px++) {
+            double x = ((px + 0.5) * 2 / w - 1) * v.orthoR, y = (1 - (py + 0.5) * 2 / h) * v.orthoR;
+            double z2 = 1 - x * x - y * y;
+            if (z2 <= 0) continue;
+            double n[3] = { x, y, sqrt(z2) }, b[3];
+            for (int i = 0; i < 3; i++) b[i] = v.rot[0][i] * n[0] + v.rot[1][i] * n[1] + v.rot[2][i] * n[2];
+            double lon = atan2(b[2], b[0]);
+            if (lon < 0) lon += 2 * M_PI;
+            double polar = atan2(hypot(b[0], b[2]), b[1]), c[3];
+            sampleRef(t, lon / (2 * M_PI) * t.w - 0.5, (M_PI - polar) / M_PI * t.h - 0.5, c);
+            frame[(size_t)py * w + px] = shadeRef(v, c, -(n[0] * v.light[0] + n[1] * v.light[1] + n[2] * v.light[2]));
+        }
+    }
+}
+
+// The tessellated sphere as tgx draws it: per-vertex Lambert (Gouraud),
+// texture coordinates interpolated across each triangle, back faces culled,
+// optionally a depth buffer. Shared edges belong to one triangle only (each
+// edge function is evaluated the same way from both sides, and a pixel
+// centre exactly on an edge goes to the triangle walking it down or right),
+// and the seam column reuses the first column's positions, as a rasterizer
+// with a fill convention and a closed mesh give
+static void meshRender(const MoonRaycastView& v, const MoonTexture& t, uint16_t* frame, int w, int h, int sectors,
+                       int stacks, bool depthTest) {
+    struct Vert { double p[3], sx, sy, z, u, vv, s; };
+    std::vector<Vert> verts((size_t)(stacks + 1) * (sectors + 1));
+    for (int i = 0; i <= stacks; i++) {
+        double phi = M_PI * i / stacks;
+        for (int j = 0; j <= sectors; j++) {
+            double th = 2 * M_PI * (j % sectors) / sectors;
+            double p[3] = { sin(phi) * cos(th), cos(phi), sin(phi) * sin(th) }, n[3];
+            for (int k = 0; k < 3; k++) n[k] = v.rot[k][0] * p[0] + v.rot[k][1] * p[1] + v.rot[k][2] * p[2];
+            Vert& q = verts[(size_t)i * (sectors + 1) + j];
+            memcpy(q.p, p, sizeof(p));
+            q.sx = (n[0] / v.orthoR + 1) * w / 2;
+            q.sy = (1 - n[1] / v.orthoR) * h / 2;
+            q.z = n[2];
+            q.u = (double)j / sectors;
+            q.vv = 1 - (double)i / stacks;
+            q.s = v.ambient + v.diffuse * fmax(0, -(n[0] * v.light[0] + n[1] * v.light[1] + n[2] * v.light[2]));
+        }
+    }
+    std::vector<float> depth;
+    if (depthTest) depth.assign((size_t)w * h, -1e9f);
+    // Edge function of p -> q at (x, y), negative on the front side
+    auto edge = [](const Vert& p, const Vert& q, double x, double y) {
+        bool swap = q.sx < p.sx || (q.sx == p.sx && q.sy < p.sy);
+        const Vert& o = swap ? q : p;
+        const Vert& e = swap ? p : q;
+        double f = (e.sx - o.sx) * (y - o.sy) - (e.sy - o.sy) * (x - o.sx);
+        return swap ? -f : f;
+    };
+    auto owns = [](const Vert& p, const Vert& q) { return q.sy > p.sy || (q.sy == p.sy && q.sx > p.sx); };
+    auto tri = [&](const Vert& a, const Vert& b, const Vert& c) {
+        double area = (b.sx - a.sx) * (c.sy - a.sy) - (b.sy - a.sy) * (c.sx - a.sx);
+        if (area >= 0) return;   // clockwise on screen: facing away
+        int x0 = (int)fmax(0, floor(fmin(a.sx, fmin(b.sx, c.sx)))), x1 = (int)fmin(w - 1, ceil(fmax(a.sx, fmax(b.sx, c.sx))));
+        int y0 = (int)fmax(0, floor(fmin(a.sy, fmin(b.sy, c.sy)))), y1 = (int)fmin(h - 1, ceil(fmax(a.sy, fmax(b.sy, c.sy))));
+        for (int py = y0; py <= y1; py++) {
+            for (int px = x0; px <= x1; px++) {
+                double x = px + 0.5, y = py + 0.5;
+                double ea = edge(b, c, x, y), eb = edge(c, a, x, y), ec = edge(a, b, x, y);
+                if (ea > 0 || eb > 0 || ec > 0) continue;
+                if ((ea == 0 && !owns(b, c)) || (eb == 0 && !owns(c, a)) || (ec == 0 && !owns(a, b))) continue;
+                double wa = ea / area, wb = eb / area, wc = ec / area;
+                size_t o = (size_t)py * w + px;
+                if (depthTest) {
+                    double z = wa * a.z + wb * b.z + wc * c.z;
+                    if (z <= depth[o]) continue;
+                    depth[o] = (float)z;
+                }
+                double col[3], s = wa * a.s + wb * b.s + wc * c.s;
+                sampleRef(t, (wa * a.u + wb * b.u + wc * c.u) * t.w - 0.5, (wa * a.vv + wb * b.vv + wc * c.vv) * t.h - 0.5, col);
+                double k[3];
+                for (int i = 0; i < 3; i++) k[i] = fmin(1, v.tint[i] * s) * col[i];
+                frame[o] = (uint16_t)(((int)(k[0] * 31 + 0.5) << 11) | ((int)(k[1] * 63 + 0.5) << 5) | (int)(k[2] * 31 + 0.5));
+            }
+        }
+    };
+    // Wound counter-clockwise seen from outside, as a mesh is
+    auto outward = [&](const Vert& a, const Vert& b, const Vert& c) {
+        double e1[3], e2[3], dot = 0;
+        for (int k = 0; k < 3; k++) {
+            e1[k] = b.p[k] - a.p[k];
+            e2[k] = c.p[k] - a.p[k];
+        }
+        double n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+        for (int k = 0; k < 3; k++) dot += n[k] * (a.p[k] + b.p[k] + c.p[k]);
+        if (dot >= 0) tri(a, b, c);
+        else tri(a, c, b);
+    };
+    for (int i = 0; i < stacks; i++) {
+        for (int j = 0; j < sectors; j++) {
+            const Vert& a = verts[(size_t)i * (sectors + 1) + j];
+            const Vert& b = verts[(size_t)i * (sectors + 1) + j + 1];
+            const Vert& c = verts[(size_t)(i + 1) * (sectors + 1) + j];
+            const Vert& d = verts[(size_t)(i + 1) * (sectors + 1) + j + 1];
+            outward(a, c, b);
+            outward(b, c, d);
+        }
+    }
+}
+
+// Largest channel difference (in that channel's steps) and mean over the
+// whole frame of the summed channel differences, 8-bit scale
+static void diff(const std::vector<uint16_t>& a, const std::vector<uint16_t>& b, int* maxStep, double* mean8) {
+    *maxStep = 0;
+    double sum = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        int d[3] = { abs((a[i] >> 11) - (b[i] >> 11)), abs(((a[i] >> 5) & 0x3F) - ((b[i] >> 5) & 0x3F)),
+                     abs((a[i] & 0x1F) - (b[i] & 0x1F)) };
+        for (int k = 0; k < 3; k++) if (d[k] > *maxStep) *maxStep = d[k];
+        sum += d[0] * 255.0 / 31 + d[1] * 255.0 / 63 + d[2] * 255.0 / 31;
+    }
+    *mean8 = sum / (a.size() * 3);
+}
+
+// Disc pixels of a supersampled double-precision render box-averaged down to
+// w x h, 8-bit channels; a pixel partly off the disc gets -1 in its red
+static std::vector<double> supersampledRef(const MoonRaycastView& v, const MoonTexture& t, int w, int h, int ss) {
+    std::vector<uint16_t> big((size_t)w * ss * h * ss, SENTINEL);
+    raycastRef(v, t, big.data(), w * ss, h * ss);
+    std::vector<double> out((size_t)w * h * 3, 0.0);
+    for (int py = 0; py < h; py++)
+        for (int px = 0; px < w; px++) {
+            double* o = &out[((size_t)py * w + px) * 3];
+            for (int sy = 0; sy < ss; sy++)
+                for (int sx = 0; sx < ss; sx++) {
+                    uint16_t p = big[(size_t)(py * ss + sy) * w * ss + px * ss + sx];
+                    if (p == SENTINEL) o[0] = -1e9;
+                    o[0] += (p >> 11) * 255.0 / 31;
+                    o[1] += ((p >> 5) & 0x3F) * 255.0 / 63;
+                    o[2] += (p & 0x1F) * 255.0 / 31;
+                }
+            for (int c = 0; c < 3; c++) o[c] /= ss * ss;
+        }
+    return out;
+}
+
+// Mean channel distance (8-bit) of a frame from a supersampled reference over
+// the pixels wholly on the disc
+static double distanceFrom(const std::vector<uint16_t>& f, const std::vector<double>& ref) {
+    double sum = 0;
+    size_t n = 0;
+    for (size_t i = 0; i < f.size(); i++) {
+        const double* r = &ref[i * 3];
+        if (r[0] < 0) continue;
+        sum += fabs((f[i] >> 11) * 255.0 / 31 - r[0]) + fabs(((f[i] >> 5) & 0x3F) * 255.0 / 63 - r[1]) +
+               fabs((f[i] & 0x1F) * 255.0 / 31 - r[2]);
+        n += 3;
+    }
+    return n ? sum / n : 0;
+}
+
+// --- Tests ------------------------------------------------------------------
+
+static void testAddressing(const MoonTexture& tex) {
+    // Unturned body: the view axis +Z is longitude 90° on the equator (a
+    // quarter of the way across, middle row), +Y the bottom row
+    std::vector<uint16_t> marked(tex.texels, tex.texels + (size_t)tex.w * tex.h);
+    for (int y = 0; y < tex.h; y++)
+        for (int x = 0; x < tex.w; x++) {
+            bool centre = abs(x - tex.w / 4) < 4 && abs(y - tex.h / 2) < 4;
+            marked[(size_t)y * tex.w + x] = centre ? 0xF800 : (y >= tex.h - tex.h / 16 ? 0x001F : 0x07E0);
+        }
+    MoonTexture t = { marked.data(), tex.w, tex.h };
+    const float headlight[3] = { 0, 0, -1 };
+    MoonRaycastView v = plainView(headlight);
+    v.ambient = 1.0f;
+    v.diffuse = 0.0f;
+    const int n = 101;
+    std::vector<uint16_t> frame((size_t)n * n, SENTINEL);
+    moonRaycastRows(&v, &t, frame.data(), n, n, 0, n);
+    CHECK(frame[(size_t)50 * n + 50] == 0xF800, "disc centre samples longitude 90 on the equator");
+    CHECK(frame[(size_t)0 * n + 50] == 0x001F, "top of the disc samples the +Y pole (bottom row)");
+    CHECK(frame[(size_t)50 * n + 0] == 0x07E0, "left edge samples the middle of the map");
+    CHECK(frame[0] == SENTINEL && frame[(size_t)n * n - 1] == SENTINEL, "corners off the disc are left alone");
+
+    // Covered pixels: the centres inside the unit disc, and only those
+    int inside = 0, covered = 0, strays = 0;
+    for (int py = 0; py < n; py++)
+        for (int px = 0; px < n; px++) {
+            double x = (px + 0.5) * 2 / n - 1, y = 1 - (py + 0.5) * 2 / n;
+            bool in = x * x + y * y < 1;
+            bool hit = frame[(size_t)py * n + px] != SENTINEL;
+            inside += in;
+            covered += hit;
+            strays += in != hit;
+        }
+    CHECK(strays == 0 && covered == inside, "exactly the pixel centres inside the disc are drawn");
+}
+
+static void testLighting(const MoonTexture& tex) {
+    const int n = 64;
+    std::vector<uint16_t> frame((size_t)n * n);
+    // Light travelling towards -X lights the +X half
+    const float fromRight[3] = { -1, 0, 0 };
+    MoonRaycastView v = plainView(fromRight);
+    moonRaycastRows(&v, &tex, frame.data(), n, n, 0, n);
+    CHECK(frame[(size_t)32 * n + 8] == 0, "far side of the terminator is black");
+    CHECK(frame[(size_t)32 * n + 56] != 0, "lit side is lit");
+
+    // Headlight: brightest in the middle, falling to the limb
+    const float headlight[3] = { 0, 0, -1 };
+    std::vector<uint16_t> white((size_t)64 * 32, 0xFFFF);
+    MoonTexture flat = { white.data(), 64, 32 };
+    v = plainView(headlight);
+    moonRaycastRows(&v, &flat, frame.data(), n, n, 0, n);
+    int mid = frame[(size_t)32 * n + 32] >> 11, edge = frame[(size_t)32 * n + 1] >> 11;
+    CHECK(mid >= 30 && edge < mid / 2, "headlight falls off towards the limb");
+}
+
+static void testAgainstReference(const MoonTexture& tex) {
+    MoonRaycastView views[] = {
+        skyView(0, 0, 0, 0, 0, 0, 0, 1.35f),            // full, disc at 80% of the frame
+        skyView(5.2f, -3.1f, 24, 0, 0, 95, 1.2f, 1.08f), // first quarter, librated and rolled
+        skyView(-4, 6, -40, 70, -25, -130, -1.5f, 1.08f) // waning crescent, dragged round
+    };
+    const int n = 240;
+    for (const auto& v : views) {
+        std::vector<uint16_t> fast((size_t)n * n, SENTINEL), ref((size_t)n * n, SENTINEL);
+        moonRaycastRows(&v, &tex, fast.data(), n, n, 0, n);
+        raycastRef(v, tex, ref.data(), n, n);
+        int maxStep;
+        double mean;
+        diff(fast, ref, &maxStep, &mean);
+        CHECK(maxStep <= 1 && mean < 0.5, "single-precision ray cast within one step of the double reference");
+
+        // Rows are independent: a band at a time gives the same frame
+        std::vector<uint16_t> bands((size_t)n * n, SENTINEL);
+        for (int r = 0; r < n; r += 37) moonRaycastRows(&v, &tex, bands.data(), n, n, r, r + 37 < n ? r + 37 : n);
+        CHECK(bands == fast, "banded rows match the whole frame");
+    }
+}
+
+static void benchAgainstMesh(const MoonTexture& tex) {
+    const int sizes[] = { 240, 720, 800 };
+    MoonRaycastView v = skyView(5.2f, -3.1f, 24, 0, 0, 95, 1.2f, 1.08f / 0.8f);
+    for (int n : sizes) {
+        std::vector<uint16_t> ray((size_t)n * n, 0), mesh((size_t)n * n, 0);
+        const int runs = n > 400 ? 3 : 10;
+        double t0 = nowUs();
+        for (int i = 0; i < runs; i++) moonRaycastRows(&v, &tex, ray.data(), n, n, 0, n);
+        double tRay = (nowUs() - t0) / runs;
+        t0 = nowUs();
+        meshRender(v, tex, mesh.data(), n, n, 96, 48, false);
+        double tMesh = nowUs() - t0;
+
+        int maxStep;
+        double mean;
+        diff(ray, mesh, &maxStep, &mean);
+        printf("%3dx%-3d ray cast %7.0f us | 96x48 mesh %8.0f us | mean diff %.2f / 255, max %d steps\n", n, n,
+               tRay, tMesh, mean, maxStep);
+        char msg[80];
+        snprintf(msg, sizeof(msg), "%d px: ray cast and mesh show the same disc", n);
+        CHECK(mean < 2.0, msg);
+    }
+}
+
+// Back faces culled, the sphere's front faces never overlap: drawing them
+// with no depth test gives the depth-tested image pixel for pixel
+static void testMeshWithoutDepth(const MoonTexture& tex) {
+    MoonRaycastView views[] = {
+        skyView(0, 0, 0, 0, 0, 0, 0, 1.35f),
+        skyView(5.2f, -3.1f, 24, 0, 0, 95, 1.2f, 1.08f),
+        skyView(-4, 6, -40, 70, -25, -130, -1.5f, 1.08f),
+        skyView(6.5f, 6.5f, 180, 180, 90, 45, 1.5f, 0.9f)   // pole on, disc over the frame edge
+    };
+    const int sizes[] = { 240, 800 };
+    for (int n : sizes) {
+        bool same = true;
+        double tDepth = 0, tFree = 0;
+        for (const auto& v : views) {
+            std::vector<uint16_t> depth((size_t)n * n, SENTINEL), free((size_t)n * n, SENTINEL);
+            double t0 = nowUs();
+            meshRender(v, tex, depth.data(), n, n, 96, 48, true);
+            tDepth += nowUs() - t0;
+            t0 = nowUs();
+            meshRender(v, tex, free.data(), n, n, 96, 48, false);
+            tFree += nowUs() - t0;
+            same = same && depth == free;
+        }
+        printf("%3dx%-3d mesh with depth test %8.0f us | without %8.0f us\n", n, n, tDepth / 4, tFree / 4);
+        char msg[80];
+        snprintf(msg, sizeof(msg), "%d px: mesh without depth test is pixel-identical", n);
+        CHECK(same, msg);
+    }
+}
+
+static void testTextureLevel() {
+    // 2048-wide map, 4 levels: the resting panel frames keep the full map,
+    // the 240 px drag frame drops to the 512-wide level
+    CHECK(moonTextureLevel(2048, 4, 800, 1.08f) == 0, "800 px frame samples level 0");
+    CHECK(moonTextureLevel(2048, 4, 720, 1.08f) == 0, "720 px frame samples level 0");
+    CHECK(moonTextureLevel(2048, 4, 720, 1.08f / 0.8f) == 0, "720 px frame, disc at 80%, samples level 0");
+    CHECK(moonTextureLevel(2048, 4, 240, 1.08f) == 2, "240 px frame samples level 2");
+    CHECK(moonTextureLevel(2048, 4, 240, 1.08f / 0.8f) == 2, "240 px frame, disc at 80%, samples level 2");
+    CHECK(moonTextureLevel(2048, 4, 60, 1.08f) == 3, "tiny frame stops at the last level");
+    CHECK(moonTextureLevel(2048, 1, 240, 1.08f) == 0, "a single level is always level 0");
+    CHECK(moonTextureLevel(2048, 4, 240, 4.0f) == 3, "small disc in the frame drops further");
+}
+
+static void testHalve() {
+    const uint16_t src[8] = { 0xFFFF, 0x0000, 0x1234, 0x1234,
+                              0x0000, 0x0000, 0x1234, 0x1234 };
+    MoonTexture t = { src, 4, 2 };
+    uint16_t dst[2];
+    moonTextureHalve(&t, dst);
+    // One white texel in four: (31+2)/4 = 8, (63+2)/4 = 16, 8
+    CHECK(dst[0] == ((8 << 11) | (16 << 5) | 8), "halving averages the 2x2 block with rounding");
+    CHECK(dst[1] == 0x1234, "a flat block halves to itself");
+}
+
+// A 240 px drag frame from the full 2048-wide map against the level the
+// renderer picks: distance from an 8x8 supersampled render, and the time
+static void benchMipChain() {
+    // Texel-scale grain on top, as the real map's crater fields have: what a
+    // frame sampling every few texels aliases on
+    std::vector<uint16_t> texels = lunarTexture(2048, 1024);
+    srand(11);
+    for (auto& p : texels) {
+        int d = (rand() % 9) - 4, r = (p >> 11) + d, g = ((p >> 5) & 0x3F) + 2 * d, b = (p & 0x1F) + d;
+        r = r < 0 ? 0 : (r > 31 ? 31 : r);
+        g = g < 0 ? 0 : (g > 63 ? 63 : g);
+        b = b < 0 ? 0 : (b > 31 ? 31 : b);
+        p = (uint16_t)((r << 11) | (g << 5) | b);
+    }
+    std::vector<std::vector<uint16_t>> chain(1, texels);
+    for (int i = 1; i < 4; i++) {
+        MoonTexture up = { chain.back().data(), 2048 >> (i - 1), 1024 >> (i - 1) };
+        chain.push_back(std::vector<uint16_t>((size_t)(up.w / 2) * (up.h / 2)));
+        moonTextureHalve(&up, chain.back().data());
+    }
+    const int n = 240;
+    MoonRaycastView views[] = {
+        skyView(5.2f, -3.1f, 24, 0, 0, 95, 1.2f, 1.08f),
+        skyView(-4, 6, -40, 70, -25, -130, -1.5f, 1.08f / 0.8f)
+    };
+    for (const auto& v : views) {
+        int level = moonTextureLevel(2048, 4, n, v.orthoR);
+        MoonTexture full = { chain[0].data(), 2048, 1024 };
+        MoonTexture mip = { chain[level].data(), 2048 >> level, 1024 >> level };
+        std::vector<double> ref = supersampledRef(v, full, n, n, 8);
+        std::vector<uint16_t> a((size_t)n * n, 0), b((size_t)n * n, 0);
+        const int runs = 20;
+        double t0 = nowUs();
+        for (int i = 0; i < runs; i++) moonRaycastRows(&v, &full, a.data(), n, n, 0, n);
+        double tFull = (nowUs() - t0) / runs;
+        t0 = nowUs();
+        for (int i = 0; i < runs; i++) moonRaycastRows(&v, &mip, b.data(), n, n, 0, n);
+        double tMip = (nowUs() - t0) / runs;
+        double dFull = distanceFrom(a, ref), dMip = distanceFrom(b, ref);
+        printf("%3dx%-3d level 0 %6.0f us, %.2f / 255 off 8x8 supersampled | level %d %6.0f us, %.2f / 255\n", n, n,
+               tFull, dFull, level, tMip, dMip);
+        CHECK(level > 0 && dMip < dFull, "mip level is nearer the supersampled disc than the full map");
+    }
+}
+
+int main(void) {
+    std::vector<uint16_t> texels = lunarTexture(1024, 512);
+    MoonTexture tex = { texels.data(), 1024, 512 };
+    testAddressing(tex);
+    testLighting(tex);
+    testAgainstReference(tex);
+    testMeshWithoutDepth(tex);
+    testTextureLevel();
+    testHalve();
+    benchAgainstMesh(tex);
+    benchMipChain();
+
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
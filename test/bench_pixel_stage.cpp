@@ -0,0 +1,82 @@
+// test/bench_pixel_stage.cpp
+// Host benchmark: the 64K-entry pixel stage table against the arithmetic
+// colour temperature pass it replaced (Kelvin scales from pow / log per call,
+// then unpack, multiply, clamp and repack every pixel), on panel-sized
+// buffers. Both must give the same pixels. Host caches hold the whole
+// 128 KB table, so the gap on the ESP32-P4 (table in internal RAM) is
+// smaller; the relative order is what this is for.
+//
+//   g++ -std=c++17 -O2 test/bench_pixel_stage.cpp pixel_stage.cpp pixel_kernels.cpp -o /tmp/t && /tmp/t
+#include "../pixel_stage.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static int clampi(int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+// The former ImageUtils::adjustColorTemperature()
+static void arithmeticPass(uint16_t* buffer, int len, int kelvin) {
+    float rS, gS, bS;
+    pixelKelvinScales(kelvin, &rS, &gS, &bS);
+    int rFix = rS * 256, gFix = gS * 256, bFix = bS * 256;
+    for (int i = 0; i < len; i++) {
+        uint16_t p = buffer[i];
+        int r = clampi((((p >> 11) & 0x1F) * rFix) >> 8, 0, 31);
+        int g = clampi((((p >> 5) & 0x3F) * gFix) >> 8, 0, 63);
+        int b = clampi(((p & 0x1F) * bFix) >> 8, 0, 31);
+        buffer[i] = (uint16_t)((r << 11) | (g << 5) | b);
+    }
+}
+
+static double nowUs() {
+    using namespace std::chrono;
+    return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void bench(int w, int h) {
+    const int runs = 50;
+    const int kelvin = 3200;
+    int len = w * h;
+    std::vector<uint16_t> src(len);
+    srand(w);
+    for (int i = 0; i < len; i++) src[i] = (uint16_t)(rand() & 0xFFFF);
+    std::vector<uint16_t> a = src, b = src;
+    std::vector<uint16_t> lut(PIXEL_STAGE_LUT_ENTRIES);
+
+    double t0 = nowUs();
+    for (int i = 0; i < runs; i++) { a = src; arithmeticPass(a.data(), len, kelvin); }
+    double arith = (nowUs() - t0) / runs;
+
+    PixelStage stage = { 0, lut.data() };
+    PixelStageSettings set = { kelvin, PIXEL_STAGE_NEUTRAL_GAMMA, 0 };
+    t0 = nowUs();
+    pixelStageBuild(&stage, set);
+    double build = nowUs() - t0;
+    t0 = nowUs();
+    for (int i = 0; i < runs; i++) { b = src; pixelStageApply(stage, b.data(), len); }
+    double table = (nowUs() - t0) / runs;
+    CHECK(a == b, "table and arithmetic give the same pixels");
+
+    // Temperature + red shift + gamma: still one lookup per pixel
+    PixelStageSettings all = { kelvin, 180, 60 };
+    pixelStageBuild(&stage, all);
+    t0 = nowUs();
+    for (int i = 0; i < runs; i++) { b = src; pixelStageApply(stage, b.data(), len); }
+    double composed = (nowUs() - t0) / runs;
+
+    printf("%dx%d: arithmetic %.0f us, table %.0f us (%.1fx), composed table %.0f us, table build %.0f us\n",
+           w, h, arith, table, arith / table, composed, build);
+}
+
+int main(void) {
+    bench(720, 720);
+    bench(800, 800);
+
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,214 @@
+// test/bench_row_pool.cpp
+// Host benchmark for the fork / join row pool on std::thread: every row of a
+// job runs exactly once whatever the band alignment, a job started from
+// inside a job runs on its caller, and the software scale and the tiled
+// scale + rotate and the ray-cast moon disc give the same pixels split into
+// bands as on one thread. Prints the speedup per kernel; the device has two
+// cores, so compare the 2-worker line with it.
+//
+//   g++ -std=c++17 -O2 test/bench_row_pool.cpp row_pool.cpp pixel_kernels.cpp moon_raycast.cpp -pthread -o /tmp/t && /tmp/t
+#include "../row_pool.h"
+#include "../moon_raycast.h"
+#include "../pixel_kernels.h"
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static double nowUs() {
+    using namespace std::chrono;
+    return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+}
+
+// --- Coverage ---------------------------------------------------------------
+
+struct CountJob {
+    std::vector<std::atomic<int>>* hits;
+    int align;
+    bool aligned;
+};
+
+static void countRows(void* ctx, int rowBegin, int rowEnd) {
+    CountJob& j = *(CountJob*)ctx;
+    if (rowBegin % j.align) j.aligned = false;
+    for (int r = rowBegin; r < rowEnd; r++) (*j.hits)[r]++;
+}
+
+static void testCoverage() {
+    const int rowCounts[] = { 1, 7, 16, 17, 100, 719, 720, 1001 };
+    const int aligns[] = { 1, 3, PX_TILE };
+    bool ok = true, aligned = true;
+    for (int rows : rowCounts) {
+        for (int align : aligns) {
+            std::vector<std::atomic<int>> hits(rows);
+            CountJob job = { &hits, align, true };
+            rowPoolRun(rows, countRows, &job, align);
+            for (int r = 0; r < rows; r++) ok = ok && hits[r] == 1;
+            aligned = aligned && job.aligned;
+        }
+    }
+    CHECK(ok, "every row runs exactly once");
+    CHECK(aligned, "bands start on a multiple of the alignment");
+}
+
+static std::atomic<int> innerRows(0);
+
+static void innerJob(void*, int rowBegin, int rowEnd) { innerRows += rowEnd - rowBegin; }
+
+static void outerJob(void*, int, int) { rowPoolRun(64, innerJob, nullptr); }
+
+static void testNested() {
+    innerRows = 0;
+    rowPoolRun(64, outerJob, nullptr);
+    // Each outer band ran all 64 inner rows itself (no deadlock, nothing lost)
+    int bands = rowPoolWorkers() > 1 ? rowPoolWorkers() : 1;
+    CHECK(innerRows == 64 * bands, "job started inside a job runs on its caller");
+}
+
+// --- Kernels ----------------------------------------------------------------
+
+struct ScaleJob {
+    const uint16_t* src;
+    int srcW, srcH;
+    uint16_t* dst;
+    int dstW, dstH;
+    int rotation;
+};
+
+static void scaleRows(void* ctx, int rowBegin, int rowEnd) {
+    const ScaleJob& j = *(const ScaleJob*)ctx;
+    uint32_t yRatio = ((uint32_t)(j.srcH - 1) << 16) / j.dstH;
+    for (int y = rowBegin; y < rowEnd; y++) {
+        uint32_t sy = (uint32_t)y * yRatio;
+        int y0 = sy >> 16;
+        int y1 = (y0 + 1 < j.srcH) ? y0 + 1 : y0;
+        pxBilinearRow(j.src + (size_t)y0 * j.srcW, j.src + (size_t)y1 * j.srcW, sy & 0xFFFF, j.srcW,
+                      j.dst + (size_t)y * j.dstW, j.dstW);
+    }
+}
+
+static void scaleRotateRows(void* ctx, int rowBegin, int rowEnd) {
+    const ScaleJob& j = *(const ScaleJob*)ctx;
+    pxScaleRotate(j.src, j.srcW, j.srcH, j.dst, j.dstW, j.dstH, j.rotation, rowBegin, rowEnd);
+}
+
+// Average time of `runs` pooled runs of the job (the pool as it is started)
+static double timeJob(RowPoolJob fn, ScaleJob* job, int align) {
+    const int runs = 20;
+    double t0 = nowUs();
+    for (int i = 0; i < runs; i++) rowPoolRun(job->dstH, fn, job, align);
+    return (nowUs() - t0) / runs;
+}
+
+static void bench(const char* name, RowPoolJob fn, int align, int srcW, int srcH, int dstW, int dstH,
+                  int rotation, int maxWorkers) {
+    std::vector<uint16_t> src((size_t)srcW * srcH);
+    srand(srcW ^ rotation);
+    for (auto& p : src) p = (uint16_t)(rand() & 0xFFFF);
+    std::vector<uint16_t> one((size_t)dstW * dstH), many((size_t)dstW * dstH);
+
+    ScaleJob job = { src.data(), srcW, srcH, one.data(), dstW, dstH, rotation };
+    fn(&job, 0, dstH);                    // reference: one call, one thread
+    double t0 = nowUs();
+    for (int i = 0; i < 20; i++) fn(&job, 0, dstH);
+    double single = (nowUs() - t0) / 20;
+
+    job.dst = many.data();
+    for (int workers = 2; workers <= maxWorkers; workers *= 2) {
+        rowPoolBegin(workers, 0, 0);
+        double pooled = timeJob(fn, &job, align);
+        char msg[80];
+        snprintf(msg, sizeof(msg), "%s: %d workers give the single-thread pixels", name, workers);
+        CHECK(many == one, msg);
+        printf("%s %dx%d -> %dx%d: 1 thread %.0f us, %d workers %.0f us (%.2fx)\n",
+               name, srcW, srcH, dstW, dstH, single, workers, pooled, single / pooled);
+        rowPoolEnd();
+    }
+}
+
+// The moon disc as moon_sphere.cpp bands it: the resting panel frame on the
+// full 2048-wide map, the drag frame on the 512-wide level it samples
+struct MoonJob {
+    MoonRaycastView view;
+    MoonTexture tex;
+    uint16_t* dst;
+    int w, h;
+};
+
+static void moonRows(void* ctx, int rowBegin, int rowEnd) {
+    const MoonJob& j = *(const MoonJob*)ctx;
+    moonRaycastRows(&j.view, &j.tex, j.dst, j.w, j.h, rowBegin, rowEnd);
+}
+
+static void benchMoon(int size, int texW, int maxWorkers) {
+    std::vector<uint16_t> texels((size_t)texW * (texW / 2));
+    srand(texW);
+    for (auto& p : texels) p = (uint16_t)(rand() & 0xFFFF);
+    MoonJob job = {};
+    // Tilted 30 degrees about X, lit from the upper right
+    float c = cosf(0.5236f), s = sinf(0.5236f);
+    float rot[3][3] = { { 1, 0, 0 }, { 0, c, -s }, { 0, s, c } };
+    memcpy(job.view.rot, rot, sizeof(rot));
+    job.view.light[0] = -0.6f;
+    job.view.light[1] = -0.3f;
+    job.view.light[2] = -0.74f;
+    job.view.tint[0] = 1.0f;
+    job.view.tint[1] = 0.96f;
+    job.view.tint[2] = 0.86f;
+    job.view.ambient = 0.06f;
+    job.view.diffuse = 1.0f;
+    job.view.orthoR = 1.08f / 0.8f;
+    job.tex = { texels.data(), texW, texW / 2 };
+    job.w = job.h = size;
+
+    std::vector<uint16_t> one((size_t)size * size, 0), many((size_t)size * size, 0);
+    job.dst = one.data();
+    moonRows(&job, 0, size);
+    const int runs = 20;
+    double t0 = nowUs();
+    for (int i = 0; i < runs; i++) moonRows(&job, 0, size);
+    double single = (nowUs() - t0) / runs;
+
+    job.dst = many.data();
+    for (int workers = 2; workers <= maxWorkers; workers *= 2) {
+        rowPoolBegin(workers, 0, 0);
+        t0 = nowUs();
+        for (int i = 0; i < runs; i++) rowPoolRun(size, moonRows, &job);
+        double pooled = (nowUs() - t0) / runs;
+        char msg[80];
+        snprintf(msg, sizeof(msg), "moon %d px: %d workers give the single-thread pixels", size, workers);
+        CHECK(many == one, msg);
+        printf("moon ray cast %dx%d (%d-wide map): 1 thread %.0f us, %d workers %.0f us (%.2fx)\n", size, size,
+               texW, single, workers, pooled, single / pooled);
+        rowPoolEnd();
+    }
+}
+
+int main(void) {
+    int cores = (int)std::thread::hardware_concurrency();
+    int maxWorkers = cores < 2 ? 2 : (cores > ROW_POOL_MAX_WORKERS ? ROW_POOL_MAX_WORKERS : cores);
+
+    // Before rowPoolBegin() everything runs on the caller
+    testCoverage();
+    rowPoolBegin(2, 0, 0);
+    testCoverage();
+    testNested();
+    rowPoolEnd();
+
+    bench("scale", scaleRows, 1, 1440, 1440, 720, 720, 0, maxWorkers);
+    bench("scale+rotate 90", scaleRotateRows, PX_TILE, 1280, 960, 720, 960, 90, maxWorkers);
+    bench("scale+rotate 180", scaleRotateRows, PX_TILE, 1280, 960, 800, 600, 180, maxWorkers);
+    benchMoon(800, 2048, maxWorkers);
+    benchMoon(240, 512, maxWorkers);
+
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
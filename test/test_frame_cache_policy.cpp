@@ -0,0 +1,143 @@
+// test/test_frame_cache_policy.cpp
+// Host test for the decoded-frame cache bookkeeping: freshness, hit / miss
+// accounting, victim order (free > expired > LRU), per-source replacement,
+// millis() wraparound and the Cache-Control max-age parser.
+//
+//   g++ -std=c++17 -O2 test/test_frame_cache_policy.cpp frame_cache_policy.cpp -o /tmp/t && /tmp/t
+#include "../frame_cache_policy.h"
+#include <stdio.h>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static const size_t FRAME = 1024 * 1024 * 2;   // 1024x1024 RGB565
+
+static void testLookupAndFreshness() {
+    FrameCachePolicy p;
+    p.reset(2);
+    uint32_t a = FrameCachePolicy::hashUrl("https://a/latest.jpg");
+    uint32_t b = FrameCachePolicy::hashUrl("https://b/latest.jpg");
+
+    CHECK(p.lookup(0, a, 1000) == -1, "empty cache misses");
+    int s = p.victim(1000);
+    CHECK(s == 0, "first victim is the first free slot");
+    p.commit(s, 0, a, FRAME, 1000, 60000, 1000);
+
+    CHECK(p.lookup(0, a, 30000) == 0, "fresh entry hits");
+    CHECK(p.lookup(0, b, 30000) == -1, "same source, different URL misses");
+    CHECK(p.lookup(1, a, 30000) == -1, "different source misses");
+    CHECK(p.findFresh(0, a, 60999) == 0, "fresh just before ttl");
+    CHECK(p.find(0, a) == 0, "find ignores freshness");
+
+    FrameCacheStats st = p.getStats();
+    CHECK(st.hits == 1 && st.misses == 3, "hit/miss counters");
+    CHECK(st.entries == 1 && st.bytesHeld == FRAME, "entry and byte accounting");
+
+    // Expired on lookup: dropped, counted as miss + expiration
+    CHECK(p.lookup(0, a, 61000) == -1, "stale entry misses");
+    st = p.getStats();
+    CHECK(st.expirations == 1 && st.entries == 0 && st.bytesHeld == 0, "stale entry dropped");
+    CHECK(p.find(0, a) == -1, "stale entry gone");
+}
+
+static void testVictimOrder() {
+    FrameCachePolicy p;
+    p.reset(3);
+    for (int i = 0; i < 3; i++) {
+        int s = p.victim(100 + i);
+        CHECK(s == i, "free slots used in order");
+        p.commit(s, i, 100 + i, FRAME, 100 + i, i == 2 ? 10000 : 100000, 100 + i);
+    }
+    // Touch source 0 so source 1 becomes least recently used
+    CHECK(p.lookup(0, 100, 500) == 0, "touch source 0");
+
+    int s = p.victim(600);
+    CHECK(s == 1, "LRU entry evicted when all fresh");
+    CHECK(p.getStats().evictions == 1, "eviction counted");
+    CHECK(p.entry(1) == nullptr, "victim slot released");
+    p.commit(s, 5, 105, FRAME, 600, 100000, 600);
+
+    // Source 2 expires (fetched at 102, ttl 10000); it goes before any LRU
+    s = p.victim(10200);
+    CHECK(s == 2, "expired entry preferred over LRU");
+    CHECK(p.getStats().expirations == 1 && p.getStats().evictions == 1, "expiration counted, not eviction");
+
+    // Protected slot is never chosen
+    p.commit(s, 2, 102, FRAME, 10200, 10000, 10200);
+    s = p.victim(10300, 0);
+    CHECK(s != 0 && s >= 0, "protected slot skipped");
+}
+
+static void testPerSourceReplacement() {
+    FrameCachePolicy p;
+    p.reset(3);
+    p.commit(p.victim(0), 4, 1, FRAME, 0, 5000, 0);
+    p.commit(p.victim(10), 7, 2, FRAME / 4, 10, 5000, 10);
+    CHECK(p.getStats().entries == 2 && p.getStats().bytesHeld == FRAME + FRAME / 4, "two entries held");
+
+    // A newer frame of source 4 (even with an edited URL) replaces the old one
+    int s = p.victim(20);
+    p.commit(s, 4, 3, FRAME, 20, 5000, 20);
+    CHECK(p.find(4, 1) == -1, "old frame of source released");
+    CHECK(p.find(4, 3) == s, "new frame of source held");
+    CHECK(p.getStats().entries == 2, "still one entry per source");
+
+    // Re-commit in place (displaced frame takes the hit's slot)
+    int hit = p.lookup(7, 2, 30);
+    p.commit(hit, 9, 9, FRAME, 25, 5000, 30);
+    CHECK(p.find(7, 2) == -1 && p.find(9, 9) == hit, "slot re-keyed in place");
+
+    p.refresh(hit, 6000);
+    CHECK(p.findFresh(9, 9, 10000) == hit, "refresh extends freshness");
+
+    p.removeSource(9);
+    CHECK(p.find(9, 9) == -1 && p.getStats().entries == 1, "removeSource");
+}
+
+static void testWraparound() {
+    FrameCachePolicy p;
+    p.reset(2);
+    uint32_t t0 = 0xFFFFF000u;   // millis() about to wrap
+    p.commit(p.victim(t0), 0, 1, FRAME, t0, 60000, t0);
+    p.commit(p.victim(t0 + 10), 1, 2, FRAME, t0 + 10, 60000, t0 + 10);
+    uint32_t later = t0 + 30000;  // wrapped past zero
+    CHECK(later < t0, "test time wrapped");
+    CHECK(p.findFresh(0, 1, later) == 0, "fresh across wrap");
+    CHECK(p.findFresh(0, 1, t0 + 60001) == -1, "stale across wrap");
+    CHECK(p.lookup(1, 2, later) == 1, "touch source 1 after wrap");
+    CHECK(p.victim(later + 1) == 0, "LRU across wrap");
+}
+
+static void testZeroSlots() {
+    FrameCachePolicy p;
+    p.reset(0);
+    CHECK(p.victim(0) == -1, "no slots, no victim");
+    CHECK(p.lookup(0, 1, 0) == -1, "no slots, miss");
+    p.reset(FRAME_CACHE_MAX_SLOTS + 5);
+    CHECK(p.capacity() == FRAME_CACHE_MAX_SLOTS, "capacity capped");
+}
+
+static void testMaxAge() {
+    CHECK(cacheControlMaxAge(nullptr) == -1, "null header");
+    CHECK(cacheControlMaxAge("") == -1, "empty header");
+    CHECK(cacheControlMaxAge("public, max-age=300") == 300, "max-age after other directive");
+    CHECK(cacheControlMaxAge("max-age=60, must-revalidate") == 60, "max-age first");
+    CHECK(cacheControlMaxAge("Max-Age=\"45\"") == 45, "case-insensitive, quoted");
+    CHECK(cacheControlMaxAge("s-maxage=600") == -1, "s-maxage is not max-age");
+    CHECK(cacheControlMaxAge("no-cache") == 0, "no-cache");
+    CHECK(cacheControlMaxAge("max-age=120, no-store") == 0, "no-store wins");
+    CHECK(cacheControlMaxAge("max-age=abc") == -1, "malformed value");
+}
+
+int main(void) {
+    testLookupAndFreshness();
+    testVictimOrder();
+    testPerSourceReplacement();
+    testWraparound();
+    testZeroSlots();
+    testMaxAge();
+
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
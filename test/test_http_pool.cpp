@@ -0,0 +1,404 @@
+// test/test_http_pool.cpp
+// Host test for the keep-alive connection pool against a local HTTP / HTTPS
+// stand-in server (POSIX sockets + OpenSSL, self-signed certificate made at
+// start-up). Checks reuse, server-side close, Connection: close, idle
+// timeout, per-host entries and eviction, and that a reused TLS connection
+// skips the handshake.
+//
+//   g++ -std=c++17 -O2 test/test_http_pool.cpp http_pool.cpp -lssl -lcrypto -pthread -o /tmp/t && /tmp/t
+#include "../http_pool.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static uint32_t nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+// -----------------------------------------------------------------------------
+// Stand-in server: HTTP/1.1 GET, fixed-length body, keep-alive unless the
+// path asks otherwise ("/close" answers with Connection: close, "/drop"
+// closes the socket right after the response without saying so).
+// -----------------------------------------------------------------------------
+static const size_t BODY_LEN = 64 * 1024;
+
+class StandInServer {
+public:
+    explicit StandInServer(SSL_CTX* tls) : accepted(0), ctx(tls), stopping(false) {
+        lfd = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in a = {};
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        a.sin_port = 0;
+        bind(lfd, (sockaddr*)&a, sizeof(a));
+        listen(lfd, 8);
+        socklen_t len = sizeof(a);
+        getsockname(lfd, (sockaddr*)&a, &len);
+        port = ntohs(a.sin_port);
+        thread = std::thread([this] { run(); });
+    }
+    ~StandInServer() {
+        stopping = true;
+        shutdown(lfd, SHUT_RDWR);
+        close(lfd);
+        thread.join();
+    }
+
+    uint16_t port;
+    std::atomic<int> accepted;
+
+private:
+    void run() {
+        while (!stopping) {
+            int fd = accept(lfd, nullptr, nullptr);
+            if (fd < 0) break;
+            accepted++;
+            std::thread([this, fd] { serve(fd); }).detach();
+        }
+    }
+
+    void serve(int fd) {
+        SSL* ssl = nullptr;
+        if (ctx) {
+            ssl = SSL_new(ctx);
+            SSL_set_fd(ssl, fd);
+            if (SSL_accept(ssl) <= 0) { SSL_free(ssl); close(fd); return; }
+        }
+        std::string body(BODY_LEN, 'x');
+        std::string buf;
+        char tmp[2048];
+        while (true) {
+            size_t hdrEnd;
+            while ((hdrEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+                int n = ssl ? SSL_read(ssl, tmp, sizeof(tmp)) : (int)recv(fd, tmp, sizeof(tmp), 0);
+                if (n <= 0) goto done;
+                buf.append(tmp, n);
+            }
+            {
+                std::string req = buf.substr(0, hdrEnd);
+                buf.erase(0, hdrEnd + 4);
+                bool sayClose = req.find("GET /close") == 0;
+                bool drop = req.find("GET /drop") == 0;
+                std::string resp = "HTTP/1.1 200 OK\r\nContent-Type: image/jpeg\r\nContent-Length: " +
+                                   std::to_string(BODY_LEN) + "\r\nConnection: " +
+                                   (sayClose ? "close" : "keep-alive") + "\r\n\r\n" + body;
+                size_t off = 0;
+                while (off < resp.size()) {
+                    int n = ssl ? SSL_write(ssl, resp.data() + off, (int)(resp.size() - off))
+                                : (int)send(fd, resp.data() + off, resp.size() - off, MSG_NOSIGNAL);
+                    if (n <= 0) goto done;
+                    off += n;
+                }
+                if (sayClose || drop) goto done;
+            }
+        }
+    done:
+        if (ssl) { SSL_shutdown(ssl); SSL_free(ssl); }
+        close(fd);
+    }
+
+    SSL_CTX* ctx;
+    int lfd;
+    std::atomic<bool> stopping;
+    std::thread thread;
+};
+
+// -----------------------------------------------------------------------------
+// Client transport: plain socket or OpenSSL on top of it
+// -----------------------------------------------------------------------------
+class SocketTransport : public PooledTransport {
+public:
+    SocketTransport(bool tls, SSL_CTX* c) : secure(tls), ctx(c), fd(-1), ssl(nullptr) {}
+    ~SocketTransport() override { stop(); }
+
+    bool connect(const HttpEndpoint& ep) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in a = {};
+        a.sin_family = AF_INET;
+        a.sin_port = htons(ep.port);
+        inet_pton(AF_INET, "127.0.0.1", &a.sin_addr);
+        if (::connect(fd, (sockaddr*)&a, sizeof(a)) != 0) { stop(); return false; }
+        if (secure) {
+            ssl = SSL_new(ctx);
+            SSL_set_fd(ssl, fd);
+            if (SSL_connect(ssl) <= 0) { stop(); return false; }
+            handshakes++;
+        }
+        return true;
+    }
+
+    // Same idea as WiFiClient::connected(): an idle keep-alive socket has
+    // nothing to read; EOF (or a close_notify) means the server let go.
+    bool connected() override {
+        if (fd < 0) return false;
+        char c;
+        ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (n == 0) return false;
+        if (n > 0) return !secure;   // unsolicited TLS record on an idle connection: alert
+        return true;                  // EAGAIN: open, no data
+    }
+
+    void stop() override {
+        if (ssl) { SSL_free(ssl); ssl = nullptr; }
+        if (fd >= 0) { close(fd); fd = -1; }
+    }
+
+    int write(const char* d, size_t n) {
+        return ssl ? SSL_write(ssl, d, (int)n) : (int)send(fd, d, n, MSG_NOSIGNAL);
+    }
+    int read(char* d, size_t n) {
+        return ssl ? SSL_read(ssl, d, (int)n) : (int)recv(fd, d, n, 0);
+    }
+
+    static int handshakes;
+
+private:
+    bool secure;
+    SSL_CTX* ctx;
+    int fd;
+    SSL* ssl;
+};
+int SocketTransport::handshakes = 0;
+
+static PooledTransport* makeSocketTransport(const HttpEndpoint& ep, void* ctx) {
+    return new SocketTransport(ep.secure, (SSL_CTX*)ctx);
+}
+
+// One GET through the pool, the way the sketch drives HTTPClient
+static bool fetch(HttpConnectionPool& pool, const char* url, uint32_t now, HttpFetchTiming* t) {
+    HttpEndpoint ep;
+    if (!httpParseEndpoint(url, &ep)) return false;
+    HttpLease lease;
+    if (!pool.acquire(ep, now, &lease)) return false;
+    SocketTransport* s = (SocketTransport*)lease.transport;
+    memset(t, 0, sizeof(*t));
+    t->reused = lease.reused;
+
+    uint32_t t0 = nowMs();
+    if (!lease.reused && !s->connect(ep)) {
+        pool.release(lease, false, now, *t);
+        return false;
+    }
+    t->connectMs = lease.reused ? 0 : nowMs() - t0;
+
+    const char* path = strchr(url + 8, '/');
+    std::string req = std::string("GET ") + (path ? path : "/") + " HTTP/1.1\r\nHost: " + ep.host +
+                      "\r\nConnection: keep-alive\r\n\r\n";
+    t0 = nowMs();
+    bool ok = s->write(req.data(), req.size()) == (int)req.size();
+    std::string buf;
+    char tmp[4096];
+    size_t hdrEnd = std::string::npos;
+    while (ok && (hdrEnd = buf.find("\r\n\r\n")) == std::string::npos) {
+        int n = s->read(tmp, sizeof(tmp));
+        if (n <= 0) ok = false; else buf.append(tmp, n);
+    }
+    t->responseMs = nowMs() - t0;
+    bool keepAlive = false;
+    if (ok) {
+        std::string hdr = buf.substr(0, hdrEnd);
+        size_t clen = strtoul(hdr.c_str() + hdr.find("Content-Length: ") + 16, nullptr, 10);
+        keepAlive = hdr.find("Connection: close") == std::string::npos;
+        size_t got = buf.size() - hdrEnd - 4;
+        t0 = nowMs();
+        while (got < clen) {
+            int n = s->read(tmp, sizeof(tmp) < clen - got ? sizeof(tmp) : clen - got);
+            if (n <= 0) { ok = false; break; }
+            got += n;
+        }
+        t->bodyMs = nowMs() - t0;
+        t->bytes = got;
+        ok = ok && got == clen;
+    }
+    pool.release(lease, ok && keepAlive, now, *t);
+    return ok;
+}
+
+// Wait until the server's FIN for a dropped connection has arrived
+static void settle() {
+    usleep(50 * 1000);
+}
+
+static SSL_CTX* makeServerTlsContext() {
+    EVP_PKEY* key = EVP_EC_gen("P-256");
+    X509* cert = X509_new();
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+    X509_set_pubkey(cert, key);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char*)"localhost", -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, key, EVP_sha256());
+
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    SSL_CTX_use_certificate(ctx, cert);
+    SSL_CTX_use_PrivateKey(ctx, key);
+    // Like an image CDN with tickets off: every new connection is a full handshake
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+    SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ctx;
+}
+
+static void testParseEndpoint() {
+    HttpEndpoint ep;
+    CHECK(httpParseEndpoint("https://sdo.gsfc.nasa.gov/assets/img/latest/latest_1024_0193.jpg", &ep) &&
+          ep.secure && ep.port == 443 && strcmp(ep.host, "sdo.gsfc.nasa.gov") == 0, "https default port");
+    CHECK(httpParseEndpoint("http://Allsky.LAN:8080/current.jpg", &ep) &&
+          !ep.secure && ep.port == 8080 && strcmp(ep.host, "allsky.lan") == 0, "explicit port, host lower-cased");
+    CHECK(httpParseEndpoint("http://user:pw@cam.local/img.jpg", &ep) && strcmp(ep.host, "cam.local") == 0 &&
+          ep.port == 80, "credentials skipped");
+    CHECK(httpParseEndpoint("http://cam.local?x=1", &ep) && strcmp(ep.host, "cam.local") == 0, "no path");
+    CHECK(!httpParseEndpoint("moon://now", &ep), "non-http scheme");
+    CHECK(!httpParseEndpoint("http:///x.jpg", &ep), "empty host");
+    CHECK(!httpParseEndpoint("http://cam:99999/x.jpg", &ep), "port out of range");
+    CHECK(!httpParseEndpoint("http://cam:/x.jpg", &ep), "empty port");
+
+    HttpEndpoint a, b;
+    httpParseEndpoint("http://h/x", &a);
+    httpParseEndpoint("https://h/x", &b);
+    CHECK(!httpEndpointEqual(a, b), "scheme is part of the key");
+}
+
+static void testPlainKeepAlive() {
+    StandInServer srv(nullptr);
+    HttpConnectionPool pool(makeSocketTransport, nullptr, 60000, 100);
+    HttpFetchTiming t;
+    char url[128];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/a.jpg", srv.port);
+
+    CHECK(fetch(pool, url, 1000, &t) && t.bytes == BODY_LEN && !t.reused, "first fetch opens");
+    CHECK(fetch(pool, url, 2000, &t) && t.reused && t.connectMs == 0, "second fetch reuses");
+    CHECK(fetch(pool, url, 3000, &t) && t.reused, "third fetch reuses");
+    CHECK(srv.accepted == 1, "one TCP connection for three fetches");
+    HttpPoolStats st = pool.getStats();
+    CHECK(st.fetches == 3 && st.reused == 2 && st.opened == 1 && st.openConnections == 1, "reuse counters");
+
+    // Server closes without Connection: close; detected on the next acquire
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/drop", srv.port);
+    CHECK(fetch(pool, url, 4000, &t) && t.reused, "drop fetch still rides the kept connection");
+    settle();
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/a.jpg", srv.port);
+    CHECK(fetch(pool, url, 5000, &t) && !t.reused, "peer-closed connection reopened");
+    CHECK(pool.getStats().closedByPeer == 1 && srv.accepted == 2, "peer close counted");
+
+    // Connection: close is honoured
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/close", srv.port);
+    CHECK(fetch(pool, url, 6000, &t), "close fetch");
+    CHECK(pool.getStats().openConnections == 0 && pool.getStats().notReusable == 1, "not kept after close");
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/a.jpg", srv.port);
+    CHECK(fetch(pool, url, 7000, &t) && !t.reused && srv.accepted == 3, "new connection after close");
+
+    // Idle timeout: closed on acquire, and by closeIdle()
+    CHECK(fetch(pool, url, 7000 + 60000, &t) && !t.reused, "idle connection not reused");
+    CHECK(pool.getStats().closedIdle == 1, "idle close counted on acquire");
+    CHECK(pool.closeIdle(7000 + 60000 + 59999) == 0, "not idle yet");
+    CHECK(pool.closeIdle(7000 + 60000 + 60000) == 1, "closeIdle closes it");
+    CHECK(pool.getStats().openConnections == 0, "nothing open after closeIdle");
+}
+
+static void testMaxRequests() {
+    StandInServer srv(nullptr);
+    HttpConnectionPool pool(makeSocketTransport, nullptr, 60000, 2);
+    HttpFetchTiming t;
+    char url[128];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/a.jpg", srv.port);
+    fetch(pool, url, 0, &t);
+    fetch(pool, url, 1, &t);
+    CHECK(fetch(pool, url, 2, &t) && !t.reused, "connection retired after maxRequests");
+    CHECK(srv.accepted == 2, "two connections for three fetches");
+}
+
+static void testHostsAndEviction() {
+    StandInServer s1(nullptr), s2(nullptr), s3(nullptr), s4(nullptr), s5(nullptr);
+    StandInServer* servers[] = { &s1, &s2, &s3, &s4, &s5 };
+    HttpConnectionPool pool(makeSocketTransport, nullptr, 60000, 100);
+    HttpFetchTiming t;
+    char url[128];
+    for (int i = 0; i < 5; i++) {
+        snprintf(url, sizeof(url), "http://127.0.0.1:%u/a.jpg", servers[i]->port);
+        CHECK(fetch(pool, url, 100 + i, &t) && !t.reused, "each host opens its own connection");
+    }
+    CHECK(pool.getStats().evicted == 1, "fifth host evicts the least recently used");
+    CHECK(pool.getStats().openConnections == HTTP_POOL_MAX_ENTRIES, "pool full");
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/a.jpg", s2.port);
+    CHECK(fetch(pool, url, 200, &t) && t.reused, "recent host still pooled");
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/a.jpg", s1.port);
+    CHECK(fetch(pool, url, 201, &t) && !t.reused, "evicted host reconnects");
+
+    // A leased entry is never handed out twice
+    HttpEndpoint ep;
+    httpParseEndpoint(url, &ep);
+    HttpLease a, b;
+    CHECK(pool.acquire(ep, 300, &a), "lease");
+    CHECK(!pool.acquire(ep, 300, &b), "second lease for the same host refused");
+    pool.release(a, false, 300, t);
+}
+
+static void testTlsHandshakeSkipped() {
+    SSL_CTX* serverCtx = makeServerTlsContext();
+    SSL_CTX* clientCtx = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_verify(clientCtx, SSL_VERIFY_NONE, nullptr);   // like setInsecure()
+    StandInServer srv(serverCtx);
+    HttpConnectionPool pool(makeSocketTransport, clientCtx, 60000, 100);
+    HttpFetchTiming t;
+    char url[128];
+    snprintf(url, sizeof(url), "https://127.0.0.1:%u/latest_1024_0193.jpg", srv.port);
+
+    SocketTransport::handshakes = 0;
+    CHECK(fetch(pool, url, 0, &t) && t.bytes == BODY_LEN && !t.reused, "https first fetch");
+    uint32_t firstConnect = t.connectMs;
+    for (int i = 1; i <= 4; i++) {
+        CHECK(fetch(pool, url, i * 1000, &t) && t.reused && t.connectMs == 0, "https fetch reuses");
+    }
+    CHECK(SocketTransport::handshakes == 1 && srv.accepted == 1, "one TLS handshake for five fetches");
+    HttpPoolStats st = pool.getStats();
+    CHECK(st.connectMsTotal == firstConnect, "handshake time only charged once");
+    printf("  https: handshake %u ms, then %u fetches reused (last: response %u ms, body %u ms)\n",
+           (unsigned)firstConnect, (unsigned)st.reused, (unsigned)t.responseMs, (unsigned)t.bodyMs);
+
+    // Server-side close over TLS is noticed too
+    snprintf(url, sizeof(url), "https://127.0.0.1:%u/drop", srv.port);
+    fetch(pool, url, 6000, &t);
+    settle();
+    snprintf(url, sizeof(url), "https://127.0.0.1:%u/a.jpg", srv.port);
+    CHECK(fetch(pool, url, 7000, &t) && !t.reused && SocketTransport::handshakes == 2, "TLS peer close reconnects");
+
+    pool.closeAll();
+    SSL_CTX_free(clientCtx);
+    SSL_CTX_free(serverCtx);
+}
+
+int main(void) {
+    testParseEndpoint();
+    testPlainKeepAlive();
+    testMaxRequests();
+    testHostsAndEviction();
+    testTlsHandshakeSkipped();
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,193 @@
+// test/test_image_decoder.cpp
+// Host test for the decoder chain selection/fallback and the JPEG header
+// parser, using software stand-ins for the hardware codec and JPEGDEC, and
+// the edge clipping / direct-decode checks of the JPEGDEC output path.
+//
+//   g++ -std=c++17 -O2 test/test_image_decoder.cpp image_decoder.cpp -o /tmp/t && /tmp/t
+#include "../image_decoder.h"
+#include "../moon_equirect_data.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+// Stand-in backend: behaves like the hardware codec when `baselineColorOnly`
+// (declines progressive / non-YCbCr streams), otherwise accepts anything.
+class FakeDecoder : public ImageDecoder {
+public:
+    FakeDecoder(const char* n, bool baselineColorOnly, uint16_t fill)
+        : label(n), strict(baselineColorOnly), fillValue(fill), available(true),
+          forceFail(false), calls(0) {}
+
+    const char* name() const override { return label; }
+    bool isAvailable() const override { return available; }
+
+    DecodeStatus decode(const DecodeRequest& req, DecodeResult* result) override {
+        calls++;
+        if (forceFail) return DECODE_FAILED;
+        JpegHeaderInfo hdr;
+        if (!jpegParseHeader(req.data, req.length, &hdr)) return DECODE_FAILED;
+        if (strict && (hdr.progressive || hdr.components != 3)) return DECODE_UNSUPPORTED;
+        int div = 1;
+        while (div < 8 && (size_t)(hdr.width / div) * (hdr.height / div) * 2 > req.dstBytes) div *= 2;
+        if ((size_t)(hdr.width / div) * (hdr.height / div) * 2 > req.dstBytes) return DECODE_UNSUPPORTED;
+        if (strict && div > 1) return DECODE_UNSUPPORTED;
+        result->srcWidth = hdr.width;
+        result->srcHeight = hdr.height;
+        result->width = hdr.width / div;
+        result->height = hdr.height / div;
+        result->scaleDiv = div;
+        for (int i = 0; i < result->width * result->height; i++) req.dst[i] = fillValue;
+        return DECODE_OK;
+    }
+
+    const char* label;
+    bool strict;
+    uint16_t fillValue;
+    bool available;
+    bool forceFail;
+    int calls;
+};
+
+// Minimal JPEG header: SOI, one APP0, SOFn with the given geometry, EOI
+static std::vector<uint8_t> makeHeader(uint8_t sof, int w, int h, int comps, uint8_t lumaSampling) {
+    std::vector<uint8_t> j = { 0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x06, 'J', 'F', 'I', 'F' };
+    int segLen = 8 + comps * 3;
+    j.push_back(0xFF); j.push_back(sof);
+    j.push_back(segLen >> 8); j.push_back(segLen & 0xFF);
+    j.push_back(8);
+    j.push_back(h >> 8); j.push_back(h & 0xFF);
+    j.push_back(w >> 8); j.push_back(w & 0xFF);
+    j.push_back((uint8_t)comps);
+    for (int c = 0; c < comps; c++) {
+        j.push_back((uint8_t)(c + 1));
+        j.push_back(c == 0 ? lumaSampling : 0x11);
+        j.push_back(c == 0 ? 0 : 1);
+    }
+    j.push_back(0xFF); j.push_back(0xD9);
+    return j;
+}
+
+static void testHeaderParser() {
+    JpegHeaderInfo info;
+    CHECK(jpegParseHeader(MOON_EQUIRECT_JPG, MOON_EQUIRECT_JPG_LEN, &info), "moon header not parsed");
+    CHECK(info.width == 2048 && info.height == 1024, "moon dimensions wrong");
+    CHECK(info.components == 3 && !info.progressive, "moon should be baseline YCbCr");
+    CHECK(info.mcuWidth == 8 && info.mcuHeight == 8, "4:4:4 MCU should be 8x8");
+
+    std::vector<uint8_t> gray = makeHeader(0xC0, 100, 50, 1, 0x22);
+    CHECK(jpegParseHeader(gray.data(), gray.size(), &info) && info.components == 1, "grayscale not parsed");
+    CHECK(info.mcuWidth == 8 && info.mcuHeight == 8, "grayscale MCU should be 8x8");
+
+    std::vector<uint8_t> goes = makeHeader(0xC0, 1808, 1808, 3, 0x22);
+    CHECK(jpegParseHeader(goes.data(), goes.size(), &info), "4:2:0 header not parsed");
+    CHECK(info.width == 1808 && info.components == 3, "4:2:0 geometry wrong");
+    CHECK(info.mcuWidth == 16 && info.mcuHeight == 16, "4:2:0 MCU should be 16x16");
+
+    std::vector<uint8_t> prog = makeHeader(0xC2, 640, 480, 3, 0x21);
+    CHECK(jpegParseHeader(prog.data(), prog.size(), &info) && info.progressive, "SOF2 not flagged progressive");
+    CHECK(info.mcuWidth == 16 && info.mcuHeight == 8, "4:2:2 MCU should be 16x8");
+
+    CHECK(!jpegParseHeader(goes.data(), 12, &info), "truncated header accepted");
+    const uint8_t png[] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+    CHECK(!jpegParseHeader(png, sizeof(png), &info), "PNG accepted as JPEG");
+}
+
+static void testChainFallback() {
+    std::vector<uint16_t> dst(1024 * 1024);
+    FakeDecoder hw("hw", true, 0x1111);
+    FakeDecoder sw("jpegdec", false, 0x2222);
+    DecoderChain chain;
+    CHECK(chain.add(&hw) && chain.add(&sw), "add failed");
+    CHECK(chain.preferred() == &hw, "hardware should be preferred");
+
+    DecodeResult res;
+    ImageDecoder* used = nullptr;
+
+    // Baseline colour frame: hardware takes it, software never runs
+    std::vector<uint8_t> color = makeHeader(0xC0, 1024, 768, 3, 0x22);
+    DecodeRequest req = { color.data(), color.size(), dst.data(), dst.size() * 2, 1448 };
+    CHECK(chain.decode(req, &res, &used) == DECODE_OK && used == &hw, "baseline frame should use hw");
+    CHECK(sw.calls == 0 && dst[0] == 0x1111, "software backend should not run");
+
+    // Progressive: hardware declines, JPEGDEC stand-in decodes
+    std::vector<uint8_t> prog = makeHeader(0xC2, 1024, 768, 3, 0x22);
+    req.data = prog.data(); req.length = prog.size();
+    CHECK(chain.decode(req, &res, &used) == DECODE_OK && used == &sw, "progressive should fall back");
+    CHECK(dst[0] == 0x2222, "fallback output not written");
+
+    // Oversized (GOES-like) frame the strict backend won't downscale 1/4
+    std::vector<uint8_t> big = makeHeader(0xC0, 4000, 4000, 3, 0x22);
+    req.data = big.data(); req.length = big.size();
+    CHECK(chain.decode(req, &res, &used) == DECODE_OK && used == &sw && res.scaleDiv == 4,
+          "oversized frame should fall back with a decode-time downscale");
+
+    // Engine error on a supported frame still falls back
+    hw.forceFail = true;
+    req.data = color.data(); req.length = color.size();
+    CHECK(chain.decode(req, &res, &used) == DECODE_OK && used == &sw, "hw failure should fall back");
+    hw.forceFail = false;
+
+    // Unavailable hardware is skipped entirely
+    hw.available = false;
+    int hwCalls = hw.calls;
+    CHECK(chain.preferred() == &sw, "preferred should skip unavailable backend");
+    CHECK(chain.decode(req, &res, &used) == DECODE_OK && used == &sw && hw.calls == hwCalls,
+          "unavailable backend should not be called");
+    hw.available = true;
+
+    // Garbage: everyone fails, status reports failure
+    const uint8_t junk[] = { 0x00, 0x01, 0x02, 0x03, 0x04 };
+    req.data = junk; req.length = sizeof(junk);
+    CHECK(chain.decode(req, &res, &used) == DECODE_FAILED && used == &sw, "garbage should fail");
+
+    CHECK(chain.okCount(0) == 1, "hw ok count wrong");
+    CHECK(chain.okCount(1) == 4, "jpegdec ok count wrong");
+    CHECK(chain.fallbackCount(0) == 4, "hw fallback count wrong");
+}
+
+static void testChainLimits() {
+    DecoderChain chain;
+    FakeDecoder d("x", false, 0);
+    for (int i = 0; i < DECODER_CHAIN_MAX; i++) CHECK(chain.add(&d), "add within capacity failed");
+    CHECK(!chain.add(&d), "add beyond capacity accepted");
+    CHECK(!chain.add(nullptr), "null decoder accepted");
+
+    DecoderChain empty;
+    DecodeResult res;
+    ImageDecoder* used = &d;
+    uint16_t px[4];
+    DecodeRequest req = { MOON_EQUIRECT_JPG, MOON_EQUIRECT_JPG_LEN, px, sizeof(px), 1448 };
+    CHECK(empty.decode(req, &res, &used) == DECODE_UNSUPPORTED && used == nullptr, "empty chain should decline");
+}
+
+static void testOutputEdges() {
+    int w, h;
+    // 1000x750 frame, 4:2:0: the last MCU column / row overhang the edge
+    CHECK(jpegClipBlock(0, 0, 128, 16, 1000, 750, &w, &h) && w == 128 && h == 16, "inner block kept whole");
+    CHECK(jpegClipBlock(896, 0, 128, 16, 1000, 750, &w, &h) && w == 104, "right overhang clipped");
+    CHECK(jpegClipBlock(0, 736, 128, 16, 1000, 750, &w, &h) && h == 14, "bottom rows written, not dropped");
+    CHECK(!jpegClipBlock(0, 752, 128, 16, 1000, 750, &w, &h), "block below the frame");
+    CHECK(!jpegClipBlock(1000, 0, 16, 16, 1000, 750, &w, &h), "block right of the frame");
+
+    // Direct decode: width a multiple of the (scaled) MCU, room for the overhang
+    CHECK(jpegDirectDecodeFits(1024, 750, 16, 16, 1, 1024 * 752 * 2), "aligned width, overhang fits");
+    CHECK(!jpegDirectDecodeFits(1024, 750, 16, 16, 1, 1024 * 750 * 2), "no room for the last MCU row");
+    CHECK(!jpegDirectDecodeFits(1000, 750, 16, 16, 1, 4u << 20), "unaligned width");
+    CHECK(jpegDirectDecodeFits(1000, 750, 8, 8, 1, 4u << 20), "4:4:4 MCUs divide 1000");
+    CHECK(jpegDirectDecodeFits(182, 94, 16, 16, 8, 182 * 94 * 2), "1/8 of a 16px MCU is 2px");
+    CHECK(!jpegDirectDecodeFits(181, 94, 16, 16, 8, 4u << 20), "odd width at 1/8 of 4:2:0");
+    CHECK(!jpegDirectDecodeFits(181, 94, 16, 16, 4, 4u << 20), "1/4 of 16 is 4px");
+}
+
+int main(void) {
+    testHeaderParser();
+    testChainFallback();
+    testChainLimits();
+    testOutputEdges();
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,197 @@
+// test/test_jpeg_stream.cpp
+// Host test for JpegStreamReader: replays the captured moon texture JPEG through
+// a throttled fake socket and checks that a callback-driven decode matches the
+// in-RAM decode byte for byte, plus the seek / tee / timeout behaviour.
+//
+//   g++ -std=c++17 -O2 test/test_jpeg_stream.cpp jpeg_stream.cpp -o /tmp/t && /tmp/t
+#include "../jpeg_stream.h"
+#include "../moon_equirect_data.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_JPEG
+#define STBI_NO_STDIO
+#include "../stb_image.h"
+
+// Simulated clock: advanced by the reader's idle hook while it waits for data.
+static uint32_t g_now = 0;
+static uint32_t fakeNow() { return g_now; }
+static void fakeIdle() { g_now += 1; }
+
+// Delivers `data` in bursts of `burst` bytes, one burst every `gapMs` of
+// simulated time. Stops delivering after `stallAt` bytes (connection stays
+// open) or closes after `closeAt` bytes.
+class FakeSocket : public ByteSource {
+public:
+    FakeSocket(const uint8_t* d, size_t n, size_t burst, uint32_t gapMs)
+        : data(d), len(n), burstSize(burst), gap(gapMs), sent(0), ready(0),
+          nextBurst(0), stallAt(n), closeAt(n) {}
+    void stallAfter(size_t n) { stallAt = n; }
+    void closeAfter(size_t n) { closeAt = n; }
+
+    int available() override {
+        if (ready == 0 && g_now >= nextBurst) {
+            size_t limit = stallAt < closeAt ? stallAt : closeAt;
+            size_t left = sent < limit ? limit - sent : 0;
+            ready = left < burstSize ? left : burstSize;
+            nextBurst = g_now + gap;
+        }
+        return (int)ready;
+    }
+    int read(uint8_t* buf, size_t n) override {
+        if (n > ready) n = ready;
+        memcpy(buf, data + sent, n);
+        sent += n;
+        ready -= n;
+        return (int)n;
+    }
+    bool connected() override { return sent < closeAt; }
+
+private:
+    const uint8_t* data;
+    size_t len, burstSize;
+    uint32_t gap;
+    size_t sent, ready;
+    uint32_t nextBurst;
+    size_t stallAt, closeAt;
+};
+
+// stb_image callbacks over the reader (the same read/seek surface JPEGDEC uses)
+static int cbRead(void* user, char* data, int size) {
+    return ((JpegStreamReader*)user)->read((uint8_t*)data, size);
+}
+static void cbSkip(void* user, int n) {
+    JpegStreamReader* r = (JpegStreamReader*)user;
+    r->seek(r->position() + n);
+}
+static int cbEof(void* user) {
+    JpegStreamReader* r = (JpegStreamReader*)user;
+    return r->ended() && r->position() >= (int32_t)r->received();
+}
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static void testStreamedDecodeMatchesRam() {
+    const int32_t n = (int32_t)MOON_EQUIRECT_JPG_LEN;
+    int rw, rh, rc;
+    unsigned char* ref = stbi_load_from_memory(MOON_EQUIRECT_JPG, n, &rw, &rh, &rc, 1);
+    CHECK(ref != nullptr, "reference decode failed");
+    CHECK(rw == 2048 && rh == 1024, "unexpected reference dimensions");
+
+    g_now = 0;
+    std::vector<uint8_t> tee(n + 1024);
+    FakeSocket sock(MOON_EQUIRECT_JPG, n, 1460, 3);   // one TCP segment every 3 ms
+    JpegStreamReader reader(&sock, n, tee.data(), tee.size(), fakeNow, fakeIdle);
+    reader.setTimeouts(5000, 600000);
+
+    stbi_io_callbacks cb = { cbRead, cbSkip, cbEof };
+    int w, h, c;
+    unsigned char* img = stbi_load_from_callbacks(&cb, &reader, &w, &h, &c, 1);
+    CHECK(img != nullptr, "streamed decode failed");
+    CHECK(reader.error() == STREAM_OK, "stream reported an error");
+    if (img && ref) {
+        CHECK(w == rw && h == rh, "streamed dimensions differ");
+        CHECK(memcmp(img, ref, (size_t)w * h) == 0, "streamed pixels differ from RAM decode");
+    }
+    CHECK(reader.drainToTee(), "tee incomplete after drain");
+    CHECK(reader.teeComplete(), "teeComplete false");
+    CHECK(memcmp(tee.data(), MOON_EQUIRECT_JPG, n) == 0, "tee does not match the body");
+    CHECK(reader.stallMs() > 0, "throttled socket recorded no wait time");
+    CHECK(reader.contentHash() == contentHashUpdate(CONTENT_HASH_INIT, MOON_EQUIRECT_JPG, n),
+          "incremental hash differs from one-shot hash");
+    printf("streamed %d bytes in %u simulated ms (%u ms waiting)\n",
+           n, (unsigned)reader.elapsedMs(), (unsigned)reader.stallMs());
+    stbi_image_free(img);
+    stbi_image_free(ref);
+}
+
+static void testSeeks() {
+    const int32_t n = 64 * 1024;
+    g_now = 0;
+    std::vector<uint8_t> tee(8 * 1024);
+    FakeSocket sock(MOON_EQUIRECT_JPG, n, 1000, 1);
+    JpegStreamReader reader(&sock, n, tee.data(), tee.size(), fakeNow, fakeIdle);
+
+    uint8_t buf[16];
+    CHECK(reader.read(buf, 4) == 4 && buf[0] == 0xFF && buf[1] == 0xD8, "SOI not read");
+    CHECK(reader.seek(4000) == 4000, "forward seek failed");
+    CHECK(reader.read(buf, 16) == 16 && memcmp(buf, MOON_EQUIRECT_JPG + 4000, 16) == 0, "data after forward seek wrong");
+    CHECK(reader.seek(2) == 2, "backward seek inside tee failed");
+    CHECK(reader.read(buf, 8) == 8 && memcmp(buf, MOON_EQUIRECT_JPG + 2, 8) == 0, "data after backward seek wrong");
+    CHECK(reader.seek(20000) == 20000, "forward seek past tee failed");
+    CHECK(!reader.teeComplete(), "tee should have overflowed");
+    CHECK(reader.seek(10000) == -1 && reader.error() == STREAM_BAD_SEEK, "seek behind tee should fail");
+}
+
+// The read that overflows the tee still tees the part that fits: seeking
+// back into it returns those bytes, up to the end of the tee and no further
+static void testSeekIntoLastPartialChunk() {
+    const int32_t n = 16 * 1024;
+    g_now = 0;
+    std::vector<uint8_t> tee(8 * 1024);   // 8192: the 8000..9000 read crosses it
+    FakeSocket sock(MOON_EQUIRECT_JPG, n, 1000, 1);
+    JpegStreamReader reader(&sock, n, tee.data(), tee.size(), fakeNow, fakeIdle);
+
+    std::vector<uint8_t> out(9000);
+    int32_t got = 0;
+    while (got < 9000) {
+        int32_t r = reader.read(out.data() + got, 1000);
+        if (r <= 0) break;
+        got += r;
+    }
+    CHECK(got == 9000 && !reader.teeComplete(), "body past the tee should overflow it");
+    uint8_t buf[200];
+    CHECK(reader.seek(8100) == 8100, "seek into the partial chunk before teeCap failed");
+    CHECK(reader.read(buf, 16) == 16 && memcmp(buf, MOON_EQUIRECT_JPG + 8100, 16) == 0,
+          "partial chunk before teeCap not teed");
+    CHECK(reader.seek(8100) == 8100 && reader.read(buf, 200) == 92 &&
+          memcmp(buf, MOON_EQUIRECT_JPG + 8100, 92) == 0, "read across teeCap should stop at the tee's end");
+    CHECK(reader.read(buf, 16) == 0 && reader.error() == STREAM_BAD_SEEK, "read past the tee should fail");
+    CHECK(reader.seek(8192) == -1 && reader.error() == STREAM_BAD_SEEK, "seek to teeCap should fail");
+}
+
+static void testStallTimeout() {
+    const int32_t n = (int32_t)MOON_EQUIRECT_JPG_LEN;
+    g_now = 0;
+    std::vector<uint8_t> tee(n);
+    FakeSocket sock(MOON_EQUIRECT_JPG, n, 4096, 1);
+    sock.stallAfter(n / 2);
+    JpegStreamReader reader(&sock, n, tee.data(), tee.size(), fakeNow, fakeIdle);
+    reader.setTimeouts(5000, 600000);
+
+    std::vector<uint8_t> out(n);
+    int32_t got = reader.read(out.data(), n);
+    CHECK(got == n / 2, "stalled read should return the delivered half");
+    CHECK(reader.error() == STREAM_STALLED, "expected STREAM_STALLED");
+    CHECK(g_now >= 5000 && g_now < 6000, "stall detected at the wrong time");
+    CHECK(reader.read(out.data(), 16) == 0, "reads after a stall should return 0");
+}
+
+static void testClosedEarly() {
+    const int32_t n = 32 * 1024;
+    g_now = 0;
+    std::vector<uint8_t> tee(n);
+    FakeSocket sock(MOON_EQUIRECT_JPG, n, 2048, 1);
+    sock.closeAfter(10000);
+    JpegStreamReader reader(&sock, n, tee.data(), tee.size(), fakeNow, fakeIdle);
+
+    std::vector<uint8_t> out(n);
+    CHECK(reader.read(out.data(), n) == 10000, "truncated read length wrong");
+    CHECK(reader.error() == STREAM_CLOSED_EARLY, "expected STREAM_CLOSED_EARLY");
+    CHECK(!reader.drainToTee(), "drain should fail on a truncated body");
+}
+
+int main(void) {
+    testStreamedDecodeMatchesRam();
+    testSeeks();
+    testSeekIntoLastPartialChunk();
+    testStallTimeout();
+    testClosedEarly();
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,153 @@
+// test/test_pixel_stage.cpp
+// Host test for the decode-time pixel stage: its colour temperature table
+// gives exactly what the old render-time pass computed, the night red shift
+// and gamma do what they say, keys tell settings apart, copy-and-process
+// matches process-in-place, and a rect touches only its own pixels.
+//
+//   g++ -std=c++17 -O2 test/test_pixel_stage.cpp pixel_stage.cpp pixel_kernels.cpp -o /tmp/t && /tmp/t
+#include "../pixel_stage.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static int clampi(int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+static std::vector<uint16_t> lutStorage(PIXEL_STAGE_LUT_ENTRIES);
+
+static PixelStage build(int kelvin, int gamma = PIXEL_STAGE_NEUTRAL_GAMMA, int redShift = 0) {
+    PixelStage s = { 0, lutStorage.data() };
+    PixelStageSettings set = { kelvin, gamma, redShift };
+    CHECK(pixelStageBuild(&s, set), "stage built");
+    return s;
+}
+
+static uint32_t key(int kelvin, int gamma = PIXEL_STAGE_NEUTRAL_GAMMA, int redShift = 0) {
+    PixelStageSettings set = { kelvin, gamma, redShift };
+    return pixelStageKey(set);
+}
+
+// The render-time ImageUtils::adjustColorTemperature() arithmetic
+static uint16_t referencePixel(uint16_t p, int kelvin) {
+    float rS, gS, bS;
+    pixelKelvinScales(kelvin, &rS, &gS, &bS);
+    int rFix = rS * 256, gFix = gS * 256, bFix = bS * 256;
+    int r = clampi((((p >> 11) & 0x1F) * rFix) >> 8, 0, 31);
+    int g = clampi((((p >> 5) & 0x3F) * gFix) >> 8, 0, 63);
+    int b = clampi(((p & 0x1F) * bFix) >> 8, 0, 31);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void testMatchesRenderPass() {
+    const int temps[] = { 2000, 3200, 5000, 6600, 9000, 12000 };
+    for (int t : temps) {
+        PixelStage s = build(t);
+        CHECK(!pixelStageIsIdentity(s) && s.key == key(t), "non-neutral stage keyed by temperature");
+        bool same = true;
+        for (uint32_t p = 0; p < 65536; p++) same = same && pixelStageMap(s, (uint16_t)p) == referencePixel((uint16_t)p, t);
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%dK matches the render-time pass for every pixel", t);
+        CHECK(same, msg);
+    }
+}
+
+static void testNeutral() {
+    PixelStage s = build(PIXEL_STAGE_NEUTRAL_KELVIN);
+    CHECK(pixelStageIsIdentity(s), "6500K is the identity");
+    std::vector<uint16_t> px = { 0x0000, 0xFFFF, 0x1234, 0xF800 };
+    std::vector<uint16_t> before = px;
+    pixelStageApply(s, px.data(), px.size());
+    CHECK(px == before, "identity leaves pixels alone");
+    bool same = true;
+    for (uint32_t p = 0; p < 65536; p++) same = same && pixelStageMap(s, (uint16_t)p) == p;
+    CHECK(same, "identity maps are the identity");
+
+    // Neutral needs no table; anything else does
+    PixelStage none = { 0, nullptr };
+    PixelStageSettings neutral = { PIXEL_STAGE_NEUTRAL_KELVIN, PIXEL_STAGE_NEUTRAL_GAMMA, 0 };
+    PixelStageSettings warm = { 3000, PIXEL_STAGE_NEUTRAL_GAMMA, 0 };
+    CHECK(pixelStageBuild(&none, neutral) && pixelStageIsIdentity(none), "neutral without a table");
+    CHECK(!pixelStageBuild(&none, warm) && pixelStageIsIdentity(none), "no table: refused, stays identity");
+}
+
+static uint16_t rgb(int r, int g, int b) { return (uint16_t)((r << 11) | (g << 5) | b); }
+
+static void testRedShiftAndGamma() {
+    // Full red shift: no green or blue left, grey becomes red of similar brightness
+    PixelStage night = build(PIXEL_STAGE_NEUTRAL_KELVIN, PIXEL_STAGE_NEUTRAL_GAMMA, 100);
+    bool noGB = true;
+    for (uint32_t p = 0; p < 65536; p++) noGB = noGB && (pixelStageMap(night, (uint16_t)p) & 0x07FF) == 0;
+    CHECK(noGB, "full red shift drops green and blue");
+    CHECK(pixelStageMap(night, rgb(16, 32, 16)) >> 11 == 16, "grey keeps its level in red");
+    CHECK(pixelStageMap(night, rgb(31, 0, 0)) == rgb(31, 0, 0), "pure red unchanged");
+
+    // Half shift keeps some green
+    PixelStage half = build(PIXEL_STAGE_NEUTRAL_KELVIN, PIXEL_STAGE_NEUTRAL_GAMMA, 50);
+    int g = (pixelStageMap(half, rgb(0, 63, 0)) >> 5) & 0x3F;
+    CHECK(g > 25 && g < 38, "half shift halves green");
+
+    // Gamma above 1 lifts mid tones, keeps black and white, stays monotonic
+    PixelStage lift = build(PIXEL_STAGE_NEUTRAL_KELVIN, 220, 0);
+    CHECK(pixelStageMap(lift, 0) == 0 && pixelStageMap(lift, 0xFFFF) == 0xFFFF, "gamma keeps ends");
+    CHECK((pixelStageMap(lift, rgb(0, 16, 0)) >> 5) > 16, "gamma lifts mid green");
+    bool mono = true;
+    for (int v = 1; v < 64; v++) {
+        mono = mono && ((pixelStageMap(lift, rgb(0, v, 0)) >> 5) & 0x3F) >= ((pixelStageMap(lift, rgb(0, v - 1, 0)) >> 5) & 0x3F);
+    }
+    CHECK(mono, "gamma monotonic");
+
+    // Composition: temperature first, then the rest (stages share one table,
+    // so each is read before the next is built)
+    uint16_t p = rgb(10, 40, 20);
+    uint16_t warmed = pixelStageMap(build(3000), p);
+    uint16_t composed = pixelStageMap(build(3000, PIXEL_STAGE_NEUTRAL_GAMMA, 100), p);
+    uint16_t twoSteps = pixelStageMap(build(PIXEL_STAGE_NEUTRAL_KELVIN, PIXEL_STAGE_NEUTRAL_GAMMA, 100), warmed);
+    CHECK(composed == twoSteps, "temperature then red shift");
+}
+
+static void testKeys() {
+    CHECK(key(PIXEL_STAGE_NEUTRAL_KELVIN) == 0, "neutral key 0");
+    CHECK(key(3000) != key(3100), "temperature in key");
+    CHECK(key(3000) != key(3000, 120), "gamma in key");
+    CHECK(key(3000) != key(3000, PIXEL_STAGE_NEUTRAL_GAMMA, 10), "red shift in key");
+    CHECK(key(PIXEL_STAGE_NEUTRAL_KELVIN, 120) != 0 && key(PIXEL_STAGE_NEUTRAL_KELVIN, 100, 1) != 0,
+          "gamma or red shift alone not neutral");
+    CHECK(key(3000, 500, 400) == key(3000, 255, 100), "out-of-range settings clamped");
+}
+
+static void testCopyAndRect() {
+    PixelStage s = build(3000);
+    std::vector<uint16_t> src(200);
+    for (size_t i = 0; i < src.size(); i++) src[i] = (uint16_t)(i * 331 + 7);
+    std::vector<uint16_t> inPlace = src, copied(src.size());
+    pixelStageApply(s, inPlace.data(), inPlace.size());
+    pixelStageCopy(s, copied.data(), src.data(), src.size());
+    CHECK(copied == inPlace, "copy + process equals process in place");
+
+    // 20x10 frame, 6x4 rect at (3, 2)
+    std::vector<uint16_t> frame = src;
+    pixelStageApplyRect(s, frame.data() + 2 * 20 + 3, 20, 6, 4);
+    bool ok = true;
+    for (int y = 0; y < 10; y++) {
+        for (int x = 0; x < 20; x++) {
+            bool inside = x >= 3 && x < 9 && y >= 2 && y < 6;
+            uint16_t want = inside ? inPlace[y * 20 + x] : src[y * 20 + x];
+            ok = ok && frame[y * 20 + x] == want;
+        }
+    }
+    CHECK(ok, "rect processes only its own pixels");
+}
+
+int main(void) {
+    testMatchesRenderPass();
+    testNeutral();
+    testRedShiftAndGamma();
+    testKeys();
+    testCopyAndRect();
+
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -0,0 +1,300 @@
+// test/test_render_geometry.cpp
+// Host test for the transform geometry: on-screen size under rotation and the
+// decode-time reduction picked from the final scale (and its zoom-in check),
+// the visible part of a frame under each rotation, where a decoded crop of it
+// is drawn, the draw scale / coarseness of prescaled frames, the bands left
+// uncovered when the drawn rectangle moves, and the PPA blocks for drawing
+// straight into the panel.
+//
+//   g++ -std=c++17 -O2 test/test_render_geometry.cpp render_geometry.cpp -o /tmp/t && /tmp/t
+#include "../render_geometry.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static void testScaledSize() {
+    int w, h;
+    renderScaledSize(1024, 768, 0.5f, 0.5f, 0.0f, &w, &h);
+    CHECK(w == 512 && h == 384, "plain scale");
+    renderScaledSize(1024, 768, 0.5f, 0.25f, 90.0f, &w, &h);
+    CHECK(w == 384 && h == 256, "90 degrees swaps axes before scaling");
+    renderScaledSize(1024, 768, 0.5f, 0.25f, 180.0f, &w, &h);
+    CHECK(w == 512 && h == 192, "180 degrees keeps axes");
+}
+
+static void testDecodeReduction() {
+    // 1024px source on a 720px panel at the default 1.2 scale: full size
+    CHECK(renderDecodeReduction(1.2f, 1.2f, 8) == 1, "upscaled frame keeps full size");
+    CHECK(renderDecodeReduction(1.0f, 1.0f, 8) == 1, "1:1 keeps full size");
+    CHECK(renderDecodeReduction(0.7f, 0.7f, 8) == 1, "0.7 needs more than half");
+    CHECK(renderDecodeReduction(0.5f, 0.5f, 8) == 2, "exactly half");
+    CHECK(renderDecodeReduction(0.3f, 0.3f, 8) == 2, "0.3 -> 1/2");
+    CHECK(renderDecodeReduction(0.25f, 0.25f, 8) == 4, "0.25 -> 1/4");
+    CHECK(renderDecodeReduction(0.1f, 0.1f, 8) == 8, "0.1 -> 1/8");
+    CHECK(renderDecodeReduction(0.01f, 0.01f, 8) == 8, "never beyond 1/8");
+    CHECK(renderDecodeReduction(0.5001f, 0.5f, 8) == 1, "just over half");
+
+    // The larger of the two axis scales decides
+    CHECK(renderDecodeReduction(0.25f, 0.6f, 8) == 1, "tall stretch limits reduction");
+    CHECK(renderDecodeReduction(0.25f, 0.5f, 8) == 2, "anisotropic scale");
+
+    // Cap: a frame already decoded at 1/2 to fit the buffer has only 4x left
+    CHECK(renderDecodeReduction(0.1f, 0.1f, 4) == 4, "capped by maxReduction");
+    CHECK(renderDecodeReduction(0.1f, 0.1f, 1) == 1, "no reduction left");
+    CHECK(renderDecodeReduction(0.0f, 0.0f, 8) == 1, "degenerate scale");
+
+    // The render-side check agrees with the decode-side choice: a frame
+    // decoded at r for scale s is too coarse exactly when s grows past 1/r
+    int r = renderDecodeReduction(0.3f, 0.3f, 8);
+    CHECK(renderDecodeReduction(0.3f, 0.3f, r) == r, "same scale is not too coarse");
+    CHECK(renderDecodeReduction(0.6f, 0.6f, r) < r, "zoom-in detected");
+    int w, h;
+    renderScaledSize(1000 / r, 1000 / r, 0.3f * r, 0.3f * r, 90.0f, &w, &h);
+    CHECK(w == 300 && h == 300, "reduced frame keeps its on-screen size");
+}
+
+static void testVisibleRect() {
+    RenderRect r;
+    // Whole frame on the panel
+    CHECK(renderVisibleRect(1024, 768, 0.5f, 0.5f, 0.0f, 0, 0, 720, 720, &r), "fits: visible");
+    CHECK(r.x == 0 && r.y == 0 && r.w == 1024 && r.h == 768, "fits: whole frame");
+
+    // 2x zoom, centred: the middle 360x360 of the frame
+    CHECK(renderVisibleRect(1024, 1024, 2.0f, 2.0f, 0.0f, 0, 0, 720, 720, &r), "zoom: visible");
+    CHECK(r.x == 332 && r.y == 332 && r.w == 360 && r.h == 360, "zoom: centre crop");
+
+    // Pan right by 200 screen px: 100 frame px further left of the frame
+    renderVisibleRect(1024, 1024, 2.0f, 2.0f, 0.0f, 200, 0, 720, 720, &r);
+    CHECK(r.x == 232 && r.w == 360 && r.y == 332, "pan shifts crop");
+
+    // Off the panel entirely
+    CHECK(!renderVisibleRect(1024, 1024, 1.0f, 1.0f, 0.0f, 2000, 0, 720, 720, &r), "off-panel");
+
+    // A frame that only covers the left part of the panel: wide, 1.0 scale,
+    // panned so its right half is off the right edge
+    renderVisibleRect(1000, 400, 1.0f, 1.0f, 0.0f, 500, 0, 720, 720, &r);
+    CHECK(r.x == 0 && r.w == 360 && r.y == 0 && r.h == 400, "partly off the right edge");
+
+    // Rotations: pan so the drawn frame's left half is visible, then check
+    // which frame edge that is (scale 1, panned right by 400: drawn columns
+    // 0..359 are shown)
+    renderVisibleRect(800, 400, 1.0f, 1.0f, 0.0f, 400, 0, 720, 720, &r);
+    CHECK(r.x == 0 && r.w == 360 && r.h == 400, "0: left columns");
+    renderVisibleRect(800, 400, 1.0f, 1.0f, 180.0f, 400, 0, 720, 720, &r);
+    CHECK(r.x == 440 && r.w == 360 && r.h == 400, "180: right columns");
+    // Counter-clockwise: the drawn left edge is the frame's top row
+    renderVisibleRect(400, 800, 1.0f, 1.0f, 90.0f, 400, 0, 720, 720, &r);
+    CHECK(r.x == 0 && r.y == 0 && r.w == 400 && r.h == 360, "90: drawn left is frame's top");
+    renderVisibleRect(400, 800, 1.0f, 1.0f, 270.0f, 400, 0, 720, 720, &r);
+    CHECK(r.x == 0 && r.y == 440 && r.w == 400 && r.h == 360, "270: drawn left is frame's bottom");
+}
+
+static void testAlignAndContain() {
+    RenderRect r = { 332, 332, 360, 360 };
+    renderAlignRect(&r, 16, 16, 1024, 1024);
+    CHECK(r.x == 304 && r.y == 304, "margin then align down");
+    CHECK(r.x + r.w == 720 && r.y + r.h == 720, "margin then align up");
+
+    RenderRect e = { 5, 1000, 10, 20 };
+    renderAlignRect(&e, 16, 16, 1024, 1010);
+    CHECK(e.x == 0 && e.y == 976 && e.x + e.w == 32 && e.y + e.h == 1010, "clipped to the frame");
+
+    RenderRect outer = { 304, 304, 416, 416 };
+    RenderRect in = { 332, 332, 360, 360 };
+    RenderRect out = { 232, 332, 360, 360 };
+    CHECK(renderRectContains(outer, in), "contains");
+    CHECK(!renderRectContains(outer, out), "panned out");
+    CHECK(renderRectContains(outer, outer), "contains itself");
+}
+
+static void testCropPlacement() {
+    RenderRect p;
+    RenderRect whole = { 0, 0, 1024, 768 };
+    int w, h;
+    for (int rot = 0; rot < 360; rot += 90) {
+        renderCropPlacement(1024, 768, whole, 0.5f, 0.5f, (float)rot, &p);
+        renderScaledSize(1024, 768, 0.5f, 0.5f, (float)rot, &w, &h);
+        CHECK(p.x == 0 && p.y == 0 && p.w == w && p.h == h, "whole frame sits at the frame origin");
+    }
+
+    // The visible crop is drawn where it covers the panel, for every rotation
+    for (int rot = 0; rot < 360; rot += 90) {
+        RenderRect v;
+        renderVisibleRect(1000, 600, 2.0f, 2.0f, (float)rot, 150, -80, 720, 720, &v);
+        renderCropPlacement(1000, 600, v, 2.0f, 2.0f, (float)rot, &p);
+        renderScaledSize(1000, 600, 2.0f, 2.0f, (float)rot, &w, &h);
+        int left = 360 - w / 2 + 150 + p.x;
+        int top = 360 - h / 2 - 80 + p.y;
+        CHECK(left <= 0 && top <= 0 && left + p.w >= 720 && top + p.h >= 720, "crop covers the panel");
+        CHECK(left > -2 && top > -2 && left + p.w < 722 && top + p.h < 722, "crop is no larger than needed");
+    }
+}
+
+static void testCropInPlace() {
+    uint16_t px[6 * 4];
+    for (int i = 0; i < 24; i++) px[i] = (uint16_t)i;
+    RenderRect c = { 2, 1, 3, 2 };
+    renderCropInPlace(px, 6, c);
+    CHECK(px[0] == 8 && px[1] == 9 && px[2] == 10, "first row moved");
+    CHECK(px[3] == 14 && px[4] == 15 && px[5] == 16, "second row moved");
+}
+
+static void testPrescaledLayout() {
+    float dx, dy;
+    FrameLayout plain = { 0, 0, 0, 0, 1, 1.0f, 1.0f };
+    frameDrawScale(plain, 0.6f, 0.4f, &dx, &dy);
+    CHECK(dx == 0.6f && dy == 0.4f, "plain frame drawn at the transform scale");
+    CHECK(!frameTooCoarse(plain, 1.5f, 1.5f), "full resolution is never too coarse");
+
+    // Decoded at 1/2, stored at 0.25 of that: drawn at 0.3 * 2 / 0.25
+    FrameLayout pre = { 0, 0, 0, 0, 2, 0.25f, 0.25f };
+    frameDrawScale(pre, 0.3f, 0.3f, &dx, &dy);
+    CHECK(dx > 2.39f && dx < 2.41f, "prescaled frame drawn up to its on-screen size");
+
+    // Stored at exactly the wanted scale: 1:1 on screen and not coarse
+    FrameLayout fit = { 0, 0, 0, 0, 1, 0.3f, 0.3f };
+    frameDrawScale(fit, 0.3f, 0.3f, &dx, &dy);
+    CHECK(dx == 1.0f && dy == 1.0f, "stored at the drawn size");
+    CHECK(!frameTooCoarse(fit, 0.3f, 0.3f), "same scale is not too coarse");
+    CHECK(!frameTooCoarse(fit, 0.2f, 0.3f), "zoom-out is not too coarse");
+    CHECK(frameTooCoarse(fit, 0.3f, 0.45f), "zoom-in on one axis detected");
+
+    // Reduced without prescale: agrees with renderDecodeReduction
+    FrameLayout red = { 0, 0, 0, 0, 4, 1.0f, 1.0f };
+    CHECK(!frameTooCoarse(red, 0.25f, 0.25f), "reduction absorbed by the scale");
+    CHECK(frameTooCoarse(red, 0.3f, 0.25f) == (renderDecodeReduction(0.3f, 0.25f, 4) < 4),
+          "matches the decode-side choice");
+    // Past full resolution nothing more can be had than undoing the reduction
+    FrameLayout half = { 0, 0, 0, 0, 1, 0.5f, 0.5f };
+    CHECK(frameTooCoarse(half, 3.0f, 3.0f), "prescaled frame zoomed past 1:1");
+    CHECK(!frameTooCoarse(plain, 3.0f, 3.0f), "capped at full resolution");
+}
+
+static void testUncoveredBands() {
+    RenderRect bands[4];
+    RenderRect prev = { 10, 10, 100, 80 };
+    CHECK(renderUncoveredBands(prev, prev, bands) == 0, "same rectangle leaves nothing");
+    RenderRect inside = { 0, 0, 200, 200 };
+    CHECK(renderUncoveredBands(prev, inside, bands) == 0, "covered rectangle leaves nothing");
+    RenderRect apart = { 300, 300, 10, 10 };
+    CHECK(renderUncoveredBands(prev, apart, bands) == 1 && bands[0].x == 10 && bands[0].w == 100,
+          "no overlap: all of prev");
+
+    // Moved right and down by 5: left band full height, top band across the overlap
+    RenderRect moved = { 15, 15, 100, 80 };
+    int n = renderUncoveredBands(prev, moved, bands);
+    int area = 0;
+    for (int i = 0; i < n; i++) area += bands[i].w * bands[i].h;
+    CHECK(n == 2 && area == 100 * 80 - 95 * 75, "moved: exactly the uncovered pixels");
+
+    // Shrunk in place: four bands, none overlapping the new rectangle
+    RenderRect shrunk = { 30, 30, 20, 20 };
+    n = renderUncoveredBands(prev, shrunk, bands);
+    area = 0;
+    bool clear = true;
+    for (int i = 0; i < n; i++) {
+        area += bands[i].w * bands[i].h;
+        RenderRect b = bands[i];
+        clear = clear && (b.x + b.w <= 30 || b.x >= 50 || b.y + b.h <= 30 || b.y >= 50);
+    }
+    CHECK(n == 4 && clear && area == 100 * 80 - 20 * 20, "shrunk: four bands around it");
+
+    RenderRect r = { -10, 700, 50, 50 };
+    CHECK(renderClipRect(&r, 720, 720) && r.x == 0 && r.w == 40 && r.y == 700 && r.h == 20, "clip");
+    RenderRect off = { 720, 0, 5, 5 };
+    CHECK(!renderClipRect(&off, 720, 720), "off the panel");
+}
+
+static void testPanelBlit() {
+    const int W = 1000, H = 800, PW = 720, PH = 720;
+    const float rots[] = { 0.0f, 90.0f, 180.0f, 270.0f };
+    const float scales[] = { 0.72f, 0.5f, 1.5f };
+    const int offs[] = { -400, -37, 0, 13, 250, 700 };
+    bool inPanel = true, inPicture = true, placed = true, tight = true, whole = true;
+    for (float rot : rots) {
+        bool quarter = rot == 90.0f || rot == 270.0f;
+        for (float sc : scales) {
+            int dw = (int)((quarter ? H : W) * sc), dh = (int)((quarter ? W : H) * sc);
+            for (int ox : offs) {
+                for (int oy : offs) {
+                    RenderBlit b;
+                    bool any = ox < PW && oy < PH && ox + dw > 0 && oy + dh > 0;
+                    if (!renderPanelBlit(W, H, sc, sc, rot, ox, oy, PW, PH, &b)) {
+                        // Only a sliver too thin for a whole source pixel may be refused
+                        tight = tight && (!any || ox + dw < sc + 1 || oy + dh < sc + 1 ||
+                                          PW - ox < sc + 1 || PH - oy < sc + 1);
+                        continue;
+                    }
+                    RenderRect o = b.out;
+                    inPanel = inPanel && o.x >= 0 && o.y >= 0 && o.x + o.w <= PW && o.y + o.h <= PH;
+                    inPicture = inPicture && b.in.x >= 0 && b.in.y >= 0 &&
+                                b.in.x + b.in.w <= W && b.in.y + b.in.h <= H;
+                    // What the PPA writes for the block, rotated
+                    int bw = quarter ? (int)(b.in.h * sc) : (int)(b.in.w * sc);
+                    int bh = quarter ? (int)(b.in.w * sc) : (int)(b.in.h * sc);
+                    placed = placed && bw == o.w && bh == o.h;
+
+                    // The block's first panel pixel shows (within a pixel) the
+                    // picture pixel that belongs there
+                    int bx = quarter ? b.in.y : b.in.x, by = quarter ? b.in.x : b.in.y;
+                    int bxw = quarter ? b.in.h : b.in.w, byh = quarter ? b.in.w : b.in.h;
+                    int lenX = quarter ? H : W, lenY = quarter ? W : H;
+                    bool revX = rot == 180.0f || rot == 270.0f, revY = rot == 90.0f || rot == 180.0f;
+                    double wantX = (revX ? lenX - bx - bxw : bx) * sc + ox;
+                    double wantY = (revY ? lenY - by - byh : by) * sc + oy;
+                    placed = placed && fabs(o.x - wantX) < 1.0 + 1e-6 && fabs(o.y - wantY) < 1.0 + 1e-6;
+
+                    // Nothing visible lost beyond a source pixel at each cut
+                    int vx0 = ox < 0 ? 0 : ox, vy0 = oy < 0 ? 0 : oy;
+                    int vx1 = ox + dw < PW ? ox + dw : PW, vy1 = oy + dh < PH ? oy + dh : PH;
+                    double slack = sc + 1;
+                    tight = tight && o.x - vx0 <= slack && vx1 - (o.x + o.w) <= slack &&
+                            o.y - vy0 <= slack && vy1 - (o.y + o.h) <= slack;
+
+                    // On the panel entirely: the whole picture, where it was asked for
+                    if (ox >= 0 && oy >= 0 && ox + dw <= PW && oy + dh <= PH) {
+                        whole = whole && b.in.x == 0 && b.in.y == 0 && b.in.w == W && b.in.h == H &&
+                                o.x == ox && o.y == oy && o.w == dw && o.h == dh;
+                    }
+                }
+            }
+        }
+    }
+    CHECK(inPanel, "blit writes only inside the panel");
+    CHECK(inPicture, "blit reads only inside the picture");
+    CHECK(placed, "blit block lands where the picture puts it");
+    CHECK(tight, "blit loses at most a source pixel at a cut");
+    CHECK(whole, "picture on the panel is drawn whole");
+
+    RenderBlit b;
+    CHECK(!renderPanelBlit(W, H, 0.5f, 0.5f, 0.0f, 720, 0, PW, PH, &b), "off the right edge");
+    CHECK(!renderPanelBlit(W, H, 0.5f, 0.5f, 90.0f, 0, -500, PW, PH, &b), "off the top");
+
+    // 90: panel x runs along picture y, so a cut on the left drops picture rows
+    CHECK(renderPanelBlit(W, H, 0.5f, 0.5f, 90.0f, -100, 0, PW, PH, &b) &&
+          b.in.x == 0 && b.in.w == W && b.in.y == 200 && b.in.h == H - 200 && b.out.x == 0,
+          "90 degrees: left cut trims the top of the picture");
+    // 180: a cut on the left drops the picture's right-hand columns
+    CHECK(renderPanelBlit(W, H, 0.5f, 0.5f, 180.0f, -100, 0, PW, PH, &b) &&
+          b.in.x == 0 && b.in.w == W - 200 && b.out.x == 0 && b.out.w == 400,
+          "180 degrees: left cut trims the right of the picture");
+}
+
+int main(void) {
+    testScaledSize();
+    testDecodeReduction();
+    testVisibleRect();
+    testAlignAndContain();
+    testCropPlacement();
+    testCropInPlace();
+    testPrescaledLayout();
+    testUncoveredBands();
+    testPanelBlit();
+
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
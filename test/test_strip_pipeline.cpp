@@ -0,0 +1,306 @@
+// test/test_strip_pipeline.cpp
+// Host test for the strip-pipelined decode -> scale: strips assembled from
+// decoder blocks and scaled one at a time must give exactly the whole-frame
+// bilinear result, for any block layout and kept window, and ring buffers
+// must not be reused before an asynchronous sink has reclaimed them. The box
+// (area-average) scale must give the exact area mean at whole and fractional
+// ratios, the same pixels strip by strip and band by band as in one go, and
+// refuse to upscale.
+//
+//   g++ -std=c++17 -O2 test/test_strip_pipeline.cpp strip_pipeline.cpp pixel_kernels.cpp render_geometry.cpp -o /tmp/t && /tmp/t
+#include "../strip_pipeline.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static std::vector<uint16_t> makeFrame(int w, int h, unsigned seed) {
+    std::vector<uint16_t> f((size_t)w * h);
+    srand(seed);
+    for (size_t i = 0; i < f.size(); i++) f[i] = (uint16_t)(rand() & 0xFFFF);
+    return f;
+}
+
+static std::vector<uint16_t> subFrame(const std::vector<uint16_t>& f, int w, const RenderRect& r) {
+    std::vector<uint16_t> s((size_t)r.w * r.h);
+    for (int y = 0; y < r.h; y++) {
+        memcpy(&s[(size_t)y * r.w], &f[(size_t)(r.y + y) * w + r.x], (size_t)r.w * 2);
+    }
+    return s;
+}
+
+// Feed a frame to the assembler the way JPEGDEC does: MCU rows of mcuH,
+// split into blocks of blockW, left to right
+static bool feed(StripAssembler& a, const std::vector<uint16_t>& f, int w, int h, int mcuH, int blockW) {
+    std::vector<uint16_t> block((size_t)blockW * mcuH);
+    for (int y = 0; y < h; y += mcuH) {
+        int bh = (y + mcuH <= h) ? mcuH : h - y;
+        for (int x = 0; x < w; x += blockW) {
+            int bw = (x + blockW <= w) ? blockW : w - x;
+            for (int r = 0; r < bh; r++) memcpy(&block[(size_t)r * bw], &f[(size_t)(y + r) * w + x], (size_t)bw * 2);
+            if (!a.draw(x, y, bw, bh, block.data())) return false;
+        }
+    }
+    return a.finish();
+}
+
+struct Ring {
+    std::vector<uint16_t> storage[STRIP_MAX_SLOTS];
+    uint16_t* ptrs[STRIP_MAX_SLOTS];
+    Ring(int w) {
+        for (int i = 0; i < STRIP_MAX_SLOTS; i++) {
+            storage[i].assign((size_t)w * STRIP_MAX_ROWS, 0);
+            ptrs[i] = storage[i].data();
+        }
+    }
+};
+
+static void testScaledMatchesWholeFrame(int w, int h, int dw, int dh, int mcuH, int blockW, const char* msg) {
+    std::vector<uint16_t> f = makeFrame(w, h, (unsigned)(w * 31 + h));
+    std::vector<uint16_t> ref((size_t)dw * dh), out((size_t)dw * dh, 0);
+    stripBilinearScale(f.data(), w, h, ref.data(), dw, dh);
+
+    std::vector<uint16_t> carry(w);
+    StripScaler scaler;
+    scaler.begin(w, h, dw, dh, out.data(), carry.data());
+    Ring ring(w);
+    StripAssembler a;
+    RenderRect all = { 0, 0, w, h };
+    CHECK(a.begin(all, ring.ptrs, 2, &scaler), msg);
+    CHECK(feed(a, f, w, h, mcuH, blockW), msg);
+    CHECK(scaler.rowsWritten() == dh, msg);
+    CHECK(out == ref, msg);
+}
+
+static void testWindow() {
+    int w = 120, h = 90;
+    std::vector<uint16_t> f = makeFrame(w, h, 7);
+    RenderRect win = { 16, 24, 64, 40 };
+    std::vector<uint16_t> sub = subFrame(f, w, win);
+
+    // Unscaled: the kept window is copied out exactly
+    std::vector<uint16_t> copy((size_t)win.w * win.h, 0);
+    StripCopySink copySink;
+    copySink.begin(win.w, copy.data(), win.h);
+    Ring ring(win.w);
+    StripAssembler a;
+    a.begin(win, ring.ptrs, 2, &copySink);
+    CHECK(feed(a, f, w, h, 16, 24), "window copy fed");
+    CHECK(copySink.rowsWritten() == win.h && copy == sub, "window copied exactly");
+
+    // Scaled: same as scaling the cut-out window in one go
+    int dw = 37, dh = 23;
+    std::vector<uint16_t> ref((size_t)dw * dh), out((size_t)dw * dh, 0);
+    stripBilinearScale(sub.data(), win.w, win.h, ref.data(), dw, dh);
+    std::vector<uint16_t> carry(win.w);
+    StripScaler scaler;
+    scaler.begin(win.w, win.h, dw, dh, out.data(), carry.data());
+    StripAssembler b;
+    b.begin(win, ring.ptrs, 2, &scaler);
+    CHECK(feed(b, f, w, h, 8, 40), "window scale fed");
+    CHECK(out == ref, "scaled window matches cut-out scale");
+
+    // Window starting mid-MCU-row (not aligned): first strip is partial
+    RenderRect odd = { 3, 5, 50, 30 };
+    std::vector<uint16_t> oddSub = subFrame(f, w, odd);
+    std::vector<uint16_t> oddOut((size_t)odd.w * odd.h, 0);
+    StripCopySink oddSink;
+    oddSink.begin(odd.w, oddOut.data(), odd.h);
+    StripAssembler c;
+    c.begin(odd, ring.ptrs, 3, &oddSink);
+    CHECK(feed(c, f, w, h, 16, 16) && oddOut == oddSub, "unaligned window");
+}
+
+// Reads each strip only when it is reclaimed or at finish, like the PPA does
+// asynchronously; output is only right if the assembler never overwrote a
+// ring buffer still in flight
+class LazySink : public StripSink {
+public:
+    LazySink(int w, uint16_t* dst) : width(w), out(dst) {}
+    bool consume(const uint16_t* strip, int y, int h, uint32_t seq) override {
+        pending.push_back({ strip, y, h, seq });
+        if (pending.size() > (size_t)maxInFlight) maxInFlight = (int)pending.size();
+        return true;
+    }
+    bool reclaim(uint32_t seq) override {
+        reclaims++;
+        while (!pending.empty() && pending.front().seq <= seq) complete();
+        return true;
+    }
+    bool finish() override {
+        while (!pending.empty()) complete();
+        return true;
+    }
+    int rowsWritten() const override { return rows; }
+    int maxInFlight = 0;
+    int reclaims = 0;
+
+private:
+    struct Job { const uint16_t* strip; int y, h; uint32_t seq; };
+    void complete() {
+        Job j = pending.front();
+        pending.erase(pending.begin());
+        memcpy(out + (size_t)j.y * width, j.strip, (size_t)j.h * width * 2);
+        rows = j.y + j.h;
+    }
+    int width;
+    uint16_t* out;
+    int rows = 0;
+    std::vector<Job> pending;
+};
+
+static void testAsyncReclaim() {
+    int w = 64, h = 100;
+    std::vector<uint16_t> f = makeFrame(w, h, 11);
+    std::vector<uint16_t> out((size_t)w * h, 0);
+    LazySink sink(w, out.data());
+    Ring ring(w);
+    StripAssembler a;
+    RenderRect all = { 0, 0, w, h };
+    a.begin(all, ring.ptrs, 2, &sink);
+    CHECK(feed(a, f, w, h, 16, 16), "async fed");
+    CHECK(out == f, "no ring buffer overwritten in flight");
+    CHECK(sink.maxInFlight == 2, "two strips in flight with two buffers");
+    CHECK(a.strips() == 7 && sink.reclaims == 5, "strip and reclaim counts");
+}
+
+static void testQuantize() {
+    CHECK(stripQuantizeScale(0.5f) == 0.5f, "exact sixteenth kept");
+    CHECK(stripQuantizeScale(0.49f) == 0.5f, "rounded up");
+    CHECK(stripQuantizeScale(0.3f) == 0.3125f, "0.3 -> 5/16");
+    CHECK(stripQuantizeScale(0.01f) == 0.0625f, "at least 1/16");
+    CHECK(stripQuantizeScale(1.0f) == 1.0f, "one stays one");
+}
+
+static void testBilinearRange() {
+    // Flat colour must survive the blend unchanged (no overflow, no drift)
+    std::vector<uint16_t> f(50 * 40, 0xFFFF), out(17 * 13);
+    stripBilinearScale(f.data(), 50, 40, out.data(), 17, 13);
+    bool flat = true;
+    for (uint16_t p : out) flat = flat && p == 0xFFFF;
+    CHECK(flat, "white stays white");
+    std::fill(f.begin(), f.end(), 0x8410);
+    stripBilinearScale(f.data(), 50, 40, out.data(), 17, 13);
+    flat = true;
+    for (uint16_t p : out) flat = flat && p == 0x8410;
+    CHECK(flat, "grey stays grey");
+}
+
+// Area mean in double precision, rounded to the nearest level per channel
+static std::vector<uint16_t> boxReference(const std::vector<uint16_t>& f, int w, int h, int dw, int dh) {
+    std::vector<uint16_t> out((size_t)dw * dh);
+    double sx = (double)w / dw, sy = (double)h / dh;
+    for (int j = 0; j < dh; j++) {
+        for (int i = 0; i < dw; i++) {
+            double x0 = i * sx, x1 = x0 + sx, y0 = j * sy, y1 = y0 + sy;
+            double r = 0, g = 0, b = 0;
+            for (int y = (int)y0; y < h && y < y1; y++) {
+                double wy = fmin(y + 1, y1) - fmax(y, y0);
+                for (int x = (int)x0; x < w && x < x1; x++) {
+                    double wt = wy * (fmin(x + 1, x1) - fmax(x, x0));
+                    uint16_t p = f[(size_t)y * w + x];
+                    r += wt * (p >> 11);
+                    g += wt * ((p >> 5) & 0x3F);
+                    b += wt * (p & 0x1F);
+                }
+            }
+            double area = sx * sy;
+            out[(size_t)j * dw + i] = (uint16_t)(((int)floor(r / area + 0.5) << 11) |
+                                                 ((int)floor(g / area + 0.5) << 5) | (int)floor(b / area + 0.5));
+        }
+    }
+    return out;
+}
+
+static int maxChannelDiff(const std::vector<uint16_t>& a, const std::vector<uint16_t>& b) {
+    int worst = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        int dr = abs((a[i] >> 11) - (b[i] >> 11));
+        int dg = abs(((a[i] >> 5) & 0x3F) - ((b[i] >> 5) & 0x3F));
+        int db = abs((a[i] & 0x1F) - (b[i] & 0x1F));
+        int d = dr > dg ? dr : dg;
+        d = d > db ? d : db;
+        if (d > worst) worst = d;
+    }
+    return worst;
+}
+
+static void testBoxMean(int w, int h, int dw, int dh, const char* msg) {
+    std::vector<uint16_t> f = makeFrame(w, h, (unsigned)(w + h * 7));
+    std::vector<uint16_t> out((size_t)dw * dh, 0);
+    CHECK(stripBoxScale(f.data(), w, h, out.data(), dw, dh), msg);
+    // Exact integer sums; only a tie the double reference rounds the other
+    // way may differ, by one level
+    CHECK(maxChannelDiff(out, boxReference(f, w, h, dw, dh)) <= 1, msg);
+}
+
+static void testBoxExact() {
+    // Whole 2x2 boxes: the mean of four pixels, rounded
+    std::vector<uint16_t> f = { 0x0000, 0x0841, 0x1082, 0x18C3,    // r,g,b = 0,1,2,3 (x2 green)
+                                0x0841, 0x0841, 0x18C3, 0x18C3 };
+    std::vector<uint16_t> out(2);
+    CHECK(stripBoxScale(f.data(), 4, 2, out.data(), 2, 1), "2x2 box runs");
+    CHECK(out[0] == 0x0841 && out[1] == 0x18C3, "2x2 box is the rounded mean");
+
+    // Flat colours survive any ratio
+    std::vector<uint16_t> white(97 * 61, 0xFFFF), grey(97 * 61, 0x8410), o(23 * 17);
+    stripBoxScale(white.data(), 97, 61, o.data(), 23, 17);
+    bool flat = true;
+    for (uint16_t p : o) flat = flat && p == 0xFFFF;
+    CHECK(flat, "box: white stays white");
+    stripBoxScale(grey.data(), 97, 61, o.data(), 23, 17);
+    flat = true;
+    for (uint16_t p : o) flat = flat && p == 0x8410;
+    CHECK(flat, "box: grey stays grey");
+
+    StripBoxScaler up;
+    CHECK(!up.begin(10, 10, 11, 10, o.data()), "box refuses to upscale");
+}
+
+static void testBoxStripsAndBands() {
+    int w = 181, h = 143, dw = 50, dh = 37;
+    std::vector<uint16_t> f = makeFrame(w, h, 21);
+    std::vector<uint16_t> ref((size_t)dw * dh), out((size_t)dw * dh, 0);
+    stripBoxScale(f.data(), w, h, ref.data(), dw, dh);
+
+    StripBoxScaler box;
+    CHECK(box.begin(w, h, dw, dh, out.data()), "box strip scaler starts");
+    Ring ring(w);
+    StripAssembler a;
+    RenderRect all = { 0, 0, w, h };
+    a.begin(all, ring.ptrs, 2, &box);
+    CHECK(feed(a, f, w, h, 16, 48), "box strips fed");
+    CHECK(box.rowsWritten() == dh && out == ref, "box strip by strip matches one go");
+
+    // Bands with boundaries inside a straddling source row
+    std::vector<uint16_t> banded((size_t)dw * dh, 0);
+    const int cuts[] = { 0, 5, 6, 19, 36, 37 };
+    bool ok = true;
+    for (int i = 0; i + 1 < 6; i++) ok = ok && stripBoxScale(f.data(), w, h, banded.data(), dw, dh, cuts[i], cuts[i + 1]);
+    CHECK(ok && banded == ref, "box band by band matches one go");
+}
+
+int main(void) {
+    testScaledMatchesWholeFrame(97, 61, 40, 25, 16, 32, "downscale, 16-row MCUs");
+    testScaledMatchesWholeFrame(97, 61, 40, 25, 8, 97, "downscale, 8-row MCUs, full-width blocks");
+    testScaledMatchesWholeFrame(64, 64, 60, 63, 16, 16, "slight downscale");
+    testScaledMatchesWholeFrame(33, 17, 5, 3, 2, 7, "tiny output, small MCUs");
+    testWindow();
+    testAsyncReclaim();
+    testQuantize();
+    testBilinearRange();
+    testBoxMean(1808, 1808 / 4, 720, 720 / 4, "box 1808 -> 720 (fractional)");
+    testBoxMean(400, 300, 100, 75, "box whole ratio 4");
+    testBoxMean(97, 61, 40, 25, "box odd sizes");
+    testBoxMean(64, 64, 64, 21, "box one axis only");
+    testBoxExact();
+    testBoxStripsAndBands();
+
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
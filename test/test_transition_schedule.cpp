@@ -0,0 +1,69 @@
+// test/test_transition_schedule.cpp
+// Host test for the image-change transition schedule: frame counts, the
+// in-place cross-fade tracking a straight mix of the two frames at every
+// step (blending as the PPA does, 8-bit alpha, rounded each step) and ending
+// exactly on the new frame, and the slide easing out to its place.
+//
+//   g++ -std=c++17 -O2 test/test_transition_schedule.cpp transition_schedule.cpp -o /tmp/t && /tmp/t
+#include "../transition_schedule.h"
+#include <math.h>
+#include <stdio.h>
+
+static int failures = 0;
+#define CHECK(cond, msg) do { if (!(cond)) { printf("FAIL: %s\n", msg); failures++; } } while (0)
+
+static void testSteps() {
+    CHECK(transitionSteps(500, 30) == 15, "500 ms at 30 fps");
+    CHECK(transitionSteps(0, 30) == 1, "no duration is one step");
+    CHECK(transitionSteps(10, 30) == 1, "shorter than a frame is one step");
+}
+
+static void testFade() {
+    const int stepCounts[] = { 1, 2, 5, 15, 30 };
+    int worst = 0;
+    bool exact = true;
+    for (int steps : stepCounts) {
+        CHECK(transitionFadeAlpha(steps, steps) == 255, "last fade step replaces");
+        for (int oldV = 0; oldV < 256; oldV += 15) {
+            for (int newV = 0; newV < 256; newV += 17) {
+                int v = oldV;
+                for (int k = 1; k <= steps; k++) {
+                    int a = transitionFadeAlpha(k, steps);
+                    v = (newV * a + v * (255 - a) + 127) / 255;
+                    double ideal = oldV + (newV - oldV) * (double)k / steps;
+                    int err = (int)fabs(v - ideal + 0.0);
+                    if (err > worst) worst = err;
+                }
+                exact = exact && v == newV;
+            }
+        }
+    }
+    printf("fade: worst step off a straight mix by %d of 255\n", worst);
+    CHECK(exact, "fade ends exactly on the new frame");
+    CHECK(worst <= 4, "every fade step close to a straight mix");
+}
+
+static void testSlide() {
+    const int steps = 15, width = 720;
+    bool falling = true;
+    int prev = width;
+    for (int k = 1; k <= steps; k++) {
+        int off = transitionSlideOffset(k, steps, width);
+        falling = falling && off <= prev && off >= 0;
+        prev = off;
+    }
+    CHECK(falling, "slide moves only towards its place");
+    CHECK(prev == 0, "slide ends in place");
+    // Easing out: the first step covers more than an even share
+    CHECK(width - transitionSlideOffset(1, steps, width) > width / steps, "slide starts fast");
+}
+
+int main(void) {
+    testSteps();
+    testFade();
+    testSlide();
+
+    if (failures == 0) { printf("PASS\n"); return 0; }
+    printf("%d check(s) failed\n", failures);
+    return 1;
+}
@@ -1,25 +1,103 @@
 # tools/bake_moon_texture.py
-# Downsamples ESP32-P4-NINA-Display/main/moon_texture.png (500x500 RGBA)
-# to 256x256 luminance+alpha and emits a C header (128 KB flash).
-from PIL import Image
+# Bakes the equirectangular lunar map into the RGB565 image the firmware maps
+# straight out of the `moontex` flash partition (partitions.csv), so boot does
+# no JPEG decode and holds no PSRAM copy of the texture.
+#
+#   python tools/bake_moon_texture.py [source image] [-o moon_texture.bin] [--levels N]
+#
+# With no source image the JPEG bytes are read back out of moon_equirect_data.h,
+# so the baked map is the one the firmware would otherwise decode. Flash the
+# result once (it survives OTA updates, which only rewrite app0/app1):
+#
+#   esptool.py --chip esp32p4 --port COM3 write_flash 0x1410000 moon_texture.bin
+#
+# Layout (little-endian), read by init_flash_texture() in moon_sphere.cpp:
+#   0   char[8]  "MOONTX01"
+#   8   u16      width of level 0 (power of two, wraps in longitude)
+#   10  u16      height of level 0 (power of two, row 0 = north)
+#   12  u8       levels (level i is width >> i by height >> i)
+#   13  u8       format (1 = RGB565)
+#   14  u16      reserved, 0
+#   16  u32[12]  byte offset of each level from the start of the image
+#   64  level 0 texels, row-major, then each further level, each 64-byte aligned
+# Level 0 is the source converted as-is (R5 = r >> 3, G6 = g >> 2, B5 = b >> 3,
+# as the stb_image path does); each further level is a 2x2 box average of the
+# one above it, filtered in 8-bit before converting; small frames (the 240 px
+# drag render) sample those instead of the full map (moonTextureLevel()).
+import argparse
+import os
+import re
+import struct
 import sys
+from io import BytesIO
+
+from PIL import Image
+
+MAGIC = b"MOONTX01"
+FORMAT_RGB565 = 1
+HEADER_SIZE = 64
+MAX_LEVELS = 12
+PARTITION_OFFSET = 0x1410000
+PARTITION_SIZE = 0x600000
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def embedded_jpeg():
+    text = open(os.path.join(ROOT, "moon_equirect_data.h")).read()
+    body = text[text.index("MOON_EQUIRECT_JPG[] = {"):]
+    body = body[:body.index("};")]
+    return bytes(int(h, 16) for h in re.findall(r"0x([0-9a-fA-F]{2})", body))
+
+
+def rgb565(img):
+    px = img.tobytes()
+    out = bytearray(len(px) // 3 * 2)
+    for i in range(0, len(px), 3):
+        v = ((px[i] & 0xF8) << 8) | ((px[i + 1] & 0xFC) << 3) | (px[i + 2] >> 3)
+        out[i // 3 * 2] = v & 0xFF
+        out[i // 3 * 2 + 1] = v >> 8
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Bake the lunar texture for the moontex partition")
+    ap.add_argument("source", nargs="?", help="equirectangular image (default: moon_equirect_data.h)")
+    ap.add_argument("-o", "--output", default="moon_texture.bin")
+    ap.add_argument("--levels", type=int, default=4, help="mip levels including the full map (default 4)")
+    args = ap.parse_args()
+
+    src = Image.open(args.source if args.source else BytesIO(embedded_jpeg())).convert("RGB")
+    w, h = src.size
+    if w & (w - 1) or h & (h - 1):
+        sys.exit(f"{w}x{h}: width and height must be powers of two (the map wraps as one)")
+    levels = max(1, min(args.levels, MAX_LEVELS))
+    while levels > 1 and (w >> (levels - 1) < 2 or h >> (levels - 1) < 2):
+        levels -= 1
+
+    blobs, img = [], src
+    for i in range(levels):
+        if i:
+            img = img.reduce(2)
+        blobs.append(rgb565(img))
+
+    offsets, pos = [], HEADER_SIZE
+    for b in blobs:
+        offsets.append(pos)
+        pos = (pos + len(b) + 63) & ~63
+    if pos > PARTITION_SIZE:
+        sys.exit(f"{pos} bytes does not fit the {PARTITION_SIZE:#x}-byte moontex partition")
+
+    out = bytearray(pos)
+    struct.pack_into("<8sHHBBH12I", out, 0, MAGIC, w, h, levels, FORMAT_RGB565, 0,
+                     *(offsets + [0] * (MAX_LEVELS - levels)))
+    for off, b in zip(offsets, blobs):
+        out[off:off + len(b)] = b
+    open(args.output, "wb").write(out)
+
+    print(f"wrote {args.output}: {w}x{h} RGB565, {levels} level(s), {len(out)} bytes")
+    print(f"flash with: esptool.py --chip esp32p4 --port <PORT> write_flash {PARTITION_OFFSET:#x} {args.output}")
+
 
-SRC = sys.argv[1] if len(sys.argv) > 1 else \
-    r"C:\Users\Kumar\git\ESP32-P4-NINA-Display\main\moon_texture.png"
-SIZE = 256
-img = Image.open(SRC).convert("RGBA").resize((SIZE, SIZE), Image.LANCZOS)
-px = img.load()
-out = ["#pragma once", "#include <stdint.h>",
-       f"#define MOON_TEX_SIZE {SIZE}",
-       "// luminance,alpha pairs, row-major, MOON_TEX_SIZE^2 entries",
-       "static const uint8_t MOON_TEX_LA[MOON_TEX_SIZE*MOON_TEX_SIZE*2] = {"]
-vals = []
-for y in range(SIZE):
-    for x in range(SIZE):
-        r, g, b, a = px[x, y]
-        lum = (r*30 + g*59 + b*11) // 100
-        vals.append(str(lum)); vals.append(str(a))
-out.append(",".join(vals))
-out.append("};")
-open("moon_texture_data.h", "w").write("\n".join(out))
-print("wrote moon_texture_data.h", SIZE, "x", SIZE)
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,19 @@
+#include "transition_schedule.h"
+
+int transitionSteps(int durationMs, int fps) {
+    int steps = durationMs * fps / 1000;
+    return steps < 1 ? 1 : steps;
+}
+
+uint8_t transitionFadeAlpha(int step, int steps) {
+    int remaining = steps - step + 1;
+    if (remaining <= 1) return 255;
+    return (uint8_t)((255 + remaining / 2) / remaining);
+}
+
+int transitionSlideOffset(int step, int steps, int width) {
+    if (step >= steps) return 0;
+    // Ease out: the distance left falls with the square of the time left
+    float left = 1.0f - (float)step / steps;
+    return (int)(width * left * left + 0.5f);
+}
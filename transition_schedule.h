@@ -0,0 +1,37 @@
+#pragma once
+#ifndef TRANSITION_SCHEDULE_H
+#define TRANSITION_SCHEDULE_H
+
+#include <stdint.h>
+
+// =============================================================================
+// TRANSITION SCHEDULE
+// =============================================================================
+// Frame sequence for the change from one image to the next (DisplayManager
+// runs it on the PPA): how many frames, and what each one does. The
+// cross-fade blends the incoming frame over what is on the panel, in place,
+// so no copy of the outgoing frame is kept; each step's alpha is chosen so
+// the panel shows old * (1 - k/N) + new * k/N after step k, and the last
+// step replaces it outright. No Arduino / IDF types: unit-tested on the host
+// (test/test_transition_schedule.cpp).
+
+#define TRANSITION_NONE 0
+#define TRANSITION_FADE 1
+#define TRANSITION_SLIDE 2
+
+// Frames in a durationMs transition at fps, at least 1
+int transitionSteps(int durationMs, int fps);
+
+// Alpha (0..255) to blend the incoming frame over the panel with at step
+// 1..steps of an in-place cross-fade: 1 / (steps - step + 1) of the way from
+// what is there to the new frame. 255 on the last step. Each blend rounds to
+// 8 bits, which holds back small differences for a step or two: a 30-frame
+// fade strays up to 4 / 255 from the straight mix on the way, and none at the
+// end.
+uint8_t transitionFadeAlpha(int step, int steps);
+
+// How far (0..width pixels) the incoming frame still is from its place at
+// step 1..steps of a slide, easing out; 0 on the last step.
+int transitionSlideOffset(int step, int steps, int width);
+
+#endif // TRANSITION_SCHEDULE_H
@@ -13,6 +13,9 @@
 #include "logging.h"
 #include "image_presets.h"
 #include "config_backup.h"
+#include "conditional_fetch.h"
+#include "frame_slots.h"
+#include "pooled_http_client.h"
 #include <Update.h>
 #include <driver/jpeg_encode.h>  // ESP32-P4 hardware JPEG encoder (screenshot endpoint)
 
@@ -140,6 +143,16 @@ void WebConfig::handleSaveConfig() {
             LOG_INFO_F("[WebAPI] Color temperature set to %dK\n", temp);
             imageSettingsChanged = true;  // Trigger image refresh to apply new color temp
         }
+        else if (name == "display_gamma") {
+            configStorage.setDisplayGamma(value.toInt());
+            LOG_INFO_F("[WebAPI] Gamma set to %.2f\n", configStorage.getDisplayGamma() / 100.0f);
+            imageSettingsChanged = true;
+        }
+        else if (name == "night_red_shift") {
+            configStorage.setNightRedShift(value.toInt());
+            LOG_INFO_F("[WebAPI] Night red shift set to %d%%\n", configStorage.getNightRedShift());
+            imageSettingsChanged = true;
+        }
         
         // Cycling settings
         else if (name == "cycle_interval") {
@@ -1366,6 +1379,59 @@ void WebConfig::handleGetAllInfo() {
     }
     json += "},";
     
+    // Conditional GET (ETag / Last-Modified) revalidation counters
+    const ConditionalFetchStats& cfs = conditionalFetch.getStats();
+    json += "\"http_cache\":{";
+    json += "\"conditional_requests\":" + String(cfs.conditionalRequests) + ",";
+    json += "\"not_modified_hits\":" + String(cfs.notModified) + ",";
+    json += "\"modified_misses\":" + String(cfs.modified) + ",";
+    json += "\"forced_refreshes\":" + String(cfs.forcedRefreshes) + ",";
+    json += "\"unconditional_requests\":" + String(cfs.unconditional) + ",";
+    json += "\"unchanged_bodies\":" + String(cfs.unchangedBodies) + ",";
+    json += "\"force_check_interval\":" + String(FORCE_CHECK_INTERVAL);
+    json += "},";
+
+    // Decoded-frame cache (prefetch + revisits within a source's TTL)
+    FrameCacheStats fcs = frameSlots.getStats();
+    uint32_t fcLookups = fcs.hits + fcs.misses;
+    json += "\"frame_cache\":{";
+    json += "\"slots\":" + String(frameSlots.count()) + ",";
+    json += "\"entries\":" + String(fcs.entries) + ",";
+    json += "\"bytes_held\":" + String((unsigned long)fcs.bytesHeld) + ",";
+    json += "\"budget_bytes\":" + String((unsigned long)frameSlots.budget()) + ",";
+    json += "\"hits\":" + String(fcs.hits) + ",";
+    json += "\"misses\":" + String(fcs.misses) + ",";
+    json += "\"hit_rate\":" + String(fcLookups ? (float)fcs.hits / fcLookups : 0.0f, 3) + ",";
+    json += "\"evictions\":" + String(fcs.evictions) + ",";
+    json += "\"expirations\":" + String(fcs.expirations);
+    json += "},";
+
+    // Keep-alive connection pool: reuse, and where fetch time goes
+    HttpPoolStats hps = httpPool.getStats();
+    const HttpFetchTiming& hlf = httpPool.lastFetch();
+    json += "\"http_pool\":{";
+    json += "\"enabled\":" + String(HTTP_KEEP_ALIVE ? "true" : "false") + ",";
+    json += "\"fetches\":" + String(hps.fetches) + ",";
+    json += "\"reused\":" + String(hps.reused) + ",";
+    json += "\"opened\":" + String(hps.opened) + ",";
+    json += "\"open_connections\":" + String(hps.openConnections) + ",";
+    json += "\"closed_idle\":" + String(hps.closedIdle) + ",";
+    json += "\"closed_by_peer\":" + String(hps.closedByPeer) + ",";
+    json += "\"evicted\":" + String(hps.evicted) + ",";
+    json += "\"not_reusable\":" + String(hps.notReusable) + ",";
+    json += "\"avg_connect_ms\":" + String(hps.opened ? hps.connectMsTotal / hps.opened : 0) + ",";
+    json += "\"avg_response_ms\":" + String(hps.fetches ? hps.responseMsTotal / hps.fetches : 0) + ",";
+    json += "\"avg_body_ms\":" + String(hps.fetches ? hps.bodyMsTotal / hps.fetches : 0) + ",";
+    json += "\"last\":{";
+    json += "\"host\":\"" + escapeJson(String(httpPool.lastHost())) + "\",";
+    json += "\"reused\":" + String(hlf.reused ? "true" : "false") + ",";
+    json += "\"connect_ms\":" + String(hlf.connectMs) + ",";
+    json += "\"response_ms\":" + String(hlf.responseMs) + ",";
+    json += "\"body_ms\":" + String(hlf.bodyMs) + ",";
+    json += "\"bytes\":" + String((unsigned long)hlf.bytes);
+    json += "}";
+    json += "},";
+
     // Default transformation settings
     json += "\"defaults\":{";
     json += "\"brightness\":" + String(configStorage.getDefaultBrightness()) + ",";
@@ -394,6 +394,18 @@ String WebConfig::generateDisplayPage() {
     html += "<input type='range' id='color_temp' name='color_temp' class='form-control' style='height:6px;padding:0' value='" + 
             String(configStorage.getColorTemp()) + "' min='2000' max='15000' step='100' oninput='document.getElementById(\"tempVal\").innerText=this.value+\"K\"' onchange='autoSaveDisplaySetting(\"color_temp\",this.value)'></div>";
     
+    // Gamma (stored x100)
+    html += "<div class='form-group' style='margin:0'><label for='display_gamma'>Gamma: <span id='gammaVal' style='color:#38bdf8;font-weight:bold'>" + 
+            String(configStorage.getDisplayGamma() / 100.0f, 2) + "</span></label>";
+    html += "<input type='range' id='display_gamma' name='display_gamma' class='form-control' style='height:6px;padding:0' value='" + 
+            String(configStorage.getDisplayGamma()) + "' min='" + String(MIN_DISPLAY_GAMMA) + "' max='" + String(MAX_DISPLAY_GAMMA) + "' step='5' oninput='document.getElementById(\"gammaVal\").innerText=(this.value/100).toFixed(2)' onchange='autoSaveDisplaySetting(\"display_gamma\",this.value)'></div>";
+    
+    // Night red shift
+    html += "<div class='form-group' style='margin:0'><label for='night_red_shift'>Night Red Shift: <span id='redShiftVal' style='color:#38bdf8;font-weight:bold'>" + 
+            String(configStorage.getNightRedShift()) + "%</span></label>";
+    html += "<input type='range' id='night_red_shift' name='night_red_shift' class='form-control' style='height:6px;padding:0' value='" + 
+            String(configStorage.getNightRedShift()) + "' min='0' max='" + String(MAX_NIGHT_RED_SHIFT) + "' step='5' oninput='document.getElementById(\"redShiftVal\").innerText=this.value+\"%\"' onchange='autoSaveDisplaySetting(\"night_red_shift\",this.value)'></div>";
+    
     html += "</div>";
     
     // PWM Settings in compact grid